@@ -0,0 +1,263 @@
+// Entry point of magpie_multi, which links one complete engine per board
+// dimension in MULTI_BOARD_DIMS (see the Makefile). Each engine is all of src/
+// compiled for its BOARD_DIM with its global symbols prefixed by b<dim>_, so
+// every board size runs at full specialized speed in the same executable.
+//
+// Each engine runs its own session. The layout named with -bdn on the command
+// line, else the one in the saved settings, picks the engine that starts;
+// without one the first engine starts. After that, every command that names a
+// layout with -bdn runs in the engine of that layout's size. When the engine
+// changes, the settings of the previous engine other than the board size
+// options are carried over first, so a later 'set -bdn super21' keeps the
+// lexicon and other options.
+
+#include "../src/def/config_defs.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct ConfigArgs ConfigArgs;
+typedef struct ExecSession ExecSession;
+
+#define MULTI_ENGINE(dim)                                                      \
+  ExecSession *b##dim##_exec_session_create(const ConfigArgs *config_args);    \
+  void b##dim##_exec_session_destroy(ExecSession *session);                    \
+  bool b##dim##_exec_session_start(ExecSession *session,                       \
+                                   const char *initial_command_string);        \
+  void b##dim##_exec_session_load_settings(ExecSession *session,               \
+                                           const char *settings);              \
+  char *b##dim##_exec_session_get_settings(const ExecSession *session);        \
+  char *b##dim##_exec_session_read_command(const ExecSession *session);        \
+  void b##dim##_exec_session_run_command(ExecSession *session,                 \
+                                         const char *command);                 \
+  void b##dim##_caches_destroy(void);                                          \
+  char *b##dim##_create_command_from_args(int argc, char *argv[]);             \
+  int b##dim##_board_layout_get_board_dim(const char *data_paths,              \
+                                          const char *board_layout_name);
+MAGPIE_MULTI_BOARD_DIMS
+#undef MULTI_ENGINE
+
+#define MULTI_ENGINE_FUNCTION_HELPER(dim, name) b##dim##_##name
+#define MULTI_ENGINE_FUNCTION(dim, name) MULTI_ENGINE_FUNCTION_HELPER(dim, name)
+
+typedef struct MultiEngine {
+  int board_dim;
+  ExecSession *(*session_create)(const ConfigArgs *config_args);
+  void (*session_destroy)(ExecSession *session);
+  bool (*session_start)(ExecSession *session,
+                        const char *initial_command_string);
+  void (*session_load_settings)(ExecSession *session, const char *settings);
+  char *(*session_get_settings)(const ExecSession *session);
+  char *(*session_read_command)(const ExecSession *session);
+  void (*session_run_command)(ExecSession *session, const char *command);
+  void (*caches_destroy)(void);
+  // Created when the engine first runs a command
+  ExecSession *session;
+} MultiEngine;
+
+static MultiEngine multi_engines[] = {
+#define MULTI_ENGINE(dim)                                                      \
+  {dim,                                                                        \
+   b##dim##_exec_session_create,                                               \
+   b##dim##_exec_session_destroy,                                              \
+   b##dim##_exec_session_start,                                                \
+   b##dim##_exec_session_load_settings,                                        \
+   b##dim##_exec_session_get_settings,                                         \
+   b##dim##_exec_session_read_command,                                         \
+   b##dim##_exec_session_run_command,                                          \
+   b##dim##_caches_destroy,                                                    \
+   NULL},
+    MAGPIE_MULTI_BOARD_DIMS
+#undef MULTI_ENGINE
+};
+
+enum {
+  NUMBER_OF_MULTI_ENGINES = sizeof(multi_engines) / sizeof(multi_engines[0]),
+};
+
+typedef struct BoardOptions {
+  char *data_paths;
+  char *board_layout_name;
+} BoardOptions;
+
+static void set_board_option(char **option, const char *value) {
+  free(*option);
+  *option = strdup(value);
+}
+
+// Updates the layout and data paths from the -bdn and -path options in the
+// options string and returns true if it names a layout. An option and its
+// value may be in consecutive strings, which previous_token carries between
+// calls.
+static bool scan_board_options(BoardOptions *board_options,
+                               const char *options, char **previous_token) {
+  bool names_layout = false;
+  char *options_copy = strdup(options);
+  for (char *token = strtok(options_copy, " \n"); token;
+       token = strtok(NULL, " \n")) {
+    if (*previous_token && strcmp(*previous_token, "-bdn") == 0) {
+      set_board_option(&board_options->board_layout_name, token);
+      names_layout = true;
+    } else if (*previous_token && strcmp(*previous_token, "-path") == 0) {
+      set_board_option(&board_options->data_paths, token);
+    }
+    set_board_option(previous_token, token);
+  }
+  free(options_copy);
+  return names_layout;
+}
+
+static int get_board_dim(const BoardOptions *board_options) {
+  if (!board_options->board_layout_name) {
+    return 0;
+  }
+  return MULTI_ENGINE_FUNCTION(MAGPIE_MULTI_FIRST_BOARD_DIM,
+                               board_layout_get_board_dim)(
+      board_options->data_paths, board_options->board_layout_name);
+}
+
+// Reads the layout the first engine will load: the one named on the command
+// line, else the one in the saved settings.
+static void scan_initial_board_options(BoardOptions *board_options, int argc,
+                                       char *argv[]) {
+  char *previous_token = NULL;
+  FILE *settings_stream = fopen(DEFAULT_SETTINGS_FILENAME, "r");
+  if (settings_stream) {
+    fseek(settings_stream, 0, SEEK_END);
+    const long settings_size = ftell(settings_stream);
+    fseek(settings_stream, 0, SEEK_SET);
+    if (settings_size > 0) {
+      char *settings = calloc((size_t)settings_size + 1, 1);
+      if (fread(settings, 1, (size_t)settings_size, settings_stream) ==
+          (size_t)settings_size) {
+        scan_board_options(board_options, settings, &previous_token);
+      }
+      free(settings);
+    }
+    fclose(settings_stream);
+  }
+  free(previous_token);
+  previous_token = NULL;
+  for (int i = 1; i < argc; i++) {
+    scan_board_options(board_options, argv[i], &previous_token);
+  }
+  free(previous_token);
+}
+
+// Returns the engine for the board dimension, or NULL if there is none.
+static MultiEngine *get_multi_engine(int board_dim) {
+  for (int i = 0; i < NUMBER_OF_MULTI_ENGINES; i++) {
+    if (multi_engines[i].board_dim == board_dim) {
+      return &multi_engines[i];
+    }
+  }
+  return NULL;
+}
+
+// Options that only apply to the board size of the engine that set them: the
+// layout, and whether to load the word maps, which are built for one board
+// size.
+static const char *const board_size_options[] = {"-bdn", "-w1", "-w2"};
+
+static bool is_board_size_option(const char *token) {
+  for (size_t i = 0;
+       i < sizeof(board_size_options) / sizeof(board_size_options[0]); i++) {
+    if (strcmp(token, board_size_options[i]) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns the settings without their board size options and their values.
+static char *remove_board_size_options(const char *settings) {
+  char *settings_without_options = calloc(strlen(settings) + 1, 1);
+  char *settings_copy = strdup(settings);
+  bool skip_next_token = false;
+  for (char *token = strtok(settings_copy, " \n"); token;
+       token = strtok(NULL, " \n")) {
+    if (skip_next_token) {
+      skip_next_token = false;
+    } else if (is_board_size_option(token)) {
+      skip_next_token = true;
+    } else {
+      if (*settings_without_options) {
+        strcat(settings_without_options, " ");
+      }
+      strcat(settings_without_options, token);
+    }
+  }
+  free(settings_copy);
+  return settings_without_options;
+}
+
+// Switches to the engine and carries over the settings of the current engine
+// other than the board size options. An engine that has not run yet starts
+// without word maps. Returns NULL if its session cannot be created.
+static MultiEngine *switch_multi_engine(MultiEngine *current_engine,
+                                        MultiEngine *next_engine) {
+  if (!next_engine->session) {
+    next_engine->session = next_engine->session_create(NULL);
+    if (!next_engine->session) {
+      return NULL;
+    }
+    next_engine->session_load_settings(next_engine->session,
+                                       "setoptions -w1 false -w2 false");
+  }
+  char *settings =
+      current_engine->session_get_settings(current_engine->session);
+  char *settings_without_options = remove_board_size_options(settings);
+  next_engine->session_load_settings(next_engine->session,
+                                     settings_without_options);
+  free(settings_without_options);
+  free(settings);
+  return next_engine;
+}
+
+int main(int argc, char *argv[]) {
+  BoardOptions board_options = {strdup(DEFAULT_DATA_PATHS), NULL};
+  scan_initial_board_options(&board_options, argc, argv);
+  MultiEngine *engine = get_multi_engine(get_board_dim(&board_options));
+  if (!engine) {
+    engine = &multi_engines[0];
+  }
+  engine->session = engine->session_create(NULL);
+  if (engine->session) {
+    char *initial_command_string = MULTI_ENGINE_FUNCTION(
+        MAGPIE_MULTI_FIRST_BOARD_DIM, create_command_from_args)(argc, argv);
+    bool read_commands =
+        engine->session_start(engine->session, initial_command_string);
+    free(initial_command_string);
+    char *previous_token = NULL;
+    char *command;
+    while (read_commands &&
+           (command = engine->session_read_command(engine->session))) {
+      if (scan_board_options(&board_options, command, &previous_token)) {
+        MultiEngine *next_engine =
+            get_multi_engine(get_board_dim(&board_options));
+        // A layout of a size without an engine is left to the current
+        // engine, which reports the error.
+        if (next_engine && next_engine != engine) {
+          engine = switch_multi_engine(engine, next_engine);
+          read_commands = engine != NULL;
+        }
+      }
+      free(previous_token);
+      previous_token = NULL;
+      if (read_commands) {
+        engine->session_run_command(engine->session, command);
+      }
+      free(command);
+    }
+  }
+  for (int i = 0; i < NUMBER_OF_MULTI_ENGINES; i++) {
+    if (multi_engines[i].session) {
+      multi_engines[i].caches_destroy();
+      multi_engines[i].session_destroy(multi_engines[i].session);
+    }
+  }
+  free(board_options.data_paths);
+  free(board_options.board_layout_name);
+  return 0;
+}
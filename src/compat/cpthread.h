@@ -3,6 +3,7 @@
 
 #include <errno.h>
 #include <pthread.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <time.h>
 
@@ -15,6 +16,12 @@ static inline void cpthread_mutex_init(cpthread_mutex_t *mutex) {
   }
 }
 
+static inline void cpthread_mutex_destroy(cpthread_mutex_t *mutex) {
+  if (pthread_mutex_destroy(mutex)) {
+    log_fatal("mutex destroy failed");
+  }
+}
+
 static inline void cpthread_mutex_lock(cpthread_mutex_t *mutex) {
   if (pthread_mutex_lock(mutex)) {
     log_fatal("mutex lock failed");
@@ -53,6 +60,21 @@ static inline void cpthread_cond_timedwait(cpthread_cond_t *cond,
   log_fatal("cond timedwait failed");
 }
 
+// Like cpthread_cond_timedwait, but returns false instead of failing if
+// abstime passes before the condition is signaled.
+static inline bool cpthread_cond_timedwait_or_timeout(
+    cpthread_cond_t *cond, cpthread_mutex_t *mutex,
+    const struct timespec *abstime) {
+  int ret = pthread_cond_timedwait(cond, mutex, abstime);
+  if (ret == ETIMEDOUT) {
+    return false;
+  }
+  if (ret != 0) {
+    log_fatal("cond timedwait failed");
+  }
+  return true;
+}
+
 static inline void cpthread_cond_timedwait_loop(cpthread_cond_t *cond,
                                                 cpthread_mutex_t *mutex,
                                                 const int timeout_seconds,
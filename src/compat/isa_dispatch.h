@@ -0,0 +1,58 @@
+#ifndef ISA_DISPATCH_H
+#define ISA_DISPATCH_H
+
+// Runtime instruction set dispatch for portable builds. Builds made with
+// -DMAGPIE_ISA_DISPATCH (the default for the optimized flavors, see the ISA
+// knob in the Makefile) compile every function marked ISA_DISPATCH once per
+// x86-64 microarchitecture level and pick the best clone for the running CPU
+// when the program is loaded. The static inline kernels those functions call
+// (bit racks, WMP lookups, KWG letter sets, leave maps) are inlined into each
+// clone, so they get the wider instructions too without being marked.
+//
+// Elsewhere, and for builds made for the build machine with ISA=native, the
+// marker expands to nothing.
+
+#if defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define ISA_DISPATCH_HAS_TARGET_CLONES 1
+#endif
+#endif
+
+// The microarchitecture levels require GCC 12 or clang 18 as clone targets.
+#if defined(MAGPIE_ISA_DISPATCH) && defined(ISA_DISPATCH_HAS_TARGET_CLONES) && \
+    defined(__x86_64__) && defined(__ELF__) &&                                \
+    ((!defined(__clang__) && __GNUC__ >= 12) ||                                \
+     (defined(__clang__) && __clang_major__ >= 18))
+#define ISA_DISPATCH_ENABLED 1
+#define ISA_DISPATCH                                                           \
+  __attribute__((target_clones("arch=x86-64-v4", "arch=x86-64-v3",            \
+                               "arch=x86-64-v2", "default")))
+#else
+#define ISA_DISPATCH_ENABLED 0
+#define ISA_DISPATCH
+#endif
+
+// Returns the name of the clones selected for the running CPU: the x86-64
+// microarchitecture level when dispatching, "native" when built for the build
+// machine and "default" otherwise.
+static inline const char *isa_dispatch_get_level(void) {
+#if ISA_DISPATCH_ENABLED
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("x86-64-v4")) {
+    return "x86-64-v4";
+  }
+  if (__builtin_cpu_supports("x86-64-v3")) {
+    return "x86-64-v3";
+  }
+  if (__builtin_cpu_supports("x86-64-v2")) {
+    return "x86-64-v2";
+  }
+  return "x86-64";
+#elif defined(MAGPIE_ISA_NATIVE)
+  return "native";
+#else
+  return "default";
+#endif
+}
+
+#endif
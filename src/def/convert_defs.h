@@ -24,6 +24,9 @@ typedef enum {
   CONVERT_TEXT2WORDMAP,
   CONVERT_DAWG2WORDMAP,
   CONVERT_KLVWMP2RIT,
+  // Rewrites the leave data of an existing RIT from a (new) KLV, reusing
+  // the lexicon-derived data already in the table.
+  CONVERT_RITKLV2RIT,
   CONVERT_UNKNOWN,
 } conversion_type_t;
 
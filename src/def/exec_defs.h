@@ -5,6 +5,8 @@
 #define TERMINATE_KEYWORD_ALIAS_EXIT "exit"
 #define TERMINATE_KEYWORD_ALIAS_SHORT "q"
 
+#define SERVE_KEYWORD "serve"
+
 typedef enum {
   ASYNC_STOP_COMMAND_TOKEN,
   ASYNC_STATUS_COMMAND_TOKEN,
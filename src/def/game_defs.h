@@ -9,6 +9,7 @@ enum {
   MAX_SEARCH_DEPTH = 25,
   MAX_SCORELESS_TURNS = 6,
   ASCII_UPPERCASE_A = 65,
+  GAME_CROSS_CHECK_INDEX_ENTRIES = 4096,
 };
 
 typedef enum {
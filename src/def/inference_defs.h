@@ -1,11 +1,29 @@
 #ifndef INFERENCE_DEFS_H
 #define INFERENCE_DEFS_H
 
+#include "rack_defs.h"
+
 // Minimum leave size for enabling cutoff optimization on exchanges.
 // Benchmarks show cutoff optimization hurts performance for exchanges
 // with leave size >= this threshold (i.e., small exchanges).
 #define INFERENCE_CUTOFF_MIN_EXCHANGE_LEAVE_SIZE 3
 
+// Number of candidate racks each inference worker collects before generating
+// their top moves together with generate_moves_for_racks.
+#define INFERENCE_MOVEGEN_BATCH_SIZE 64
+
+// Number of refuting moves each inference worker keeps to reject later
+// candidate racks without generating their moves.
+#define INFERENCE_NUMBER_OF_WITNESSES 8
+
+// Number of equivalence classes of racks each inference worker keeps the
+// tile placements of, and the number of moves generated for each class.
+#define INFERENCE_NUMBER_OF_CLASSES 16
+#define INFERENCE_CLASS_MOVE_LIST_CAPACITY 256
+// Distinct leaves kept per class, which is at most the number of subsets of
+// the playable part of a rack.
+#define INFERENCE_MAX_CLASS_LEAVES (1 << RACK_SIZE)
+
 typedef enum {
   INFERENCE_TYPE_LEAVE,
   INFERENCE_TYPE_EXCHANGED,
@@ -0,0 +1,27 @@
+#ifndef PERF_COUNTER_DEFS_H
+#define PERF_COUNTER_DEFS_H
+
+// Hot-path counters recorded when built with PERF_COUNTERS=1. Timer
+// counters record elapsed cycle_counter_read ticks per event; the others
+// record the value passed to PERF_COUNTER_ADD.
+typedef enum {
+  PERF_COUNTER_MOVEGEN,
+  PERF_COUNTER_MOVEGEN_SHADOW,
+  PERF_COUNTER_MOVEGEN_RECORD,
+  PERF_COUNTER_MOVEGEN_WMP_ANCHOR,
+  PERF_COUNTER_MOVEGEN_ANCHORS,
+  PERF_COUNTER_CROSS_SET_UPDATE,
+  PERF_COUNTER_PLAY_MOVE,
+  PERF_COUNTER_UNPLAY_MOVE,
+  PERF_COUNTER_BAI_NEXT_ARM,
+  PERF_COUNTER_BAI_SAMPLE,
+  PERF_COUNTER_TT_PROBE_HIT,
+  PERF_COUNTER_PEG_SCENARIO_LEAF,
+  NUMBER_OF_PERF_COUNTERS,
+} perf_counter_t;
+
+// One log2 bucket per possible bit length of a uint64_t value, plus one for
+// zero.
+enum { PERF_COUNTER_HISTOGRAM_BUCKETS = 65 };
+
+#endif
@@ -6,6 +6,7 @@ typedef enum {
   PLAYERS_DATA_TYPE_KLV,
   PLAYERS_DATA_TYPE_WMP,
   PLAYERS_DATA_TYPE_RIT,
+  PLAYERS_DATA_TYPE_OPENING_TABLE,
   NUMBER_OF_DATA
 } players_data_t;
 
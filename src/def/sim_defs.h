@@ -3,6 +3,16 @@
 
 enum {
   MAX_PLIES = 25,
+  // Number of rollouts of a play whose per ply stats a sim worker collects
+  // before merging them into the shared results.
+  SIM_PLY_STATS_MERGE_INTERVAL = 64,
+  // By default the per ply stats of every rollout are collected.
+  DEFAULT_PLY_STATS_RATE = 1,
+  // Base two log of the number of entries in the table of rollout replies
+  // shared by the candidates of a sim.
+  SIM_REPLY_CACHE_SIZE_POWER = 16,
+  // Number of locks guarding the entries of the reply table.
+  SIM_REPLY_CACHE_NUM_LOCKS = 64,
 };
 
 #endif
\ No newline at end of file
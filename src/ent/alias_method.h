@@ -1,49 +1,82 @@
 #ifndef ALIAS_METHOD_H
 #define ALIAS_METHOD_H
 
-#include "../compat/cpthread.h"
-#include "../def/cpthread_defs.h"
+#include "../compat/malloc.h"
 #include "../util/io_util.h"
 #include "encoded_rack.h"
 #include "rack.h"
 #include "xoshiro.h"
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define INITIAL_AM_ENTRIES_SIZE 1024
 
+// A bin is padded to a power of two no larger than a cache line so that, with
+// the bins allocated on a cache line boundary, sampling a bin touches exactly
+// one cache line.
+#define ALIAS_METHOD_CACHE_LINE_BYTES 64
+#define ALIAS_METHOD_BIN_ALIGNMENT                                             \
+  (ENCODED_RACK_UNITS == 1 ? 32 : ALIAS_METHOD_CACHE_LINE_BYTES)
+
+// A recorded rack and its number of draws.
 typedef struct AliasMethodItem {
   EncodedRack rack;
   uint32_t count;
-  uint32_t alias;
-  uint32_t overfull_item_index;
-  uint32_t underfull_item_index;
-  double probability;
 } AliasMethodItem;
 
+// One bin of the sampling table. The bin holds both of its racks, so a sample
+// never has to follow the alias to another item.
+typedef struct AliasMethodBin {
+  _Alignas(ALIAS_METHOD_BIN_ALIGNMENT) EncodedRack rack;
+  EncodedRack alias_rack;
+  // The bin's own rack is chosen when the fractional part of the draw, scaled
+  // to 2^64, is below this threshold, and the alias rack otherwise.
+  uint64_t threshold;
+} AliasMethodBin;
+
+// Records weighted racks and samples them in constant time with Vose's alias
+// method. Recording is not thread safe: concurrent recorders each fill their
+// own AliasMethod and merge them into one with alias_method_merge before the
+// tables are generated.
 typedef struct AliasMethod {
   AliasMethodItem *items;
   uint32_t num_items;
   uint32_t capacity;
   uint64_t total_item_count;
-  cpthread_mutex_t mutex;
+  // Sampling table with one bin per item, built by
+  // alias_method_generate_tables.
+  AliasMethodBin *bins;
+  uint32_t num_bins;
+  uint32_t bins_capacity;
+  // Scratch space for building the table: the scaled probability of each item
+  // and the stacks of overfull and underfull item indexes.
+  double *scaled_probabilities;
+  uint32_t *overfull_item_indexes;
+  uint32_t *underfull_item_indexes;
 } AliasMethod;
 
 static inline AliasMethod *alias_method_create(void) {
-  AliasMethod *am = (AliasMethod *)malloc_or_die(sizeof(AliasMethod));
+  AliasMethod *am = (AliasMethod *)calloc_or_die(1, sizeof(AliasMethod));
   am->capacity = INITIAL_AM_ENTRIES_SIZE;
   am->items =
       (AliasMethodItem *)malloc_or_die(sizeof(AliasMethodItem) * am->capacity);
-  am->num_items = 0;
-  am->total_item_count = 0;
-  cpthread_mutex_init(&am->mutex);
   return am;
 }
 
+static inline void alias_method_destroy_tables(AliasMethod *am) {
+  portable_aligned_free(am->bins);
+  free(am->scaled_probabilities);
+  free(am->overfull_item_indexes);
+  free(am->underfull_item_indexes);
+}
+
 static inline void alias_method_destroy(AliasMethod *am) {
   if (!am) {
     return;
   }
+  alias_method_destroy_tables(am);
   free(am->items);
   free(am);
 }
@@ -51,112 +84,166 @@ static inline void alias_method_destroy(AliasMethod *am) {
 static inline void alias_method_reset(AliasMethod *am) {
   am->num_items = 0;
   am->total_item_count = 0;
+  am->num_bins = 0;
 }
 
-// Thread safe
-static inline void alias_method_add_rack(AliasMethod *am, const Rack *rack,
-                                         int count) {
-  cpthread_mutex_lock(&am->mutex);
-  if (am->num_items == am->capacity) {
+static inline void alias_method_reserve(AliasMethod *am, uint32_t num_items) {
+  if (num_items <= am->capacity) {
+    return;
+  }
+  while (am->capacity < num_items) {
     am->capacity *= 2;
-    am->items = (AliasMethodItem *)realloc_or_die(
-        am->items, sizeof(AliasMethodItem) * am->capacity);
   }
-  int new_item_index = am->num_items;
-  am->total_item_count += (uint64_t)count;
-  am->num_items++;
-  AliasMethodItem *item = &am->items[new_item_index];
+  am->items = (AliasMethodItem *)realloc_or_die(
+      am->items, sizeof(AliasMethodItem) * am->capacity);
+}
+
+// Not thread safe, see above.
+static inline void alias_method_add_rack(AliasMethod *am, const Rack *rack,
+                                         int count) {
+  alias_method_reserve(am, am->num_items + 1);
+  AliasMethodItem *item = &am->items[am->num_items++];
   rack_encode(rack, &item->rack);
   item->count = (uint32_t)count;
-  cpthread_mutex_unlock(&am->mutex);
+  am->total_item_count += (uint64_t)count;
+}
+
+// Appends the racks recorded in other to am.
+static inline void alias_method_merge(AliasMethod *am,
+                                      const AliasMethod *other) {
+  if (other->num_items == 0) {
+    return;
+  }
+  alias_method_reserve(am, am->num_items + other->num_items);
+  memcpy(am->items + am->num_items, other->items,
+         sizeof(AliasMethodItem) * other->num_items);
+  am->num_items += other->num_items;
+  am->total_item_count += other->total_item_count;
+}
+
+static inline void alias_method_reserve_tables(AliasMethod *am) {
+  if (am->num_items <= am->bins_capacity) {
+    return;
+  }
+  alias_method_destroy_tables(am);
+  am->bins_capacity = am->capacity;
+  if (portable_aligned_alloc((void **)&am->bins, ALIAS_METHOD_CACHE_LINE_BYTES,
+                             sizeof(AliasMethodBin) * am->bins_capacity) != 0) {
+    log_fatal("failed to allocate %u alias method bins", am->bins_capacity);
+  }
+  am->scaled_probabilities =
+      (double *)malloc_or_die(sizeof(double) * am->bins_capacity);
+  am->overfull_item_indexes =
+      (uint32_t *)malloc_or_die(sizeof(uint32_t) * am->bins_capacity);
+  am->underfull_item_indexes =
+      (uint32_t *)malloc_or_die(sizeof(uint32_t) * am->bins_capacity);
+}
+
+static inline void alias_method_set_bin(AliasMethod *am, uint32_t bin_index,
+                                        uint32_t alias_item_index,
+                                        double probability) {
+  AliasMethodBin *bin = &am->bins[bin_index];
+  bin->rack = am->items[bin_index].rack;
+  bin->alias_rack = am->items[alias_item_index].rack;
+  // 2^64 does not fit, but a probability of 1 always picks the bin's own rack
+  // anyway since its alias is itself.
+  if (probability >= 1.0) {
+    bin->threshold = UINT64_MAX;
+  } else {
+    bin->threshold = (uint64_t)(probability * 18446744073709551616.0);
+  }
 }
 
 // Returns true if there are a nonzero number of items and counts to generate
 // tables for and returns false otherwise.
 static inline bool alias_method_generate_tables(AliasMethod *am) {
+  am->num_bins = 0;
   if (am->num_items == 0 || am->total_item_count == 0) {
     return false;
   }
+  alias_method_reserve_tables(am);
 
+  double *scaled_probabilities = am->scaled_probabilities;
+  uint32_t *overfull_item_indexes = am->overfull_item_indexes;
+  uint32_t *underfull_item_indexes = am->underfull_item_indexes;
   uint32_t num_overfull_items = 0;
   uint32_t num_underfull_items = 0;
 
-  // Scale probabilities and separate into small/large queues
-  double n = (double)am->num_items;
+  // Scale probabilities and separate into small/large stacks
+  const double scale = (double)am->num_items / (double)am->total_item_count;
   for (uint32_t i = 0; i < am->num_items; i++) {
-    double prob = (double)am->items[i].count / (double)am->total_item_count;
-    am->items[i].probability = prob * n;
-    if (am->items[i].probability > 1.0) {
-      am->items[num_overfull_items++].overfull_item_index = i;
+    scaled_probabilities[i] = (double)am->items[i].count * scale;
+    if (scaled_probabilities[i] > 1.0) {
+      overfull_item_indexes[num_overfull_items++] = i;
     } else {
-      am->items[num_underfull_items++].underfull_item_index = i;
+      underfull_item_indexes[num_underfull_items++] = i;
     }
   }
 
-  // Process pairs from small and large lists
+  // Process pairs from small and large stacks
   while (num_overfull_items > 0 && num_underfull_items > 0) {
-    num_overfull_items--;
-    num_underfull_items--;
-    uint32_t overfull_item_index =
-        am->items[num_overfull_items].overfull_item_index;
-    uint32_t underfull_item_index =
-        am->items[num_underfull_items].underfull_item_index;
+    const uint32_t overfull_item_index =
+        overfull_item_indexes[--num_overfull_items];
+    const uint32_t underfull_item_index =
+        underfull_item_indexes[--num_underfull_items];
 
     // Set up the alias relationship
-    am->items[underfull_item_index].alias = overfull_item_index;
+    alias_method_set_bin(am, underfull_item_index, overfull_item_index,
+                         scaled_probabilities[underfull_item_index]);
 
     // Update the large item's scaled probability
-    am->items[overfull_item_index].probability =
-        am->items[overfull_item_index].probability +
-        am->items[underfull_item_index].probability - 1.0;
+    scaled_probabilities[overfull_item_index] +=
+        scaled_probabilities[underfull_item_index] - 1.0;
 
     // Reclassify the large item
-    if (am->items[overfull_item_index].probability > 1.0) {
-      am->items[num_overfull_items++].overfull_item_index = overfull_item_index;
+    if (scaled_probabilities[overfull_item_index] > 1.0) {
+      overfull_item_indexes[num_overfull_items++] = overfull_item_index;
     } else {
-      am->items[num_underfull_items++].underfull_item_index =
-          overfull_item_index;
+      underfull_item_indexes[num_underfull_items++] = overfull_item_index;
     }
   }
 
+  // Whatever is left is full up to rounding error.
   while (num_overfull_items) {
-    num_overfull_items--;
-    uint32_t overfull_item_index =
-        am->items[num_overfull_items].overfull_item_index;
-    am->items[overfull_item_index].probability = 1.0;
-    am->items[overfull_item_index].alias = overfull_item_index;
+    const uint32_t overfull_item_index =
+        overfull_item_indexes[--num_overfull_items];
+    alias_method_set_bin(am, overfull_item_index, overfull_item_index, 1.0);
   }
 
   while (num_underfull_items) {
-    num_underfull_items--;
-    uint32_t underfull_item_index =
-        am->items[num_underfull_items].underfull_item_index;
-    am->items[underfull_item_index].probability = 1.0;
-    am->items[underfull_item_index].alias = underfull_item_index;
+    const uint32_t underfull_item_index =
+        underfull_item_indexes[--num_underfull_items];
+    alias_method_set_bin(am, underfull_item_index, underfull_item_index, 1.0);
   }
+  am->num_bins = am->num_items;
   return true;
 }
 
 // Returns true if there are a nonzero number of items and counts to sample from
 // and returns false otherwise.
-static inline bool alias_method_sample(AliasMethod *am, XoshiroPRNG *prng,
+//
+// A single 64 bit draw r picks both the bin and the coin flip: r / 2^64 scaled
+// by the number of bins has the bin as its integer part and a uniform
+// fraction, the low 64 bits of r * num_bins, as its fractional part.
+static inline bool alias_method_sample(const AliasMethod *am,
+                                       XoshiroPRNG *prng,
                                        Rack *rack_to_update) {
-  if (am->num_items == 0 || am->total_item_count == 0) {
+  if (am->num_bins == 0) {
     return false;
   }
-
-  const uint32_t bin = (uint32_t)prng_get_random_number(prng, am->num_items);
-  const double rand_between_0_and_1 =
-      (double)prng_get_random_number(prng, XOSHIRO_MAX) / (double)XOSHIRO_MAX;
-
-  uint32_t chosen_idx;
-  if (rand_between_0_and_1 < am->items[bin].probability) {
-    chosen_idx = bin;
-  } else {
-    chosen_idx = am->items[bin].alias;
-  }
-  rack_decode(&am->items[chosen_idx].rack, rack_to_update);
+  const uint64_t random_number = prng_next(prng);
+  const uint64_t num_bins = am->num_bins;
+  // The high 64 bits of the 128 bit product, computed in 64 bit arithmetic,
+  // which is exact since num_bins < 2^32.
+  const uint64_t high_product = (random_number >> 32) * num_bins;
+  const uint64_t low_product = (random_number & UINT32_MAX) * num_bins;
+  const uint32_t bin_index =
+      (uint32_t)((high_product + (low_product >> 32)) >> 32);
+  const uint64_t fraction = random_number * num_bins;
+  const AliasMethodBin *bin = &am->bins[bin_index];
+  rack_decode(fraction < bin->threshold ? &bin->rack : &bin->alias_rack,
+              rack_to_update);
   return true;
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -6,6 +6,7 @@
 #include "../def/letter_distribution_defs.h"
 #include "../def/rack_defs.h"
 #include "../def/static_eval_defs.h"
+#include "../util/fnv.h"
 #include "../util/io_util.h"
 #include "../util/string_util.h"
 #include "board_layout.h"
@@ -42,6 +43,9 @@ typedef struct Board {
   int tiles_played;
   // Start coordinates used to reset the board
   int start_coords[2];
+  // Hash of the start coordinates and bonus squares of the applied layout,
+  // which identifies the layout data computed for it ahead of time.
+  uint64_t layout_fingerprint;
   // Flag for lazy cross-set evaluation in endgame solver.
   // When false, cross-sets need to be recalculated before move generation.
   bool cross_sets_valid;
@@ -441,6 +445,10 @@ board_get_opening_move_penalties(const Board *board) {
   return board->opening_move_penalties;
 }
 
+static inline uint64_t board_get_layout_fingerprint(const Board *board) {
+  return board->layout_fingerprint;
+}
+
 // Board: Transposed
 
 static inline bool board_get_transposed(const Board *board) {
@@ -761,6 +769,18 @@ static inline void board_apply_layout(const BoardLayout *bl, Board *board) {
     }
   }
 
+  uint64_t layout_fingerprint = FNV_64_OFFSET_BASIS;
+  layout_fingerprint = fnv64a_step(layout_fingerprint, BOARD_DIM);
+  layout_fingerprint = fnv64a_step(layout_fingerprint, board->start_coords[0]);
+  layout_fingerprint = fnv64a_step(layout_fingerprint, board->start_coords[1]);
+  for (int row = 0; row < BOARD_DIM; row++) {
+    for (int col = 0; col < BOARD_DIM; col++) {
+      layout_fingerprint = fnv64a_step(
+          layout_fingerprint, board_layout_get_bonus_square(bl, row, col).raw);
+    }
+  }
+  board->layout_fingerprint = layout_fingerprint;
+
   memset(board->opening_move_penalties, 0,
          sizeof(board->opening_move_penalties));
 
@@ -138,7 +138,7 @@ void board_layout_load(BoardLayout *bl, const char *data_paths,
         fileproxy_get_string_from_filename(layout_filename, error_stack);
     if (error_stack_is_empty(error_stack)) {
       StringSplitter *layout_rows =
-          split_string_by_newline(file_contents, error_stack);
+          split_string_by_newline(file_contents, true);
       if (error_stack_is_empty(error_stack)) {
         board_layout_parse_split_file(bl, board_layout_name, layout_rows,
                                       error_stack);
@@ -150,6 +150,31 @@ void board_layout_load(BoardLayout *bl, const char *data_paths,
   free(layout_filename);
 }
 
+int board_layout_get_board_dim(const char *data_paths,
+                               const char *board_layout_name) {
+  ErrorStack *error_stack = error_stack_create();
+  int board_dim = 0;
+  char *layout_filename = data_filepaths_get_readable_filename(
+      data_paths, board_layout_name, DATA_FILEPATH_TYPE_LAYOUT, error_stack);
+  if (error_stack_is_empty(error_stack)) {
+    char *file_contents =
+        fileproxy_get_string_from_filename(layout_filename, error_stack);
+    if (error_stack_is_empty(error_stack)) {
+      StringSplitter *layout_rows =
+          split_string_by_newline(file_contents, true);
+      if (error_stack_is_empty(error_stack)) {
+        // The first row holds the starting coordinates.
+        board_dim = string_splitter_get_number_of_items(layout_rows) - 1;
+      }
+      string_splitter_destroy(layout_rows);
+    }
+    free(file_contents);
+  }
+  free(layout_filename);
+  error_stack_destroy(error_stack);
+  return board_dim;
+}
+
 char *board_layout_get_default_name(void) {
   return get_formatted_string("standard%d", BOARD_DIM);
 }
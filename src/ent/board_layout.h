@@ -11,6 +11,10 @@ typedef struct BoardLayout BoardLayout;
 BoardLayout *board_layout_create(void);
 void board_layout_load(BoardLayout *bl, const char *data_paths,
                        const char *board_layout_name, ErrorStack *error_stack);
+// Returns the number of rows of the board in the named layout file, which
+// may differ from BOARD_DIM, or 0 if the file cannot be read.
+int board_layout_get_board_dim(const char *data_paths,
+                               const char *board_layout_name);
 char *board_layout_get_default_name(void);
 const char *board_layout_get_name(const BoardLayout *bl);
 bool board_layout_is_name_default(const char *board_layout_name);
@@ -0,0 +1,118 @@
+#include "cross_check_index.h"
+
+#include "../util/fnv.h"
+#include "../util/io_util.h"
+#include "kwg.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct CrossCheckIndexEntry {
+  const KWG *kwg;
+  uint32_t left_node_index;
+  uint32_t right_node_index;
+  uint64_t letter_set;
+  // Entries from an earlier generation are stale, which makes a reset O(1).
+  uint32_t generation;
+} CrossCheckIndexEntry;
+
+struct CrossCheckIndex {
+  CrossCheckIndexEntry *entries;
+  uint64_t mask;
+  uint32_t generation;
+  uint64_t hits;
+  uint64_t misses;
+};
+
+CrossCheckIndex *cross_check_index_create(int number_of_entries) {
+  uint64_t size = 1;
+  while (size < (uint64_t)number_of_entries) {
+    size <<= 1;
+  }
+  CrossCheckIndex *index = malloc_or_die(sizeof(CrossCheckIndex));
+  index->entries = NULL;
+  index->mask = size - 1;
+  index->generation = 1;
+  index->hits = 0;
+  index->misses = 0;
+  return index;
+}
+
+void cross_check_index_destroy(CrossCheckIndex *index) {
+  if (!index) {
+    return;
+  }
+  free(index->entries);
+  free(index);
+}
+
+void cross_check_index_reset(CrossCheckIndex *index) {
+  index->generation++;
+  if (index->generation == 0) {
+    if (index->entries) {
+      memset(index->entries, 0,
+             sizeof(CrossCheckIndexEntry) * (index->mask + 1));
+    }
+    index->generation = 1;
+  }
+  index->hits = 0;
+  index->misses = 0;
+}
+
+static inline uint64_t cross_check_hash(const KWG *kwg,
+                                        uint32_t left_node_index,
+                                        uint32_t right_node_index) {
+  uint64_t hash = FNV_64_OFFSET_BASIS;
+  hash = fnv64a_step(hash, (uintptr_t)kwg);
+  hash = fnv64a_step(hash, ((uint64_t)left_node_index << 32) |
+                               (uint64_t)right_node_index);
+  // FNV leaves the low bits weakly mixed; fold the high half in before
+  // masking.
+  return hash ^ (hash >> 32);
+}
+
+bool cross_check_index_lookup(CrossCheckIndex *index, const KWG *kwg,
+                              uint32_t left_node_index,
+                              uint32_t right_node_index, uint64_t *letter_set) {
+  if (index->entries) {
+    const CrossCheckIndexEntry *entry =
+        &index->entries[cross_check_hash(kwg, left_node_index,
+                                         right_node_index) &
+                        index->mask];
+    if (entry->generation == index->generation && entry->kwg == kwg &&
+        entry->left_node_index == left_node_index &&
+        entry->right_node_index == right_node_index) {
+      *letter_set = entry->letter_set;
+      index->hits++;
+      return true;
+    }
+  }
+  index->misses++;
+  return false;
+}
+
+void cross_check_index_insert(CrossCheckIndex *index, const KWG *kwg,
+                              uint32_t left_node_index,
+                              uint32_t right_node_index, uint64_t letter_set) {
+  if (!index->entries) {
+    index->entries =
+        calloc_or_die(index->mask + 1, sizeof(CrossCheckIndexEntry));
+  }
+  CrossCheckIndexEntry *entry =
+      &index->entries[cross_check_hash(kwg, left_node_index, right_node_index) &
+                      index->mask];
+  entry->kwg = kwg;
+  entry->left_node_index = left_node_index;
+  entry->right_node_index = right_node_index;
+  entry->letter_set = letter_set;
+  entry->generation = index->generation;
+}
+
+uint64_t cross_check_index_get_hits(const CrossCheckIndex *index) {
+  return index->hits;
+}
+
+uint64_t cross_check_index_get_misses(const CrossCheckIndex *index) {
+  return index->misses;
+}
@@ -0,0 +1,40 @@
+#ifndef CROSS_CHECK_INDEX_H
+#define CROSS_CHECK_INDEX_H
+
+#include "kwg.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Caches the cross-set letter masks of empty squares with tiles on both
+// sides. Such a square needs one KWG walk over the left fragment for every
+// letter that can follow the right fragment, which dominates cross-set
+// generation when the fragments are long.
+//
+// The mask only depends on the KWG and the nodes reached by walking the
+// reversed left and right fragments from the root: two fragments reaching the
+// same node have the same set of completions, so the node pair is an exact
+// key and the fragments themselves never need to be stored. Cross-scores
+// depend on blanks and are cheap to sum, so they are not cached.
+typedef struct CrossCheckIndex CrossCheckIndex;
+
+// number_of_entries is rounded up to a power of two. The entries are only
+// allocated on the first insert.
+CrossCheckIndex *cross_check_index_create(int number_of_entries);
+void cross_check_index_destroy(CrossCheckIndex *index);
+
+// Invalidates every entry. Required whenever a KWG the index has seen may be
+// freed, since entries are keyed on the KWG pointer.
+void cross_check_index_reset(CrossCheckIndex *index);
+
+// Returns true and sets letter_set if the node pair is in the index.
+bool cross_check_index_lookup(CrossCheckIndex *index, const KWG *kwg,
+                              uint32_t left_node_index,
+                              uint32_t right_node_index, uint64_t *letter_set);
+void cross_check_index_insert(CrossCheckIndex *index, const KWG *kwg,
+                              uint32_t left_node_index,
+                              uint32_t right_node_index, uint64_t letter_set);
+
+uint64_t cross_check_index_get_hits(const CrossCheckIndex *index);
+uint64_t cross_check_index_get_misses(const CrossCheckIndex *index);
+
+#endif
@@ -17,7 +17,8 @@ static const char *const filepath_type_names[] = {"kwg",
                                                   "lexicon",
                                                   "wordmap",
                                                   "rack info table",
-                                                  "packed dawg"};
+                                                  "packed dawg",
+                                                  "opening table"};
 
 void string_builder_add_directory_for_data_type(StringBuilder *sb,
                                                 const char *data_path,
@@ -30,6 +31,7 @@ void string_builder_add_directory_for_data_type(StringBuilder *sb,
   case DATA_FILEPATH_TYPE_LEAVES:
   case DATA_FILEPATH_TYPE_RACK_INFO_TABLE:
   case DATA_FILEPATH_TYPE_DAWG_PACKED:
+  case DATA_FILEPATH_TYPE_OPENING_TABLE:
     string_builder_add_formatted_string(sb, "%s/lexica/", data_path);
     break;
   case DATA_FILEPATH_TYPE_LAYOUT:
@@ -70,6 +72,9 @@ char *get_filepath(const char *data_path, const char *data_name,
   case DATA_FILEPATH_TYPE_DAWG_PACKED:
     file_ext = DAWG_PACKED_EXTENSION;
     break;
+  case DATA_FILEPATH_TYPE_OPENING_TABLE:
+    file_ext = OPENING_TABLE_EXTENSION;
+    break;
   case DATA_FILEPATH_TYPE_LAYOUT:
     file_ext = TXT_EXTENSION;
     break;
@@ -0,0 +1,76 @@
+#include "endgame_tablebase.h"
+
+#include "../util/io_util.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Each entry is a key word and a data word, with the key word XOR'd against
+// the data word so a torn read fails the key check. The data word packs the
+// value in bits 0-15 and the generation in bits 16-31. Generation 0 is never
+// current, so a zeroed table has no valid entries.
+enum {
+  TABLEBASE_GENERATION_SHIFT = 16,
+  TABLEBASE_MAX_GENERATION = 0xFFFF,
+};
+
+struct EndgameTablebase {
+  _Atomic uint64_t *table;
+  uint64_t size_mask;
+  uint32_t generation;
+};
+
+EndgameTablebase *endgame_tablebase_create(int size_power_of_2) {
+  EndgameTablebase *tablebase = malloc_or_die(sizeof(EndgameTablebase));
+  const uint64_t num_elems = (uint64_t)1 << size_power_of_2;
+  tablebase->table =
+      (_Atomic uint64_t *)calloc_or_die(num_elems * 2, sizeof(uint64_t));
+  tablebase->size_mask = num_elems - 1;
+  tablebase->generation = 0;
+  return tablebase;
+}
+
+void endgame_tablebase_destroy(EndgameTablebase *tablebase) {
+  if (!tablebase) {
+    return;
+  }
+  free(tablebase->table);
+  free(tablebase);
+}
+
+// Must not run concurrently with probes or stores.
+void endgame_tablebase_new_generation(EndgameTablebase *tablebase) {
+  if (tablebase->generation == TABLEBASE_MAX_GENERATION) {
+    memset(tablebase->table, 0,
+           sizeof(uint64_t) * 2 * (tablebase->size_mask + 1));
+    tablebase->generation = 0;
+  }
+  tablebase->generation++;
+}
+
+bool endgame_tablebase_probe(const EndgameTablebase *tablebase, uint64_t key,
+                             int16_t *value) {
+  const _Atomic uint64_t *slot =
+      &tablebase->table[(key & tablebase->size_mask) * 2];
+  const uint64_t xored_key =
+      atomic_load_explicit(&slot[0], memory_order_relaxed);
+  const uint64_t data = atomic_load_explicit(&slot[1], memory_order_relaxed);
+  if ((xored_key ^ data) != key ||
+      (data >> TABLEBASE_GENERATION_SHIFT) != tablebase->generation) {
+    return false;
+  }
+  *value = (int16_t)(uint16_t)data;
+  return true;
+}
+
+void endgame_tablebase_store(EndgameTablebase *tablebase, uint64_t key,
+                             int16_t value) {
+  _Atomic uint64_t *slot = &tablebase->table[(key & tablebase->size_mask) * 2];
+  const uint64_t data =
+      ((uint64_t)tablebase->generation << TABLEBASE_GENERATION_SHIFT) |
+      (uint16_t)value;
+  atomic_store_explicit(&slot[0], key ^ data, memory_order_relaxed);
+  atomic_store_explicit(&slot[1], data, memory_order_relaxed);
+}
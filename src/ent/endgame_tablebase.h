@@ -0,0 +1,29 @@
+#ifndef ENDGAME_TABLEBASE_H
+#define ENDGAME_TABLEBASE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// In-memory table of exact endgame values for positions where both racks are
+// small, keyed by the position's Zobrist hash (board, both racks, side to
+// move and scoreless turns). Values are the rest-of-game spread change for
+// the side to move, so they hold for any score. Entries are filled on demand
+// by the solver and shared between threads with the same lockless scheme as
+// the transposition table. The table has a fixed size and always replaces.
+//
+// Values depend on the word list the solver generates with, so each solve
+// starts a new generation, which invalidates every older entry without
+// clearing the table.
+typedef struct EndgameTablebase EndgameTablebase;
+
+EndgameTablebase *endgame_tablebase_create(int size_power_of_2);
+void endgame_tablebase_destroy(EndgameTablebase *tablebase);
+
+void endgame_tablebase_new_generation(EndgameTablebase *tablebase);
+
+bool endgame_tablebase_probe(const EndgameTablebase *tablebase, uint64_t key,
+                             int16_t *value);
+void endgame_tablebase_store(EndgameTablebase *tablebase, uint64_t key,
+                             int16_t value);
+
+#endif
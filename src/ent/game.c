@@ -1,5 +1,6 @@
 #include "game.h"
 
+#include "../compat/isa_dispatch.h"
 #include "../def/board_defs.h"
 #include "../def/cross_set_defs.h"
 #include "../def/game_defs.h"
@@ -10,6 +11,7 @@
 #include "../util/string_util.h"
 #include "bag.h"
 #include "board.h"
+#include "cross_check_index.h"
 #include "kwg.h"
 #include "kwg_alpha.h"
 #include "letter_distribution.h"
@@ -61,6 +63,9 @@ struct Game {
   // instead of the player's full KWG. Not owned by Game.
   const KWG *override_kwgs[2];
   dual_lexicon_mode_t dual_lexicon_mode;
+  // Not shared by duplicates and copies, which may outlive the KWGs it has
+  // seen.
+  CrossCheckIndex *cross_check_index;
   // Backups
   MinimalGameBackup *sim_game_backups[MAX_SEARCH_DEPTH];
   int backup_cursor;
@@ -223,12 +228,18 @@ void game_set_override_kwgs(Game *game, const KWG *kwg0, const KWG *kwg1,
   game->override_kwgs[0] = kwg0;
   game->override_kwgs[1] = kwg1;
   game->dual_lexicon_mode = mode;
+  cross_check_index_reset(game->cross_check_index);
 }
 
 void game_clear_override_kwgs(Game *game) {
   game->override_kwgs[0] = NULL;
   game->override_kwgs[1] = NULL;
   game->dual_lexicon_mode = DUAL_LEXICON_MODE_IGNORANT;
+  cross_check_index_reset(game->cross_check_index);
+}
+
+CrossCheckIndex *game_get_cross_check_index(const Game *game) {
+  return game->cross_check_index;
 }
 
 const KWG *game_get_effective_kwg(const Game *game, int player_index) {
@@ -343,11 +354,13 @@ static inline void game_gen_classic_cross_set(const Game *game, int row,
   uint64_t leftside_rightx_set = 0;
 
   const bool nonempty_to_left = left_col < col;
+  uint32_t left_lnode_index = 0;
   if (nonempty_to_left) {
     uint64_t leftside_leftx_set = 0;
     const uint32_t lnode_index =
         traverse_backwards(kwg, board, row, col - 1, kwg_root, false, 0);
     left_lpath_is_valid = lnode_index != 0;
+    left_lnode_index = lnode_index;
     score += traverse_backwards_for_score(board, ld, row, col - 1);
     if (left_lpath_is_valid) {
       kwg_get_letter_sets(kwg, lnode_index, &leftside_leftx_set);
@@ -401,7 +414,10 @@ static inline void game_gen_classic_cross_set(const Game *game, int row,
 
   if (nonempty_to_left && nonempty_to_right) {
     uint64_t letter_set = 0;
-    if (left_lpath_is_valid && right_lpath_is_valid) {
+    if (left_lpath_is_valid && right_lpath_is_valid &&
+        !cross_check_index_lookup(game->cross_check_index, kwg,
+                                  left_lnode_index, right_lnode_index,
+                                  &letter_set)) {
       for (uint32_t i = right_lnode_index;; i++) {
         const uint32_t node = kwg_node(kwg, i);
         const uint32_t ml = kwg_node_tile(node);
@@ -419,6 +435,8 @@ static inline void game_gen_classic_cross_set(const Game *game, int row,
           break;
         }
       }
+      cross_check_index_insert(game->cross_check_index, kwg, left_lnode_index,
+                               right_lnode_index, letter_set);
     }
     board_set_cross_set_with_blank(board, row, col, dir, cross_set_index,
                                    letter_set);
@@ -432,8 +450,8 @@ static inline void game_gen_classic_cross_set(const Game *game, int row,
   board_set_cross_score(board, row, col, dir, cross_set_index, score);
 }
 
-void game_gen_cross_set(const Game *game, int row, int col, int dir,
-                        int cross_set_index) {
+ISA_DISPATCH void game_gen_cross_set(const Game *game, int row, int col,
+                                     int dir, int cross_set_index) {
   if (game_get_variant(game) == GAME_VARIANT_CLASSIC) {
     game_gen_classic_cross_set(game, row, col, dir, cross_set_index);
   } else {
@@ -441,7 +459,7 @@ void game_gen_cross_set(const Game *game, int row, int col, int dir,
   }
 }
 
-void game_gen_all_cross_sets(const Game *game) {
+ISA_DISPATCH void game_gen_all_cross_sets(const Game *game) {
   Board *board = game_get_board(game);
   bool kwgs_are_shared = game_get_data_is_shared(game, PLAYERS_DATA_TYPE_KWG);
 
@@ -536,6 +554,7 @@ void game_update(Game *game, const GameArgs *game_args) {
   board_apply_layout(game_args->board_layout, game->board);
 
   game->variant = game_args->game_variant;
+  cross_check_index_reset(game->cross_check_index);
 }
 
 Game *game_create(const GameArgs *game_args) {
@@ -562,6 +581,8 @@ Game *game_create(const GameArgs *game_args) {
   game->override_kwgs[0] = NULL;
   game->override_kwgs[1] = NULL;
   game->dual_lexicon_mode = DUAL_LEXICON_MODE_IGNORANT;
+  game->cross_check_index =
+      cross_check_index_create(GAME_CROSS_CHECK_INDEX_ENTRIES);
 
   for (int i = 0; i < MAX_SEARCH_DEPTH; i++) {
     game->sim_game_backups[i] = NULL;
@@ -596,6 +617,8 @@ Game *game_duplicate(const Game *game) {
   new_game->override_kwgs[0] = game->override_kwgs[0];
   new_game->override_kwgs[1] = game->override_kwgs[1];
   new_game->dual_lexicon_mode = game->dual_lexicon_mode;
+  new_game->cross_check_index =
+      cross_check_index_create(GAME_CROSS_CHECK_INDEX_ENTRIES);
 
   // note: game backups must be explicitly handled by the caller if they want
   // game copies to have backups.
@@ -629,6 +652,7 @@ void game_copy(Game *dst, const Game *src) {
   dst->override_kwgs[0] = src->override_kwgs[0];
   dst->override_kwgs[1] = src->override_kwgs[1];
   dst->dual_lexicon_mode = src->dual_lexicon_mode;
+  cross_check_index_reset(dst->cross_check_index);
   dst->backup_cursor = 0;
   dst->backup_mode = BACKUP_MODE_OFF;
 }
@@ -725,6 +749,7 @@ void game_destroy(Game *game) {
   player_destroy(game->players[0]);
   player_destroy(game->players[1]);
   backups_destroy(game);
+  cross_check_index_destroy(game->cross_check_index);
   free(game);
 }
 
@@ -5,6 +5,7 @@
 #include "../def/players_data_defs.h"
 #include "bag.h"
 #include "board.h"
+#include "cross_check_index.h"
 #include "kwg.h"
 #include "letter_distribution.h"
 #include "player.h"
@@ -75,4 +76,8 @@ void game_clear_override_kwgs(Game *game);
 // any override KWGs. Falls back to the player's own KWG if no override is set.
 const KWG *game_get_effective_kwg(const Game *game, int player_index);
 
+// The index of two-sided cross-set masks used by cross-set generation. It is
+// reset whenever the KWGs used for cross-sets may change.
+CrossCheckIndex *game_get_cross_check_index(const Game *game);
+
 #endif
\ No newline at end of file
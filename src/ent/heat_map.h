@@ -84,6 +84,20 @@ static inline void heat_map_add_move(HeatMap *hm, const Move *move) {
   }
 }
 
+// Adds the counts of other to hm.
+static inline void heat_map_add_heat_map(HeatMap *hm, const HeatMap *other) {
+  for (size_t i = 0; i < NUM_HEAT_MAP_COUNTS; i++) {
+    if (other->counts[i] == 0) {
+      continue;
+    }
+    hm->counts[i] += other->counts[i];
+    const heat_map_t type = (heat_map_t)(i % NUM_HEAT_MAP_TYPES);
+    if (hm->counts[i] > hm->board_count_maxes[type]) {
+      hm->board_count_maxes[type] = hm->counts[i];
+    }
+  }
+}
+
 static inline uint64_t heat_map_get_total_count(const HeatMap *hm) {
   uint64_t sum = 0;
   for (size_t i = 0; i < NUM_HEAT_MAP_COUNTS; i++) {
@@ -0,0 +1,176 @@
+#include "lane_move_cache.h"
+
+#include "../def/board_defs.h"
+#include "../util/fnv.h"
+#include "../util/io_util.h"
+#include "board.h"
+#include "kwg.h"
+#include "move.h"
+#include "rack.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct LaneMoveCacheEntry {
+  uint64_t hash;
+  const KWG *kwg;
+  int lane_index;
+  bool valid;
+  Rack rack;
+  Square lane[BOARD_DIM];
+  int count;
+  int capacity;
+  SmallMove *moves;
+} LaneMoveCacheEntry;
+
+struct LaneMoveCache {
+  LaneMoveCacheEntry *entries;
+  uint64_t mask;
+  LaneMoveCacheEntry *pending_entry;
+  uint64_t hits;
+  uint64_t misses;
+};
+
+LaneMoveCache *lane_move_cache_create(int number_of_entries) {
+  uint64_t size = 1;
+  while (size < (uint64_t)number_of_entries) {
+    size <<= 1;
+  }
+  LaneMoveCache *cache = malloc_or_die(sizeof(LaneMoveCache));
+  cache->entries = calloc_or_die(size, sizeof(LaneMoveCacheEntry));
+  cache->mask = size - 1;
+  cache->pending_entry = NULL;
+  cache->hits = 0;
+  cache->misses = 0;
+  return cache;
+}
+
+void lane_move_cache_destroy(LaneMoveCache *cache) {
+  if (!cache) {
+    return;
+  }
+  for (uint64_t i = 0; i <= cache->mask; i++) {
+    free(cache->entries[i].moves);
+  }
+  free(cache->entries);
+  free(cache);
+}
+
+void lane_move_cache_reset(LaneMoveCache *cache) {
+  for (uint64_t i = 0; i <= cache->mask; i++) {
+    cache->entries[i].valid = false;
+  }
+  cache->pending_entry = NULL;
+  cache->hits = 0;
+  cache->misses = 0;
+}
+
+// Squares are compared and hashed field by field so struct padding never
+// takes part in the key.
+static inline bool lane_squares_equal(const Square *a, const Square *b) {
+  for (int col = 0; col < BOARD_DIM; col++) {
+    if (a[col].cross_set != b[col].cross_set ||
+        a[col].left_extension_set != b[col].left_extension_set ||
+        a[col].right_extension_set != b[col].right_extension_set ||
+        a[col].cross_score != b[col].cross_score ||
+        a[col].letter != b[col].letter ||
+        a[col].bonus_square.raw != b[col].bonus_square.raw ||
+        a[col].anchor != b[col].anchor ||
+        a[col].is_cross_word != b[col].is_cross_word) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static inline bool lane_racks_equal(const Rack *a, const Rack *b) {
+  if (rack_get_dist_size(a) != rack_get_dist_size(b)) {
+    return false;
+  }
+  for (int ml = 0; ml < rack_get_dist_size(a); ml++) {
+    if (rack_get_letter(a, ml) != rack_get_letter(b, ml)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static inline uint64_t lane_hash(const KWG *kwg, const Rack *rack,
+                                 const Square *lane, int lane_index) {
+  uint64_t hash = FNV_64_OFFSET_BASIS;
+  hash = fnv64a_step(hash, (uintptr_t)kwg);
+  hash = fnv64a_step(hash, (uint64_t)lane_index);
+  for (int ml = 0; ml < rack_get_dist_size(rack); ml++) {
+    hash = fnv64a_step(hash, rack_get_letter(rack, ml));
+  }
+  for (int col = 0; col < BOARD_DIM; col++) {
+    const Square *sq = &lane[col];
+    hash = fnv64a_step(hash, sq->cross_set);
+    hash = fnv64a_step(hash, sq->left_extension_set);
+    hash = fnv64a_step(hash, sq->right_extension_set);
+    hash = fnv64a_step(hash, ((uint64_t)(uint32_t)sq->cross_score << 32) |
+                                 ((uint64_t)sq->letter << 24) |
+                                 ((uint64_t)sq->bonus_square.raw << 16) |
+                                 ((uint64_t)sq->anchor << 8) |
+                                 (uint64_t)sq->is_cross_word);
+  }
+  // FNV leaves the low bits weakly mixed; fold the high half in before
+  // masking.
+  return hash ^ (hash >> 32);
+}
+
+bool lane_move_cache_load(LaneMoveCache *cache, const KWG *kwg,
+                          const Rack *rack, const Square *lane, int lane_index,
+                          MoveList *move_list) {
+  const uint64_t hash = lane_hash(kwg, rack, lane, lane_index);
+  LaneMoveCacheEntry *entry = &cache->entries[hash & cache->mask];
+  if (entry->valid && entry->hash == hash && entry->kwg == kwg &&
+      entry->lane_index == lane_index && lane_racks_equal(&entry->rack, rack) &&
+      lane_squares_equal(entry->lane, lane)) {
+    for (int i = 0; i < entry->count; i++) {
+      *move_list->spare_small_move = entry->moves[i];
+      move_list_insert_spare_small_move(move_list);
+    }
+    cache->pending_entry = NULL;
+    cache->hits++;
+    return true;
+  }
+  entry->valid = false;
+  entry->hash = hash;
+  entry->kwg = kwg;
+  entry->lane_index = lane_index;
+  rack_copy(&entry->rack, rack);
+  memcpy(entry->lane, lane, sizeof(entry->lane));
+  cache->pending_entry = entry;
+  cache->misses++;
+  return false;
+}
+
+void lane_move_cache_store(LaneMoveCache *cache, const MoveList *move_list,
+                           int first_move_index) {
+  LaneMoveCacheEntry *entry = cache->pending_entry;
+  if (entry == NULL) {
+    log_fatal("lane move cache store without a pending miss");
+  }
+  const int count = move_list->count - first_move_index;
+  if (count > entry->capacity) {
+    free(entry->moves);
+    entry->capacity = count;
+    entry->moves = malloc_or_die(sizeof(SmallMove) * (size_t)count);
+  }
+  for (int i = 0; i < count; i++) {
+    entry->moves[i] = *move_list->small_moves[first_move_index + i];
+  }
+  entry->count = count;
+  entry->valid = true;
+  cache->pending_entry = NULL;
+}
+
+uint64_t lane_move_cache_get_hits(const LaneMoveCache *cache) {
+  return cache->hits;
+}
+
+uint64_t lane_move_cache_get_misses(const LaneMoveCache *cache) {
+  return cache->misses;
+}
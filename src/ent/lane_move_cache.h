@@ -0,0 +1,42 @@
+#ifndef LANE_MOVE_CACHE_H
+#define LANE_MOVE_CACHE_H
+
+#include "board.h"
+#include "kwg.h"
+#include "move.h"
+#include "rack.h"
+#include <stdint.h>
+
+// Caches the small moves generated in one board lane (a row in one
+// direction). Everything generation reads for a lane lives in the lane's
+// squares (letters, cross-sets, cross-scores, extension sets, anchors and
+// bonuses) plus the rack and the KWG, so those form the key. A play only
+// changes the lanes whose squares or cross-sets it touched, so every other
+// lane hits on the next generation for the same rack, and an unplay brings
+// the old lanes and their entries back without any bookkeeping.
+typedef struct LaneMoveCache LaneMoveCache;
+
+// number_of_entries is rounded up to a power of two.
+LaneMoveCache *lane_move_cache_create(int number_of_entries);
+void lane_move_cache_destroy(LaneMoveCache *cache);
+
+// Invalidates every entry. Required whenever a KWG the cache has seen may be
+// freed, since entries are keyed on the KWG pointer.
+void lane_move_cache_reset(LaneMoveCache *cache);
+
+// On a hit, appends the cached moves to move_list and returns true. On a
+// miss, claims the lane's slot and returns false; the caller generates the
+// lane and then calls lane_move_cache_store.
+bool lane_move_cache_load(LaneMoveCache *cache, const KWG *kwg,
+                          const Rack *rack, const Square *lane, int lane_index,
+                          MoveList *move_list);
+
+// Fills the slot claimed by the last missing lane_move_cache_load with
+// move_list's moves from first_move_index onward.
+void lane_move_cache_store(LaneMoveCache *cache, const MoveList *move_list,
+                           int first_move_index);
+
+uint64_t lane_move_cache_get_hits(const LaneMoveCache *cache);
+uint64_t lane_move_cache_get_misses(const LaneMoveCache *cache);
+
+#endif
@@ -0,0 +1,434 @@
+#include "opening_table.h"
+
+#include "../compat/endian_conv.h"
+#include "../def/board_defs.h"
+#include "../def/equity_defs.h"
+#include "../def/game_history_defs.h"
+#include "../def/rack_defs.h"
+#include "../util/fileproxy.h"
+#include "../util/io_util.h"
+#include "../util/string_util.h"
+#include "bit_rack.h"
+#include "data_filepaths.h"
+#include "equity.h"
+#include "move.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+  OPENING_TABLE_MIN_BUCKETS = 16,
+  OPENING_TABLE_BIT_RACK_BYTES = 16,
+  OPENING_TABLE_MOVE_BYTES = 13 + RACK_SIZE,
+};
+
+typedef struct OpeningTableMove {
+  Equity score;
+  Equity equity;
+  uint8_t move_type;
+  uint8_t row_start;
+  uint8_t col_start;
+  uint8_t dir;
+  uint8_t tiles_length;
+  MachineLetter tiles[RACK_SIZE];
+} OpeningTableMove;
+
+struct OpeningTable {
+  char *name;
+  char *lexicon_name;
+  char *ld_name;
+  uint64_t layout_fingerprint;
+  int bingo_bonus;
+  int number_of_moves;
+  uint32_t num_buckets;
+  uint32_t num_entries;
+  uint32_t *bucket_starts;
+  BitRack *bit_racks;
+  // number_of_moves moves for each entry, in entry order
+  OpeningTableMove *moves;
+};
+
+static OpeningTable *opening_table_alloc(void) {
+  return calloc_or_die(1, sizeof(OpeningTable));
+}
+
+void opening_table_destroy(OpeningTable *table) {
+  if (!table) {
+    return;
+  }
+  free(table->name);
+  free(table->lexicon_name);
+  free(table->ld_name);
+  free(table->bucket_starts);
+  free(table->bit_racks);
+  free(table->moves);
+  free(table);
+}
+
+static void opening_table_move_set_as_pass(OpeningTableMove *table_move) {
+  memset(table_move, 0, sizeof(OpeningTableMove));
+  table_move->move_type = GAME_EVENT_PASS;
+  table_move->equity = EQUITY_PASS_VALUE;
+}
+
+OpeningTable *opening_table_create_empty(const BitRack *bit_racks,
+                                         int number_of_racks,
+                                         int number_of_moves,
+                                         const char *lexicon_name,
+                                         const char *ld_name,
+                                         uint64_t layout_fingerprint,
+                                         int bingo_bonus) {
+  OpeningTable *table = opening_table_alloc();
+  table->lexicon_name = string_duplicate(lexicon_name);
+  table->ld_name = string_duplicate(ld_name);
+  table->layout_fingerprint = layout_fingerprint;
+  table->bingo_bonus = bingo_bonus;
+  table->number_of_moves = number_of_moves;
+  table->num_entries = (uint32_t)number_of_racks;
+  table->num_buckets = OPENING_TABLE_MIN_BUCKETS;
+  while (table->num_buckets < table->num_entries) {
+    table->num_buckets <<= 1;
+  }
+
+  // Count the racks of each bucket and lay the buckets out one after another
+  table->bucket_starts =
+      calloc_or_die((size_t)table->num_buckets + 1, sizeof(uint32_t));
+  for (int rack_index = 0; rack_index < number_of_racks; rack_index++) {
+    const uint32_t bucket =
+        bit_rack_get_bucket_index(&bit_racks[rack_index], table->num_buckets);
+    table->bucket_starts[bucket + 1]++;
+  }
+  for (uint32_t bucket = 0; bucket < table->num_buckets; bucket++) {
+    table->bucket_starts[bucket + 1] += table->bucket_starts[bucket];
+  }
+  uint32_t *bucket_fill = calloc_or_die(table->num_buckets, sizeof(uint32_t));
+  table->bit_racks =
+      malloc_or_die((size_t)table->num_entries * sizeof(BitRack));
+  for (int rack_index = 0; rack_index < number_of_racks; rack_index++) {
+    const uint32_t bucket =
+        bit_rack_get_bucket_index(&bit_racks[rack_index], table->num_buckets);
+    table->bit_racks[table->bucket_starts[bucket] + bucket_fill[bucket]++] =
+        bit_racks[rack_index];
+  }
+  free(bucket_fill);
+
+  const size_t number_of_table_moves =
+      (size_t)table->num_entries * (size_t)number_of_moves;
+  table->moves =
+      malloc_or_die(number_of_table_moves * sizeof(OpeningTableMove));
+  for (size_t i = 0; i < number_of_table_moves; i++) {
+    opening_table_move_set_as_pass(&table->moves[i]);
+  }
+  return table;
+}
+
+const char *opening_table_get_name(const OpeningTable *table) {
+  return table->name;
+}
+
+const char *opening_table_get_lexicon_name(const OpeningTable *table) {
+  return table->lexicon_name;
+}
+
+const char *opening_table_get_ld_name(const OpeningTable *table) {
+  return table->ld_name;
+}
+
+uint64_t opening_table_get_layout_fingerprint(const OpeningTable *table) {
+  return table->layout_fingerprint;
+}
+
+int opening_table_get_bingo_bonus(const OpeningTable *table) {
+  return table->bingo_bonus;
+}
+
+int opening_table_get_number_of_moves(const OpeningTable *table) {
+  return table->number_of_moves;
+}
+
+int opening_table_get_number_of_entries(const OpeningTable *table) {
+  return (int)table->num_entries;
+}
+
+BitRack opening_table_get_bit_rack(const OpeningTable *table, int entry_index) {
+  return table->bit_racks[entry_index];
+}
+
+int opening_table_lookup(const OpeningTable *table, const BitRack *bit_rack) {
+  const uint32_t bucket =
+      bit_rack_get_bucket_index(bit_rack, table->num_buckets);
+  const uint32_t end = table->bucket_starts[bucket + 1];
+  for (uint32_t entry_index = table->bucket_starts[bucket]; entry_index < end;
+       entry_index++) {
+    if (bit_rack_equals(&table->bit_racks[entry_index], bit_rack)) {
+      return (int)entry_index;
+    }
+  }
+  return -1;
+}
+
+static const OpeningTableMove *
+opening_table_get_table_move(const OpeningTable *table, int entry_index,
+                             int move_index) {
+  return &table->moves[(size_t)entry_index * table->number_of_moves +
+                       move_index];
+}
+
+void opening_table_get_move(const OpeningTable *table, int entry_index,
+                            int move_index, Move *move) {
+  const OpeningTableMove *table_move =
+      opening_table_get_table_move(table, entry_index, move_index);
+  move_set_type(move, (game_event_t)table_move->move_type);
+  move_set_score(move, table_move->score);
+  move_set_equity(move, table_move->equity);
+  move_set_row_start(move, table_move->row_start);
+  move_set_col_start(move, table_move->col_start);
+  move_set_dir(move, table_move->dir);
+  // Nothing is played through on the empty board.
+  move_set_tiles_length(move, table_move->tiles_length);
+  move_set_tiles_played(move, table_move->tiles_length);
+  for (int i = 0; i < table_move->tiles_length; i++) {
+    move_set_tile(move, table_move->tiles[i], i);
+  }
+}
+
+void opening_table_set_move(OpeningTable *table, int entry_index,
+                            int move_index, const Move *move) {
+  OpeningTableMove *table_move =
+      (OpeningTableMove *)opening_table_get_table_move(table, entry_index,
+                                                       move_index);
+  opening_table_move_set_as_pass(table_move);
+  table_move->move_type = (uint8_t)move_get_type(move);
+  table_move->score = move_get_score(move);
+  table_move->equity = move_get_equity(move);
+  if (table_move->move_type == GAME_EVENT_PASS) {
+    return;
+  }
+  table_move->row_start = (uint8_t)move_get_row_start(move);
+  table_move->col_start = (uint8_t)move_get_col_start(move);
+  table_move->dir = (uint8_t)move_get_dir(move);
+  table_move->tiles_length = (uint8_t)move_get_tiles_length(move);
+  for (int i = 0; i < table_move->tiles_length; i++) {
+    table_move->tiles[i] = move_get_tile(move, i);
+  }
+}
+
+// File I/O
+
+static void opening_table_write_uint32(uint32_t value, FILE *stream,
+                                       const char *description) {
+  const uint32_t le = htole32(value);
+  fwrite_or_die(&le, sizeof(le), 1, stream, description);
+}
+
+static void opening_table_write_string(const char *string, FILE *stream,
+                                       const char *description) {
+  const uint8_t length = (uint8_t)string_length(string);
+  fwrite_or_die(&length, sizeof(length), 1, stream, description);
+  fwrite_or_die(string, sizeof(char), length, stream, description);
+}
+
+// BitRacks of full racks do not fit in 12 bytes for distributions with more
+// than 24 letters, so they are written in full as two little-endian halves.
+static void opening_table_write_bit_rack(const BitRack *bit_rack,
+                                         FILE *stream) {
+  const uint64_t halves[2] = {htole64(bit_rack_get_low_64(bit_rack)),
+                              htole64(bit_rack_get_high_64(bit_rack))};
+  fwrite_or_die(halves, sizeof(uint64_t), 2, stream,
+                "opening table bit racks");
+}
+
+static void opening_table_write_move(const OpeningTableMove *table_move,
+                                     FILE *stream) {
+  uint8_t bytes[OPENING_TABLE_MOVE_BYTES];
+  const uint32_t score = htole32((uint32_t)table_move->score);
+  const uint32_t equity = htole32((uint32_t)table_move->equity);
+  memcpy(bytes, &score, 4);
+  memcpy(bytes + 4, &equity, 4);
+  bytes[8] = table_move->move_type;
+  bytes[9] = table_move->row_start;
+  bytes[10] = table_move->col_start;
+  bytes[11] = table_move->dir;
+  bytes[12] = table_move->tiles_length;
+  memcpy(bytes + 13, table_move->tiles, RACK_SIZE);
+  fwrite_or_die(bytes, sizeof(uint8_t), OPENING_TABLE_MOVE_BYTES, stream,
+                "opening table move");
+}
+
+void opening_table_write(const OpeningTable *table, const char *data_paths,
+                         const char *name, ErrorStack *error_stack) {
+  char *filename = data_filepaths_get_writable_filename(
+      data_paths, name, DATA_FILEPATH_TYPE_OPENING_TABLE, error_stack);
+  if (!error_stack_is_empty(error_stack)) {
+    return;
+  }
+  FILE *stream = fopen_safe(filename, "wb", error_stack);
+  free(filename);
+  if (!error_stack_is_empty(error_stack)) {
+    return;
+  }
+  const uint8_t header[4] = {OPENING_TABLE_VERSION, RACK_SIZE, BOARD_DIM,
+                             (uint8_t)table->number_of_moves};
+  fwrite_or_die(header, sizeof(uint8_t), 4, stream, "opening table header");
+  opening_table_write_uint32((uint32_t)table->bingo_bonus, stream,
+                             "opening table bingo bonus");
+  const uint64_t layout_fingerprint = htole64(table->layout_fingerprint);
+  fwrite_or_die(&layout_fingerprint, sizeof(layout_fingerprint), 1, stream,
+                "opening table layout fingerprint");
+  opening_table_write_string(table->lexicon_name, stream,
+                             "opening table lexicon name");
+  opening_table_write_string(table->ld_name, stream, "opening table ld name");
+  opening_table_write_uint32(table->num_buckets, stream,
+                             "opening table num buckets");
+  opening_table_write_uint32(table->num_entries, stream,
+                             "opening table num entries");
+  for (uint32_t i = 0; i <= table->num_buckets; i++) {
+    opening_table_write_uint32(table->bucket_starts[i], stream,
+                               "opening table bucket starts");
+  }
+  for (uint32_t i = 0; i < table->num_entries; i++) {
+    opening_table_write_bit_rack(&table->bit_racks[i], stream);
+  }
+  const size_t number_of_table_moves =
+      (size_t)table->num_entries * (size_t)table->number_of_moves;
+  for (size_t i = 0; i < number_of_table_moves; i++) {
+    opening_table_write_move(&table->moves[i], stream);
+  }
+  fclose_or_die(stream);
+}
+
+static void opening_table_read_or_die(void *ptr, size_t size, size_t nmemb,
+                                      FILE *stream, const char *description) {
+  if (fread(ptr, size, nmemb, stream) != nmemb) {
+    log_fatal("could not read %s from opening table stream", description);
+  }
+}
+
+static uint32_t opening_table_read_uint32(FILE *stream,
+                                          const char *description) {
+  uint32_t value;
+  opening_table_read_or_die(&value, sizeof(value), 1, stream, description);
+  return le32toh(value);
+}
+
+static char *opening_table_read_string(FILE *stream, const char *description) {
+  uint8_t length;
+  opening_table_read_or_die(&length, sizeof(length), 1, stream, description);
+  char *string = malloc_or_die((size_t)length + 1);
+  opening_table_read_or_die(string, sizeof(char), length, stream, description);
+  string[length] = '\0';
+  return string;
+}
+
+static BitRack opening_table_read_bit_rack(FILE *stream) {
+  uint8_t bytes[OPENING_TABLE_BIT_RACK_BYTES];
+  opening_table_read_or_die(bytes, sizeof(uint8_t),
+                            OPENING_TABLE_BIT_RACK_BYTES, stream, "bit racks");
+#if IS_LITTLE_ENDIAN
+  BitRack bit_rack;
+  memcpy(&bit_rack, bytes, OPENING_TABLE_BIT_RACK_BYTES);
+  return bit_rack;
+#else
+  uint64_t low, high;
+  memcpy(&low, bytes, 8);
+  memcpy(&high, bytes + 8, 8);
+  return (BitRack){.low = le64toh(low), .high = le64toh(high)};
+#endif
+}
+
+static void opening_table_read_move(OpeningTableMove *table_move,
+                                    FILE *stream) {
+  uint8_t bytes[OPENING_TABLE_MOVE_BYTES];
+  opening_table_read_or_die(bytes, sizeof(uint8_t), OPENING_TABLE_MOVE_BYTES,
+                            stream, "move");
+  uint32_t score;
+  uint32_t equity;
+  memcpy(&score, bytes, 4);
+  memcpy(&equity, bytes + 4, 4);
+  table_move->score = (Equity)le32toh(score);
+  table_move->equity = (Equity)le32toh(equity);
+  table_move->move_type = bytes[8];
+  table_move->row_start = bytes[9];
+  table_move->col_start = bytes[10];
+  table_move->dir = bytes[11];
+  table_move->tiles_length = bytes[12];
+  memcpy(table_move->tiles, bytes + 13, RACK_SIZE);
+}
+
+static void opening_table_load_from_stream(OpeningTable *table, FILE *stream,
+                                           const char *filename,
+                                           ErrorStack *error_stack) {
+  uint8_t header[4];
+  opening_table_read_or_die(header, sizeof(uint8_t), 4, stream, "header");
+  if (header[0] != OPENING_TABLE_VERSION) {
+    error_stack_push(
+        error_stack, ERROR_STATUS_OPENING_TABLE_UNSUPPORTED_VERSION,
+        get_formatted_string(
+            "detected opening table version %d but only %d is supported: %s",
+            header[0], OPENING_TABLE_VERSION, filename));
+    return;
+  }
+  if (header[1] != RACK_SIZE || header[2] != BOARD_DIM) {
+    error_stack_push(
+        error_stack, ERROR_STATUS_OPENING_TABLE_INCOMPATIBLE_DATA,
+        get_formatted_string("opening table rack size %d and board dimension "
+                             "%d do not match build rack size %d and board "
+                             "dimension %d: %s",
+                             header[1], header[2], RACK_SIZE, BOARD_DIM,
+                             filename));
+    return;
+  }
+  table->number_of_moves = header[3];
+  table->bingo_bonus =
+      (int)(int32_t)opening_table_read_uint32(stream, "bingo bonus");
+  uint64_t layout_fingerprint;
+  opening_table_read_or_die(&layout_fingerprint, sizeof(layout_fingerprint), 1,
+                            stream, "layout fingerprint");
+  table->layout_fingerprint = le64toh(layout_fingerprint);
+  table->lexicon_name = opening_table_read_string(stream, "lexicon name");
+  table->ld_name = opening_table_read_string(stream, "ld name");
+  table->num_buckets = opening_table_read_uint32(stream, "num buckets");
+  table->num_entries = opening_table_read_uint32(stream, "num entries");
+  table->bucket_starts =
+      malloc_or_die(((size_t)table->num_buckets + 1) * sizeof(uint32_t));
+  for (uint32_t i = 0; i <= table->num_buckets; i++) {
+    table->bucket_starts[i] = opening_table_read_uint32(stream, "buckets");
+  }
+  table->bit_racks =
+      malloc_or_die((size_t)table->num_entries * sizeof(BitRack));
+  for (uint32_t i = 0; i < table->num_entries; i++) {
+    table->bit_racks[i] = opening_table_read_bit_rack(stream);
+  }
+  const size_t number_of_table_moves =
+      (size_t)table->num_entries * (size_t)table->number_of_moves;
+  table->moves =
+      malloc_or_die(number_of_table_moves * sizeof(OpeningTableMove));
+  for (size_t i = 0; i < number_of_table_moves; i++) {
+    opening_table_read_move(&table->moves[i], stream);
+  }
+}
+
+OpeningTable *opening_table_create(const char *data_paths, const char *name,
+                                   ErrorStack *error_stack) {
+  char *filename = data_filepaths_get_readable_filename(
+      data_paths, name, DATA_FILEPATH_TYPE_OPENING_TABLE, error_stack);
+  if (!error_stack_is_empty(error_stack)) {
+    return NULL;
+  }
+  FILE *stream = stream_from_filename(filename, error_stack);
+  if (!error_stack_is_empty(error_stack)) {
+    free(filename);
+    return NULL;
+  }
+  OpeningTable *table = opening_table_alloc();
+  opening_table_load_from_stream(table, stream, filename, error_stack);
+  fclose_or_die(stream);
+  free(filename);
+  if (!error_stack_is_empty(error_stack)) {
+    opening_table_destroy(table);
+    return NULL;
+  }
+  table->name = string_duplicate(name);
+  return table;
+}
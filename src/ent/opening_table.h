@@ -0,0 +1,76 @@
+#ifndef OPENING_TABLE_H
+#define OPENING_TABLE_H
+
+#include "../util/io_util.h"
+#include "bit_rack.h"
+#include "move.h"
+#include <stdint.h>
+
+// An OpeningTable maps full-rack BitRacks to the top equity moves of that
+// rack on the empty board, computed ahead of time by make_opening_table.
+// The moves of a rack only depend on the lexicon, the leaves, the letter
+// distribution, the board layout and the bingo bonus. The leaves are
+// identified by the table name, which is the name of the KLV it was built
+// with, and the other inputs are recorded in the table so that a table is
+// never used for a game it was not built for.
+//
+// Each entry stores the same number of moves, sorted by equity with the move
+// that generate_moves returns for MOVE_RECORD_BEST first. Entries of racks
+// with fewer moves are padded with passes.
+//
+// On-disk layout (all integers little-endian):
+//   1 byte:  version (OPENING_TABLE_VERSION)
+//   1 byte:  rack_size (matches RACK_SIZE)
+//   1 byte:  board_dim (matches BOARD_DIM)
+//   1 byte:  number_of_moves per entry
+//   4 bytes: bingo_bonus
+//   8 bytes: layout_fingerprint
+//   1 byte + n bytes: length and characters of the lexicon name
+//   1 byte + n bytes: length and characters of the letter distribution name
+//   4 bytes: num_buckets
+//   4 bytes: num_entries
+//   (num_buckets + 1) * 4 bytes: bucket_starts
+//   num_entries * 16 bytes: BitRacks of the entries
+//   num_entries * number_of_moves * OPENING_TABLE_MOVE_BYTES bytes: moves,
+//     each 4 bytes of score, 4 bytes of equity, 1 byte each of move type,
+//     row, column, direction and tiles length and RACK_SIZE bytes of tiles
+typedef struct OpeningTable OpeningTable;
+
+enum {
+  OPENING_TABLE_VERSION = 1,
+  // The number of moves per entry is stored in a single byte.
+  OPENING_TABLE_MAX_NUMBER_OF_MOVES = 255,
+};
+
+OpeningTable *opening_table_create(const char *data_paths, const char *name,
+                                   ErrorStack *error_stack);
+// Creates a table with an entry for each of the given racks whose moves are
+// all passes, to be filled in with opening_table_set_move.
+OpeningTable *opening_table_create_empty(const BitRack *bit_racks,
+                                         int number_of_racks,
+                                         int number_of_moves,
+                                         const char *lexicon_name,
+                                         const char *ld_name,
+                                         uint64_t layout_fingerprint,
+                                         int bingo_bonus);
+void opening_table_destroy(OpeningTable *table);
+void opening_table_write(const OpeningTable *table, const char *data_paths,
+                         const char *name, ErrorStack *error_stack);
+
+const char *opening_table_get_name(const OpeningTable *table);
+const char *opening_table_get_lexicon_name(const OpeningTable *table);
+const char *opening_table_get_ld_name(const OpeningTable *table);
+uint64_t opening_table_get_layout_fingerprint(const OpeningTable *table);
+int opening_table_get_bingo_bonus(const OpeningTable *table);
+int opening_table_get_number_of_moves(const OpeningTable *table);
+int opening_table_get_number_of_entries(const OpeningTable *table);
+BitRack opening_table_get_bit_rack(const OpeningTable *table, int entry_index);
+
+// Returns the index of the entry for the full rack or -1 if there is none.
+int opening_table_lookup(const OpeningTable *table, const BitRack *bit_rack);
+void opening_table_get_move(const OpeningTable *table, int entry_index,
+                            int move_index, Move *move);
+void opening_table_set_move(OpeningTable *table, int entry_index,
+                            int move_index, const Move *move);
+
+#endif
@@ -0,0 +1,239 @@
+#include "perf_counters.h"
+
+#include "../def/perf_counter_defs.h"
+#include "../util/io_util.h"
+#include "../util/string_util.h"
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef enum {
+  PERF_COUNTER_UNIT_TICKS,
+  PERF_COUNTER_UNIT_VALUE,
+} perf_counter_unit_t;
+
+typedef struct PerfCounterInfo {
+  const char *name;
+  perf_counter_unit_t unit;
+} PerfCounterInfo;
+
+static const PerfCounterInfo perf_counter_infos[NUMBER_OF_PERF_COUNTERS] = {
+    [PERF_COUNTER_MOVEGEN] = {"movegen", PERF_COUNTER_UNIT_TICKS},
+    [PERF_COUNTER_MOVEGEN_SHADOW] = {"movegen_shadow", PERF_COUNTER_UNIT_TICKS},
+    [PERF_COUNTER_MOVEGEN_RECORD] = {"movegen_record", PERF_COUNTER_UNIT_TICKS},
+    [PERF_COUNTER_MOVEGEN_WMP_ANCHOR] = {"movegen_wmp_anchor",
+                                         PERF_COUNTER_UNIT_TICKS},
+    [PERF_COUNTER_MOVEGEN_ANCHORS] = {"movegen_anchors",
+                                      PERF_COUNTER_UNIT_VALUE},
+    [PERF_COUNTER_CROSS_SET_UPDATE] = {"cross_set_update",
+                                       PERF_COUNTER_UNIT_TICKS},
+    [PERF_COUNTER_PLAY_MOVE] = {"play_move", PERF_COUNTER_UNIT_TICKS},
+    [PERF_COUNTER_UNPLAY_MOVE] = {"unplay_move", PERF_COUNTER_UNIT_TICKS},
+    [PERF_COUNTER_BAI_NEXT_ARM] = {"bai_next_arm", PERF_COUNTER_UNIT_TICKS},
+    [PERF_COUNTER_BAI_SAMPLE] = {"bai_sample", PERF_COUNTER_UNIT_TICKS},
+    [PERF_COUNTER_TT_PROBE_HIT] = {"tt_probe_hit", PERF_COUNTER_UNIT_VALUE},
+    [PERF_COUNTER_PEG_SCENARIO_LEAF] = {"peg_scenario_leaf",
+                                        PERF_COUNTER_UNIT_TICKS},
+};
+
+typedef struct PerfCounterData {
+  uint64_t count;
+  uint64_t sum;
+  uint64_t histogram[PERF_COUNTER_HISTOGRAM_BUCKETS];
+} PerfCounterData;
+
+static inline int perf_counter_histogram_bucket(uint64_t value) {
+  if (value == 0) {
+    return 0;
+  }
+#if defined(__has_builtin) && __has_builtin(__builtin_clzll)
+  return 64 - __builtin_clzll(value);
+#else
+  int bucket = 0;
+  while (value) {
+    value >>= 1;
+    bucket++;
+  }
+  return bucket;
+#endif
+}
+
+static inline void perf_counter_data_merge(PerfCounterData *dst,
+                                           const PerfCounterData *src) {
+  dst->count += src->count;
+  dst->sum += src->sum;
+  for (int bucket = 0; bucket < PERF_COUNTER_HISTOGRAM_BUCKETS; bucket++) {
+    dst->histogram[bucket] += src->histogram[bucket];
+  }
+}
+
+// Upper bound of the log2 bucket holding the given percentile.
+static uint64_t perf_counter_data_percentile(const PerfCounterData *data,
+                                             double percentile) {
+  if (data->count == 0) {
+    return 0;
+  }
+  const uint64_t target = (uint64_t)((double)data->count * percentile);
+  uint64_t seen = 0;
+  for (int bucket = 0; bucket < PERF_COUNTER_HISTOGRAM_BUCKETS; bucket++) {
+    seen += data->histogram[bucket];
+    if (seen > target) {
+      if (bucket == 0) {
+        return 0;
+      }
+      if (bucket == 64) {
+        return UINT64_MAX;
+      }
+      return ((uint64_t)1 << bucket) - 1;
+    }
+  }
+  return UINT64_MAX;
+}
+
+#ifdef MAGPIE_PERF_COUNTERS
+
+#include "../compat/cpthread.h"
+#include "../def/cpthread_defs.h"
+#include "../def/thread_control_defs.h"
+
+enum { PERF_COUNTERS_CACHE_LINE_BYTES = 64 };
+
+// Slots are aligned to a cache line so two threads never write to the same
+// line.
+typedef struct PerfCounterSlot {
+  _Alignas(PERF_COUNTERS_CACHE_LINE_BYTES)
+      PerfCounterData counters[NUMBER_OF_PERF_COUNTERS];
+} PerfCounterSlot;
+
+// Same slot pool scheme as the MoveGen cache: each live thread holds a
+// distinct slot, the key destructor only releases the slot on thread exit
+// (and perf_counters_release_thread_slot when a pool thread parks) and a
+// later thread keeps accumulating into it, so the merged totals cover every
+// thread that ever ran.
+static PerfCounterSlot perf_counter_slots[MAX_THREADS];
+static bool perf_counter_slot_in_use[MAX_THREADS];
+static cpthread_mutex_t perf_counter_mutex = PTHREAD_MUTEX_INITIALIZER;
+static cpthread_key_t perf_counter_key;
+static cpthread_once_t perf_counter_key_once = CPTHREAD_ONCE_INIT;
+
+static void perf_counter_release_slot(void *ptr) {
+  if (ptr == NULL) {
+    return;
+  }
+  cpthread_mutex_lock(&perf_counter_mutex);
+  perf_counter_slot_in_use[(PerfCounterSlot *)ptr - perf_counter_slots] =
+      false;
+  cpthread_mutex_unlock(&perf_counter_mutex);
+}
+
+static void perf_counter_key_init(void) {
+  cpthread_key_create(&perf_counter_key, perf_counter_release_slot);
+}
+
+static PerfCounterSlot *perf_counter_get_slot(void) {
+  cpthread_once(&perf_counter_key_once, perf_counter_key_init);
+  PerfCounterSlot *slot = cpthread_getspecific(perf_counter_key);
+  if (slot != NULL) {
+    return slot;
+  }
+  cpthread_mutex_lock(&perf_counter_mutex);
+  for (int i = 0; i < MAX_THREADS; i++) {
+    if (!perf_counter_slot_in_use[i]) {
+      perf_counter_slot_in_use[i] = true;
+      slot = &perf_counter_slots[i];
+      break;
+    }
+  }
+  cpthread_mutex_unlock(&perf_counter_mutex);
+  if (slot == NULL) {
+    log_fatal("perf counter pool exhausted: more than %d concurrent threads",
+              MAX_THREADS);
+  }
+  cpthread_setspecific(perf_counter_key, slot);
+  return slot;
+}
+
+void perf_counters_release_thread_slot(void) {
+  cpthread_once(&perf_counter_key_once, perf_counter_key_init);
+  perf_counter_release_slot(cpthread_getspecific(perf_counter_key));
+  cpthread_setspecific(perf_counter_key, NULL);
+}
+
+void perf_counter_record(perf_counter_t counter, uint64_t value) {
+  PerfCounterData *data = &perf_counter_get_slot()->counters[counter];
+  data->count++;
+  data->sum += value;
+  data->histogram[perf_counter_histogram_bucket(value)]++;
+}
+
+bool perf_counters_enabled(void) { return true; }
+
+// Slots of threads that are still running are read without
+// synchronization, so totals taken while a command runs are approximate.
+static void perf_counters_merge(PerfCounterData *merged) {
+  memset(merged, 0, sizeof(PerfCounterData) * NUMBER_OF_PERF_COUNTERS);
+  for (int i = 0; i < MAX_THREADS; i++) {
+    for (int counter = 0; counter < NUMBER_OF_PERF_COUNTERS; counter++) {
+      perf_counter_data_merge(&merged[counter],
+                              &perf_counter_slots[i].counters[counter]);
+    }
+  }
+}
+
+void perf_counters_reset(void) {
+  cpthread_mutex_lock(&perf_counter_mutex);
+  memset(perf_counter_slots, 0, sizeof(perf_counter_slots));
+  cpthread_mutex_unlock(&perf_counter_mutex);
+}
+
+#else
+
+void perf_counter_record(perf_counter_t __attribute__((unused)) counter,
+                         uint64_t __attribute__((unused)) value) {}
+
+void perf_counters_release_thread_slot(void) {}
+
+bool perf_counters_enabled(void) { return false; }
+
+static void perf_counters_merge(PerfCounterData *merged) {
+  memset(merged, 0, sizeof(PerfCounterData) * NUMBER_OF_PERF_COUNTERS);
+}
+
+void perf_counters_reset(void) {}
+
+#endif
+
+char *perf_counters_to_string(void) {
+  if (!perf_counters_enabled()) {
+    return string_duplicate(
+        "performance counters are disabled, rebuild with PERF_COUNTERS=1\n");
+  }
+  PerfCounterData *merged =
+      malloc_or_die(sizeof(PerfCounterData) * NUMBER_OF_PERF_COUNTERS);
+  perf_counters_merge(merged);
+  StringBuilder *sb = string_builder_create();
+  string_builder_add_formatted_string(
+      sb, "%-20s %5s %12s %16s %12s %12s %12s %12s\n", "counter", "unit",
+      "count", "total", "mean", "p50", "p90", "p99");
+  for (int counter = 0; counter < NUMBER_OF_PERF_COUNTERS; counter++) {
+    const PerfCounterData *data = &merged[counter];
+    const PerfCounterInfo *info = &perf_counter_infos[counter];
+    const double mean =
+        data->count > 0 ? (double)data->sum / (double)data->count : 0.0;
+    string_builder_add_formatted_string(
+        sb,
+        "%-20s %5s %12" PRIu64 " %16" PRIu64 " %12.1f %12" PRIu64
+        " %12" PRIu64 " %12" PRIu64 "\n",
+        info->name, info->unit == PERF_COUNTER_UNIT_TICKS ? "ticks" : "value",
+        data->count, data->sum, mean,
+        perf_counter_data_percentile(data, 0.5),
+        perf_counter_data_percentile(data, 0.9),
+        perf_counter_data_percentile(data, 0.99));
+  }
+  free(merged);
+  char *result = string_builder_dump(sb, NULL);
+  string_builder_destroy(sb);
+  return result;
+}
@@ -0,0 +1,40 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include "../def/perf_counter_defs.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Hot-path instrumentation. Call sites use the macros below, which compile
+// to nothing unless the build defines MAGPIE_PERF_COUNTERS (make
+// PERF_COUNTERS=1), so regular builds pay no cost at all. When enabled,
+// every thread records into its own cache-line-aligned slot and only
+// perf_counters_to_string merges the slots.
+//
+// PERF_TIMER_START declares a local holding the start tick, so it must be
+// used where a declaration is allowed and timer_name must be unique in its
+// scope.
+#ifdef MAGPIE_PERF_COUNTERS
+#include "../compat/cycle_counter.h"
+#define PERF_COUNTER_ADD(counter, value) perf_counter_record(counter, value)
+#define PERF_TIMER_START(timer_name)                                           \
+  const uint64_t timer_name = cycle_counter_read()
+#define PERF_TIMER_STOP(counter, timer_name)                                   \
+  perf_counter_record(counter, cycle_counter_read() - (timer_name))
+#else
+#define PERF_COUNTER_ADD(counter, value) ((void)0)
+#define PERF_TIMER_START(timer_name) ((void)0)
+#define PERF_TIMER_STOP(counter, timer_name) ((void)0)
+#endif
+
+void perf_counter_record(perf_counter_t counter, uint64_t value);
+// Returns the calling thread's slot, keeping its counts, so that a thread
+// that stays alive without recording does not hold one.
+void perf_counters_release_thread_slot(void);
+bool perf_counters_enabled(void);
+void perf_counters_reset(void);
+// Returns the per-counter totals and log2 histogram percentiles merged
+// across all threads. The caller owns the returned string.
+char *perf_counters_to_string(void);
+
+#endif
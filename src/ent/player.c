@@ -6,6 +6,7 @@
 #include "klv.h"
 #include "kwg.h"
 #include "letter_distribution.h"
+#include "opening_table.h"
 #include "players_data.h"
 #include "rack.h"
 #include "rack_info_table.h"
@@ -26,6 +27,7 @@ struct Player {
   const KLV *klv;
   const WMP *wmp;
   const RackInfoTable *rack_info_table;
+  const OpeningTable *opening_table;
 };
 
 void player_reset(Player *player) {
@@ -44,6 +46,8 @@ void player_update(const PlayersData *players_data, Player *player) {
   player->wmp = players_data_get_wmp(players_data, player->index);
   player->rack_info_table =
       players_data_get_rack_info_table(players_data, player->index);
+  player->opening_table =
+      players_data_get_opening_table(players_data, player->index);
 }
 
 Player *player_create(const PlayersData *players_data,
@@ -72,6 +76,7 @@ Player *player_duplicate(const Player *player) {
   new_player->klv = player->klv;
   new_player->wmp = player->wmp;
   new_player->rack_info_table = player->rack_info_table;
+  new_player->opening_table = player->opening_table;
   return new_player;
 }
 
@@ -86,6 +91,7 @@ void player_copy(Player *dst, const Player *src) {
   dst->klv = src->klv;
   dst->wmp = src->wmp;
   dst->rack_info_table = src->rack_info_table;
+  dst->opening_table = src->opening_table;
 }
 
 void player_destroy(Player *player) {
@@ -125,12 +131,21 @@ const RackInfoTable *player_get_rack_info_table(const Player *player) {
   return player->rack_info_table;
 }
 
+const OpeningTable *player_get_opening_table(const Player *player) {
+  return player->opening_table;
+}
+
 void player_set_score(Player *player, Equity score) { player->score = score; }
 
 void player_add_to_score(Player *player, Equity score) {
   player->score += score;
 }
 
+void player_set_opening_table(Player *player,
+                              const OpeningTable *opening_table) {
+  player->opening_table = opening_table;
+}
+
 void player_set_move_sort_type(Player *player, move_sort_t move_sort_type) {
   player->move_sort_type = move_sort_type;
 }
@@ -4,6 +4,7 @@
 #include "../def/move_defs.h"
 #include "klv.h"
 #include "kwg.h"
+#include "opening_table.h"
 #include "players_data.h"
 #include "rack.h"
 #include "rack_info_table.h"
@@ -25,12 +26,15 @@ const KWG *player_get_kwg(const Player *player);
 const KLV *player_get_klv(const Player *player);
 const WMP *player_get_wmp(const Player *player);
 const RackInfoTable *player_get_rack_info_table(const Player *player);
+const OpeningTable *player_get_opening_table(const Player *player);
 
 void player_set_score(Player *player, Equity score);
 void player_set_move_sort_type(Player *player, move_sort_t move_sort_type);
 void player_set_move_record_type(Player *player,
                                  move_record_t move_record_type);
 void player_add_to_score(Player *player, Equity score);
+void player_set_opening_table(Player *player,
+                              const OpeningTable *opening_table);
 
 void player_update(const PlayersData *players_data, Player *player);
 Player *player_duplicate(const Player *player);
@@ -1,17 +1,19 @@
 #include "players_data.h"
 
+#include "../compat/cpthread.h"
 #include "../def/move_defs.h"
 #include "../def/players_data_defs.h"
 #include "../util/io_util.h"
 #include "../util/string_util.h"
 #include "klv.h"
 #include "kwg.h"
+#include "opening_table.h"
 #include "rack_info_table.h"
 #include "wmp.h"
 #include <stdlib.h>
 
-static const char *const players_data_type_names[] = {"kwg", "klv", "wordmap",
-                                                      "rack info table"};
+static const char *const players_data_type_names[] = {
+    "kwg", "klv", "wordmap", "rack info table", "opening table"};
 
 // The PlayersData struct holds all of the
 // information that can be set during configuration.
@@ -23,8 +25,27 @@ struct PlayersData {
   bool use_when_available[(NUMBER_OF_DATA * 2)];
   move_sort_t move_sort_types[2];
   move_record_t move_record_types[2];
+  bool share_loaded_data;
 };
 
+// Data loaded by a PlayersData that shares loaded data is registered here
+// and handed out to every other sharing PlayersData that asks for the same
+// data, so configs that run side by side in one process (such as the jobs of
+// the job server) hold a single read-only copy of each lexicon. Entries are
+// reference counted and destroyed with their last user.
+typedef struct SharedLoadedData {
+  players_data_t players_data_type;
+  char *data_paths;
+  char *data_name;
+  bool use_mmap;
+  void *data;
+  int ref_count;
+  struct SharedLoadedData *next;
+} SharedLoadedData;
+
+static SharedLoadedData *shared_loaded_data_list = NULL;
+static cpthread_mutex_t shared_loaded_data_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 #define DEFAULT_MOVE_SORT_TYPE MOVE_SORT_EQUITY
 #define DEFAULT_MOVE_RECORD_TYPE MOVE_RECORD_ALL
 
@@ -55,6 +76,15 @@ move_record_t players_data_get_move_record_type(const PlayersData *players_data,
   return players_data->move_record_types[player_index];
 }
 
+void players_data_set_share_loaded_data(PlayersData *players_data,
+                                        bool share_loaded_data) {
+  players_data->share_loaded_data = share_loaded_data;
+}
+
+bool players_data_get_share_loaded_data(const PlayersData *players_data) {
+  return players_data->share_loaded_data;
+}
+
 bool players_data_get_is_shared(const PlayersData *players_data,
                                 players_data_t players_data_type) {
   return players_data->data_is_shared[(int)players_data_type];
@@ -111,6 +141,12 @@ RackInfoTable *players_data_get_rack_info_table(const PlayersData *players_data,
       players_data, PLAYERS_DATA_TYPE_RIT, player_index);
 }
 
+OpeningTable *players_data_get_opening_table(const PlayersData *players_data,
+                                            int player_index) {
+  return (OpeningTable *)players_data_get_data(
+      players_data, PLAYERS_DATA_TYPE_OPENING_TABLE, player_index);
+}
+
 void players_data_set_data(PlayersData *players_data,
                            players_data_t players_data_type, int player_index,
                            void *data) {
@@ -121,9 +157,10 @@ void players_data_set_data(PlayersData *players_data,
   players_data->use_when_available[data_index] = !!data;
 }
 
-void *players_data_create_data(players_data_t players_data_type,
-                               const char *data_paths, const char *data_name,
-                               bool use_mmap, ErrorStack *error_stack) {
+static void *players_data_load_data(players_data_t players_data_type,
+                                    const char *data_paths,
+                                    const char *data_name, bool use_mmap,
+                                    ErrorStack *error_stack) {
   if (!data_name) {
     return NULL;
   }
@@ -141,6 +178,9 @@ void *players_data_create_data(players_data_t players_data_type,
   case PLAYERS_DATA_TYPE_RIT:
     data = rack_info_table_create(data_paths, data_name, use_mmap, error_stack);
     break;
+  case PLAYERS_DATA_TYPE_OPENING_TABLE:
+    data = opening_table_create(data_paths, data_name, error_stack);
+    break;
   case NUMBER_OF_DATA:
     log_fatal("cannot create invalid players data type");
     break;
@@ -148,28 +188,125 @@ void *players_data_create_data(players_data_t players_data_type,
   return data;
 }
 
+static void players_data_unload_data(players_data_t players_data_type,
+                                      void *data) {
+  switch (players_data_type) {
+  case PLAYERS_DATA_TYPE_KWG:
+    kwg_destroy(data);
+    break;
+  case PLAYERS_DATA_TYPE_KLV:
+    klv_destroy(data);
+    break;
+  case PLAYERS_DATA_TYPE_WMP:
+    wmp_destroy(data);
+    break;
+  case PLAYERS_DATA_TYPE_RIT:
+    rack_info_table_destroy(data);
+    break;
+  case PLAYERS_DATA_TYPE_OPENING_TABLE:
+    opening_table_destroy(data);
+    break;
+  case NUMBER_OF_DATA:
+    log_fatal("cannot destroy invalid players data type");
+    break;
+  }
+}
+
+// Returns the registered data matching the arguments, loading and
+// registering it first if no sharing PlayersData holds it yet.
+static void *players_data_acquire_shared_data(players_data_t players_data_type,
+                                              const char *data_paths,
+                                              const char *data_name,
+                                              bool use_mmap,
+                                              ErrorStack *error_stack) {
+  void *data = NULL;
+  cpthread_mutex_lock(&shared_loaded_data_mutex);
+  for (SharedLoadedData *entry = shared_loaded_data_list; entry;
+       entry = entry->next) {
+    if (entry->players_data_type == players_data_type &&
+        entry->use_mmap == use_mmap &&
+        strings_equal(entry->data_paths, data_paths) &&
+        strings_equal(entry->data_name, data_name)) {
+      entry->ref_count++;
+      data = entry->data;
+      break;
+    }
+  }
+  if (!data) {
+    // Loading under the lock keeps two jobs that start at the same time
+    // from loading the same lexicon twice.
+    data = players_data_load_data(players_data_type, data_paths, data_name,
+                                  use_mmap, error_stack);
+    if (data) {
+      SharedLoadedData *entry = malloc_or_die(sizeof(SharedLoadedData));
+      entry->players_data_type = players_data_type;
+      entry->data_paths = string_duplicate(data_paths);
+      entry->data_name = string_duplicate(data_name);
+      entry->use_mmap = use_mmap;
+      entry->data = data;
+      entry->ref_count = 1;
+      entry->next = shared_loaded_data_list;
+      shared_loaded_data_list = entry;
+    }
+  }
+  cpthread_mutex_unlock(&shared_loaded_data_mutex);
+  return data;
+}
+
+// Drops one reference to registered data, destroying it with its last
+// reference. Returns false if the data is not registered.
+static bool players_data_release_shared_data(const void *data) {
+  bool found = false;
+  SharedLoadedData *released_entry = NULL;
+  cpthread_mutex_lock(&shared_loaded_data_mutex);
+  for (SharedLoadedData **entry_ptr = &shared_loaded_data_list; *entry_ptr;
+       entry_ptr = &(*entry_ptr)->next) {
+    SharedLoadedData *entry = *entry_ptr;
+    if (entry->data == data) {
+      found = true;
+      entry->ref_count--;
+      if (entry->ref_count == 0) {
+        *entry_ptr = entry->next;
+        released_entry = entry;
+      }
+      break;
+    }
+  }
+  cpthread_mutex_unlock(&shared_loaded_data_mutex);
+  if (released_entry) {
+    players_data_unload_data(released_entry->players_data_type,
+                             released_entry->data);
+    free(released_entry->data_paths);
+    free(released_entry->data_name);
+    free(released_entry);
+  }
+  return found;
+}
+
+void *players_data_create_data(const PlayersData *players_data,
+                               players_data_t players_data_type,
+                               const char *data_paths, const char *data_name,
+                               bool use_mmap, ErrorStack *error_stack) {
+  if (!data_name) {
+    return NULL;
+  }
+  if (players_data->share_loaded_data) {
+    return players_data_acquire_shared_data(players_data_type, data_paths,
+                                            data_name, use_mmap, error_stack);
+  }
+  return players_data_load_data(players_data_type, data_paths, data_name,
+                                use_mmap, error_stack);
+}
+
 void players_data_destroy_data(PlayersData *players_data,
                                players_data_t players_data_type,
                                int player_index) {
   int data_index =
       players_data_get_player_data_index(players_data_type, player_index);
-  if (players_data->data[data_index]) {
-    switch (players_data_type) {
-    case PLAYERS_DATA_TYPE_KWG:
-      kwg_destroy(players_data->data[data_index]);
-      break;
-    case PLAYERS_DATA_TYPE_KLV:
-      klv_destroy(players_data->data[data_index]);
-      break;
-    case PLAYERS_DATA_TYPE_WMP:
-      wmp_destroy(players_data->data[data_index]);
-      break;
-    case PLAYERS_DATA_TYPE_RIT:
-      rack_info_table_destroy(players_data->data[data_index]);
-      break;
-    case NUMBER_OF_DATA:
-      log_fatal("cannot destroy invalid players data type");
-      break;
+  void *data = players_data->data[data_index];
+  if (data) {
+    if (!players_data_release_shared_data(data)) {
+      players_data_unload_data(players_data_type, data);
     }
     players_data->data[data_index] = NULL;
   }
@@ -211,6 +348,9 @@ const char *players_data_get_data_name(const PlayersData *players_data,
     case PLAYERS_DATA_TYPE_RIT:
       data_name = rack_info_table_get_name(players_data->data[data_index]);
       break;
+    case PLAYERS_DATA_TYPE_OPENING_TABLE:
+      data_name = opening_table_get_name(players_data->data[data_index]);
+      break;
     case NUMBER_OF_DATA:
       log_fatal("cannot destroy invalid players data type");
       break;
@@ -221,6 +361,7 @@ const char *players_data_get_data_name(const PlayersData *players_data,
 
 PlayersData *players_data_create(bool use_wmp) {
   PlayersData *players_data = malloc_or_die(sizeof(PlayersData));
+  players_data->share_loaded_data = false;
   for (int player_index = 0; player_index < 2; player_index++) {
     for (int data_index = 0; data_index < NUMBER_OF_DATA; data_index++) {
       int player_data_index = players_data_get_player_data_index(
@@ -230,10 +371,12 @@ PlayersData *players_data_create(bool use_wmp) {
       bool default_use = true;
       if (data_index == PLAYERS_DATA_TYPE_WMP) {
         default_use = use_wmp;
-      } else if (data_index == PLAYERS_DATA_TYPE_RIT) {
+      } else if (data_index == PLAYERS_DATA_TYPE_RIT ||
+                 data_index == PLAYERS_DATA_TYPE_OPENING_TABLE) {
         // RIT files are opt-in: callers must explicitly enable them with
         // -rit true (or -rit1/-rit2) since they are large and may not
-        // exist for every lexicon.
+        // exist for every lexicon. Opening tables are enabled with
+        // -openings true for the same reasons.
         default_use = false;
       }
       players_data_set_use_when_available(players_data, data_index,
@@ -266,14 +409,16 @@ void players_data_destroy(PlayersData *players_data) {
 
 bool players_data_type_is_nullable(players_data_t players_data_type) {
   return players_data_type == PLAYERS_DATA_TYPE_WMP ||
-         players_data_type == PLAYERS_DATA_TYPE_RIT;
+         players_data_type == PLAYERS_DATA_TYPE_RIT ||
+         players_data_type == PLAYERS_DATA_TYPE_OPENING_TABLE;
 }
 
 void players_data_set(PlayersData *players_data,
                       players_data_t players_data_type, const char *data_paths,
                       const char *p1_data_name, const char *p2_data_name,
                       bool use_mmap_for_rit, ErrorStack *error_stack) {
-  // WMP is optional, KWG and KLV are required for every player.
+  // WMP, RIT and opening tables are optional, KWG and KLV are required for
+  // every player.
   if (!players_data_type_is_nullable(players_data_type)) {
     if (is_string_empty_or_null(p1_data_name)) {
       log_fatal("cannot set data type '%s' to null for player one",
@@ -314,8 +459,8 @@ void players_data_set(PlayersData *players_data,
         bool use_mmap =
             use_mmap_for_rit && players_data_type == PLAYERS_DATA_TYPE_RIT;
         void *generic_players_data = players_data_create_data(
-            players_data_type, data_paths, input_data_names[player_index],
-            use_mmap, error_stack);
+            players_data, players_data_type, data_paths,
+            input_data_names[player_index], use_mmap, error_stack);
         if (!error_stack_is_empty(error_stack)) {
           return;
         }
@@ -363,7 +508,9 @@ void players_data_reload(PlayersData *players_data,
           reload_mmap = existing_rit->is_mmapped;
         }
       }
-      recreated_data[player_index] = players_data_create_data(
+      // Reloaded data is never shared since it is reloaded precisely
+      // because its file changed.
+      recreated_data[player_index] = players_data_load_data(
           players_data_type, data_paths,
           players_data_get_data_name(players_data, players_data_type,
                                      player_index),
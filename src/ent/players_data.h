@@ -5,6 +5,7 @@
 #include "../def/players_data_defs.h"
 #include "klv.h"
 #include "kwg.h"
+#include "opening_table.h"
 #include "rack_info_table.h"
 #include "wmp.h"
 #include <stdbool.h>
@@ -13,6 +14,12 @@ typedef struct PlayersData PlayersData;
 
 PlayersData *players_data_create(bool use_wmp);
 void players_data_destroy(PlayersData *players_data);
+// When enabled, data loaded by name is shared read-only with every other
+// PlayersData in the process that also shares loaded data. Sharing
+// PlayersData must not modify their data in place.
+void players_data_set_share_loaded_data(PlayersData *players_data,
+                                        bool share_loaded_data);
+bool players_data_get_share_loaded_data(const PlayersData *players_data);
 
 move_sort_t players_data_get_move_sort_type(const PlayersData *players_data,
                                             int player_index);
@@ -26,6 +33,8 @@ KLV *players_data_get_klv(const PlayersData *players_data, int player_index);
 WMP *players_data_get_wmp(const PlayersData *players_data, int player_index);
 RackInfoTable *players_data_get_rack_info_table(const PlayersData *players_data,
                                                 int player_index);
+OpeningTable *players_data_get_opening_table(const PlayersData *players_data,
+                                            int player_index);
 
 void players_data_set_move_sort_type(PlayersData *players_data,
                                      int player_index,
@@ -379,6 +379,31 @@ static inline void rack_info_table_destroy(RackInfoTable *rit) {
   free(rit);
 }
 
+// Copies a memory-mapped table into owned memory so its entries can be
+// modified in place. No-op for tables that are already owned.
+static inline void rack_info_table_make_writable(RackInfoTable *rit) {
+  if (!rit->is_mmapped) {
+    return;
+  }
+  const size_t bucket_starts_size =
+      ((size_t)rit->num_buckets + 1) * sizeof(uint32_t);
+  const size_t entries_size =
+      (size_t)rit->num_entries * sizeof(RackInfoTableEntry);
+  uint32_t *bucket_starts = malloc_or_die(bucket_starts_size);
+  memcpy(bucket_starts, rit->bucket_starts, bucket_starts_size);
+  RackInfoTableEntry *entries = NULL;
+  if (entries_size > 0) {
+    entries = malloc_or_die(entries_size);
+    memcpy(entries, rit->entries, entries_size);
+  }
+  munmap(rit->mmap_base, rit->mmap_size);
+  rit->bucket_starts = bucket_starts;
+  rit->entries = entries;
+  rit->is_mmapped = false;
+  rit->mmap_base = NULL;
+  rit->mmap_size = 0;
+}
+
 // ============================================================================
 // File I/O
 // ============================================================================
@@ -2,6 +2,7 @@
 #define SIM_ARGS_H
 
 #include "../def/bai_defs.h"
+#include "../def/sim_defs.h"
 #include "../ent/equity.h"
 #include "../ent/game.h"
 #include "../ent/game_history.h"
@@ -22,6 +23,12 @@ typedef struct SimArgs {
   WinPct *win_pcts;
   bool use_inference;
   bool use_heat_map;
+  // Collect the per ply stats and heat maps of one in every ply_stats_rate
+  // rollouts. Defaulted to every rollout by sim_args_fill.
+  int ply_stats_rate;
+  // Share the moves found in the rollouts between candidates that reach the
+  // same positions, see sim_reply_cache.h.
+  bool share_rollouts;
   InferenceResults *inference_results;
   InferenceArgs inference_args;
   int num_threads;
@@ -69,6 +76,8 @@ sim_args_fill(const int num_plies, const MoveList *move_list,
   sim_args->game = game;
   sim_args->use_inference = sim_with_inference;
   sim_args->use_heat_map = use_heat_map;
+  sim_args->ply_stats_rate = DEFAULT_PLY_STATS_RATE;
+  sim_args->share_rollouts = false;
   sim_args->num_threads = num_threads;
   sim_args->print_interval = print_interval;
   sim_args->max_num_display_plays = max_num_display_plays;
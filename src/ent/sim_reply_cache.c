@@ -0,0 +1,111 @@
+#include "sim_reply_cache.h"
+
+#include "../compat/cpthread.h"
+#include "../def/sim_defs.h"
+#include "../util/io_util.h"
+#include "bag.h"
+#include "board.h"
+#include "game.h"
+#include "move.h"
+#include "player.h"
+#include "rack.h"
+#include "zobrist.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+typedef struct SimReplyCacheEntry {
+  uint64_t key;
+  uint64_t generation;
+  Move move;
+} SimReplyCacheEntry;
+
+struct SimReplyCache {
+  Zobrist *zobrist;
+  SimReplyCacheEntry *entries;
+  uint64_t generation;
+  cpthread_mutex_t locks[SIM_REPLY_CACHE_NUM_LOCKS];
+};
+
+SimReplyCache *sim_reply_cache_create(uint64_t seed) {
+  SimReplyCache *cache = malloc_or_die(sizeof(SimReplyCache));
+  cache->zobrist = zobrist_create(seed);
+  cache->entries = calloc_or_die((size_t)1 << SIM_REPLY_CACHE_SIZE_POWER,
+                                 sizeof(SimReplyCacheEntry));
+  // Entries start out with generation 0, which is never current.
+  cache->generation = 1;
+  for (int i = 0; i < SIM_REPLY_CACHE_NUM_LOCKS; i++) {
+    cpthread_mutex_init(&cache->locks[i]);
+  }
+  return cache;
+}
+
+void sim_reply_cache_destroy(SimReplyCache *cache) {
+  if (!cache) {
+    return;
+  }
+  for (int i = 0; i < SIM_REPLY_CACHE_NUM_LOCKS; i++) {
+    cpthread_mutex_destroy(&cache->locks[i]);
+  }
+  zobrist_destroy(cache->zobrist);
+  free(cache->entries);
+  free(cache);
+}
+
+void sim_reply_cache_reset(SimReplyCache *cache) { cache->generation++; }
+
+uint64_t sim_reply_cache_get_key(const SimReplyCache *cache, const Game *game) {
+  const int player_on_turn_index = game_get_player_on_turn_index(game);
+  const Rack *player_rack =
+      player_get_rack(game_get_player(game, player_on_turn_index));
+  const Rack *opp_rack =
+      player_get_rack(game_get_player(game, 1 - player_on_turn_index));
+  const int bag_size = bag_get_letters(game_get_bag(game));
+  // While the bag has tiles, the move only depends on the size of the
+  // opponent rack, which decides whether exchanges are allowed.
+  Rack opp_rack_for_key;
+  rack_set_dist_size_and_reset(&opp_rack_for_key, rack_get_dist_size(opp_rack));
+  if (bag_size == 0) {
+    rack_copy(&opp_rack_for_key, opp_rack);
+  }
+  const uint64_t sizes = ((uint64_t)bag_size << 8) |
+                         (uint64_t)rack_get_total_letters(opp_rack);
+  return zobrist_calculate_hash(cache->zobrist, game_get_board(game),
+                                player_rack, &opp_rack_for_key,
+                                player_on_turn_index == 1, 0) ^
+         (sizes * 0x9E3779B97F4A7C15ULL);
+}
+
+static SimReplyCacheEntry *sim_reply_cache_get_entry(SimReplyCache *cache,
+                                                     uint64_t key,
+                                                     cpthread_mutex_t **lock) {
+  const uint64_t index =
+      key & (((uint64_t)1 << SIM_REPLY_CACHE_SIZE_POWER) - 1);
+  *lock = &cache->locks[index % SIM_REPLY_CACHE_NUM_LOCKS];
+  return &cache->entries[index];
+}
+
+bool sim_reply_cache_lookup(SimReplyCache *cache, uint64_t key, Move *move) {
+  cpthread_mutex_t *lock;
+  const SimReplyCacheEntry *entry =
+      sim_reply_cache_get_entry(cache, key, &lock);
+  cpthread_mutex_lock(lock);
+  const bool found =
+      entry->key == key && entry->generation == cache->generation;
+  if (found) {
+    move_copy(move, &entry->move);
+  }
+  cpthread_mutex_unlock(lock);
+  return found;
+}
+
+void sim_reply_cache_store(SimReplyCache *cache, uint64_t key,
+                           const Move *move) {
+  cpthread_mutex_t *lock;
+  SimReplyCacheEntry *entry = sim_reply_cache_get_entry(cache, key, &lock);
+  cpthread_mutex_lock(lock);
+  entry->key = key;
+  entry->generation = cache->generation;
+  move_copy(&entry->move, move);
+  cpthread_mutex_unlock(lock);
+}
@@ -0,0 +1,34 @@
+#ifndef SIM_REPLY_CACHE_H
+#define SIM_REPLY_CACHE_H
+
+#include "game.h"
+#include "move.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Shared table of the top equity move found in the positions reached by sim
+// rollouts. Candidates that leave the same board, such as exchanges and
+// passes, face the same reply for the same sampled opponent rack, and
+// candidates that leave the same position share their whole rollouts, so
+// their threads can look up the move instead of generating it again.
+//
+// A position is keyed by everything the top equity move depends on: the
+// board, the rack and index of the player on turn, the number of tiles in the
+// bag and the rack of the other player, of which only the size matters while
+// the bag has tiles. Entries are replaced on collision and are invalidated
+// in constant time by sim_reply_cache_reset.
+typedef struct SimReplyCache SimReplyCache;
+
+SimReplyCache *sim_reply_cache_create(uint64_t seed);
+void sim_reply_cache_destroy(SimReplyCache *cache);
+// Invalidates all entries, which is needed when the players' lexica or leaves
+// may have changed.
+void sim_reply_cache_reset(SimReplyCache *cache);
+uint64_t sim_reply_cache_get_key(const SimReplyCache *cache, const Game *game);
+// Copies the cached move for the key into move and returns true if there is
+// one.
+bool sim_reply_cache_lookup(SimReplyCache *cache, uint64_t key, Move *move);
+void sim_reply_cache_store(SimReplyCache *cache, uint64_t key,
+                           const Move *move);
+
+#endif
@@ -53,6 +53,8 @@ struct SimResults {
   int num_plies;
   atomic_uint_least64_t iteration_count;
   atomic_uint_least64_t node_count;
+  // Number of rollout moves copied from the reply cache
+  atomic_uint_least64_t shared_reply_count;
   cpthread_mutex_t simmed_plays_mutex;
   cpthread_mutex_t display_mutex;
   SimmedPlay **simmed_plays;
@@ -96,6 +98,57 @@ void ply_info_reset(PlyInfo *ply_info, bool use_heat_map) {
   memset(ply_info->ply_info_counts, 0, sizeof(ply_info->ply_info_counts));
 }
 
+void ply_info_destroy(PlyInfo *ply_info) {
+  stat_destroy(ply_info->bingo_stat);
+  stat_destroy(ply_info->score_stat);
+  heat_map_destroy(ply_info->heat_map);
+}
+
+static void ply_info_add_move(PlyInfo *ply_info, const Move *move,
+                              int ply_index) {
+  const double move_score = equity_to_double(move_get_score(move));
+  bool is_bingo = false;
+  ply_info_count_t count_type;
+  switch (move_get_type(move)) {
+  case GAME_EVENT_PASS:
+    count_type = PLY_INFO_COUNT_PASS;
+    break;
+  case GAME_EVENT_EXCHANGE:
+    count_type = PLY_INFO_COUNT_EXCHANGE;
+    break;
+  case GAME_EVENT_TILE_PLACEMENT_MOVE:
+    count_type = PLY_INFO_COUNT_TILE_PLACEMENT;
+    is_bingo = move_get_tiles_played(move) == RACK_SIZE;
+    break;
+  default:
+    log_fatal(
+        "encountered unexpected move type %d when adding stats for ply %d",
+        move_get_type(move), ply_index);
+    return;
+  }
+  stat_push(ply_info->score_stat, move_score, 1);
+  stat_push(ply_info->bingo_stat, (double)(is_bingo), 1);
+  if (ply_info->heat_map) {
+    heat_map_add_move(ply_info->heat_map, move);
+  }
+  ply_info->ply_info_counts[count_type]++;
+  ply_info->ply_info_counts[PLY_INFO_COUNT_BINGO] += (uint64_t)is_bingo;
+}
+
+// Adds the stats of src to dst.
+static void ply_info_merge(PlyInfo *dst, const PlyInfo *src) {
+  Stat *score_stats[] = {dst->score_stat, src->score_stat};
+  stats_combine(score_stats, 2, dst->score_stat);
+  Stat *bingo_stats[] = {dst->bingo_stat, src->bingo_stat};
+  stats_combine(bingo_stats, 2, dst->bingo_stat);
+  if (dst->heat_map && src->heat_map) {
+    heat_map_add_heat_map(dst->heat_map, src->heat_map);
+  }
+  for (int i = 0; i < NUM_PLY_INFO_COUNT_TYPES; i++) {
+    dst->ply_info_counts[i] += src->ply_info_counts[i];
+  }
+}
+
 SimmedPlay *simmed_play_create(const MoveList *move_list, int num_plies,
                                uint64_t seed, double cutoff, bool use_heat_map,
                                const int i) {
@@ -290,9 +343,7 @@ void simmed_plays_destroy(SimmedPlay **simmed_plays, int num_alloc_sps) {
   }
   for (int i = 0; i < num_alloc_sps; i++) {
     for (int j = 0; j < simmed_plays[i]->num_alloc_plies; j++) {
-      stat_destroy(simmed_plays[i]->ply_infos[j].bingo_stat);
-      stat_destroy(simmed_plays[i]->ply_infos[j].score_stat);
-      heat_map_destroy(simmed_plays[i]->ply_infos[j].heat_map);
+      ply_info_destroy(&simmed_plays[i]->ply_infos[j]);
     }
     free(simmed_plays[i]->ply_infos);
     stat_destroy(simmed_plays[i]->equity_stat);
@@ -336,6 +387,7 @@ void sim_results_reset(const MoveList *move_list, SimResults *sim_results,
                                    use_heat_map);
   }
   atomic_init(&sim_results->node_count, 0);
+  atomic_init(&sim_results->shared_reply_count, 0);
   atomic_init(&sim_results->iteration_count, 0);
   sim_results->valid_for_current_game_state = false;
   cpthread_mutex_unlock(&sim_results->display_mutex);
@@ -347,6 +399,7 @@ SimResults *sim_results_create(const double cutoff) {
   sim_results->num_alloc_simmed_plays = 0;
   sim_results->num_plies = 0;
   atomic_init(&sim_results->node_count, 0);
+  atomic_init(&sim_results->shared_reply_count, 0);
   atomic_init(&sim_results->iteration_count, 0);
   cpthread_mutex_init(&sim_results->simmed_plays_mutex);
   cpthread_mutex_init(&sim_results->display_mutex);
@@ -379,6 +432,8 @@ SimResults *sim_results_duplicate(const SimResults *sim_results) {
   new_sim_results->num_plies = sim_results->num_plies;
   atomic_init(&new_sim_results->node_count,
               atomic_load(&sim_results->node_count));
+  atomic_init(&new_sim_results->shared_reply_count,
+              atomic_load(&sim_results->shared_reply_count));
   atomic_init(&new_sim_results->iteration_count,
               atomic_load(&sim_results->iteration_count));
   cpthread_mutex_init(&new_sim_results->simmed_plays_mutex);
@@ -481,6 +536,14 @@ void sim_results_increment_node_count(SimResults *sim_results) {
   atomic_fetch_add(&sim_results->node_count, 1);
 }
 
+uint64_t sim_results_get_shared_reply_count(const SimResults *sim_results) {
+  return atomic_load(&sim_results->shared_reply_count);
+}
+
+void sim_results_increment_shared_reply_count(SimResults *sim_results) {
+  atomic_fetch_add(&sim_results->shared_reply_count, 1);
+}
+
 uint64_t sim_results_get_iteration_count(const SimResults *sim_results) {
   return atomic_load(&sim_results->iteration_count);
 }
@@ -548,40 +611,100 @@ void sim_results_set_num_infer_leaves(SimResults *sim_results,
   sim_results->num_infer_leaves = num_infer_leaves;
 }
 
-void simmed_play_add_stats_for_ply(SimmedPlay *simmed_play, int ply_index,
-                                   const Move *move) {
-  const double move_score = equity_to_double(move_get_score(move));
-  bool is_bingo = false;
-  ply_info_count_t count_type;
-  switch (move_get_type(move)) {
-  case GAME_EVENT_PASS:
-    count_type = PLY_INFO_COUNT_PASS;
-    break;
-  case GAME_EVENT_EXCHANGE:
-    count_type = PLY_INFO_COUNT_EXCHANGE;
-    break;
-  case GAME_EVENT_TILE_PLACEMENT_MOVE:
-    count_type = PLY_INFO_COUNT_TILE_PLACEMENT;
-    is_bingo = move_get_tiles_played(move) == RACK_SIZE;
-    break;
-  default:
-    log_fatal(
-        "encountered unexpected move type %d when adding stats for ply %d",
-        move_get_type(move), ply_index);
+struct SimPlyStatsShard {
+  int num_plays;
+  int num_plies;
+  int num_alloc_ply_infos;
+  // The ply infos of play i are at i * num_plies.
+  PlyInfo *ply_infos;
+  // Number of rollouts of each play added since its last merge.
+  int *num_unmerged_rollouts;
+  int num_alloc_plays;
+};
+
+SimPlyStatsShard *sim_ply_stats_shard_create(void) {
+  return calloc_or_die(1, sizeof(SimPlyStatsShard));
+}
+
+void sim_ply_stats_shard_destroy(SimPlyStatsShard *shard) {
+  if (!shard) {
     return;
   }
-  HeatMap *heat_map = simmed_play_get_heat_map(simmed_play, ply_index);
+  for (int i = 0; i < shard->num_alloc_ply_infos; i++) {
+    ply_info_destroy(&shard->ply_infos[i]);
+  }
+  free(shard->ply_infos);
+  free(shard->num_unmerged_rollouts);
+  free(shard);
+}
+
+void sim_ply_stats_shard_reset(SimPlyStatsShard *shard,
+                               const SimResults *sim_results,
+                               bool use_heat_map) {
+  shard->num_plays = sim_results->num_simmed_plays;
+  shard->num_plies = sim_results->num_plies;
+  const int num_ply_infos = shard->num_plays * shard->num_plies;
+  for (int i = 0; i < shard->num_alloc_ply_infos && i < num_ply_infos; i++) {
+    ply_info_reset(&shard->ply_infos[i], use_heat_map);
+  }
+  if (num_ply_infos > shard->num_alloc_ply_infos) {
+    shard->ply_infos =
+        realloc_or_die(shard->ply_infos, sizeof(PlyInfo) * num_ply_infos);
+    for (int i = shard->num_alloc_ply_infos; i < num_ply_infos; i++) {
+      ply_info_init(&shard->ply_infos[i], use_heat_map);
+    }
+    shard->num_alloc_ply_infos = num_ply_infos;
+  }
+  if (shard->num_plays > shard->num_alloc_plays) {
+    shard->num_unmerged_rollouts = realloc_or_die(
+        shard->num_unmerged_rollouts, sizeof(int) * shard->num_plays);
+    shard->num_alloc_plays = shard->num_plays;
+  }
+  memset(shard->num_unmerged_rollouts, 0, sizeof(int) * shard->num_plays);
+}
+
+void sim_ply_stats_shard_add_stats_for_ply(SimPlyStatsShard *shard,
+                                           int play_index, int ply_index,
+                                           const Move *move) {
+  const int ply_info_index = play_index * shard->num_plies + ply_index;
+  ply_info_add_move(&shard->ply_infos[ply_info_index], move, ply_index);
+}
+
+static void sim_ply_stats_shard_merge_play(SimPlyStatsShard *shard,
+                                           SimResults *sim_results,
+                                           int play_index) {
+  if (shard->num_unmerged_rollouts[play_index] == 0) {
+    return;
+  }
+  SimmedPlay *simmed_play = sim_results->simmed_plays[play_index];
+  PlyInfo *shard_ply_infos = &shard->ply_infos[play_index * shard->num_plies];
   cpthread_mutex_lock(&simmed_play->mutex);
-  stat_push(simmed_play->ply_infos[ply_index].score_stat, move_score, 1);
-  stat_push(simmed_play->ply_infos[ply_index].bingo_stat, (double)(is_bingo),
-            1);
-  if (heat_map) {
-    heat_map_add_move(heat_map, move);
-  }
-  simmed_play->ply_infos[ply_index].ply_info_counts[count_type]++;
-  simmed_play->ply_infos[ply_index].ply_info_counts[PLY_INFO_COUNT_BINGO] +=
-      (uint64_t)is_bingo;
+  for (int ply_index = 0; ply_index < shard->num_plies; ply_index++) {
+    ply_info_merge(&simmed_play->ply_infos[ply_index],
+                   &shard_ply_infos[ply_index]);
+  }
   cpthread_mutex_unlock(&simmed_play->mutex);
+  for (int ply_index = 0; ply_index < shard->num_plies; ply_index++) {
+    ply_info_reset(&shard_ply_infos[ply_index],
+                   shard_ply_infos[ply_index].heat_map != NULL);
+  }
+  shard->num_unmerged_rollouts[play_index] = 0;
+}
+
+void sim_ply_stats_shard_finish_rollout(SimPlyStatsShard *shard,
+                                        SimResults *sim_results,
+                                        int play_index) {
+  if (++shard->num_unmerged_rollouts[play_index] >=
+      SIM_PLY_STATS_MERGE_INTERVAL) {
+    sim_ply_stats_shard_merge_play(shard, sim_results, play_index);
+  }
+}
+
+void sim_ply_stats_shard_merge(SimPlyStatsShard *shard,
+                               SimResults *sim_results) {
+  for (int play_index = 0; play_index < shard->num_plays; play_index++) {
+    sim_ply_stats_shard_merge_play(shard, sim_results, play_index);
+  }
 }
 
 void simmed_play_add_equity_stat(SimmedPlay *simmed_play, Equity initial_spread,
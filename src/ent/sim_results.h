@@ -38,8 +38,6 @@ const Stat *simmed_play_get_utility_stat(const SimmedPlay *simmed_play);
 bool simmed_play_get_utility_w_spread_is_set(const SimmedPlay *simmed_play);
 int simmed_play_get_play_index_by_sort_type(const SimmedPlay *simmed_play);
 uint64_t simmed_play_get_seed(SimmedPlay *simmed_play);
-void simmed_play_add_stats_for_ply(SimmedPlay *simmed_play, int ply_index,
-                                   const Move *move);
 void simmed_play_add_equity_stat(SimmedPlay *simmed_play, Equity initial_spread,
                                  Equity spread, Equity leftover);
 double simmed_play_add_win_pct_stat(const WinPct *wp, SimmedPlay *simmed_play,
@@ -50,6 +48,28 @@ void simmed_play_add_utility_stat(SimmedPlay *simmed_play, double utility);
 
 typedef struct SimResults SimResults;
 
+// The per ply stats and heat maps one sim worker collects from its rollouts
+// without locking. The stats of a play are merged into the shared results
+// every SIM_PLY_STATS_MERGE_INTERVAL rollouts of it, and all of them when
+// sim_ply_stats_shard_merge is called at the end of the sim or before a
+// display.
+typedef struct SimPlyStatsShard SimPlyStatsShard;
+
+SimPlyStatsShard *sim_ply_stats_shard_create(void);
+void sim_ply_stats_shard_destroy(SimPlyStatsShard *shard);
+// Sizes the shard for the plays and plies of the reset sim results.
+void sim_ply_stats_shard_reset(SimPlyStatsShard *shard,
+                               const SimResults *sim_results,
+                               bool use_heat_map);
+void sim_ply_stats_shard_add_stats_for_ply(SimPlyStatsShard *shard,
+                                           int play_index, int ply_index,
+                                           const Move *move);
+void sim_ply_stats_shard_finish_rollout(SimPlyStatsShard *shard,
+                                        SimResults *sim_results,
+                                        int play_index);
+void sim_ply_stats_shard_merge(SimPlyStatsShard *shard,
+                               SimResults *sim_results);
+
 SimResults *sim_results_create(const double cutoff);
 SimResults *sim_results_duplicate(const SimResults *sim_results);
 void sim_results_reset(const MoveList *move_list, SimResults *sim_results,
@@ -60,6 +80,8 @@ int sim_results_get_number_of_plays(const SimResults *sim_results);
 int sim_results_get_num_plies(const SimResults *sim_results);
 uint64_t sim_results_get_node_count(const SimResults *sim_results);
 void sim_results_increment_node_count(SimResults *sim_results);
+uint64_t sim_results_get_shared_reply_count(const SimResults *sim_results);
+void sim_results_increment_shared_reply_count(SimResults *sim_results);
 uint64_t sim_results_get_iteration_count(const SimResults *sim_results);
 void sim_results_increment_iteration_count(SimResults *sim_results);
 SimmedPlay *sim_results_get_simmed_play(const SimResults *sim_results,
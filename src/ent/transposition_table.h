@@ -3,6 +3,7 @@
 
 #include "../compat/ctime.h"
 #include "../compat/memory_info.h"
+#include "perf_counters.h"
 #include "zobrist.h"
 #include <assert.h>
 #include <stdatomic.h>
@@ -172,11 +173,13 @@ static inline TTEntry transposition_table_lookup(TranspositionTable *tt,
       // type 2 collision.
       atomic_fetch_add(&tt->t2_collisions, 1);
     }
+    PERF_COUNTER_ADD(PERF_COUNTER_TT_PROBE_HIT, 0);
     TTEntry e;
     ttentry_reset(&e);
     return e;
   }
   atomic_fetch_add(&tt->hits, 1);
+  PERF_COUNTER_ADD(PERF_COUNTER_TT_PROBE_HIT, 1);
   // Assume the same zobrist hash is the same position. If it's not, that's
   // a type 1 collision, which we can't do anything about. It should happen
   // extremely rarely.
@@ -4,14 +4,23 @@
 #include "../util/io_util.h"
 #include "../util/string_util.h"
 #include "data_filepaths.h"
+#include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
+// Spreads are divided by this before the logistic model is applied so that
+// the fitted coefficients are of similar magnitude.
+#define WIN_PCT_LOGISTIC_SPREAD_SCALE 100.0
+#define WIN_PCT_LOGISTIC_MAX_ITERATIONS 50
+#define WIN_PCT_LOGISTIC_TOLERANCE 1e-9
+
 struct WinPct {
   char *name;
-  float **win_pcts;
+  // A single max_tiles_unseen x number_of_spreads array, one row per number
+  // of unseen tiles, so that a lookup is one bounds clamp and one load.
+  float *win_pcts;
   int min_spread;
   int max_spread;
   int number_of_spreads;
@@ -20,8 +29,14 @@ struct WinPct {
 
 const char *win_pct_get_name(const WinPct *wp) { return wp->name; }
 
-float win_pct_get(const WinPct *wp, int spread_plus_leftover,
-                  unsigned int game_unseen_tiles) {
+static inline float *win_pct_get_row(const WinPct *wp,
+                                     unsigned int tiles_unseen_index) {
+  return wp->win_pcts + (size_t)tiles_unseen_index * wp->number_of_spreads;
+}
+
+static inline size_t win_pct_get_index(const WinPct *wp,
+                                       int spread_plus_leftover,
+                                       unsigned int game_unseen_tiles) {
   if (spread_plus_leftover > wp->max_spread) {
     spread_plus_leftover = wp->max_spread;
   }
@@ -37,9 +52,15 @@ float win_pct_get(const WinPct *wp, int spread_plus_leftover,
     log_fatal("cannot get win percentage value for 0 unseen tiles when the "
               "minimum unseen tiles is 1");
   }
-  return wp
-      ->win_pcts[game_unseen_tiles - 1][wp->max_spread + spread_plus_leftover];
-};
+  return (size_t)(game_unseen_tiles - 1) * wp->number_of_spreads +
+         (size_t)(wp->max_spread + spread_plus_leftover);
+}
+
+float win_pct_get(const WinPct *wp, int spread_plus_leftover,
+                  unsigned int game_unseen_tiles) {
+  return wp->win_pcts[win_pct_get_index(wp, spread_plus_leftover,
+                                        game_unseen_tiles)];
+}
 
 void win_pct_create_internal(const char *win_pct_name,
                              const char *win_pct_filename, WinPct *wp,
@@ -56,9 +77,7 @@ void win_pct_create_internal(const char *win_pct_name,
     return;
   }
 
-  // Allocate memory for the 2D array
-  float **array =
-      (float **)malloc_or_die(wp->max_tiles_unseen * sizeof(float *));
+  float *array = NULL;
 
   // Read data lines
   StringSplitter *split_tiles_remaining_row = NULL;
@@ -84,10 +103,9 @@ void win_pct_create_internal(const char *win_pct_name,
       wp->max_spread = num_spreads_in_row / 2;
       wp->min_spread = -wp->max_spread;
       wp->number_of_spreads = num_spreads_in_row;
-      for (unsigned int j = 0; j < wp->max_tiles_unseen; j++) {
-        array[j] =
-            (float *)malloc_or_die(wp->number_of_spreads * sizeof(float));
-      }
+      array = (float *)malloc_or_die((size_t)wp->max_tiles_unseen *
+                                     wp->number_of_spreads * sizeof(float));
+      wp->win_pcts = array;
     } else if (num_spreads_in_row != wp->number_of_spreads) {
       error_stack_push(
           error_stack, ERROR_STATUS_WIN_PCT_INVALID_NUMBER_OF_COLUMNS,
@@ -122,7 +140,8 @@ void win_pct_create_internal(const char *win_pct_name,
                 tiles_unseen_index + 1));
         break;
       }
-      memcpy(array[tiles_unseen_index], array[prev_nonzero_total_games_index],
+      memcpy(win_pct_get_row(wp, tiles_unseen_index),
+             win_pct_get_row(wp, prev_nonzero_total_games_index),
              num_spreads_in_row * sizeof(float));
     } else {
       for (int spread_index = 0; spread_index < num_spreads_in_row;
@@ -142,7 +161,7 @@ void win_pct_create_internal(const char *win_pct_name,
                   tiles_unseen_index + 1));
           break;
         }
-        array[tiles_unseen_index][spread_index] =
+        win_pct_get_row(wp, tiles_unseen_index)[spread_index] =
             (float)total_win_score /
             (float)(total_games_for_tiles_remaining * 2);
       }
@@ -152,20 +171,78 @@ void win_pct_create_internal(const char *win_pct_name,
     split_tiles_remaining_row = NULL;
   }
   string_splitter_destroy(split_tiles_remaining_row);
-  wp->win_pcts = array;
   wp->name = string_duplicate(win_pct_name);
 }
 
-// Function to free the memory allocated for the 2D array
+// Fits win% = 1 / (1 + exp(-(intercept + slope * x))), where x is the
+// scaled spread, to one row of the table with Newton's method on the cross
+// entropy, weighting every spread equally. Rows that are (almost) perfectly
+// separated, such as the one for a single unseen tile, stop once the
+// Hessian becomes singular, which leaves a steep but finite slope.
+static void win_pct_fit_logistic_row(const WinPct *wp, const float *row,
+                                     double *intercept, double *slope) {
+  double a = 0.0;
+  double b = 1.0;
+  for (int iteration = 0; iteration < WIN_PCT_LOGISTIC_MAX_ITERATIONS;
+       iteration++) {
+    double grad_a = 0.0;
+    double grad_b = 0.0;
+    double h_aa = 0.0;
+    double h_ab = 0.0;
+    double h_bb = 0.0;
+    for (int spread_index = 0; spread_index < wp->number_of_spreads;
+         spread_index++) {
+      const double x = (wp->min_spread + spread_index) /
+                       WIN_PCT_LOGISTIC_SPREAD_SCALE;
+      const double p = 1.0 / (1.0 + exp(-(a + b * x)));
+      const double residual = p - row[spread_index];
+      const double weight = p * (1.0 - p);
+      grad_a += residual;
+      grad_b += residual * x;
+      h_aa += weight;
+      h_ab += weight * x;
+      h_bb += weight * x * x;
+    }
+    const double det = h_aa * h_bb - h_ab * h_ab;
+    if (det < WIN_PCT_LOGISTIC_TOLERANCE) {
+      break;
+    }
+    const double step_a = (h_bb * grad_a - h_ab * grad_b) / det;
+    const double step_b = (h_aa * grad_b - h_ab * grad_a) / det;
+    a -= step_a;
+    b -= step_b;
+    if (fabs(step_a) + fabs(step_b) < WIN_PCT_LOGISTIC_TOLERANCE) {
+      break;
+    }
+  }
+  *intercept = a;
+  *slope = b;
+}
+
+// Replaces every row of the table with the values of a logistic model fitted
+// to it. The model is smooth and monotone in the spread, unlike the sampled
+// table, which is noisy where few games were observed. The values are
+// tabulated so that lookups cost the same as for the sampled table.
+static void win_pct_apply_logistic_model(WinPct *wp) {
+  for (unsigned int tiles_unseen_index = 0;
+       tiles_unseen_index < wp->max_tiles_unseen; tiles_unseen_index++) {
+    float *row = win_pct_get_row(wp, tiles_unseen_index);
+    double intercept;
+    double slope;
+    win_pct_fit_logistic_row(wp, row, &intercept, &slope);
+    for (int spread_index = 0; spread_index < wp->number_of_spreads;
+         spread_index++) {
+      const double x = (wp->min_spread + spread_index) /
+                       WIN_PCT_LOGISTIC_SPREAD_SCALE;
+      row[spread_index] = (float)(1.0 / (1.0 + exp(-(intercept + slope * x))));
+    }
+  }
+}
+
 void win_pct_destroy(WinPct *wp) {
   if (!wp) {
     return;
   }
-  if (wp->win_pcts) {
-    for (unsigned int i = 0; i < wp->max_tiles_unseen; i++) {
-      free(wp->win_pcts[i]);
-    }
-  }
   free(wp->name);
   free(wp->win_pcts);
   free(wp);
@@ -173,8 +250,19 @@ void win_pct_destroy(WinPct *wp) {
 
 WinPct *win_pct_create(const char *data_paths, const char *win_pct_name,
                        ErrorStack *error_stack) {
+  // The logistic flavor of a table is fitted to the table of the same name
+  // without the suffix.
+  const bool use_logistic_model =
+      has_suffix(WIN_PCT_LOGISTIC_SUFFIX, win_pct_name);
+  char *win_pct_data_name =
+      use_logistic_model
+          ? get_substring(win_pct_name, 0,
+                          (int)(string_length(win_pct_name) -
+                                string_length(WIN_PCT_LOGISTIC_SUFFIX)))
+          : string_duplicate(win_pct_name);
   char *win_pct_filename = data_filepaths_get_readable_filename(
-      data_paths, win_pct_name, DATA_FILEPATH_TYPE_WIN_PCT, error_stack);
+      data_paths, win_pct_data_name, DATA_FILEPATH_TYPE_WIN_PCT, error_stack);
+  free(win_pct_data_name);
   WinPct *wp = NULL;
   if (error_stack_is_empty(error_stack)) {
     char *file_contents =
@@ -195,6 +283,8 @@ WinPct *win_pct_create(const char *data_paths, const char *win_pct_name,
   if (!error_stack_is_empty(error_stack)) {
     win_pct_destroy(wp);
     wp = NULL;
+  } else if (use_logistic_model) {
+    win_pct_apply_logistic_model(wp);
   }
   return wp;
 }
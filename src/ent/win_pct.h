@@ -6,6 +6,11 @@
 
 typedef struct WinPct WinPct;
 
+// Appending this suffix to the name of a win percentage table selects a
+// logistic model fitted to each row of that table instead of the sampled
+// values.
+#define WIN_PCT_LOGISTIC_SUFFIX ".logistic"
+
 WinPct *win_pct_create(const char *data_paths, const char *win_pct_name,
                        ErrorStack *error_stack);
 void win_pct_destroy(WinPct *wp);
@@ -38,8 +38,10 @@
 #include "../util/string_util.h"
 #include "gameplay.h"
 #include "play_chooser.h"
+#include "rack_info_table_maker.h"
 #include "rack_list.h"
 #include "simmer.h"
+#include "thread_pool.h"
 #include <math.h>
 #include <stdatomic.h>
 #include <stdbool.h>
@@ -102,6 +104,11 @@ typedef struct LeavegenSharedData {
   const LetterDistribution *ld;
   const char *data_paths;
   KLV *klv;
+  // Rack info tables in use by the players, if any. Their leave data is
+  // refilled from the KLV after every generation so movegen keeps seeing
+  // the current leaves. rits[1] is NULL when both players share a table.
+  RackInfoTable *rits[2];
+  const WMP *rit_wmps[2];
   RackList *rack_list;
   // Whether each generation should also dump rack_list's
   // "<rack>,<count>,<mean>" data to a CSV (see rack_list_write_rack_equity_
@@ -189,6 +196,14 @@ void postgen_prebroadcast_func(void *data) {
   LeavegenSharedData *lg_shared_data = shared_data->leavegen_shared_data;
   rack_list_write_to_klv(lg_shared_data->rack_list, lg_shared_data->ld,
                          lg_shared_data->klv);
+  for (int player_index = 0; player_index < 2; player_index++) {
+    if (lg_shared_data->rits[player_index]) {
+      rack_info_table_refill_leaves(
+          lg_shared_data->rits[player_index], lg_shared_data->klv,
+          lg_shared_data->rit_wmps[player_index], lg_shared_data->ld,
+          shared_data->num_threads);
+    }
+  }
   lg_shared_data->gens_completed++;
 
   // Write the KLV for the current generation.
@@ -422,15 +437,25 @@ void autoplay_worker_destroy(AutoplayWorker *autoplay_worker) {
 LeavegenSharedData *leavegen_shared_data_create(
     AutoplayResults *primary_autoplay_results,
     AutoplayResults **autoplay_results_list, const LetterDistribution *ld,
-    const char *data_paths, KLV *klv, int number_of_threads, int num_gens,
-    int *min_rack_targets, const char *forced_racks_filename,
-    bool write_rack_equity_csv, ErrorStack *error_stack) {
+    const char *data_paths, const PlayersData *players_data, KLV *klv,
+    int number_of_threads, int num_gens, int *min_rack_targets,
+    const char *forced_racks_filename, bool write_rack_equity_csv,
+    ErrorStack *error_stack) {
   LeavegenSharedData *shared_data = malloc_or_die(sizeof(LeavegenSharedData));
 
   shared_data->num_gens = num_gens;
   shared_data->gens_completed = 0;
   shared_data->gen_start_games = 0;
   shared_data->klv = klv;
+  for (int player_index = 0; player_index < 2; player_index++) {
+    shared_data->rits[player_index] =
+        players_data_get_rack_info_table(players_data, player_index);
+    shared_data->rit_wmps[player_index] =
+        players_data_get_wmp(players_data, player_index);
+  }
+  if (shared_data->rits[1] == shared_data->rits[0]) {
+    shared_data->rits[1] = NULL;
+  }
   shared_data->gen_autoplay_results =
       autoplay_results_create_empty_copy(primary_autoplay_results);
   shared_data->primary_autoplay_results = primary_autoplay_results;
@@ -479,7 +504,8 @@ autoplay_shared_data_create(const AutoplayArgs *args, int num_autoplay_threads,
   if (klv) {
     shared_data->leavegen_shared_data = leavegen_shared_data_create(
         primary_autoplay_results, autoplay_results_list, args->game_args->ld,
-        args->data_paths, klv, num_autoplay_threads, num_gens, min_rack_targets,
+        args->data_paths, args->game_args->players_data, klv,
+        num_autoplay_threads, num_gens, min_rack_targets,
         forced_racks_filename, args->write_rack_equity_csv, error_stack);
     if (!error_stack_is_empty(error_stack)) {
       prng_destroy(shared_data->prng);
@@ -1169,10 +1195,27 @@ void autoplay(const AutoplayArgs *args, AutoplayResults *autoplay_results,
 
   KLV *klv = NULL;
   bool show_divergent_results = args->use_game_pairs;
+  PlayersData *players_data = args->game_args->players_data;
+  if (is_leavegen_mode && players_data_get_share_loaded_data(players_data)) {
+    // Leavegen writes the KLV and refills the RITs in place, so it gets
+    // its own copies instead of the ones shared with other configs.
+    players_data_reload(players_data, PLAYERS_DATA_TYPE_KLV, args->data_paths,
+                        error_stack);
+    if (error_stack_is_empty(error_stack) &&
+        (players_data_get_rack_info_table(players_data, 0) ||
+         players_data_get_rack_info_table(players_data, 1))) {
+      players_data_reload(players_data, PLAYERS_DATA_TYPE_RIT,
+                          args->data_paths, error_stack);
+    }
+    if (!error_stack_is_empty(error_stack)) {
+      free(min_rack_targets);
+      return;
+    }
+  }
   if (is_leavegen_mode) {
     // We can use player index 0 here since it is guaranteed that
     // players share the the KLV.
-    klv = players_data_get_klv(args->game_args->players_data, 0);
+    klv = players_data_get_klv(players_data, 0);
     show_divergent_results = false;
   }
 
@@ -1193,8 +1236,8 @@ void autoplay(const AutoplayArgs *args, AutoplayResults *autoplay_results,
 
   AutoplayWorker **autoplay_workers =
       malloc_or_die((sizeof(AutoplayWorker *)) * (autoplay_num_threads));
-  cpthread_t *worker_ids =
-      malloc_or_die((sizeof(cpthread_t)) * (autoplay_num_threads));
+  ThreadPoolThread **worker_ids =
+      malloc_or_die((sizeof(ThreadPoolThread *)) * (autoplay_num_threads));
 
   for (int thread_index = 0; thread_index < autoplay_num_threads;
        thread_index++) {
@@ -1202,8 +1245,8 @@ void autoplay(const AutoplayArgs *args, AutoplayResults *autoplay_results,
         args, autoplay_results, thread_index, shared_data);
     autoplay_results_list[thread_index] =
         autoplay_workers[thread_index]->autoplay_results;
-    cpthread_create(&worker_ids[thread_index], autoplay_worker,
-                    autoplay_workers[thread_index]);
+    worker_ids[thread_index] =
+        thread_pool_start(autoplay_worker, autoplay_workers[thread_index]);
   }
 
   autoplay_results_set_status_data(
@@ -1212,7 +1255,7 @@ void autoplay(const AutoplayArgs *args, AutoplayResults *autoplay_results,
 
   for (int thread_index = 0; thread_index < autoplay_num_threads;
        thread_index++) {
-    cpthread_join(worker_ids[thread_index]);
+    thread_pool_join(worker_ids[thread_index]);
   }
 
   // The stats have already been combined in leavegen mode
@@ -1237,10 +1280,27 @@ void autoplay(const AutoplayArgs *args, AutoplayResults *autoplay_results,
   autoplay_shared_data_destroy(shared_data);
   free(min_rack_targets);
 
-  // Only reload KLV if it was modified during leavegen
+  // Only reload KLV if it was modified during leavegen. Any rack info table
+  // had its leaves refilled from the generated KLVs, so refill it again from
+  // the reloaded KLV rather than trusting its file to match.
   if (is_leavegen_mode) {
-    players_data_reload(args->game_args->players_data, PLAYERS_DATA_TYPE_KLV,
-                        args->data_paths, error_stack);
+    players_data_reload(players_data, PLAYERS_DATA_TYPE_KLV, args->data_paths,
+                        error_stack);
+    for (int player_index = 0; player_index < 2; player_index++) {
+      if (!error_stack_is_empty(error_stack)) {
+        break;
+      }
+      RackInfoTable *rit =
+          players_data_get_rack_info_table(players_data, player_index);
+      if (!rit || (player_index == 1 &&
+                   rit == players_data_get_rack_info_table(players_data, 0))) {
+        continue;
+      }
+      rack_info_table_refill_leaves(
+          rit, players_data_get_klv(players_data, player_index),
+          players_data_get_wmp(players_data, player_index),
+          args->game_args->ld, autoplay_num_threads);
+    }
   }
 
   char *autoplay_results_string = autoplay_results_to_string(
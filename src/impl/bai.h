@@ -20,11 +20,13 @@
 #include "../def/thread_control_defs.h"
 #include "../ent/bai_result.h"
 #include "../ent/checkpoint.h"
+#include "../ent/perf_counters.h"
 #include "../ent/thread_control.h"
 #include "../ent/win_pct.h"
 #include "../util/io_util.h"
 #include "bai_logger.h"
 #include "random_variable.h"
+#include "thread_pool.h"
 #include <assert.h>
 #include <limits.h>
 #include <stdbool.h>
@@ -508,11 +510,15 @@ static inline void bai_worker_sample_loop(BAIWorkerArgs *bai_worker_args) {
   };
 
   while (!bai_should_stop(sync_data->bai_result, thread_control)) {
+    PERF_TIMER_START(next_arm_start);
     const int arm_index = bai_sync_data_get_next_sample_index(&sample_args);
+    PERF_TIMER_STOP(PERF_COUNTER_BAI_NEXT_ARM, next_arm_start);
     if (arm_index < 0) {
       break;
     }
+    PERF_TIMER_START(sample_start);
     double sample = rvs_sample(rvs, arm_index, rvs_thread_index, NULL);
+    PERF_TIMER_STOP(PERF_COUNTER_BAI_SAMPLE, sample_start);
     bai_sync_data_add_sample(&sample_args, arm_index, sample);
   }
 }
@@ -560,20 +566,20 @@ static inline void bai(const BAIOptions *bai_options, RandomVariables *rvs,
       .avoid_prune_checkpoint = avoid_prune_checkpoint,
   };
 
-  cpthread_t *worker_ids =
-      malloc_or_die((sizeof(cpthread_t)) * bai_options->num_threads);
+  ThreadPoolThread **worker_ids =
+      malloc_or_die((sizeof(ThreadPoolThread *)) * bai_options->num_threads);
   BAIWorkerArgs *bai_worker_args_array =
       malloc_or_die((sizeof(BAIWorkerArgs)) * bai_options->num_threads);
   for (int thread_index = 0; thread_index < bai_options->num_threads;
        thread_index++) {
     bai_worker_args_array[thread_index] = bai_worker_args;
     bai_worker_args_array[thread_index].thread_index = thread_index;
-    cpthread_create(&worker_ids[thread_index], bai_worker,
-                    &bai_worker_args_array[thread_index]);
+    worker_ids[thread_index] =
+        thread_pool_start(bai_worker, &bai_worker_args_array[thread_index]);
   }
   for (int thread_index = 0; thread_index < bai_options->num_threads;
        thread_index++) {
-    cpthread_join(worker_ids[thread_index]);
+    thread_pool_join(worker_ids[thread_index]);
   }
   bai_result_set_best_arm(bai_result, sync_data->astar_index);
   bai_result_stop_timer(bai_result);
@@ -19,24 +19,30 @@
 #include "../util/string_util.h"
 #include <ctype.h>
 #include <stdlib.h>
+#include <string.h>
+
+// The CGP is parsed from a single copy whose fields, rows and racks are
+// terminated in place, so parsing allocates nothing per field.
 
 void place_letters_on_board(const Game *game, const char *letters,
                             int row_start, int *current_column_index,
                             ErrorStack *error_stack) {
-  size_t letters_length = string_length(letters);
-  MachineLetter *machine_letters =
-      malloc_or_die(sizeof(MachineLetter) * letters_length);
+  MachineLetter machine_letters[BOARD_DIM];
   const LetterDistribution *ld = game_get_ld(game);
   Bag *bag = game_get_bag(game);
   Board *board = game_get_board(game);
   int number_of_machine_letters =
-      ld_str_to_mls(ld, letters, false, machine_letters, letters_length);
+      ld_str_to_mls(ld, letters, false, machine_letters, BOARD_DIM);
   int col_start = *current_column_index;
 
   if (number_of_machine_letters < 0) {
     error_stack_push(
         error_stack, ERROR_STATUS_CGP_PARSE_MALFORMED_BOARD_LETTERS,
         get_formatted_string("failed to parse letters for cgp: %s", letters));
+  } else if (col_start + number_of_machine_letters > BOARD_DIM) {
+    error_stack_push(
+        error_stack, ERROR_STATUS_CGP_PARSE_INVALID_NUMBER_OF_BOARD_COLUMNS,
+        string_duplicate("cgp board has an invalid number of columns"));
   } else {
     for (int i = 0; i < number_of_machine_letters; i++) {
       board_set_letter(board, row_start, col_start + i, machine_letters[i]);
@@ -58,45 +64,61 @@ void place_letters_on_board(const Game *game, const char *letters,
     }
     *current_column_index = *current_column_index + number_of_machine_letters;
   }
-  free(machine_letters);
 }
 
-void parse_cgp_board_row(const Game *game, const char *cgp_board_row,
-                         int row_index, ErrorStack *error_stack) {
-  StringBuilder *tile_string_builder = string_builder_create();
-  size_t row_length = string_length(cgp_board_row);
+// Places the letters of the row from letters_start up to letters_end,
+// terminating them in place only for the duration of the call.
+static void place_row_letters_on_board(const Game *game, char *letters_start,
+                                       char *letters_end, int row_index,
+                                       int *current_column_index,
+                                       ErrorStack *error_stack) {
+  const char replaced_char = *letters_end;
+  *letters_end = '\0';
+  place_letters_on_board(game, letters_start, row_index, current_column_index,
+                         error_stack);
+  *letters_end = replaced_char;
+}
 
+void parse_cgp_board_row(const Game *game, char *cgp_board_row, int row_index,
+                         ErrorStack *error_stack) {
+  char *letters_start = NULL;
   int current_row_number_of_spaces = 0;
   int current_column_index = 0;
-  for (size_t i = 0; i < row_length; i++) {
-    char current_char = cgp_board_row[i];
-    if (isdigit(current_char)) {
+  char *current_char = cgp_board_row;
+  for (; *current_char != '\0'; current_char++) {
+    if (isdigit((unsigned char)*current_char)) {
       current_row_number_of_spaces =
-          (current_row_number_of_spaces * 10) + (current_char - '0');
-      if (string_builder_length(tile_string_builder) > 0) {
-        place_letters_on_board(game, string_builder_peek(tile_string_builder),
-                               row_index, &current_column_index, error_stack);
-        string_builder_clear(tile_string_builder);
+          (current_row_number_of_spaces * 10) + (*current_char - '0');
+      if (letters_start) {
+        place_row_letters_on_board(game, letters_start, current_char,
+                                   row_index, &current_column_index,
+                                   error_stack);
+        letters_start = NULL;
         if (!error_stack_is_empty(error_stack)) {
           break;
         }
       }
     } else {
-      if (i == 0 || current_row_number_of_spaces > 0) {
+      if (current_char == cgp_board_row || current_row_number_of_spaces > 0) {
         current_column_index += current_row_number_of_spaces;
         current_row_number_of_spaces = 0;
       }
-      string_builder_add_char(tile_string_builder, current_char);
+      if (!letters_start) {
+        letters_start = current_char;
+      }
     }
   }
 
-  if (string_builder_length(tile_string_builder) > 0) {
-    place_letters_on_board(game, string_builder_peek(tile_string_builder),
-                           row_index, &current_column_index, error_stack);
+  if (!error_stack_is_empty(error_stack)) {
+    return;
+  }
+
+  if (letters_start) {
+    place_row_letters_on_board(game, letters_start, current_char, row_index,
+                               &current_column_index, error_stack);
   } else {
     current_column_index += current_row_number_of_spaces;
   }
-  string_builder_destroy(tile_string_builder);
 
   if (current_column_index != BOARD_DIM && error_stack_is_empty(error_stack)) {
     error_stack_push(
@@ -106,40 +128,83 @@ void parse_cgp_board_row(const Game *game, const char *cgp_board_row,
   }
 }
 
-void parse_cgp_board(const Game *game, const char *cgp_board,
+// Terminates the next nonempty row in place and returns it, or NULL if
+// there are no rows left. Empty rows are skipped.
+static char *next_cgp_board_row(char **cursor) {
+  while (**cursor == '/') {
+    (*cursor)++;
+  }
+  if (**cursor == '\0') {
+    return NULL;
+  }
+  char *row = *cursor;
+  char *row_end = strchr(row, '/');
+  if (row_end) {
+    *row_end = '\0';
+    *cursor = row_end + 1;
+  } else {
+    *cursor = row + string_length(row);
+  }
+  return row;
+}
+
+void parse_cgp_board(const Game *game, char *cgp_board,
                      ErrorStack *error_stack) {
-  StringSplitter *board_rows = split_string(cgp_board, '/', true);
+  int number_of_rows = 0;
+  for (const char *c = cgp_board; *c != '\0'; c++) {
+    if (*c != '/' && (c == cgp_board || *(c - 1) == '/')) {
+      number_of_rows++;
+    }
+  }
 
-  if (string_splitter_get_number_of_items(board_rows) != BOARD_DIM) {
+  if (number_of_rows != BOARD_DIM) {
     error_stack_push(
         error_stack, ERROR_STATUS_CGP_PARSE_INVALID_NUMBER_OF_BOARD_ROWS,
         get_formatted_string("cgp board has an invalid number of rows: %d",
-                             string_splitter_get_number_of_items(board_rows)));
-  } else {
-    for (int i = 0; i < BOARD_DIM; i++) {
-      parse_cgp_board_row(game, string_splitter_get_item(board_rows, i), i,
-                          error_stack);
-      if (!error_stack_is_empty(error_stack)) {
-        break;
-      }
+                             number_of_rows));
+    return;
+  }
+  char *cursor = cgp_board;
+  for (int i = 0; i < BOARD_DIM; i++) {
+    parse_cgp_board_row(game, next_cgp_board_row(&cursor), i, error_stack);
+    if (!error_stack_is_empty(error_stack)) {
+      break;
     }
   }
-  string_splitter_destroy(board_rows);
 }
 
-void parse_cgp_racks_with_string_splitter(const StringSplitter *player_racks,
-                                          const Game *game,
-                                          ErrorStack *error_stack) {
+// Splits a field of exactly two '/' separated parts, either of which may be
+// empty, by terminating the first part in place. Returns false if the field
+// does not have exactly two parts.
+static bool split_cgp_player_pair(char *cgp_field, char **parts) {
+  char *separator = strchr(cgp_field, '/');
+  if (!separator || strchr(separator + 1, '/')) {
+    return false;
+  }
+  *separator = '\0';
+  parts[0] = cgp_field;
+  parts[1] = separator + 1;
+  return true;
+}
+
+void parse_cgp_racks(const Game *game, char *cgp_racks,
+                     ErrorStack *error_stack) {
+  char *player_racks[2];
+  if (!split_cgp_player_pair(cgp_racks, player_racks)) {
+    error_stack_push(error_stack,
+                     ERROR_STATUS_CGP_PARSE_INVALID_NUMBER_OF_PLAYER_RACKS,
+                     get_formatted_string(
+                         "cgp has an invalid number of racks: %s", cgp_racks));
+    return;
+  }
   for (int player_index = 0; player_index < 2; player_index++) {
     int number_of_letters_added = draw_rack_string_from_bag(
-        game, player_index,
-        string_splitter_get_item(player_racks, player_index));
+        game, player_index, player_racks[player_index]);
     if (number_of_letters_added == -1) {
       error_stack_push(
           error_stack, ERROR_STATUS_CGP_PARSE_MALFORMED_RACK_LETTERS,
-          get_formatted_string(
-              "failed to parse rack for player %d: %s", player_index + 1,
-              string_splitter_get_item(player_racks, player_index)));
+          get_formatted_string("failed to parse rack for player %d: %s",
+                               player_index + 1, player_racks[player_index]));
       return;
     }
     if (number_of_letters_added == -2) {
@@ -147,52 +212,34 @@ void parse_cgp_racks_with_string_splitter(const StringSplitter *player_racks,
           error_stack, ERROR_STATUS_CGP_PARSE_RACK_LETTERS_NOT_IN_BAG,
           get_formatted_string(
               "rack not available in the bag for player %d: %s",
-              player_index + 1,
-              string_splitter_get_item(player_racks, player_index)));
+              player_index + 1, player_racks[player_index]));
       return;
     }
   }
 }
 
-void parse_cgp_racks(const Game *game, const char *cgp_racks,
-                     ErrorStack *error_stack) {
-  StringSplitter *player_racks = split_string(cgp_racks, '/', false);
-  if (string_splitter_get_number_of_items(player_racks) != 2) {
-    error_stack_push(error_stack,
-                     ERROR_STATUS_CGP_PARSE_INVALID_NUMBER_OF_PLAYER_RACKS,
-                     get_formatted_string(
-                         "cgp has an invalid number of racks: %s", cgp_racks));
-  } else {
-    parse_cgp_racks_with_string_splitter(player_racks, game, error_stack);
-  }
-  string_splitter_destroy(player_racks);
-}
-
-void parse_cgp_scores(const Game *game, const char *cgp_scores,
+void parse_cgp_scores(const Game *game, char *cgp_scores,
                       ErrorStack *error_stack) {
-  StringSplitter *player_scores = split_string(cgp_scores, '/', false);
-  if (string_splitter_get_number_of_items(player_scores) != 2) {
+  char *player_scores[2];
+  if (!split_cgp_player_pair(cgp_scores, player_scores)) {
     error_stack_push(error_stack,
                      ERROR_STATUS_CGP_PARSE_INVALID_NUMBER_OF_PLAYER_SCORES,
                      get_formatted_string(
                          "cgp has an invalid number of score: %s", cgp_scores));
-  } else {
-    for (int player_index = 0; player_index < 2; player_index++) {
-      int player_score = string_to_int(
-          string_splitter_get_item(player_scores, player_index), error_stack);
-      if (!error_stack_is_empty(error_stack)) {
-        error_stack_push(
-            error_stack, ERROR_STATUS_CGP_PARSE_MALFORMED_SCORES,
-            get_formatted_string(
-                "cgp has invalid score for player %d: %s", player_index + 1,
-                string_splitter_get_item(player_scores, player_index)));
-        break;
-      }
-      player_set_score(game_get_player(game, player_index),
-                       int_to_equity(player_score));
+    return;
+  }
+  for (int player_index = 0; player_index < 2; player_index++) {
+    int player_score = string_to_int(player_scores[player_index], error_stack);
+    if (!error_stack_is_empty(error_stack)) {
+      error_stack_push(
+          error_stack, ERROR_STATUS_CGP_PARSE_MALFORMED_SCORES,
+          get_formatted_string("cgp has invalid score for player %d: %s",
+                               player_index + 1, player_scores[player_index]));
+      break;
     }
+    player_set_score(game_get_player(game, player_index),
+                     int_to_equity(player_score));
   }
-  string_splitter_destroy(player_scores);
 }
 
 void parse_cgp_consecutive_zeros(Game *game, const char *cgp_consecutive_zeros,
@@ -218,38 +265,69 @@ void parse_cgp_consecutive_zeros(Game *game, const char *cgp_consecutive_zeros,
   game_set_consecutive_scoreless_turns(game, consecutive_zeros_int);
 }
 
-void parse_cgp_with_cgp_fields(const StringSplitter *cgp_fields, Game *game,
+enum { NUMBER_OF_REQUIRED_CGP_FIELDS = 4 };
+
+// Terminates the next whitespace separated field in place and returns it,
+// or NULL if there are no fields left.
+static char *next_cgp_field(char **cursor) {
+  char *field = *cursor;
+  while (*field != '\0' && isspace((unsigned char)*field)) {
+    field++;
+  }
+  if (*field == '\0') {
+    *cursor = field;
+    return NULL;
+  }
+  char *field_end = field;
+  while (*field_end != '\0' && !isspace((unsigned char)*field_end)) {
+    field_end++;
+  }
+  *cursor = field_end;
+  if (*field_end != '\0') {
+    *field_end = '\0';
+    (*cursor)++;
+  }
+  return field;
+}
+
+void parse_cgp_with_cgp_fields(char **cgp_fields, Game *game,
                                ErrorStack *error_stack) {
-  parse_cgp_board(game, string_splitter_get_item(cgp_fields, 0), error_stack);
+  parse_cgp_board(game, cgp_fields[0], error_stack);
   if (!error_stack_is_empty(error_stack)) {
     return;
   }
 
-  parse_cgp_racks(game, string_splitter_get_item(cgp_fields, 1), error_stack);
+  parse_cgp_racks(game, cgp_fields[1], error_stack);
   if (!error_stack_is_empty(error_stack)) {
     return;
   }
 
-  parse_cgp_scores(game, string_splitter_get_item(cgp_fields, 2), error_stack);
+  parse_cgp_scores(game, cgp_fields[2], error_stack);
   if (!error_stack_is_empty(error_stack)) {
     return;
   }
 
-  parse_cgp_consecutive_zeros(game, string_splitter_get_item(cgp_fields, 3),
-                              error_stack);
+  parse_cgp_consecutive_zeros(game, cgp_fields[3], error_stack);
 }
 
 void parse_cgp(Game *game, const char *cgp, ErrorStack *error_stack) {
-  StringSplitter *cgp_fields = split_string_by_whitespace(cgp, true);
+  char *cgp_copy = string_duplicate(cgp);
+  char *cursor = cgp_copy;
+  char *cgp_fields[NUMBER_OF_REQUIRED_CGP_FIELDS];
+  int number_of_fields = 0;
+  while (number_of_fields < NUMBER_OF_REQUIRED_CGP_FIELDS &&
+         (cgp_fields[number_of_fields] = next_cgp_field(&cursor)) != NULL) {
+    number_of_fields++;
+  }
 
-  if (string_splitter_get_number_of_items(cgp_fields) < 4) {
+  if (number_of_fields < NUMBER_OF_REQUIRED_CGP_FIELDS) {
     error_stack_push(error_stack,
                      ERROR_STATUS_CGP_PARSE_MISSING_REQUIRED_FIELDS,
                      string_duplicate("cgp does not have exactly four fields"));
   } else {
     parse_cgp_with_cgp_fields(cgp_fields, game, error_stack);
   }
-  string_splitter_destroy(cgp_fields);
+  free(cgp_copy);
 }
 
 void game_load_cgp(Game *game, const char *cgp, ErrorStack *error_stack) {
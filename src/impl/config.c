@@ -34,6 +34,8 @@
 #include "../ent/klv_csv.h"
 #include "../ent/letter_distribution.h"
 #include "../ent/move.h"
+#include "../ent/opening_table.h"
+#include "../ent/perf_counters.h"
 #include "../ent/player.h"
 #include "../ent/players_data.h"
 #include "../ent/rack.h"
@@ -60,12 +62,15 @@
 #include "endgame.h"
 #include "gameplay.h"
 #include "gcg.h"
+#include "gcg_corpus.h"
 #include "get_gcg.h"
 #include "inference.h"
 #include "move_gen.h"
+#include "opening_table_maker.h"
 #include "peg.h"
 #include "play_chooser.h"
 #include "simmer.h"
+#include "thread_pool.h"
 #include <assert.h>
 #include <ctype.h>
 #include <float.h>
@@ -120,6 +125,7 @@ typedef enum {
   ARG_TOKEN_USE_WMP,
   ARG_TOKEN_USE_RIT,
   ARG_TOKEN_USE_MMAP_FOR_RIT,
+  ARG_TOKEN_USE_OPENING_TABLE,
   ARG_TOKEN_LEAVES,
   ARG_TOKEN_P1_LEXICON,
   ARG_TOKEN_P1_USE_WMP,
@@ -140,6 +146,7 @@ typedef enum {
   ARG_TOKEN_ENDGAME_PLIES,
   ARG_TOKEN_ENDGAME_TOP_K,
   ARG_TOKEN_ENDGAME_TIME_LIMIT,
+  ARG_TOKEN_ENDGAME_TB_MAX_TILES,
   ARG_TOKEN_PEG_TOP_K,
   ARG_TOKEN_PEG_TIME_LIMIT,
   ARG_TOKEN_PEG_STRIDE,
@@ -162,11 +169,15 @@ typedef enum {
   ARG_TOKEN_USE_SMALL_PLAYS,
   ARG_TOKEN_SIM_WITH_INFERENCE,
   ARG_TOKEN_USE_HEAT_MAP,
+  ARG_TOKEN_PLY_STATS_RATE,
+  ARG_TOKEN_SIM_SHARE_ROLLOUTS,
   ARG_TOKEN_WRITE_BUFFER_SIZE,
   ARG_TOKEN_HUMAN_READABLE,
   ARG_TOKEN_SHOW_MISTAKES,
   ARG_TOKEN_RANDOM_SEED,
   ARG_TOKEN_NUMBER_OF_THREADS,
+  ARG_TOKEN_MOVEGEN_THREADS,
+  ARG_TOKEN_PIN_THREADS,
   ARG_TOKEN_PRINT_INTERVAL,
   ARG_TOKEN_EXEC_MODE,
   ARG_TOKEN_TT_FRACTION_OF_MEM,
@@ -246,6 +257,8 @@ typedef enum {
   ARG_TOKEN_ANALYZE,
   ARG_TOKEN_VERSION,
   ARG_TOKEN_WRITE_RACK_EQUITY_CSV,
+  ARG_TOKEN_WMP_MAX_MEMORY,
+  ARG_TOKEN_STATS,
   // This must always be the last
   // token for the count to be accurate
   NUMBER_OF_ARG_TOKENS
@@ -342,6 +355,7 @@ struct Config {
   int shplies;
   int endgame_plies;
   int endgame_top_k;
+  int endgame_tablebase_max_tiles;
   // PEG scenario-sampling stride (halving stages, bag >= 3). 0 = solver
   // default.
   int peg_num_stages;
@@ -355,6 +369,8 @@ struct Config {
   Equity eq_margin_inference;
   Equity eq_margin_movegen;
   int num_threads;
+  int movegen_threads;
+  bool pin_threads;
   int print_interval;
   bai_sampling_rule_t sampling_rule;
   bai_threshold_t threshold;
@@ -391,6 +407,8 @@ struct Config {
   bool use_small_plays;
   bool sim_with_inference;
   bool use_heat_map;
+  int ply_stats_rate;
+  bool sim_share_rollouts;
   bool print_boards;
   bool print_on_finish;
   bool show_game_with_moves;
@@ -405,6 +423,9 @@ struct Config {
   // rack_list_write_rack_equity_csv). Independent of whether a
   // forceracksfile restriction is in use.
   bool write_rack_equity_csv;
+  // Megabytes of scratch the wordmap builder may use before spilling sorted
+  // runs to temporary files. 0 = unbounded (fully in memory).
+  int wmp_max_memory_mb;
   bool p1_sim_with_inference;
   bool p2_sim_with_inference;
   // Set when the most recent sim ran inference internally and it completed
@@ -540,6 +561,10 @@ int config_get_endgame_plies(const Config *config) {
   return config->endgame_plies;
 }
 
+int config_get_endgame_tablebase_max_tiles(const Config *config) {
+  return config->endgame_tablebase_max_tiles;
+}
+
 uint64_t config_get_max_iterations(const Config *config) {
   return config->max_iterations;
 }
@@ -674,6 +699,10 @@ const char *config_get_settings_filename(const Config *config) {
 
 int config_get_num_threads(const Config *config) { return config->num_threads; }
 
+void config_set_num_threads(Config *config, int num_threads) {
+  config->num_threads = num_threads;
+}
+
 int config_get_print_interval(const Config *config) {
   return config->print_interval;
 }
@@ -960,6 +989,33 @@ char *str_api_version(Config __attribute__((unused)) * config,
   return string_duplicate(MAGPIE_VERSION "\n");
 }
 
+char *impl_stats(Config *config, ErrorStack *error_stack) {
+  const char *stats_arg = config_get_parg_value(config, ARG_TOKEN_STATS, 0);
+  if (!stats_arg) {
+    return perf_counters_to_string();
+  }
+  if (!strings_equal(stats_arg, "reset")) {
+    error_stack_push(
+        error_stack, ERROR_STATUS_CONFIG_LOAD_UNRECOGNIZED_ARG,
+        get_formatted_string("unrecognized stats argument: %s", stats_arg));
+    return empty_string();
+  }
+  perf_counters_reset();
+  return empty_string();
+}
+
+void execute_stats(Config *config, ErrorStack *error_stack) {
+  char *result = impl_stats(config, error_stack);
+  if (error_stack_is_empty(error_stack)) {
+    thread_control_print(config->thread_control, result);
+  }
+  free(result);
+}
+
+char *str_api_stats(Config *config, ErrorStack *error_stack) {
+  return impl_stats(config, error_stack);
+}
+
 // Used for commands that only update the config state
 void execute_noop(Config __attribute__((unused)) * config,
                   ErrorStack __attribute__((unused)) * error_stack) {}
@@ -1246,13 +1302,23 @@ void add_help_arg_to_string_builder(const Config *config, int token,
           "dump each generation's rack data to a CSV.";
       break;
     case ARG_TOKEN_CREATE_DATA:
-      usages[0] = "<type> <output_name> [<letter_distribution>]";
+      usages[0] = "klv <output_name> [<letter_distribution>]";
+      usages[1] = "openings <output_name> [<number_of_moves>]";
       examples[0] = "klv CSW50";
       examples[1] = "klv CSW50 english";
+      examples[2] = "openings CSW21";
+      examples[3] = "openings CSW21 5";
       text =
-          "Creates a zeroed or empty data file of the specified type. If no "
-          "letter distribution is specified, the current letter distribution "
-          "is used. Currently, only the 'klv' type is supported.";
+          "Creates a data file of the specified type. The 'klv' type creates "
+          "a zeroed leaves file. If no letter distribution is specified, the "
+          "current letter distribution is used. The 'openings' type creates "
+          "an opening table for the -openings option with the top moves of "
+          "every full rack on the empty board, using the current lexicon, "
+          "leaves, letter distribution, board layout and bingo bonus of the "
+          "first player and the current number of threads. The table should "
+          "be given the name of the leaves to be found by -openings. If the "
+          "number of moves per rack is not specified, only the best move is "
+          "stored.";
       break;
     case ARG_TOKEN_ANALYZE:
       usages[0] = "[<path_or_players>] [<player_list>]";
@@ -1531,7 +1597,9 @@ void add_help_arg_to_string_builder(const Config *config, int token,
              "future, other per-rack data) for every possible full rack, "
              "enabling a single hash lookup to replace repeated KLV traversal. "
              "Off by default because .rit files are large and must be built "
-             "with the klvwmp2rit convert command.";
+             "with the klvwmp2rit convert command. After a KLV changes, the "
+             "ritklv2rit convert command rewrites only the leave data of an "
+             "existing table, which is much faster than a full rebuild.";
       break;
     case ARG_TOKEN_USE_MMAP_FOR_RIT:
       usages[0] = "<true_or_false>";
@@ -1542,6 +1610,18 @@ void add_help_arg_to_string_builder(const Config *config, int token,
              "loading the file but pages are faulted on demand during play. "
              "Only supported on little-endian architectures.";
       break;
+    case ARG_TOKEN_USE_OPENING_TABLE:
+      usages[0] = "<true_or_false>";
+      examples[0] = "true";
+      examples[1] = "false";
+      text = "Specifies whether to look up the moves of full racks on the "
+             "empty board in a precomputed opening table instead of "
+             "generating them. The table of each player shares the name of "
+             "their leaves and is built with the 'createdata openings' "
+             "command. Tables built for a different lexicon or letter "
+             "distribution are rejected and tables built for a different "
+             "board layout or bingo bonus are ignored. Off by default.";
+      break;
     case ARG_TOKEN_LEAVES:
       usages[0] = "<leaves>";
       examples[0] = "CSW21";
@@ -1607,7 +1687,11 @@ void add_help_arg_to_string_builder(const Config *config, int token,
     case ARG_TOKEN_WIN_PCT:
       usages[0] = "<win_percentage>";
       examples[0] = "winpct";
-      text = "Specifies which win percentage file to use for simulations.";
+      examples[1] = "winpct.logistic";
+      text = "Specifies which win percentage file to use for simulations. "
+             "Appending '.logistic' to the name uses a logistic model fitted "
+             "to each row of the file instead of the sampled values, which "
+             "is smooth and monotone where few games were sampled.";
       break;
     case ARG_TOKEN_PLIES:
       usages[0] = "<plies>";
@@ -1648,6 +1732,15 @@ void add_help_arg_to_string_builder(const Config *config, int token,
       text = "Specifies the time limit in seconds for the endgame solver. A "
              "value of 0 (the default) falls back to -tlim.";
       break;
+    case ARG_TOKEN_ENDGAME_TB_MAX_TILES:
+      usages[0] = "<max_tiles>";
+      examples[0] = "0";
+      examples[1] = "2";
+      text = "Specifies the largest rack, for both players, at which the "
+             "endgame solver solves a position below the root exactly to the "
+             "end of the game instead of searching it to the remaining depth. "
+             "At most 3. A value of 0 (the default) disables it.";
+      break;
     case ARG_TOKEN_PEG_TIME_LIMIT:
       usages[0] = "<time_limit_seconds>";
       text = "Specifies the time limit in seconds for the pre-endgame solver. "
@@ -1852,6 +1945,25 @@ void add_help_arg_to_string_builder(const Config *config, int token,
              "when simulating. Heat maps may be memory intensive for many "
              "plays or plies.";
       break;
+    case ARG_TOKEN_PLY_STATS_RATE:
+      usages[0] = "<rate>";
+      examples[0] = "1";
+      examples[1] = "8";
+      text = "Specifies that the per ply statistics and heat maps shown for "
+             "simulated plays are collected from one in every <rate> "
+             "rollouts. Higher rates make many threaded simulations with "
+             "heat maps faster at the cost of noisier per ply statistics.";
+      break;
+    case ARG_TOKEN_SIM_SHARE_ROLLOUTS:
+      usages[0] = "<true_or_false>";
+      examples[0] = "true";
+      examples[1] = "false";
+      text = "Specifies whether or not to share the moves found in the "
+             "rollouts of a simulation between plays that reach the same "
+             "positions, such as the replies to exchanges and passes. The "
+             "results are the same as without sharing. Speeds up simulations "
+             "of many plays at the cost of some memory.";
+      break;
     case ARG_TOKEN_WRITE_BUFFER_SIZE:
       usages[0] = "<write_buffer_size>";
       examples[0] = "10000";
@@ -1886,6 +1998,31 @@ void add_help_arg_to_string_builder(const Config *config, int token,
       examples[1] = "4";
       text = "Specifies the number of threads to use when running commands.";
       break;
+    case ARG_TOKEN_PIN_THREADS:
+      usages[0] = "<true_or_false>";
+      examples[0] = "true";
+      examples[1] = "false";
+      text = "Specifies whether or not to pin each worker thread to its own "
+             "core. Only supported on Linux. Off by default.";
+      break;
+    case ARG_TOKEN_MOVEGEN_THREADS:
+      usages[0] = "<number_of_threads>";
+      examples[0] = "1";
+      examples[1] = "4";
+      text = "Specifies the number of threads the generate command splits the "
+             "anchors of the position across. The moves are the same for any "
+             "number of threads.";
+      break;
+    case ARG_TOKEN_WMP_MAX_MEMORY:
+      usages[0] = "<megabytes>";
+      examples[0] = "0";
+      examples[1] = "2048";
+      text = "Specifies the approximate number of megabytes of scratch memory "
+             "the wordmap conversions may use. Blank and double-blank tables "
+             "that would exceed it are built from sorted runs spilled to "
+             "temporary files. The resulting wordmap is identical. A value of "
+             "0 (the default) builds entirely in memory.";
+      break;
     case ARG_TOKEN_PRINT_INTERVAL:
       usages[0] = "<print_interval>";
       examples[0] = "100";
@@ -2214,6 +2351,16 @@ void add_help_arg_to_string_builder(const Config *config, int token,
       usages[0] = "";
       text = "Prints the version of the magpie executable.";
       break;
+    case ARG_TOKEN_STATS:
+      usages[0] = "[reset]";
+      examples[0] = "";
+      examples[1] = "reset";
+      text = "Prints the hot-path performance counters (movegen phases, "
+             "cross-set updates, play/unplay, BAI decisions, transposition "
+             "table probes and PEG scenario leaves) merged across all "
+             "threads, or resets them with reset. Counters are only "
+             "recorded in builds made with PERF_COUNTERS=1.";
+      break;
     case NUMBER_OF_ARG_TOKENS:
       log_fatal("encountered invalid arg token in help command");
       break;
@@ -2328,6 +2475,7 @@ char *impl_help(Config *config, ErrorStack *error_stack) {
         ARG_TOKEN_CREATE_DATA, /* createdata */
         ARG_TOKEN_HELP,        /* help */
         ARG_TOKEN_SET,         /* setoptions */
+        ARG_TOKEN_STATS,       /* stats */
         ARG_TOKEN_VERSION,     /* version */
     };
     // Player Options (alphabetical by name)
@@ -2342,6 +2490,7 @@ char *impl_help(Config *config, ErrorStack *error_stack) {
         ARG_TOKEN_LETTER_DISTRIBUTION, /* ld */
         ARG_TOKEN_LEAVES,              /* leaves */
         ARG_TOKEN_LEXICON,             /* lex */
+        ARG_TOKEN_USE_OPENING_TABLE,   /* openings */
         ARG_TOKEN_P1_MOVE_RECORD_TYPE, /* r1 */
         ARG_TOKEN_P2_MOVE_RECORD_TYPE, /* r2 */
         ARG_TOKEN_USE_RIT,             /* rit */
@@ -2359,6 +2508,7 @@ char *impl_help(Config *config, ErrorStack *error_stack) {
     static const arg_token_t game_analysis_opts[] = {
         ARG_TOKEN_CUTOFF,                  /* cutoff */
         ARG_TOKEN_ENDGAME_PLIES,           /* eplies */
+        ARG_TOKEN_ENDGAME_TB_MAX_TILES,    /* etbtiles */
         ARG_TOKEN_ENDGAME_TIME_LIMIT,      /* etlim */
         ARG_TOKEN_ENDGAME_TOP_K,           /* etopk */
         ARG_TOKEN_USE_GAME_PAIRS,          /* gp */
@@ -2394,11 +2544,13 @@ char *impl_help(Config *config, ErrorStack *error_stack) {
         ARG_TOKEN_P1_SIM_PLIES,            /* pl1 */
         ARG_TOKEN_P2_SIM_PLIES,            /* pl2 */
         ARG_TOKEN_PLIES,                   /* plies */
+        ARG_TOKEN_PLY_STATS_RATE,          /* plystatrate */
         ARG_TOKEN_PEG_NOPRUNE,             /* pnoprune */
         ARG_TOKEN_STOP_COND_PCT,           /* scondition */
         ARG_TOKEN_SIM_WITH_INFERENCE,      /* sinfer */
         ARG_TOKEN_USE_SMALL_PLAYS,         /* sp */
         ARG_TOKEN_SAMPLING_RULE,           /* sr */
+        ARG_TOKEN_SIM_SHARE_ROLLOUTS,      /* sshare */
         ARG_TOKEN_P1_STOP_COND_PCT,        /* sc1 */
         ARG_TOKEN_P2_STOP_COND_PCT,        /* sc2 */
         ARG_TOKEN_P1_SIM_WITH_INFERENCE,   /* si1 */
@@ -2446,14 +2598,17 @@ char *impl_help(Config *config, ErrorStack *error_stack) {
     static const arg_token_t other_opts[] = {
         ARG_TOKEN_AUTOSAVE_GCG,          /* autosavegcg */
         ARG_TOKEN_FG_REQUIRED,           /* fgrequired */
+        ARG_TOKEN_MOVEGEN_THREADS,       /* mgthreads */
         ARG_TOKEN_EXEC_MODE,             /* mode */
         ARG_TOKEN_DATA_PATH,             /* path */
         ARG_TOKEN_PRINT_INTERVAL,        /* pfrequency */
+        ARG_TOKEN_PIN_THREADS,           /* pinthreads */
         ARG_TOKEN_PRINT_ON_FINISH,       /* printonfinish */
         ARG_TOKEN_SAVE_SETTINGS,         /* savesettings */
         ARG_TOKEN_RANDOM_SEED,           /* seed */
         ARG_TOKEN_SHOW_PROMPT,           /* shprompt */
         ARG_TOKEN_NUMBER_OF_THREADS,     /* threads */
+        ARG_TOKEN_WMP_MAX_MEMORY,        /* wmpmem */
         ARG_TOKEN_WRITE_RACK_EQUITY_CSV, /* writerackequitycsv */
     };
     int total_tokens = 0;
@@ -2712,6 +2867,7 @@ void impl_move_gen_override_record_type(Config *config,
       .eq_margin_movegen = config->eq_margin_movegen,
       .target_equity = EQUITY_MAX_VALUE,
       .target_leave_size_for_exchange_cutoff = UNSET_LEAVE_SIZE,
+      .num_threads = config->movegen_threads,
   };
   generate_moves_for_game_override_record_type(&args, move_record_type);
   move_list_sort_moves(config->move_list);
@@ -2940,6 +3096,8 @@ void config_fill_sim_args(const Config *config, Rack *known_opp_rack,
       config->sampling_rule, config->cutoff, config->utility_w_winpct,
       config->utility_w_spread, config->utility_spread_scale, &inference_args,
       sim_args);
+  sim_args->ply_stats_rate = config->ply_stats_rate;
+  sim_args->share_rollouts = config->sim_share_rollouts;
 }
 
 void config_load_win_pcts(Config *config, ErrorStack *error_stack) {
@@ -3289,7 +3447,8 @@ void config_fill_endgame_args(Config *config, EndgameArgs *endgame_args) {
       /*skip_word_pruning=*/false, /*shared_tt=*/NULL, /*max_workers=*/0,
       /*first_win=*/false, /*first_win_fallback_moves=*/0,
       /*use_initial_window=*/false, /*initial_alpha=*/0, /*initial_beta=*/0,
-      /*external_deadline_ns=*/0, /*actual_move=*/NULL, endgame_args);
+      /*external_deadline_ns=*/0, /*actual_move=*/NULL,
+      config->endgame_tablebase_max_tiles, endgame_args);
 }
 
 void config_endgame(Config *config, EndgameResults *endgame_results,
@@ -3415,7 +3574,8 @@ void config_fill_peg_args(Config *config, PegArgs *peg_args) {
       /*protect_moves=*/NULL, /*n_protect_moves=*/0,
       /*include_per_scenario=*/config->peg_show_outcomes,
       /*on_stage_start=*/NULL, /*on_cand_done=*/NULL,
-      /*on_scenario_done=*/NULL, /*user_data=*/NULL, /*poll=*/NULL, peg_args);
+      /*on_scenario_done=*/NULL, /*user_data=*/NULL, /*poll=*/NULL,
+      /*core_lender=*/NULL, peg_args);
 }
 
 // Parses a space-free UCGI PEG move list (coordinate.tiles, comma-separated)
@@ -3783,6 +3943,7 @@ void config_fill_conversion_args(const Config *config, ConversionArgs *args) {
       config_get_parg_value(config, ARG_TOKEN_CONVERT, 1);
   args->ld_name = config_get_parg_value(config, ARG_TOKEN_CONVERT, 2);
   args->num_threads = config_get_num_threads(config);
+  args->wmp_max_memory_bytes = (size_t)config->wmp_max_memory_mb * 1024 * 1024;
 }
 
 void config_convert(const Config *config, ConversionResults *results,
@@ -3852,8 +4013,7 @@ void impl_leave_gen(Config *config, ErrorStack *error_stack) {
 
 // Create
 
-// This only implements creating a klv for now.
-void impl_create_data(const Config *config, ErrorStack *error_stack) {
+void impl_create_data(Config *config, ErrorStack *error_stack) {
   const char *create_type_str =
       config_get_parg_value(config, ARG_TOKEN_CREATE_DATA, 0);
 
@@ -3884,6 +4044,45 @@ void impl_create_data(const Config *config, ErrorStack *error_stack) {
     if (ld_name_arg) {
       ld_destroy(ld);
     }
+  } else if (has_iprefix(create_type_str, "openings")) {
+    const char *opening_table_name_str =
+        config_get_parg_value(config, ARG_TOKEN_CREATE_DATA, 1);
+    const char *number_of_moves_str =
+        config_get_parg_value(config, ARG_TOKEN_CREATE_DATA, 2);
+    if (!config_has_game_data(config)) {
+      error_stack_push(
+          error_stack, ERROR_STATUS_CREATE_DATA_MISSING_LEXICON,
+          get_formatted_string("cannot create %s without lexicon",
+                               create_type_str));
+      return;
+    }
+    int number_of_moves = 1;
+    if (number_of_moves_str) {
+      number_of_moves = string_to_int(number_of_moves_str, error_stack);
+      if (!error_stack_is_empty(error_stack)) {
+        return;
+      }
+      if (number_of_moves < 1 ||
+          number_of_moves > OPENING_TABLE_MAX_NUMBER_OF_MOVES) {
+        error_stack_push(
+            error_stack, ERROR_STATUS_CREATE_DATA_INVALID_NUMBER_OF_MOVES,
+            get_formatted_string(
+                "number of moves for %s must be between 1 and %d, got %d",
+                create_type_str, OPENING_TABLE_MAX_NUMBER_OF_MOVES,
+                number_of_moves));
+        return;
+      }
+    }
+    config_init_game(config);
+    OpeningTable *opening_table =
+        make_opening_table(config->game, number_of_moves,
+                           config_get_num_threads(config), error_stack);
+    if (!error_stack_is_empty(error_stack)) {
+      return;
+    }
+    opening_table_write(opening_table, config_get_data_paths(config),
+                        opening_table_name_str, error_stack);
+    opening_table_destroy(opening_table);
   } else {
     error_stack_push(
         error_stack, ERROR_STATUS_CONFIG_LOAD_UNRECOGNIZED_CREATE_DATA_TYPE,
@@ -6057,7 +6256,8 @@ void config_load_lexicon_dependent_data(
     const bool use_wmp_has_value, const bool p1_use_wmp_has_value,
     const bool p2_use_wmp_has_value, const bool use_rit_has_value,
     const bool p1_use_rit_has_value, const bool p2_use_rit_has_value,
-    const bool use_mmap_for_rit_has_value, const bool is_loading_game_history,
+    const bool use_mmap_for_rit_has_value,
+    const bool use_opening_table_has_value, const bool is_loading_game_history,
     ErrorStack *error_stack) {
   // Lexical player data
 
@@ -6198,6 +6398,22 @@ void config_load_lexicon_dependent_data(
     }
   }
 
+  // Opening tables are either used by both players or by neither.
+  bool opening_table_use_when_available = players_data_get_use_when_available(
+      config->players_data, PLAYERS_DATA_TYPE_OPENING_TABLE, 0);
+  if (use_opening_table_has_value) {
+    config_load_bool(config, ARG_TOKEN_USE_OPENING_TABLE,
+                     &opening_table_use_when_available, error_stack);
+    if (!error_stack_is_empty(error_stack)) {
+      return;
+    }
+  }
+  for (int player_index = 0; player_index < 2; player_index++) {
+    players_data_set_use_when_available(
+        config->players_data, PLAYERS_DATA_TYPE_OPENING_TABLE, player_index,
+        opening_table_use_when_available);
+  }
+
   // Both lexicons are not specified, so we don't
   // load any of the lexicon dependent data
   if (!updated_p1_lexicon_name && !updated_p2_lexicon_name) {
@@ -6385,6 +6601,52 @@ void config_load_lexicon_dependent_data(
     }
   }
   free(updated_ld_name);
+
+  if (!error_stack_is_empty(error_stack)) {
+    return;
+  }
+
+  // Load opening tables (if enabled). The moves of a table depend on the
+  // leaves, so the .opt file shares the leaves name, and the lexicon and
+  // letter distribution it was built with must match the current ones.
+  const char *opening_table_names[2] = {NULL, NULL};
+  if (opening_table_use_when_available) {
+    for (int player_index = 0; player_index < 2; player_index++) {
+      opening_table_names[player_index] = players_data_get_data_name(
+          config->players_data, PLAYERS_DATA_TYPE_KLV, player_index);
+    }
+  }
+  players_data_set(config->players_data, PLAYERS_DATA_TYPE_OPENING_TABLE,
+                   config->data_paths, opening_table_names[0],
+                   opening_table_names[1], false, error_stack);
+  if (!error_stack_is_empty(error_stack)) {
+    return;
+  }
+  for (int player_index = 0; player_index < 2; player_index++) {
+    const OpeningTable *opening_table = players_data_get_opening_table(
+        config->players_data, player_index);
+    if (!opening_table) {
+      continue;
+    }
+    const char *lexicon_name = players_data_get_data_name(
+        config->players_data, PLAYERS_DATA_TYPE_KWG, player_index);
+    if (!strings_equal(opening_table_get_lexicon_name(opening_table),
+                       lexicon_name) ||
+        !strings_equal(opening_table_get_ld_name(opening_table),
+                       ld_get_name(config->ld))) {
+      error_stack_push(
+          error_stack, ERROR_STATUS_OPENING_TABLE_INCOMPATIBLE_DATA,
+          get_formatted_string(
+              "opening table %s was built for lexicon %s and letter "
+              "distribution %s but player %d uses lexicon %s and letter "
+              "distribution %s",
+              opening_table_get_name(opening_table),
+              opening_table_get_lexicon_name(opening_table),
+              opening_table_get_ld_name(opening_table), player_index + 1,
+              lexicon_name, ld_get_name(config->ld)));
+      return;
+    }
+  }
 }
 
 // Loads a new board layout by name. If the layout name changes and the load
@@ -6442,7 +6704,8 @@ void config_load_game_history(Config *config, const GameHistory *game_history,
       game_history_get_game_variant(game_history);
   config_load_lexicon_dependent_data(config, lexicon, NULL, NULL, NULL, NULL,
                                      NULL, ld_name, false, false, false, false,
-                                     false, false, false, true, error_stack);
+                                     false, false, false, false, true,
+                                     error_stack);
   if (!error_stack_is_empty(error_stack)) {
     return;
   }
@@ -6506,6 +6769,23 @@ void config_parse_gcg(Config *config, const char *gcg_filename,
   free(gcg_string);
 }
 
+// Parses every game of a GCG directory or multi-game GCG file in parallel
+// against the currently loaded data. Unlike config_parse_gcg, this does not
+// load the lexicon of each game or change the current game.
+GCGCorpus *config_create_gcg_corpus(Config *config, const char *path,
+                                    ErrorStack *error_stack) {
+  config_init_game(config);
+  const GCGCorpusArgs args = {
+      .path = path,
+      .game = config->game,
+      .lexicon_name = players_data_get_data_name(config->players_data,
+                                                 PLAYERS_DATA_TYPE_KWG, 0),
+      .board_layout_name = board_layout_get_name(config->board_layout),
+      .num_threads = config->num_threads,
+  };
+  return gcg_corpus_create(&args, error_stack);
+}
+
 // For downloaded GCGs (non-local), builds a filename from the basename and
 // player names, sets it on the game history, and writes the GCG string to
 // disk. Local files are skipped because they are already saved.
@@ -7031,6 +7311,13 @@ void config_load_data(Config *config, ErrorStack *error_stack) {
     return;
   }
 
+  config_load_int(config, ARG_TOKEN_ENDGAME_TB_MAX_TILES, 0,
+                  ENDGAME_TABLEBASE_MAX_TILES,
+                  &config->endgame_tablebase_max_tiles, error_stack);
+  if (!error_stack_is_empty(error_stack)) {
+    return;
+  }
+
   config_load_double(config, ARG_TOKEN_PEG_TIME_LIMIT, 0, 1e9,
                      &config->peg_time_limit_seconds, error_stack);
   if (!error_stack_is_empty(error_stack)) {
@@ -7131,12 +7418,31 @@ void config_load_data(Config *config, ErrorStack *error_stack) {
     return;
   }
 
+  config_load_int(config, ARG_TOKEN_MOVEGEN_THREADS, 1, MAX_THREADS,
+                  &config->movegen_threads, error_stack);
+  if (!error_stack_is_empty(error_stack)) {
+    return;
+  }
+
+  config_load_bool(config, ARG_TOKEN_PIN_THREADS, &config->pin_threads,
+                   error_stack);
+  if (!error_stack_is_empty(error_stack)) {
+    return;
+  }
+  thread_pool_set_cpu_affinity(config->pin_threads);
+
   config_load_int(config, ARG_TOKEN_PRINT_INTERVAL, 0, INT_MAX,
                   &config->print_interval, error_stack);
   if (!error_stack_is_empty(error_stack)) {
     return;
   }
 
+  config_load_int(config, ARG_TOKEN_WMP_MAX_MEMORY, 0, INT_MAX,
+                  &config->wmp_max_memory_mb, error_stack);
+  if (!error_stack_is_empty(error_stack)) {
+    return;
+  }
+
   config_load_double(config, ARG_TOKEN_TIME_LIMIT, 0, 1e9,
                      &config->time_limit_seconds, error_stack);
   if (!error_stack_is_empty(error_stack)) {
@@ -7227,6 +7533,18 @@ void config_load_data(Config *config, ErrorStack *error_stack) {
     return;
   }
 
+  config_load_int(config, ARG_TOKEN_PLY_STATS_RATE, 1, INT_MAX,
+                  &config->ply_stats_rate, error_stack);
+  if (!error_stack_is_empty(error_stack)) {
+    return;
+  }
+
+  config_load_bool(config, ARG_TOKEN_SIM_SHARE_ROLLOUTS,
+                   &config->sim_share_rollouts, error_stack);
+  if (!error_stack_is_empty(error_stack)) {
+    return;
+  }
+
   // Human readable
 
   config_load_bool(config, ARG_TOKEN_HUMAN_READABLE, &config->human_readable,
@@ -7971,11 +8289,15 @@ void config_load_data(Config *config, ErrorStack *error_stack) {
   const bool use_mmap_for_rit =
       config_get_parg_value(config, ARG_TOKEN_USE_MMAP_FOR_RIT, 0);
 
+  // Opening table settings
+  const bool use_opening_table =
+      config_get_parg_value(config, ARG_TOKEN_USE_OPENING_TABLE, 0);
+
   config_load_lexicon_dependent_data(
       config, new_lexicon_name, new_p1_lexicon_name, new_p2_lexicon_name,
       new_leaves_name, new_p1_leaves_name, new_p2_leaves_name, new_ld_name,
       use_wmp, p1_use_wmp, p2_use_wmp, use_rit, p1_use_rit, p2_use_rit,
-      use_mmap_for_rit, false, error_stack);
+      use_mmap_for_rit, use_opening_table, false, error_stack);
   if (!error_stack_is_empty(error_stack)) {
     return;
   }
@@ -9096,6 +9418,7 @@ Config *config_create(const ConfigArgs *config_args, ErrorStack *error_stack) {
 
   cmd(ARG_TOKEN_HELP, "help", 0, 1, help, generic, false);
   cmd(ARG_TOKEN_VERSION, "version", 0, 0, version, generic, false);
+  cmd(ARG_TOKEN_STATS, "stats", 0, 1, stats, generic, false);
   cmd(ARG_TOKEN_SET, "setoptions", 0, 0, noop, generic, false);
   cmd(ARG_TOKEN_CGP, "cgp", 4, 4, load_cgp, generic, false);
   cmd(ARG_TOKEN_LOAD, "load", 1, 1, load_gcg, generic, false);
@@ -9153,6 +9476,7 @@ Config *config_create(const ConfigArgs *config_args, ErrorStack *error_stack) {
   arg(ARG_TOKEN_USE_WMP, "wmp", 1, 1);
   arg(ARG_TOKEN_USE_RIT, "rit", 1, 1);
   arg(ARG_TOKEN_USE_MMAP_FOR_RIT, "ritmmap", 1, 1);
+  arg(ARG_TOKEN_USE_OPENING_TABLE, "openings", 1, 1);
   arg(ARG_TOKEN_LEAVES, "leaves", 1, 1);
   arg(ARG_TOKEN_P1_LEXICON, "l1", 1, 1);
   arg(ARG_TOKEN_P1_USE_WMP, "w1", 1, 1);
@@ -9173,6 +9497,7 @@ Config *config_create(const ConfigArgs *config_args, ErrorStack *error_stack) {
   arg(ARG_TOKEN_ENDGAME_PLIES, "eplies", 1, 1);
   arg(ARG_TOKEN_ENDGAME_TOP_K, "etopk", 1, 1);
   arg(ARG_TOKEN_ENDGAME_TIME_LIMIT, "etlim", 1, 1);
+  arg(ARG_TOKEN_ENDGAME_TB_MAX_TILES, "etbtiles", 1, 1);
   arg(ARG_TOKEN_PEG_TOP_K, "pegtopk", 1, 1);
   arg(ARG_TOKEN_PEG_TIME_LIMIT, "pegtlim", 1, 1);
   arg(ARG_TOKEN_PEG_STRIDE, "pegstride", 1, 1);
@@ -9195,11 +9520,15 @@ Config *config_create(const ConfigArgs *config_args, ErrorStack *error_stack) {
   arg(ARG_TOKEN_USE_SMALL_PLAYS, "sp", 1, 1);
   arg(ARG_TOKEN_SIM_WITH_INFERENCE, "sinfer", 1, 1);
   arg(ARG_TOKEN_USE_HEAT_MAP, "useheatmap", 1, 1);
+  arg(ARG_TOKEN_PLY_STATS_RATE, "plystatrate", 1, 1);
+  arg(ARG_TOKEN_SIM_SHARE_ROLLOUTS, "sshare", 1, 1);
   arg(ARG_TOKEN_HUMAN_READABLE, "hr", 1, 1);
   arg(ARG_TOKEN_SHOW_MISTAKES, "mistakes", 1, 1);
   arg(ARG_TOKEN_WRITE_BUFFER_SIZE, "wb", 1, 1);
   arg(ARG_TOKEN_RANDOM_SEED, "seed", 1, 1);
   arg(ARG_TOKEN_NUMBER_OF_THREADS, "threads", 1, 1);
+  arg(ARG_TOKEN_MOVEGEN_THREADS, "mgthreads", 1, 1);
+  arg(ARG_TOKEN_PIN_THREADS, "pinthreads", 1, 1);
   arg(ARG_TOKEN_PRINT_INTERVAL, "pfrequency", 1, 1);
   arg(ARG_TOKEN_EXEC_MODE, "mode", 1, 1);
   arg(ARG_TOKEN_TT_FRACTION_OF_MEM, "ttfraction", 1, 1);
@@ -9252,6 +9581,7 @@ Config *config_create(const ConfigArgs *config_args, ErrorStack *error_stack) {
   arg(ARG_TOKEN_PRETTY, "pretty", 1, 1);
   arg(ARG_TOKEN_PRINT_ON_FINISH, "printonfinish", 1, 1);
   arg(ARG_TOKEN_WRITE_RACK_EQUITY_CSV, "writerackequitycsv", 1, 1);
+  arg(ARG_TOKEN_WMP_MAX_MEMORY, "wmpmem", 1, 1);
   arg(ARG_TOKEN_SHOW_PROMPT, "shprompt", 1, 1);
   arg(ARG_TOKEN_SAVE_SETTINGS, "savesettings", 1, 1);
   arg(ARG_TOKEN_AUTOSAVE_GCG, "autosavegcg", 1, 1);
@@ -9295,6 +9625,7 @@ Config *config_create(const ConfigArgs *config_args, ErrorStack *error_stack) {
   config->show_bu = false;
   config->endgame_plies = 6;
   config->endgame_top_k = 1;
+  config->endgame_tablebase_max_tiles = 0;
   // -1 = no peg results yet; 0 stages = built-in schedule; 0 stride = solver
   // default; rational opponent; no only-solve / never-prune restrictions.
   config->peg_result.last_completed_stage = -1;
@@ -9320,6 +9651,8 @@ Config *config_create(const ConfigArgs *config_args, ErrorStack *error_stack) {
   config->endgame_time_limit_seconds = 0;
   config->peg_time_limit_seconds = 0;
   config->num_threads = get_num_cores();
+  config->movegen_threads = 1;
+  config->pin_threads = false;
   config->print_interval = 0;
   config->seed = ctime_get_current_time();
   config->sampling_rule = BAI_SAMPLING_RULE_TOP_TWO_IDS;
@@ -9361,9 +9694,12 @@ Config *config_create(const ConfigArgs *config_args, ErrorStack *error_stack) {
   config->p2_eq_margin_inference = config->eq_margin_inference;
   config->multi_threading_mode = MULTI_THREADING_MODE_PER_GAME_PARALLELISM;
   config->use_heat_map = false;
+  config->ply_stats_rate = DEFAULT_PLY_STATS_RATE;
+  config->sim_share_rollouts = false;
   config->print_boards = false;
   config->print_on_finish = false;
   config->write_rack_equity_csv = false;
+  config->wmp_max_memory_mb = 0;
   config->show_game_with_moves = true;
   config->show_prompt = true;
   config->save_settings = true;
@@ -9373,6 +9709,10 @@ Config *config_create(const ConfigArgs *config_args, ErrorStack *error_stack) {
   config->game_variant = DEFAULT_GAME_VARIANT;
   config->ld = NULL;
   config->players_data = players_data_create(default_use_wmp);
+  if (config_args) {
+    players_data_set_share_loaded_data(config->players_data,
+                                       config_args->share_loaded_data);
+  }
   config->thread_control = thread_control_create();
   config->game = NULL;
   config->game_backup = NULL;
@@ -9479,6 +9819,7 @@ void config_add_settings_to_string_builder(const Config *config,
     switch (arg_token) {
     case ARG_TOKEN_HELP:
     case ARG_TOKEN_VERSION:
+    case ARG_TOKEN_STATS:
     case ARG_TOKEN_SET:
     case ARG_TOKEN_CGP:
     case ARG_TOKEN_MOVES:
@@ -9574,6 +9915,12 @@ void config_add_settings_to_string_builder(const Config *config,
       config_add_bool_setting_to_string_builder(config, sb, arg_token,
                                                 config->use_mmap_for_rit);
       break;
+    case ARG_TOKEN_USE_OPENING_TABLE:
+      config_add_bool_setting_to_string_builder(
+          config, sb, arg_token,
+          players_data_get_use_when_available(
+              config->players_data, PLAYERS_DATA_TYPE_OPENING_TABLE, 0));
+      break;
     case ARG_TOKEN_P1_LEXICON:
       config_add_string_setting_to_string_builder(
           config, sb, arg_token,
@@ -9713,6 +10060,10 @@ void config_add_settings_to_string_builder(const Config *config,
       config_add_double_setting_to_string_builder(
           config, sb, arg_token, config->endgame_time_limit_seconds);
       break;
+    case ARG_TOKEN_ENDGAME_TB_MAX_TILES:
+      config_add_int_setting_to_string_builder(
+          config, sb, arg_token, config->endgame_tablebase_max_tiles);
+      break;
     case ARG_TOKEN_PEG_TIME_LIMIT:
       config_add_double_setting_to_string_builder(
           config, sb, arg_token, config->peg_time_limit_seconds);
@@ -9834,6 +10185,14 @@ void config_add_settings_to_string_builder(const Config *config,
       config_add_bool_setting_to_string_builder(config, sb, arg_token,
                                                 config->use_heat_map);
       break;
+    case ARG_TOKEN_PLY_STATS_RATE:
+      config_add_int_setting_to_string_builder(config, sb, arg_token,
+                                               config->ply_stats_rate);
+      break;
+    case ARG_TOKEN_SIM_SHARE_ROLLOUTS:
+      config_add_bool_setting_to_string_builder(config, sb, arg_token,
+                                                config->sim_share_rollouts);
+      break;
     case ARG_TOKEN_WRITE_BUFFER_SIZE:
       config_add_uint64_setting_to_string_builder(
           config, sb, arg_token,
@@ -9857,6 +10216,14 @@ void config_add_settings_to_string_builder(const Config *config,
       config_add_int_setting_to_string_builder(config, sb, arg_token,
                                                config->num_threads);
       break;
+    case ARG_TOKEN_MOVEGEN_THREADS:
+      config_add_int_setting_to_string_builder(config, sb, arg_token,
+                                               config->movegen_threads);
+      break;
+    case ARG_TOKEN_PIN_THREADS:
+      config_add_bool_setting_to_string_builder(config, sb, arg_token,
+                                                config->pin_threads);
+      break;
     case ARG_TOKEN_PRINT_INTERVAL:
       config_add_int_setting_to_string_builder(config, sb, arg_token,
                                                config->print_interval);
@@ -10024,6 +10391,10 @@ void config_add_settings_to_string_builder(const Config *config,
       config_add_bool_setting_to_string_builder(config, sb, arg_token,
                                                 config->write_rack_equity_csv);
       break;
+    case ARG_TOKEN_WMP_MAX_MEMORY:
+      config_add_int_setting_to_string_builder(config, sb, arg_token,
+                                               config->wmp_max_memory_mb);
+      break;
     case ARG_TOKEN_SHOW_GAME_WITH_MOVES:
       config_add_bool_setting_to_string_builder(config, sb, arg_token,
                                                 config->show_game_with_moves);
@@ -20,6 +20,7 @@
 #include "../ent/win_pct.h"
 #include "../impl/simmer.h"
 #include "../util/io_util.h"
+#include "gcg_corpus.h"
 #include "peg.h"
 #include <stdbool.h>
 
@@ -29,6 +30,9 @@ typedef struct ConfigArgs {
   const char *data_paths;
   const char *settings_filename;
   bool use_wmp;
+  // Share loaded lexicon data read-only with other configs in the process
+  // that also set this.
+  bool share_loaded_data;
 } ConfigArgs;
 
 // Constructors and Destructors
@@ -56,6 +60,7 @@ int config_get_plies(const Config *config);
 int config_get_shplies(const Config *config);
 bool config_get_show_bu(const Config *config);
 int config_get_endgame_plies(const Config *config);
+int config_get_endgame_tablebase_max_tiles(const Config *config);
 uint64_t config_get_max_iterations(const Config *config);
 uint64_t config_get_seed(const Config *config);
 double config_get_stop_cond_pct(const Config *config);
@@ -93,6 +98,7 @@ AutoplayResults *config_get_autoplay_results(const Config *config);
 const char *config_get_settings_filename(const Config *config);
 const char *config_get_current_exec_name(const Config *config);
 int config_get_num_threads(const Config *config);
+void config_set_num_threads(Config *config, int num_threads);
 int config_get_print_interval(const Config *config);
 Equity config_get_eq_margin_inference(const Config *config);
 Equity config_get_p1_eq_margin_inference(const Config *config);
@@ -125,6 +131,8 @@ void config_parse_gcg(Config *config, const char *gcg_filename,
 void config_parse_gcg_string(Config *config, const char *gcg_string,
                              GameHistory *game_history,
                              ErrorStack *error_stack);
+GCGCorpus *config_create_gcg_corpus(Config *config, const char *path,
+                                    ErrorStack *error_stack);
 // Settings
 void config_add_settings_to_string_builder(const Config *config,
                                            StringBuilder *sb);
@@ -30,7 +30,8 @@ void convert_from_text_with_dwl(const LetterDistribution *ld,
                                 const char *output_name,
                                 DictionaryWordList *strings,
                                 ConversionResults *conversion_results,
-                                int num_threads, ErrorStack *error_stack) {
+                                int num_threads, size_t wmp_max_memory_bytes,
+                                ErrorStack *error_stack) {
 
   char *input_filename = data_filepaths_get_readable_filename(
       data_paths, input_name, DATA_FILEPATH_TYPE_LEXICON, error_stack);
@@ -109,7 +110,8 @@ void convert_from_text_with_dwl(const LetterDistribution *ld,
     if (!error_stack_is_empty(error_stack)) {
       return;
     }
-    WMP *wmp = make_wmp_from_words(strings, ld, num_threads);
+    WMP *wmp = make_wmp_from_words_bounded(strings, ld, num_threads,
+                                           wmp_max_memory_bytes);
     wmp_write_to_file(wmp, wmp_output_filename, error_stack);
     if (!error_stack_is_empty(error_stack)) {
       error_stack_push(
@@ -184,7 +186,7 @@ void convert_with_names(const LetterDistribution *ld,
                         const char *data_paths, const char *input_name,
                         const char *output_name,
                         ConversionResults *conversion_results, int num_threads,
-                        ErrorStack *error_stack) {
+                        size_t wmp_max_memory_bytes, ErrorStack *error_stack) {
   if ((conversion_type == CONVERT_TEXT2DAWG) ||
       (conversion_type == CONVERT_TEXT2GADDAG) ||
       (conversion_type == CONVERT_TEXT2KWG) ||
@@ -195,7 +197,7 @@ void convert_with_names(const LetterDistribution *ld,
     DictionaryWordList *strings = dictionary_word_list_create();
     convert_from_text_with_dwl(ld, conversion_type, data_paths, input_name,
                                output_name, strings, conversion_results,
-                               num_threads, error_stack);
+                               num_threads, wmp_max_memory_bytes, error_stack);
     dictionary_word_list_destroy(strings);
   } else if (conversion_type == CONVERT_DAWG2TEXT) {
     KWG *kwg = kwg_create(data_paths, input_name, error_stack);
@@ -213,7 +215,8 @@ void convert_with_names(const LetterDistribution *ld,
       char *wmp_output_filename = data_filepaths_get_writable_filename(
           data_paths, output_name, DATA_FILEPATH_TYPE_WORDMAP, error_stack);
       if (error_stack_is_empty(error_stack)) {
-        WMP *wmp = make_wmp_from_kwg(kwg, ld, num_threads);
+        WMP *wmp = make_wmp_from_kwg_bounded(kwg, ld, num_threads,
+                                             wmp_max_memory_bytes);
         wmp_write_to_file(wmp, wmp_output_filename, error_stack);
         if (!error_stack_is_empty(error_stack)) {
           error_stack_push(
@@ -276,6 +279,41 @@ void convert_with_names(const LetterDistribution *ld,
     free(rit_output_filename);
     wmp_destroy(wmp);
     klv_destroy(klv);
+  } else if (conversion_type == CONVERT_RITKLV2RIT) {
+    RackInfoTable *rit =
+        rack_info_table_create(data_paths, input_name, false, error_stack);
+    if (!error_stack_is_empty(error_stack)) {
+      return;
+    }
+    KLV *klv = klv_create(data_paths, input_name, error_stack);
+    if (!error_stack_is_empty(error_stack)) {
+      rack_info_table_destroy(rit);
+      return;
+    }
+    WMP *wmp = wmp_create(data_paths, input_name, error_stack);
+    if (!error_stack_is_empty(error_stack)) {
+      klv_destroy(klv);
+      rack_info_table_destroy(rit);
+      return;
+    }
+    char *rit_output_filename = data_filepaths_get_writable_filename(
+        data_paths, output_name, DATA_FILEPATH_TYPE_RACK_INFO_TABLE,
+        error_stack);
+    if (error_stack_is_empty(error_stack)) {
+      rack_info_table_refill_leaves(rit, klv, wmp, ld, num_threads);
+      rack_info_table_write_to_file(rit, rit_output_filename, error_stack);
+      if (!error_stack_is_empty(error_stack)) {
+        error_stack_push(
+            error_stack, ERROR_STATUS_CONVERT_OUTPUT_FILE_NOT_WRITABLE,
+            get_formatted_string(
+                "could not write rack info table to output file: %s",
+                rit_output_filename));
+      }
+    }
+    free(rit_output_filename);
+    wmp_destroy(wmp);
+    klv_destroy(klv);
+    rack_info_table_destroy(rit);
   } else {
     error_stack_push(error_stack,
                      ERROR_STATUS_CONVERT_UNIMPLEMENTED_CONVERSION_TYPE,
@@ -312,6 +350,8 @@ get_conversion_type_from_string(const char *conversion_type_string) {
     conversion_type = CONVERT_DAWG2WORDMAP;
   } else if (strings_equal(conversion_type_string, "klvwmp2rit")) {
     conversion_type = CONVERT_KLVWMP2RIT;
+  } else if (strings_equal(conversion_type_string, "ritklv2rit")) {
+    conversion_type = CONVERT_RITKLV2RIT;
   }
   return conversion_type;
 }
@@ -355,6 +395,7 @@ void convert(const ConversionArgs *args, ConversionResults *conversion_results,
 
   convert_with_names(ld, conversion_type, args->data_paths,
                      args->input_and_output_name, args->input_and_output_name,
-                     conversion_results, args->num_threads, error_stack);
+                     conversion_results, args->num_threads,
+                     args->wmp_max_memory_bytes, error_stack);
   ld_destroy(ld);
 }
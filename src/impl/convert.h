@@ -5,6 +5,7 @@
 #include "../ent/conversion_results.h"
 #include "../ent/letter_distribution.h"
 #include "../util/io_util.h"
+#include <stddef.h>
 
 typedef struct ConversionArgs {
   const char *conversion_type_string;
@@ -12,6 +13,8 @@ typedef struct ConversionArgs {
   const char *input_and_output_name;
   const char *ld_name;
   int num_threads;
+  // Scratch limit for wordmap builds, 0 for unbounded
+  size_t wmp_max_memory_bytes;
 } ConversionArgs;
 
 void convert(const ConversionArgs *args, ConversionResults *conversion_results,
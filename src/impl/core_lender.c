@@ -0,0 +1,272 @@
+#include "core_lender.h"
+
+#include "../compat/cpthread.h"
+#include "../compat/ctime.h"
+#include "../def/cpthread_defs.h"
+#include "../util/io_util.h"
+#include "endgame.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+enum {
+  CORE_LENDER_INITIAL_BORROWERS_CAPACITY = 4,
+  CORE_LENDER_MAX_IDLE_SOURCES = 4,
+  // How often the monitor looks for idle cores.
+  CORE_LENDER_POLL_NS = 2 * 1000 * 1000,
+};
+
+// Only lend to solves that have been running at least this long: the many
+// sub-millisecond solves finish before this, so they never pay the spawn and
+// coordination cost of an extra worker.
+#define CORE_LENDER_MIN_SOLVE_AGE_NS (30LL * 1000 * 1000)
+// A worker spawned this close to the deadline would barely get to search
+// before the solve stops, so a core is not lent with less time left.
+#define CORE_LENDER_MIN_REMAINING_NS (20LL * 1000 * 1000)
+
+typedef struct CoreLenderBorrower {
+  EndgameCtx *endgame_ctx;
+  int64_t deadline_ns;
+  // Cores lent to the solve whose injection window opened at lent_window_ns.
+  int lent_cores;
+  int64_t lent_window_ns;
+} CoreLenderBorrower;
+
+typedef struct CoreLenderIdleSource {
+  CoreLenderIdleCoresFn idle_cores_fn;
+  void *data;
+} CoreLenderIdleSource;
+
+struct CoreLender {
+  int num_cores;
+  // Everything below is guarded by mutex.
+  // Acquired and lent cores. Cores lent against an idle source may take it
+  // past num_cores.
+  int cores_in_use;
+  int num_loans;
+  CoreLenderIdleSource idle_sources[CORE_LENDER_MAX_IDLE_SOURCES];
+  int num_idle_sources;
+  CoreLenderBorrower *borrowers;
+  int num_borrowers;
+  int borrowers_capacity;
+  cpthread_mutex_t mutex;
+  cpthread_t monitor_thread;
+  atomic_int stop;
+};
+
+// Takes back the cores lent to a solve that has ended. A solve has ended once
+// its injection window is shut or has reopened for a later solve.
+static void core_lender_reclaim(CoreLender *lender,
+                                CoreLenderBorrower *borrower) {
+  if (borrower->lent_cores == 0) {
+    return;
+  }
+  const EndgameCtx *endgame_ctx = borrower->endgame_ctx;
+  if (endgame_injecting(endgame_ctx) &&
+      endgame_window_open_ns(endgame_ctx) == borrower->lent_window_ns) {
+    return;
+  }
+  lender->cores_in_use -= borrower->lent_cores;
+  borrower->lent_cores = 0;
+}
+
+// Lends at most one core per call. Must hold the mutex.
+static void core_lender_lend(CoreLender *lender) {
+  int total_live_workers = 0;
+  for (int i = 0; i < lender->num_borrowers; i++) {
+    CoreLenderBorrower *borrower = &lender->borrowers[i];
+    core_lender_reclaim(lender, borrower);
+    if (endgame_injecting(borrower->endgame_ctx)) {
+      total_live_workers += endgame_live_workers(borrower->endgame_ctx);
+    }
+  }
+  int idle_cores = lender->num_cores - lender->cores_in_use;
+  for (int i = 0; i < lender->num_idle_sources; i++) {
+    const CoreLenderIdleSource *idle_source = &lender->idle_sources[i];
+    idle_cores += idle_source->idle_cores_fn(idle_source->data);
+  }
+  if (idle_cores <= 0 || total_live_workers >= lender->num_cores) {
+    return;
+  }
+  const int64_t now_ns = ctimer_monotonic_ns();
+  CoreLenderBorrower *best_borrower = NULL;
+  int64_t best_remaining_ns_per_worker = 0;
+  for (int i = 0; i < lender->num_borrowers; i++) {
+    CoreLenderBorrower *borrower = &lender->borrowers[i];
+    const EndgameCtx *endgame_ctx = borrower->endgame_ctx;
+    if (!endgame_injecting(endgame_ctx) ||
+        now_ns - endgame_window_open_ns(endgame_ctx) <
+            CORE_LENDER_MIN_SOLVE_AGE_NS) {
+      continue;
+    }
+    int64_t remaining_ns = INT64_MAX;
+    if (borrower->deadline_ns > 0) {
+      remaining_ns = borrower->deadline_ns - now_ns;
+      if (remaining_ns < CORE_LENDER_MIN_REMAINING_NS) {
+        continue;
+      }
+    }
+    int live_workers = endgame_live_workers(endgame_ctx);
+    if (live_workers < 1) {
+      live_workers = 1;
+    }
+    const int64_t remaining_ns_per_worker = remaining_ns / live_workers;
+    if (!best_borrower ||
+        remaining_ns_per_worker > best_remaining_ns_per_worker) {
+      best_borrower = borrower;
+      best_remaining_ns_per_worker = remaining_ns_per_worker;
+    }
+  }
+  if (!best_borrower) {
+    return;
+  }
+  // The window may have reopened since the reclaim above; read it before
+  // adding so a worker is never credited to a later solve.
+  const int64_t window_ns = endgame_window_open_ns(best_borrower->endgame_ctx);
+  if (!endgame_add_worker(best_borrower->endgame_ctx)) {
+    return;
+  }
+  if (best_borrower->lent_cores == 0) {
+    best_borrower->lent_window_ns = window_ns;
+  }
+  best_borrower->lent_cores++;
+  lender->cores_in_use++;
+  lender->num_loans++;
+}
+
+static void *core_lender_monitor(void *uncasted_lender) {
+  CoreLender *lender = (CoreLender *)uncasted_lender;
+  const struct timespec nap = {0, CORE_LENDER_POLL_NS};
+  while (!atomic_load(&lender->stop)) {
+    cpthread_mutex_lock(&lender->mutex);
+    core_lender_lend(lender);
+    cpthread_mutex_unlock(&lender->mutex);
+    nanosleep(&nap, NULL);
+  }
+  return NULL;
+}
+
+CoreLender *core_lender_create(int num_cores) {
+  CoreLender *lender = calloc_or_die(1, sizeof(CoreLender));
+  lender->num_cores = num_cores < 1 ? 1 : num_cores;
+  lender->borrowers_capacity = CORE_LENDER_INITIAL_BORROWERS_CAPACITY;
+  lender->borrowers = malloc_or_die((size_t)lender->borrowers_capacity *
+                                    sizeof(CoreLenderBorrower));
+  cpthread_mutex_init(&lender->mutex);
+  atomic_init(&lender->stop, 0);
+  cpthread_create(&lender->monitor_thread, core_lender_monitor, lender);
+  return lender;
+}
+
+void core_lender_destroy(CoreLender *lender) {
+  if (!lender) {
+    return;
+  }
+  atomic_store(&lender->stop, 1);
+  cpthread_join(lender->monitor_thread);
+  free(lender->borrowers);
+  free(lender);
+}
+
+int core_lender_get_num_cores(const CoreLender *lender) {
+  return lender->num_cores;
+}
+
+int core_lender_get_free_cores(CoreLender *lender) {
+  cpthread_mutex_lock(&lender->mutex);
+  int free_cores = lender->num_cores - lender->cores_in_use;
+  cpthread_mutex_unlock(&lender->mutex);
+  if (free_cores < 0) {
+    free_cores = 0;
+  }
+  return free_cores;
+}
+
+int core_lender_get_num_loans(CoreLender *lender) {
+  cpthread_mutex_lock(&lender->mutex);
+  const int num_loans = lender->num_loans;
+  cpthread_mutex_unlock(&lender->mutex);
+  return num_loans;
+}
+
+int core_lender_acquire(CoreLender *lender, int num_cores) {
+  cpthread_mutex_lock(&lender->mutex);
+  int acquired_cores = lender->num_cores - lender->cores_in_use;
+  if (acquired_cores > num_cores) {
+    acquired_cores = num_cores;
+  }
+  if (acquired_cores < 0) {
+    acquired_cores = 0;
+  }
+  lender->cores_in_use += acquired_cores;
+  cpthread_mutex_unlock(&lender->mutex);
+  return acquired_cores;
+}
+
+void core_lender_release(CoreLender *lender, int num_cores) {
+  cpthread_mutex_lock(&lender->mutex);
+  lender->cores_in_use -= num_cores;
+  if (lender->cores_in_use < 0) {
+    log_fatal("core lender released more cores than were acquired");
+  }
+  cpthread_mutex_unlock(&lender->mutex);
+}
+
+void core_lender_add_idle_source(CoreLender *lender,
+                                 CoreLenderIdleCoresFn idle_cores_fn,
+                                 void *data) {
+  cpthread_mutex_lock(&lender->mutex);
+  if (lender->num_idle_sources == CORE_LENDER_MAX_IDLE_SOURCES) {
+    log_fatal("core lender has too many idle sources");
+  }
+  lender->idle_sources[lender->num_idle_sources++] = (CoreLenderIdleSource){
+      .idle_cores_fn = idle_cores_fn,
+      .data = data,
+  };
+  cpthread_mutex_unlock(&lender->mutex);
+}
+
+void core_lender_remove_idle_source(CoreLender *lender, void *data) {
+  cpthread_mutex_lock(&lender->mutex);
+  for (int i = 0; i < lender->num_idle_sources; i++) {
+    if (lender->idle_sources[i].data != data) {
+      continue;
+    }
+    lender->idle_sources[i] = lender->idle_sources[--lender->num_idle_sources];
+    break;
+  }
+  cpthread_mutex_unlock(&lender->mutex);
+}
+
+void core_lender_add_endgame(CoreLender *lender, EndgameCtx *endgame_ctx,
+                             int64_t deadline_ns) {
+  cpthread_mutex_lock(&lender->mutex);
+  if (lender->num_borrowers == lender->borrowers_capacity) {
+    lender->borrowers_capacity *= 2;
+    lender->borrowers = realloc_or_die(
+        lender->borrowers,
+        (size_t)lender->borrowers_capacity * sizeof(CoreLenderBorrower));
+  }
+  lender->borrowers[lender->num_borrowers++] = (CoreLenderBorrower){
+      .endgame_ctx = endgame_ctx,
+      .deadline_ns = deadline_ns,
+      .lent_cores = 0,
+      .lent_window_ns = 0,
+  };
+  cpthread_mutex_unlock(&lender->mutex);
+}
+
+void core_lender_remove_endgame(CoreLender *lender, EndgameCtx *endgame_ctx) {
+  cpthread_mutex_lock(&lender->mutex);
+  for (int i = 0; i < lender->num_borrowers; i++) {
+    if (lender->borrowers[i].endgame_ctx != endgame_ctx) {
+      continue;
+    }
+    lender->cores_in_use -= lender->borrowers[i].lent_cores;
+    lender->borrowers[i] = lender->borrowers[--lender->num_borrowers];
+    break;
+  }
+  cpthread_mutex_unlock(&lender->mutex);
+}
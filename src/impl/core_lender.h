@@ -0,0 +1,69 @@
+#ifndef CORE_LENDER_H
+#define CORE_LENDER_H
+
+#include "endgame.h"
+#include <stdint.h>
+
+// ---------------------------------------------------------------------------
+// Core lender
+// ---------------------------------------------------------------------------
+//
+// Shares a fixed number of cores between searches that run at the same time,
+// such as the two branches of a challenge decision (a sim, PEG or endgame
+// each) or the leaf endgames of a PEG solve. Each search acquires the cores it
+// starts with and releases them when it finishes. A background monitor lends
+// idle cores to registered endgame solves by injecting ABDADA workers with
+// endgame_add_worker, so the cores a finished search frees up keep working on
+// the searches that are still running.
+//
+// A core is only lent to a solve that has run for a little while (so the many
+// sub-millisecond solves never pay for a spawn) and that has enough time left
+// before its deadline for an extra worker to pay off. Among those, the solve
+// with the most remaining time per live worker gets the core. Lent cores
+// return to the lender when the solve they were lent to ends.
+typedef struct CoreLender CoreLender;
+
+// Reports how many of the cores a running search acquired are idle right now,
+// for example the idle workers of a PegPool whose stage is draining.
+typedef int (*CoreLenderIdleCoresFn)(void *data);
+
+// Creates the lender and starts its monitor thread.
+CoreLender *core_lender_create(int num_cores);
+// Stops the monitor. All registered endgames and idle sources must be
+// removed.
+void core_lender_destroy(CoreLender *lender);
+
+int core_lender_get_num_cores(const CoreLender *lender);
+// Number of cores that are neither acquired nor lent out.
+int core_lender_get_free_cores(CoreLender *lender);
+// Number of cores lent to endgame solves since the lender was created.
+int core_lender_get_num_loans(CoreLender *lender);
+
+// Acquires up to num_cores cores for a search that is about to start and
+// returns the number acquired, which may be 0 when every core is busy.
+int core_lender_acquire(CoreLender *lender, int num_cores);
+// Returns cores acquired by a search that has finished so that the lender can
+// lend them to the searches that are still running.
+void core_lender_release(CoreLender *lender, int num_cores);
+
+// Registers a search that gives back the cores it acquired while it runs
+// short of work: the idle cores it reports are lent like free cores, and
+// every core lent against them counts against the search's idle cores until
+// the solve it was lent to ends. data identifies the source for removal.
+void core_lender_add_idle_source(CoreLender *lender,
+                                 CoreLenderIdleCoresFn idle_cores_fn,
+                                 void *data);
+void core_lender_remove_idle_source(CoreLender *lender, void *data);
+
+// Registers an endgame context whose solves may be grown with lent cores. The
+// solves must be launched with max_workers above their thread count for the
+// lender to grow them. deadline_ns is a monotonic deadline for the solves, or
+// 0 for none. The context must exist before it is registered, and it may be
+// reused for several solves while registered.
+void core_lender_add_endgame(CoreLender *lender, EndgameCtx *endgame_ctx,
+                             int64_t deadline_ns);
+// Unregisters the endgame context once its solve has returned and takes back
+// any cores that were lent to it.
+void core_lender_remove_endgame(CoreLender *lender, EndgameCtx *endgame_ctx);
+
+#endif
@@ -18,9 +18,11 @@
 #include "../ent/bonus_square.h"
 #include "../ent/dictionary_word.h"
 #include "../ent/endgame_results.h"
+#include "../ent/endgame_tablebase.h"
 #include "../ent/equity.h"
 #include "../ent/game.h"
 #include "../ent/kwg.h"
+#include "../ent/lane_move_cache.h"
 #include "../ent/letter_distribution.h"
 #include "../ent/move.h"
 #include "../ent/move_undo.h"
@@ -39,6 +41,7 @@
 #include "gameplay.h"
 #include "kwg_maker.h"
 #include "move_gen.h"
+#include "thread_pool.h"
 #include "word_prune.h"
 #include <assert.h>
 #include <math.h>
@@ -49,6 +52,9 @@
 
 enum {
   DEFAULT_ENDGAME_MOVELIST_CAPACITY = 250000,
+  // Per-worker lane move cache slots. Each slot keeps one lane's key and
+  // moves, so this is roughly a megabyte of keys per worker.
+  ENDGAME_LANE_MOVE_CACHE_ENTRIES = 1024,
   // Maximum moves for stack allocation in ABDADA deferred tracking
   // Keep small to avoid stack overflow in deep recursive searches
   MAX_DEFERRED_STACK = 64,
@@ -74,6 +80,28 @@ enum {
   // usually happen within the first few moves, so most nodes never pay for
   // a full sort of the move list.
   LAZY_SELECTION_LIMIT = 8,
+  // Small-rack subgame tablebase: 2^18 entries (4 MB) per solver, used below
+  // the root wherever neither rack holds more than the configured number of
+  // tiles. A subgame has at most one tile-playing turn per tile of both
+  // racks, and fewer than MAX_SCORELESS_TURNS scoreless turns in a row
+  // before each of those turns and after the last one.
+  ENDGAME_TABLEBASE_SIZE_POWER = 18,
+  ENDGAME_TABLEBASE_MAX_PLIES =
+      (2 * ENDGAME_TABLEBASE_MAX_TILES + 1) * MAX_SCORELESS_TURNS,
+  // Killer moves remembered per ply from the root.
+  ENDGAME_KILLER_SLOTS = 2,
+  // History table entries per side to move, indexed by a hash of the
+  // tiny_move (tiles, position and direction).
+  ENDGAME_HISTORY_BITS = 12,
+  ENDGAME_HISTORY_SIZE = 1 << ENDGAME_HISTORY_BITS,
+  // Once an entry passes this the whole table is halved, so history keeps
+  // favoring moves that cut off in the part of the tree searched recently.
+  ENDGAME_HISTORY_MAX = 1 << 16,
+  // Estimate bonuses in points for a killer move and for a history entry at
+  // ENDGAME_HISTORY_MAX. The static estimates already put the cutoff move
+  // first at most nodes, so these only break near-ties.
+  ENDGAME_KILLER_BONUS = 16,
+  ENDGAME_HISTORY_BONUS = 16,
   // Conservation bonus weights: penalize playing tiles when opponent is stuck
   CONSERVATION_TILE_WEIGHT = 7,
   CONSERVATION_VALUE_WEIGHT = 2,
@@ -148,6 +176,10 @@ struct EndgameCtx {
   double tt_fraction_of_mem;
   TranspositionTable *transposition_table;
   bool tt_is_external; // true when using a caller-provided shared TT
+  // Exact values for small-rack subgames. Allocated on the first solve that
+  // uses it; tablebase_max_tiles is 0 when this solve does not.
+  EndgameTablebase *tablebase;
+  int tablebase_max_tiles;
 
   // Signal for threads to stop early (0=running, 1=done)
   atomic_int search_complete;
@@ -199,7 +231,7 @@ struct EndgameCtx {
   // (e.g., different lexicon), the pool is destroyed and rebuilt to avoid
   // bag_copy into incompatibly-sized allocations.
   EndgameCtxWorker **workers;
-  cpthread_t *worker_ids;
+  ThreadPoolThread **worker_ids;
   // _Atomic so the lock-free live-view accessors can read it (acquire) while
   // endgame_add_worker grows it (under add_mutex) during a solve.
   atomic_int cap_workers; // created worker structs (workers[0..cap_workers))
@@ -226,6 +258,9 @@ struct EndgameCtxWorker {
   Game *game_copy;
   Arena *small_move_arena;
   MoveList *move_list;
+  // Lanes left untouched by the plays since the side to move last generated
+  // with the same rack reuse their moves from here.
+  LaneMoveCache *lane_move_cache;
   EndgameCtx *solver;
   int current_iterative_deepening_depth;
   // Array of MoveUndo structures for incremental play/unplay. Sized at
@@ -239,6 +274,8 @@ struct EndgameCtxWorker {
   // Per-depth MoveUndo for forced-pass bypass. Pass recurses at the same depth
   // so it cannot share move_undos[]; indexed by the depth parameter (0..25).
   MoveUndo pass_undos[MAX_SEARCH_DEPTH + 1];
+  // MoveUndo per ply of an exact tablebase subgame solve below a leaf.
+  MoveUndo tablebase_undos[ENDGAME_TABLEBASE_MAX_PLIES];
   XoshiroPRNG *prng;       // Per-thread PRNG for jitter
   PVLine best_pv;          // Thread-local best PV
   int32_t best_pv_value;   // Thread-local best value
@@ -248,6 +285,13 @@ struct EndgameCtxWorker {
   // Counter for throttling per-depth deadline checks in abdada_negamax
   uint64_t nodes_since_deadline_check;
 
+  // Move ordering state, kept across the depths of one solve. Killers are
+  // the last moves to cause a beta cutoff at each ply from the root; history
+  // accumulates depth^2 per cutoff for each side to move. Both feed
+  // assign_estimates.
+  uint64_t killer_moves[MAX_SEARCH_DEPTH + 1][ENDGAME_KILLER_SLOTS];
+  int32_t history[2][ENDGAME_HISTORY_SIZE];
+
   // Per-thread node counter for the live-progress getter. Plain uint64
   // (no atomics on the writer side); flushed periodically to the
   // shared atomic via the deadline-check rhythm. The reader sums per-
@@ -255,6 +299,12 @@ struct EndgameCtxWorker {
   // nodes) is acceptable.
   uint64_t local_nodes_searched;
   _Atomic uint64_t published_nodes_searched;
+  // Beta cutoffs, and those caused by the first move searched at the node.
+  // Published alongside the node count.
+  uint64_t local_beta_cutoffs;
+  uint64_t local_first_move_cutoffs;
+  _Atomic uint64_t published_beta_cutoffs;
+  _Atomic uint64_t published_first_move_cutoffs;
 
   // Per-thread "current line being explored" for the live-progress
   // getter. current_line[i] is the tiny_move played at the i-th ply
@@ -782,6 +832,19 @@ void endgame_ctx_reset(EndgameCtx *es, EndgameResults *results,
   if (es->transposition_table == NULL) {
     es->transposition_table_optim = false;
   }
+  // The tablebase stands in for greedy leaf playouts and is keyed by the
+  // TT's Zobrist hashes. Its values depend on this solve's pruned KWGs, so
+  // every solve starts a new generation.
+  es->tablebase_max_tiles = 0;
+  if (es->use_heuristics && es->transposition_table_optim &&
+      endgame_args->tablebase_max_tiles > 0) {
+    es->tablebase_max_tiles =
+        MIN(endgame_args->tablebase_max_tiles, ENDGAME_TABLEBASE_MAX_TILES);
+    if (!es->tablebase) {
+      es->tablebase = endgame_tablebase_create(ENDGAME_TABLEBASE_SIZE_POWER);
+    }
+    endgame_tablebase_new_generation(es->tablebase);
+  }
   es->results = results;
   if (es->results) {
     endgame_results_lock(es->results, ENDGAME_RESULT_DISPLAY);
@@ -862,6 +925,22 @@ uint64_t endgame_ctx_get_nodes_searched(const EndgameCtx *ctx) {
   return total;
 }
 
+void endgame_ctx_get_move_ordering_stats(const EndgameCtx *ctx,
+                                         uint64_t *beta_cutoffs,
+                                         uint64_t *first_move_cutoffs) {
+  *beta_cutoffs = 0;
+  *first_move_cutoffs = 0;
+  const int active = endgame_active_worker_count(ctx);
+  for (int worker_idx = 0; worker_idx < active; worker_idx++) {
+    *beta_cutoffs +=
+        atomic_load_explicit(&ctx->workers[worker_idx]->published_beta_cutoffs,
+                             memory_order_relaxed);
+    *first_move_cutoffs += atomic_load_explicit(
+        &ctx->workers[worker_idx]->published_first_move_cutoffs,
+        memory_order_relaxed);
+  }
+}
+
 int endgame_ctx_get_current_line(const EndgameCtx *ctx, int worker_index,
                                  uint64_t *out_line, int max_len) {
   if (max_len <= 0 || worker_index < 0 ||
@@ -986,6 +1065,7 @@ static void solver_worker_destroy(EndgameCtxWorker *solver_worker) {
   }
   game_destroy(solver_worker->game_copy);
   small_move_list_destroy(solver_worker->move_list);
+  lane_move_cache_destroy(solver_worker->lane_move_cache);
   arena_destroy(solver_worker->small_move_arena);
   prng_destroy(solver_worker->prng);
   free(solver_worker);
@@ -1004,6 +1084,7 @@ void endgame_ctx_destroy(EndgameCtx *ctx) {
   if (!ctx->tt_is_external) {
     transposition_table_destroy(ctx->transposition_table);
   }
+  endgame_tablebase_destroy(ctx->tablebase);
   kwg_destroy(ctx->pruned_kwgs[0]);
   kwg_destroy(ctx->pruned_kwgs[1]);
   game_destroy(ctx->ext_game);
@@ -1025,6 +1106,8 @@ static EndgameCtxWorker *endgame_ctx_create_worker(EndgameCtx *solver,
 
   solver_worker->move_list =
       move_list_create_small(DEFAULT_ENDGAME_MOVELIST_CAPACITY);
+  solver_worker->lane_move_cache =
+      lane_move_cache_create(ENDGAME_LANE_MOVE_CACHE_ENTRIES);
 
   solver_worker->small_move_arena =
       create_arena(solver->initial_small_move_arena_size, 16);
@@ -1053,6 +1136,19 @@ static void reset_worker_analysis_state(EndgameCtxWorker *worker) {
   worker->local_nodes_searched = 0;
   atomic_store_explicit(&worker->published_nodes_searched, 0,
                         memory_order_relaxed);
+  worker->local_beta_cutoffs = 0;
+  worker->local_first_move_cutoffs = 0;
+  atomic_store_explicit(&worker->published_beta_cutoffs, 0,
+                        memory_order_relaxed);
+  atomic_store_explicit(&worker->published_first_move_cutoffs, 0,
+                        memory_order_relaxed);
+  // A zero tiny_move is a pass, so empty killer slots hold the invalid move.
+  for (int ply = 0; ply <= MAX_SEARCH_DEPTH; ply++) {
+    for (int slot = 0; slot < ENDGAME_KILLER_SLOTS; slot++) {
+      worker->killer_moves[ply][slot] = INVALID_TINY_MOVE;
+    }
+  }
+  memset(worker->history, 0, sizeof(worker->history));
   atomic_store_explicit(&worker->current_line_len, 0, memory_order_relaxed);
   atomic_store_explicit(&worker->live_pv_length, 0, memory_order_relaxed);
   atomic_store_explicit(&worker->live_pv_value, 0, memory_order_relaxed);
@@ -1071,6 +1167,9 @@ static void endgame_ctx_reset_worker(EndgameCtxWorker *worker,
   game_set_endgame_solving_mode(worker->game_copy);
   game_set_backup_mode(worker->game_copy, BACKUP_MODE_SIMULATION);
   arena_reset(worker->small_move_arena);
+  // Entries are keyed on KWG pointers, and the pruned KWGs of the previous
+  // solve may have been freed.
+  lane_move_cache_reset(worker->lane_move_cache);
   memset(worker->move_undos, 0, sizeof(worker->move_undos));
   prng_seed(worker->prng, base_seed + (uint64_t)worker->ordinal * 12345);
   worker->best_pv.game = worker->game_copy;
@@ -1127,8 +1226,8 @@ static void endgame_ctx_prepare_workers(EndgameCtx *solver,
   if (solver->arr_cap < needed_cap) {
     solver->workers = realloc_or_die(solver->workers,
                                      sizeof(EndgameCtxWorker *) * needed_cap);
-    solver->worker_ids =
-        realloc_or_die(solver->worker_ids, sizeof(cpthread_t) * needed_cap);
+    solver->worker_ids = realloc_or_die(
+        solver->worker_ids, sizeof(ThreadPoolThread *) * needed_cap);
     for (int idx = solver->arr_cap; idx < needed_cap; idx++) {
       solver->workers[idx] = NULL;
     }
@@ -1446,6 +1545,7 @@ int generate_stm_plays(EndgameCtxWorker *worker, int depth) {
       .eq_margin_movegen = 0,
       .target_equity = EQUITY_MAX_VALUE,
       .target_leave_size_for_exchange_cutoff = UNSET_LEAVE_SIZE,
+      .lane_move_cache = worker->lane_move_cache,
   };
   generate_moves(&args);
 
@@ -1649,10 +1749,57 @@ static int *compute_build_chain_values(EndgameCtxWorker *worker, int move_count,
   return build_values;
 }
 
+static inline uint32_t history_index(uint64_t tiny_move) {
+  return (uint32_t)((tiny_move * 0x9E3779B97F4A7C15ULL) >>
+                    (64 - ENDGAME_HISTORY_BITS));
+}
+
+// Estimate bonus from the move ordering tables: ENDGAME_KILLER_BONUS for a
+// killer move at this ply, otherwise up to ENDGAME_HISTORY_BONUS of history.
+static inline int32_t move_ordering_bonus(const EndgameCtxWorker *worker,
+                                          int ply, int player_index,
+                                          uint64_t tiny_move) {
+  const uint64_t *killers = worker->killer_moves[ply];
+  for (int slot = 0; slot < ENDGAME_KILLER_SLOTS; slot++) {
+    if (killers[slot] == tiny_move) {
+      return ENDGAME_KILLER_BONUS;
+    }
+  }
+  return worker->history[player_index][history_index(tiny_move)] *
+         ENDGAME_HISTORY_BONUS / ENDGAME_HISTORY_MAX;
+}
+
+// Records a beta cutoff by tiny_move: counts it, makes the move the first
+// killer at this ply and adds depth^2 to its history entry.
+static void record_beta_cutoff(EndgameCtxWorker *worker, int ply,
+                               int player_index, int depth, uint64_t tiny_move,
+                               bool first_move) {
+  worker->local_beta_cutoffs++;
+  if (first_move) {
+    worker->local_first_move_cutoffs++;
+  }
+  uint64_t *killers = worker->killer_moves[ply];
+  if (killers[0] != tiny_move) {
+    for (int slot = ENDGAME_KILLER_SLOTS - 1; slot > 0; slot--) {
+      killers[slot] = killers[slot - 1];
+    }
+    killers[0] = tiny_move;
+  }
+  int32_t *history = worker->history[player_index];
+  int32_t *entry = &history[history_index(tiny_move)];
+  *entry += depth * depth;
+  if (*entry > ENDGAME_HISTORY_MAX) {
+    for (int i = 0; i < ENDGAME_HISTORY_SIZE; i++) {
+      history[i] /= 2;
+    }
+  }
+}
+
 // Assign estimated values to the freshly generated moves at the top of the
 // arena. Does not sort: interior nodes order moves lazily in abdada_negamax
-// (selection picks + one tail sort), and the root sorts explicitly.
-void assign_estimates(EndgameCtxWorker *worker, int move_count,
+// (selection picks + one tail sort), and the root sorts explicitly. ply is the
+// distance from the root, used to look up killer moves.
+void assign_estimates(EndgameCtxWorker *worker, int move_count, int ply,
                       uint64_t tt_move, float opp_stuck_frac) {
   const int player_index = game_get_player_on_turn_index(worker->game_copy);
   const Player *player = game_get_player(worker->game_copy, player_index);
@@ -1722,6 +1869,10 @@ void assign_estimates(EndgameCtxWorker *worker, int move_count,
       small_move_set_estimated_value(current_move, estimate);
     }
 
+    small_move_add_estimated_value(
+        current_move, move_ordering_bonus(worker, ply, player_index,
+                                          current_move->tiny_move));
+
     if (current_move->tiny_move == tt_move) {
       small_move_add_estimated_value(current_move, HASH_MOVE_BF);
     }
@@ -1739,7 +1890,7 @@ void assign_estimates(EndgameCtxWorker *worker, int move_count,
 // Used for the root move list, which is iterated in full every depth.
 void assign_estimates_and_sort(EndgameCtxWorker *worker, int move_count,
                                uint64_t tt_move, float opp_stuck_frac) {
-  assign_estimates(worker, move_count, tt_move, opp_stuck_frac);
+  assign_estimates(worker, move_count, 0, tt_move, opp_stuck_frac);
   SmallMove *small_moves = (SmallMove *)(worker->small_move_arena->memory +
                                          worker->small_move_arena->size -
                                          (sizeof(SmallMove) * move_count));
@@ -1860,6 +2011,7 @@ static int32_t negamax_greedy_leaf_playout(EndgameCtxWorker *worker,
           .eq_margin_movegen = 0,
           .target_equity = EQUITY_MAX_VALUE,
           .target_leave_size_for_exchange_cutoff = UNSET_LEAVE_SIZE,
+          .lane_move_cache = worker->lane_move_cache,
       };
       generate_moves(&pargs);
       nplays = worker->move_list->count;
@@ -2013,6 +2165,227 @@ static void negamax_tt_store(const EndgameCtxWorker *worker, uint64_t node_key,
                             entry_to_store);
 }
 
+// Applies the lazy cross-set update left behind by the move that led to this
+// node, if it has not been applied yet.
+static inline void negamax_ensure_cross_sets_valid(EndgameCtxWorker *worker,
+                                                   int depth) {
+  Board *board = game_get_board(worker->game_copy);
+  if (!board_get_cross_sets_valid(board)) {
+    int undo_index = worker->solver->requested_plies - depth - 1;
+    if (undo_index >= 0) {
+      MoveUndo *parent_undo = &worker->move_undos[undo_index];
+      if (parent_undo->move_tiles_length > 0) {
+        update_cross_set_for_move_from_undo(parent_undo, worker->game_copy);
+      }
+    }
+    board_set_cross_sets_valid(board, true);
+  }
+}
+
+// Rebuilds the TT move as a scored SmallMove if it is still a legal tile
+// placement for the side to move. The TT only keeps the tiny move and a key
+// collision can return a move from another position, so the squares, rack
+// tiles, cross-sets and main word are all checked against the current
+// position. Passes are not staged. Assumes cross-sets are valid.
+static bool negamax_load_tt_move(EndgameCtxWorker *worker, uint64_t tt_move,
+                                 SmallMove *sm) {
+  if (tt_move == INVALID_TINY_MOVE || tt_move == 0) {
+    return false;
+  }
+  const int row_start = (int)((tt_move & SMALL_MOVE_ROW_BITMASK) >> 6);
+  const int col_start = (int)((tt_move & SMALL_MOVE_COL_BITMASK) >> 1);
+  if (row_start >= BOARD_DIM || col_start >= BOARD_DIM) {
+    return false;
+  }
+  Game *game = worker->game_copy;
+  Board *board = game_get_board(game);
+  const bool vertical = (tt_move & 1) != 0;
+  const int row_inc = vertical ? 1 : 0;
+  const int col_inc = vertical ? 0 : 1;
+  // The main word must not extend past its recorded start square.
+  if (row_start - row_inc >= 0 && col_start - col_inc >= 0 &&
+      !board_is_empty(board, row_start - row_inc, col_start - col_inc)) {
+    return false;
+  }
+
+  memset(sm, 0, sizeof(SmallMove));
+  sm->tiny_move = tt_move;
+  Move *move = worker->move_list->spare_move;
+  small_move_to_move(move, sm, board);
+  int encoded_tiles = 0;
+  while (encoded_tiles < (int)(sizeof(SMALL_MOVE_T_BITMASK) /
+                               sizeof(SMALL_MOVE_T_BITMASK[0])) &&
+         (tt_move & SMALL_MOVE_T_BITMASK[encoded_tiles]) != 0) {
+    encoded_tiles++;
+  }
+  const int tiles_played = move_get_tiles_played(move);
+  const int tiles_length = move_get_tiles_length(move);
+  if (tiles_played == 0 || tiles_played != encoded_tiles) {
+    return false;
+  }
+
+  const int stm_idx = game_get_player_on_turn_index(game);
+  const Rack *stm_rack = player_get_rack(game_get_player(game, stm_idx));
+  const int ci = board_get_cross_set_index(
+      game_get_data_is_shared(game, PLAYERS_DATA_TYPE_KWG), stm_idx);
+  const KWG *kwg = solver_get_pruned_kwg(worker->solver, stm_idx);
+  uint32_t node_index = kwg_get_dawg_root_node_index(kwg);
+  bool connected = false;
+  int row = row_start;
+  int col = col_start;
+  for (int idx = 0; idx < tiles_length;
+       idx++, row += row_inc, col += col_inc) {
+    MachineLetter ml = move_get_tile(move, idx);
+    if (ml == PLAYED_THROUGH_MARKER) {
+      ml = board_get_letter(board, row, col);
+      connected = true;
+    } else {
+      if (board_is_nonempty_or_bricked(board, row, col)) {
+        return false;
+      }
+      const MachineLetter rack_ml =
+          get_is_blanked(ml) ? BLANK_MACHINE_LETTER : ml;
+      int needed = 0;
+      for (int other = 0; other < tiles_length; other++) {
+        const MachineLetter other_ml = move_get_tile(move, other);
+        if (other_ml != PLAYED_THROUGH_MARKER &&
+            (get_is_blanked(other_ml) ? BLANK_MACHINE_LETTER : other_ml) ==
+                rack_ml) {
+          needed++;
+        }
+      }
+      if (rack_get_letter(stm_rack, rack_ml) < needed) {
+        return false;
+      }
+      if (!board_is_letter_allowed_in_cross_set(
+              board_get_cross_set(board, row, col, move_get_dir(move), ci),
+              get_unblanked_machine_letter(ml))) {
+        return false;
+      }
+      if ((row - col_inc >= 0 && col - row_inc >= 0 &&
+           !board_is_empty(board, row - col_inc, col - row_inc)) ||
+          (row + col_inc < BOARD_DIM && col + row_inc < BOARD_DIM &&
+           !board_is_empty(board, row + col_inc, col + row_inc))) {
+        connected = true;
+      }
+    }
+    if (tiles_length == 1) {
+      continue;
+    }
+    if (idx < tiles_length - 1) {
+      node_index = kwg_get_next_node_index(kwg, node_index,
+                                           get_unblanked_machine_letter(ml));
+      if (node_index == 0) {
+        return false;
+      }
+    } else if (!kwg_in_letter_set(kwg, ml, node_index)) {
+      return false;
+    }
+  }
+  if (!connected) {
+    return false;
+  }
+
+  const Equity score = static_eval_get_move_score(
+      game_get_ld(game), move, board, game_get_bingo_bonus(game), ci);
+  sm->metadata.score = (uint16_t)equity_to_int(score);
+  sm->metadata.play_length = (uint8_t)tiles_length;
+  sm->metadata.tiles_played = (uint8_t)tiles_played;
+  return true;
+}
+
+// Plays small_move for the side to move into undo and returns the child's TT
+// key.
+static inline uint64_t play_small_move(EndgameCtxWorker *worker,
+                                       const SmallMove *small_move,
+                                       uint64_t node_key, int on_turn_idx,
+                                       MoveUndo *undo) {
+  small_move_to_move(worker->move_list->spare_move, small_move,
+                     game_get_board(worker->game_copy));
+
+  const Rack *stm_rack =
+      player_get_rack(game_get_player(worker->game_copy, on_turn_idx));
+  const int stm_rack_tiles = rack_get_total_letters(stm_rack);
+  const bool is_outplay =
+      small_move_get_tiles_played(small_move) == stm_rack_tiles;
+
+  // Outplays use play_move_endgame_outplay (below), which deliberately does
+  // NOT empty the rack, so stm_rack still holds the full pre-move rack.
+  // zobrist_add_move treats its rack arg as the post-move leftover, which
+  // for an outplay is empty; passing the stale full rack double-counts the
+  // played tiles (placeholder = placed + full = 2*placed) and can index the
+  // rack hash table out of bounds -- e.g. outplaying four S's yields
+  // placeholder[S] = 8 into an 8-slot (0..RACK_SIZE) row. Use an empty
+  // leftover for outplays.
+  Rack outplay_leftover;
+  if (is_outplay) {
+    rack_set_dist_size_and_reset(&outplay_leftover,
+                                 rack_get_dist_size(stm_rack));
+  }
+  const Rack *move_leftover_rack = is_outplay ? &outplay_leftover : stm_rack;
+
+  int last_consecutive_scoreless_turns =
+      game_get_consecutive_scoreless_turns(worker->game_copy);
+
+  // Use optimized function for outplays - skips board/cross-set updates
+  if (is_outplay) {
+    play_move_endgame_outplay(worker->move_list->spare_move, worker->game_copy,
+                              undo);
+  } else {
+    play_move_incremental(worker->move_list->spare_move, worker->game_copy,
+                          undo);
+    // Cross-sets are left invalid - they will be computed lazily before
+    // move generation if we reach that point. The cross-set squares will be
+    // saved to MoveUndo before updating, so they're restored on unplay.
+  }
+
+  uint64_t child_key = 0;
+  if (worker->solver->transposition_table_optim) {
+    child_key = zobrist_add_move(
+        worker->solver->transposition_table->zobrist, node_key,
+        worker->move_list->spare_move, move_leftover_rack,
+        on_turn_idx == worker->solver->solving_player,
+        game_get_consecutive_scoreless_turns(worker->game_copy),
+        last_consecutive_scoreless_turns);
+  }
+  return child_key;
+}
+
+// Plays small_move for the side to move into the given undo slot, publishes
+// it to the live current line and returns the child's TT key.
+static inline uint64_t negamax_play_child(EndgameCtxWorker *worker,
+                                          const SmallMove *small_move,
+                                          uint64_t node_key, int on_turn_idx,
+                                          int undo_index) {
+  // Live-progress: publish this move into the per-thread "current line"
+  // buffer before recursing so a polling reader can see what the engine
+  // is currently exploring even during a long single-root subtree where
+  // no other signal updates. The slot store is a relaxed atomic; the
+  // length store uses release ordering so the reader (acquire on length)
+  // sees the tiny_move write.
+  atomic_store_explicit(&worker->current_line[undo_index],
+                        small_move->tiny_move, memory_order_relaxed);
+  atomic_store_explicit(&worker->current_line_len, undo_index + 1,
+                        memory_order_release);
+  return play_small_move(worker, small_move, node_key, on_turn_idx,
+                         &worker->move_undos[undo_index]);
+}
+
+// Reverts negamax_play_child.
+static inline void negamax_unplay_child(EndgameCtxWorker *worker,
+                                        int undo_index) {
+  unplay_move_incremental(worker->game_copy, &worker->move_undos[undo_index]);
+  // Cross-sets need no recompute here: any lazy cross-set update in the
+  // child's subtree was saved into this undo (or a descendant's undo that
+  // was already restored), so the square restore reverted them exactly.
+
+  // Live-progress: pop the line back to the parent's depth. The entry at
+  // undo_index is left as-is (overwritten by the next sibling's push).
+  // Release pairs with the reader's acquire on length.
+  atomic_store_explicit(&worker->current_line_len, undo_index,
+                        memory_order_release);
+}
+
 // Stuck-tile detection, move generation, logging, and estimate assignment
 // for non-root nodes (move ordering itself is done lazily by the caller).
 // Updates *opp_stuck_frac. Returns move count, or -1 if interrupted.
@@ -2027,19 +2400,7 @@ static int negamax_generate_and_estimate_moves(EndgameCtxWorker *worker,
   // generate_stm_plays; doing it here first means generate_stm_plays will
   // find cross-sets already valid and skip its own update. Net cost is
   // identical — one update per node either way.
-  {
-    Board *board = game_get_board(worker->game_copy);
-    if (!board_get_cross_sets_valid(board)) {
-      int undo_index = worker->solver->requested_plies - depth - 1;
-      if (undo_index >= 0) {
-        MoveUndo *parent_undo = &worker->move_undos[undo_index];
-        if (parent_undo->move_tiles_length > 0) {
-          update_cross_set_for_move_from_undo(parent_undo, worker->game_copy);
-        }
-      }
-      board_set_cross_sets_valid(board, true);
-    }
-  }
+  negamax_ensure_cross_sets_valid(worker, depth);
   if (worker->solver->use_heuristics) {
     *opp_stuck_frac = compute_opp_stuck_fraction(
         worker->game_copy, worker->move_list,
@@ -2084,7 +2445,9 @@ static int negamax_generate_and_estimate_moves(EndgameCtxWorker *worker,
     }
   }
 
-  assign_estimates(worker, nplays, tt_move, *opp_stuck_frac);
+  assign_estimates(worker, nplays,
+                   worker->current_iterative_deepening_depth - depth, tt_move,
+                   *opp_stuck_frac);
   return nplays;
 }
 
@@ -2216,12 +2579,19 @@ static void publish_live_top_k_pv(EndgameCtxWorker *worker, uint64_t root_tiny,
                         memory_order_release);
 }
 
-int32_t abdada_negamax(EndgameCtxWorker *worker, uint64_t node_key, int depth,
-                       int32_t alpha, int32_t beta, PVLine *pv, bool pv_node,
-                       bool exclusive_p, float opp_stuck_frac) {
-
-  assert(pv_node || alpha == beta - 1);
+// Copies the worker's node and cutoff counts to the atomics read by the
+// live-progress getters.
+static inline void publish_search_counters(EndgameCtxWorker *worker) {
+  atomic_store_explicit(&worker->published_nodes_searched,
+                        worker->local_nodes_searched, memory_order_relaxed);
+  atomic_store_explicit(&worker->published_beta_cutoffs,
+                        worker->local_beta_cutoffs, memory_order_relaxed);
+  atomic_store_explicit(&worker->published_first_move_cutoffs,
+                        worker->local_first_move_cutoffs, memory_order_relaxed);
+}
 
+// Counts a node visit and returns true if the search must stop.
+static inline bool count_node_and_check_stop(EndgameCtxWorker *worker) {
   // Live-progress: count this node visit in the per-thread local counter.
   // The published-to-shared atomic is updated alongside the deadline check
   // below, batching ~DEPTH_DEADLINE_CHECK_INTERVAL increments into one
@@ -2230,7 +2600,7 @@ int32_t abdada_negamax(EndgameCtxWorker *worker, uint64_t node_key, int depth,
   worker->local_nodes_searched++;
 
   if (iterative_deepening_should_stop(worker->solver)) {
-    return ABDADA_INTERRUPTED;
+    return true;
   }
 
   // Per-depth deadline check: bail mid-depth if we're running over the EBF
@@ -2243,11 +2613,152 @@ int32_t abdada_negamax(EndgameCtxWorker *worker, uint64_t node_key, int depth,
     // Flush per-thread node count to the shared atomic at the same
     // cadence as the deadline check, so the live-progress getter sees
     // updates ~once per DEPTH_DEADLINE_CHECK_INTERVAL nodes per worker.
-    atomic_store_explicit(&worker->published_nodes_searched,
-                          worker->local_nodes_searched, memory_order_relaxed);
+    publish_search_counters(worker);
     if (check_depth_deadline(worker)) {
-      return ABDADA_INTERRUPTED;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Whether the position is a small-rack subgame the tablebase solves.
+static inline bool tablebase_covers_node(const EndgameCtxWorker *worker) {
+  const int max_tiles = worker->solver->tablebase_max_tiles;
+  if (max_tiles == 0) {
+    return false;
+  }
+  for (int player_idx = 0; player_idx < 2; player_idx++) {
+    const Rack *rack =
+        player_get_rack(game_get_player(worker->game_copy, player_idx));
+    if (rack_get_total_letters(rack) > max_tiles) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Exact fail-soft negamax over the rest of a small-rack subgame. Returns the
+// final spread for the side to move. Values that land strictly inside the
+// window are exact and go to the tablebase as the change from the current
+// spread. ply is the distance into the subgame and indexes tablebase_undos.
+static int32_t tablebase_negamax(EndgameCtxWorker *worker, uint64_t node_key,
+                                 int ply, int32_t alpha, int32_t beta,
+                                 PVLine *pv) {
+  pv->num_moves = 0;
+  pv->negamax_depth = 0;
+  if (count_node_and_check_stop(worker)) {
+    return ABDADA_INTERRUPTED;
+  }
+  Game *game = worker->game_copy;
+  const int on_turn_idx = game_get_player_on_turn_index(game);
+  const int32_t on_turn_spread =
+      equity_to_int(player_get_score(game_get_player(game, on_turn_idx)) -
+                    player_get_score(game_get_player(game, 1 - on_turn_idx)));
+  if (game_get_game_end_reason(game) != GAME_END_REASON_NONE) {
+    return on_turn_spread;
+  }
+  int16_t tablebase_value;
+  if (endgame_tablebase_probe(worker->solver->tablebase, node_key,
+                              &tablebase_value)) {
+    return on_turn_spread + tablebase_value;
+  }
+  assert(ply < ENDGAME_TABLEBASE_MAX_PLIES);
+
+  Board *board = game_get_board(game);
+  if (ply > 0 && !board_get_cross_sets_valid(board)) {
+    MoveUndo *parent_undo = &worker->tablebase_undos[ply - 1];
+    if (parent_undo->move_tiles_length > 0) {
+      update_cross_set_for_move_from_undo(parent_undo, game);
+    }
+    board_set_cross_sets_valid(board, true);
+  }
+  // Cross-sets are valid here, so the depth only matters for the root move
+  // augmentation, which a leaf never gets.
+  const int nplays = generate_stm_plays(worker, 0);
+  const size_t arena_offset =
+      worker->small_move_arena->size - (sizeof(SmallMove) * nplays);
+  SmallMove *moves =
+      (SmallMove *)(worker->small_move_arena->memory + arena_offset);
+  const int rack_tiles = rack_get_total_letters(
+      player_get_rack(game_get_player(game, on_turn_idx)));
+  for (int i = 0; i < nplays; i++) {
+    int32_t estimate = small_move_get_score(&moves[i]);
+    if (small_move_get_tiles_played(&moves[i]) == rack_tiles) {
+      estimate |= GOING_OUT_BF;
+    }
+    small_move_set_estimated_value(&moves[i], estimate);
+  }
+  qsort(moves, nplays, sizeof(SmallMove),
+        compare_small_moves_by_estimated_value);
+
+  const int32_t alpha_orig = alpha;
+  int32_t best_value = -LARGE_VALUE;
+  PVLine child_pv;
+  child_pv.game = game;
+  for (int idx = 0; idx < nplays; idx++) {
+    // Copied out, since the arena may move while the child generates.
+    const SmallMove small_move =
+        *(const SmallMove *)(worker->small_move_arena->memory + arena_offset +
+                             idx * sizeof(SmallMove));
+    const uint64_t child_key =
+        play_small_move(worker, &small_move, node_key, on_turn_idx,
+                        &worker->tablebase_undos[ply]);
+    const int32_t value = tablebase_negamax(worker, child_key, ply + 1, -beta,
+                                            -alpha, &child_pv);
+    unplay_move_incremental(game, &worker->tablebase_undos[ply]);
+    if (value == ABDADA_INTERRUPTED) {
+      best_value = ABDADA_INTERRUPTED;
+      break;
     }
+    if (-value > best_value) {
+      best_value = -value;
+      pvline_update(pv, &child_pv, &small_move, 0);
+      pv->negamax_depth = pv->num_moves;
+    }
+    alpha = MAX(alpha, best_value);
+    if (best_value >= beta) {
+      break;
+    }
+  }
+  arena_dealloc(worker->small_move_arena, nplays * sizeof(SmallMove));
+
+  if (best_value != ABDADA_INTERRUPTED && alpha_orig < best_value &&
+      best_value < beta) {
+    endgame_tablebase_store(worker->solver->tablebase, node_key,
+                            (int16_t)(best_value - on_turn_spread));
+  }
+  return best_value;
+}
+
+// Searches a node whose racks the tablebase covers as an exact subgame
+// instead of to the remaining depth. The result is a true game value (or a
+// bound on one, outside the window), so it goes to the TT at the deepest
+// depth and satisfies every later probe.
+static int32_t negamax_tablebase_search(EndgameCtxWorker *worker,
+                                        uint64_t node_key, int depth,
+                                        int32_t alpha, int32_t beta,
+                                        int32_t on_turn_spread, PVLine *pv) {
+  negamax_ensure_cross_sets_valid(worker, depth);
+  const int32_t value =
+      tablebase_negamax(worker, node_key, 0, alpha, beta, pv);
+  if (value == ABDADA_INTERRUPTED) {
+    return ABDADA_INTERRUPTED;
+  }
+  negamax_tt_store(worker, node_key, DEPTH_MASK, value, alpha, beta,
+                   on_turn_spread,
+                   pv->num_moves > 0 ? pv->moves[0].tiny_move
+                                     : INVALID_TINY_MOVE);
+  return value;
+}
+
+int32_t abdada_negamax(EndgameCtxWorker *worker, uint64_t node_key, int depth,
+                       int32_t alpha, int32_t beta, PVLine *pv, bool pv_node,
+                       bool exclusive_p, float opp_stuck_frac) {
+
+  assert(pv_node || alpha == beta - 1);
+
+  if (count_node_and_check_stop(worker)) {
+    return ABDADA_INTERRUPTED;
   }
 
   // ABDADA: if exclusive search and another processor is on this node, defer.
@@ -2316,7 +2827,25 @@ int32_t abdada_negamax(EndgameCtxWorker *worker, uint64_t node_key, int depth,
       }
       // search hash move first
       tt_move = ttentry_move(tt_entry);
+    } else if (ttentry_valid(tt_entry)) {
+      // Too shallow to bound the score, but the best move from the previous
+      // iterative deepening pass is still the best first guess.
+      tt_move = ttentry_move(tt_entry);
+    }
+  }
+
+  // Small-rack subgames below the root are solved exactly through the
+  // tablebase, which replaces both the remaining search and the greedy leaf
+  // playout.
+  if (worker->current_iterative_deepening_depth != depth &&
+      game_get_game_end_reason(worker->game_copy) == GAME_END_REASON_NONE &&
+      tablebase_covers_node(worker)) {
+    if (abdada_active) {
+      transposition_table_leave_node(worker->solver->transposition_table,
+                                     node_key);
     }
+    return negamax_tablebase_search(worker, node_key, depth, alpha, beta,
+                                    on_turn_spread, pv);
   }
 
   if (depth == 0 ||
@@ -2340,6 +2869,64 @@ int32_t abdada_negamax(EndgameCtxWorker *worker, uint64_t node_key, int depth,
   child_pv.num_moves = 0;
   child_pv.negamax_depth = 0;
 
+  const bool is_root = (worker->current_iterative_deepening_depth == depth);
+  const int ply = worker->current_iterative_deepening_depth - depth;
+  const bool is_ply2 =
+      (worker->current_iterative_deepening_depth - 1 == depth) &&
+      worker->ordinal == 0 && worker->in_first_root_move;
+  int32_t best_value = -LARGE_VALUE;
+  uint64_t best_tiny_move = INVALID_TINY_MOVE;
+
+  // Staged move generation: at interior nodes, search a TT move that is still
+  // legal here before running movegen, the opponent stuck-tile scan and the
+  // estimates. When it fails high, none of that work is done. The child sees
+  // this node's inherited stuck fraction; it only feeds move ordering since
+  // leaves recompute their own.
+  bool tt_move_searched = false;
+  if (!is_root && !is_ply2 && tt_move != INVALID_TINY_MOVE) {
+    negamax_ensure_cross_sets_valid(worker, depth);
+    SmallMove staged_move;
+    if (negamax_load_tt_move(worker, tt_move, &staged_move)) {
+      const int undo_index = worker->solver->requested_plies - depth;
+      const uint64_t child_key = negamax_play_child(
+          worker, &staged_move, node_key, on_turn_idx, undo_index);
+      // Searched as the first move: full window and never exclusive, so it
+      // cannot come back ON_EVALUATION.
+      const int32_t value =
+          abdada_negamax(worker, child_key, depth - 1, -beta, -alpha,
+                         &child_pv, pv_node, false, opp_stuck_frac);
+      negamax_unplay_child(worker, undo_index);
+      if (value == ABDADA_INTERRUPTED) {
+        if (abdada_active) {
+          transposition_table_leave_node(worker->solver->transposition_table,
+                                         node_key);
+        }
+        return ABDADA_INTERRUPTED;
+      }
+      tt_move_searched = true;
+      best_value = -value;
+      best_tiny_move = staged_move.tiny_move;
+      pvline_update(pv, &child_pv, &staged_move,
+                    best_value - worker->solver->initial_spread);
+      pv->negamax_depth = child_pv.negamax_depth + 1;
+      if (best_value >= beta) {
+        record_beta_cutoff(worker, ply, on_turn_idx, depth, best_tiny_move,
+                           true);
+        if (worker->solver->transposition_table_optim) {
+          negamax_tt_store(worker, node_key, depth, best_value, alpha_orig,
+                           beta, on_turn_spread, best_tiny_move);
+        }
+        if (abdada_active) {
+          transposition_table_leave_node(worker->solver->transposition_table,
+                                         node_key);
+        }
+        return best_value;
+      }
+      alpha = MAX(alpha, best_value);
+      pvline_clear(&child_pv);
+    }
+  }
+
   int nplays;
   bool arena_alloced = false;
   if (worker->current_iterative_deepening_depth != depth) {
@@ -2375,7 +2962,8 @@ int32_t abdada_negamax(EndgameCtxWorker *worker, uint64_t node_key, int depth,
   // deterministic (no branching), it shouldn't cost search depth.
   // Guard: only when previous move scored (consecutive_scoreless_turns == 0)
   // to avoid non-termination in mutual-pass endgames.
-  if (worker->solver->forced_pass_bypass && arena_alloced && nplays == 1 &&
+  if (worker->solver->forced_pass_bypass && arena_alloced &&
+      !tt_move_searched && nplays == 1 &&
       game_get_consecutive_scoreless_turns(worker->game_copy) == 0) {
     size_t fp_offset = worker->small_move_arena->size - sizeof(SmallMove);
     const SmallMove *only_move =
@@ -2435,8 +3023,6 @@ int32_t abdada_negamax(EndgameCtxWorker *worker, uint64_t node_key, int depth,
     }
   }
 
-  int32_t best_value = -LARGE_VALUE;
-  uint64_t best_tiny_move = INVALID_TINY_MOVE;
   size_t arena_offset =
       worker->small_move_arena->size - (sizeof(SmallMove) * nplays);
 
@@ -2444,7 +3030,7 @@ int32_t abdada_negamax(EndgameCtxWorker *worker, uint64_t node_key, int depth,
   // When stm has exactly 1 tile and the only legal move is a non-pass, it
   // plays that tile and ends the game immediately. Skip the board mutation
   // cycle (small_move_to_move + play_move + child recursion + unplay).
-  if (arena_alloced && nplays == 1) {
+  if (arena_alloced && !tt_move_searched && nplays == 1) {
     const SmallMove *only_sm =
         (const SmallMove *)(worker->small_move_arena->memory + arena_offset);
     const Rack *stm_rack_a = player_get_rack(player_on_turn);
@@ -2477,10 +3063,6 @@ int32_t abdada_negamax(EndgameCtxWorker *worker, uint64_t node_key, int depth,
   }
 
   // Multi-PV: track top-K values at root to widen alpha
-  const bool is_root = (worker->current_iterative_deepening_depth == depth);
-  const bool is_ply2 =
-      (worker->current_iterative_deepening_depth - 1 == depth) &&
-      worker->ordinal == 0 && worker->in_first_root_move;
   if (is_ply2) {
     atomic_store(&worker->solver->ply2_moves_total, nplays);
     atomic_store(&worker->solver->ply2_moves_completed, 0);
@@ -2524,6 +3106,8 @@ int32_t abdada_negamax(EndgameCtxWorker *worker, uint64_t node_key, int depth,
   // first few moves and never pay for a full sort. Root move lists
   // (!arena_alloced) arrive pre-sorted.
   bool tail_sorted = !arena_alloced;
+  // Children searched to a value so far, counting the staged TT move.
+  int moves_searched = tt_move_searched ? 1 : 0;
   while (!all_done) {
     all_done = true;
 
@@ -2563,82 +3147,29 @@ int32_t abdada_negamax(EndgameCtxWorker *worker, uint64_t node_key, int depth,
       }
 
       // ABDADA: determine if this move should be searched exclusively
-      // First move (idx == 0) is never exclusive
+      // First move (idx == 0, or the staged TT move) is never exclusive
       // In first phase, other moves are exclusive
       // In retry phase (deferred[idx] == true), moves are not exclusive
-      bool child_exclusive = use_abdada && (idx > 0) && !deferred[idx];
+      const bool first_move = idx == 0 && !tt_move_searched;
+      bool child_exclusive = use_abdada && !first_move && !deferred[idx];
 
       size_t element_offset = arena_offset + idx * sizeof(SmallMove);
       SmallMove *small_move =
           (SmallMove *)(worker->small_move_arena->memory + element_offset);
-      small_move_to_move(worker->move_list->spare_move, small_move,
-                         game_get_board(worker->game_copy));
-
-      const Rack *stm_rack = player_get_rack(player_on_turn);
-      const int stm_rack_tiles = rack_get_total_letters(stm_rack);
-      const bool is_outplay =
-          small_move_get_tiles_played(small_move) == stm_rack_tiles;
-
-      // Outplays use play_move_endgame_outplay (below), which deliberately does
-      // NOT empty the rack, so stm_rack still holds the full pre-move rack.
-      // zobrist_add_move treats its rack arg as the post-move leftover, which
-      // for an outplay is empty; passing the stale full rack double-counts the
-      // played tiles (placeholder = placed + full = 2*placed) and can index the
-      // rack hash table out of bounds -- e.g. outplaying four S's yields
-      // placeholder[S] = 8 into an 8-slot (0..RACK_SIZE) row. Use an empty
-      // leftover for outplays.
-      Rack outplay_leftover;
-      if (is_outplay) {
-        rack_set_dist_size_and_reset(&outplay_leftover,
-                                     rack_get_dist_size(stm_rack));
-      }
-      const Rack *move_leftover_rack =
-          is_outplay ? &outplay_leftover : stm_rack;
+      if (tt_move_searched && small_move->tiny_move == tt_move) {
+        // Already searched ahead of movegen.
+        continue;
+      }
 
       // Track whether thread 0 is inside root move #1's subtree
       if (is_root && worker->ordinal == 0 && pass == 0) {
         worker->in_first_root_move = (idx == 0);
       }
 
-      int last_consecutive_scoreless_turns =
-          game_get_consecutive_scoreless_turns(worker->game_copy);
-
       // Calculate undo index for incremental backup
       int undo_index = worker->solver->requested_plies - depth;
-
-      // Live-progress: publish this move into the per-thread "current line"
-      // buffer before recursing so a polling reader can see what the engine
-      // is currently exploring even during a long single-root subtree where
-      // no other signal updates. The slot store is a relaxed atomic; the
-      // length store uses release ordering so the reader (acquire on length)
-      // sees the tiny_move write.
-      atomic_store_explicit(&worker->current_line[undo_index],
-                            small_move->tiny_move, memory_order_relaxed);
-      atomic_store_explicit(&worker->current_line_len, undo_index + 1,
-                            memory_order_release);
-
-      // Use optimized function for outplays - skips board/cross-set updates
-      if (is_outplay) {
-        play_move_endgame_outplay(worker->move_list->spare_move,
-                                  worker->game_copy,
-                                  &worker->move_undos[undo_index]);
-      } else {
-        play_move_incremental(worker->move_list->spare_move, worker->game_copy,
-                              &worker->move_undos[undo_index]);
-        // Cross-sets are left invalid - they will be computed lazily before
-        // move generation if we reach that point. The cross-set squares will be
-        // saved to MoveUndo before updating, so they're restored on unplay.
-      }
-
-      uint64_t child_key = 0;
-      if (worker->solver->transposition_table_optim) {
-        child_key = zobrist_add_move(
-            worker->solver->transposition_table->zobrist, node_key,
-            worker->move_list->spare_move, move_leftover_rack,
-            on_turn_idx == worker->solver->solving_player,
-            game_get_consecutive_scoreless_turns(worker->game_copy),
-            last_consecutive_scoreless_turns);
-      }
+      uint64_t child_key = negamax_play_child(worker, small_move, node_key,
+                                              on_turn_idx, undo_index);
 
       // Per-root-move aspiration: at root after depth 1, each move gets its
       // own aspiration window centered on its estimated_value from the previous
@@ -2684,7 +3215,7 @@ int32_t abdada_negamax(EndgameCtxWorker *worker, uint64_t node_key, int depth,
             break;
           }
         }
-      } else if (idx == 0 || !worker->solver->negascout_optim || is_root) {
+      } else if (first_move || !worker->solver->negascout_optim || is_root) {
         value =
             abdada_negamax(worker, child_key, depth - 1, -beta, -alpha,
                            &child_pv, pv_node, child_exclusive, opp_stuck_frac);
@@ -2699,17 +3230,7 @@ int32_t abdada_negamax(EndgameCtxWorker *worker, uint64_t node_key, int depth,
                                  &child_pv, pv_node, false, opp_stuck_frac);
         }
       }
-      unplay_move_incremental(worker->game_copy,
-                              &worker->move_undos[undo_index]);
-      // Cross-sets need no recompute here: any lazy cross-set update in the
-      // child's subtree was saved into this undo (or a descendant's undo that
-      // was already restored), so the square restore reverted them exactly.
-
-      // Live-progress: pop the line back to the parent's depth. The entry at
-      // undo_index is left as-is (overwritten by the next sibling's push).
-      // Release pairs with the reader's acquire on length.
-      atomic_store_explicit(&worker->current_line_len, undo_index,
-                            memory_order_release);
+      negamax_unplay_child(worker, undo_index);
 
       if (value == ABDADA_INTERRUPTED) {
         all_done = true;
@@ -2730,6 +3251,7 @@ int32_t abdada_negamax(EndgameCtxWorker *worker, uint64_t node_key, int depth,
       if (deferred != NULL) {
         deferred[idx] = false;
       }
+      moves_searched++;
 
       // Re-assign small_move. Its pointer location may have changed after all
       // the calls to negamax and possible reallocations in the
@@ -2809,6 +3331,8 @@ int32_t abdada_negamax(EndgameCtxWorker *worker, uint64_t node_key, int depth,
       }
       if (best_value >= beta) {
         // beta cut-off
+        record_beta_cutoff(worker, ply, on_turn_idx, depth, best_tiny_move,
+                           moves_searched == 1);
         all_done = true;
         break;
       }
@@ -3346,8 +3870,7 @@ void iterative_deepening(EndgameCtxWorker *worker, int plies) {
   // worker (and all of a very short solve) would be permanently
   // under-reported by up to DEPTH_DEADLINE_CHECK_INTERVAL-1 nodes. All
   // exit paths of the loop above fall through to here.
-  atomic_store_explicit(&worker->published_nodes_searched,
-                        worker->local_nodes_searched, memory_order_relaxed);
+  publish_search_counters(worker);
 }
 
 void *solver_worker_start(void *uncasted_solver_worker) {
@@ -3497,7 +4020,7 @@ void endgame_solve_inline(EndgameCtx **ctx, const EndgameArgs *endgame_args,
   const int total_workers = atomic_load(&solver->live_workers);
   cpthread_mutex_unlock(&solver->add_mutex);
   for (int idx = solver->threads; idx < total_workers; idx++) {
-    cpthread_join(solver->worker_ids[idx]);
+    thread_pool_join(solver->worker_ids[idx]);
   }
 
   const PVLine *best_pv =
@@ -3544,8 +4067,8 @@ void endgame_solve(EndgameCtx **ctx, const EndgameArgs *endgame_args,
   endgame_ctx_prepare_workers(solver, endgame_args->seed);
 
   for (int thread_index = 0; thread_index < solver->threads; thread_index++) {
-    cpthread_create(&solver->worker_ids[thread_index], solver_worker_start,
-                    solver->workers[thread_index]);
+    solver->worker_ids[thread_index] =
+        thread_pool_start(solver_worker_start, solver->workers[thread_index]);
   }
 
   // Open the injection window now that the initial workers exist and the solve
@@ -3561,7 +4084,7 @@ void endgame_solve(EndgameCtx **ctx, const EndgameArgs *endgame_args,
   // completion, so once these exit the search has finished (or
   // interrupted/timed out).
   for (int thread_index = 0; thread_index < solver->threads; thread_index++) {
-    cpthread_join(solver->worker_ids[thread_index]);
+    thread_pool_join(solver->worker_ids[thread_index]);
   }
 
   // Shut the injection window and join any workers added mid-search. Under the
@@ -3573,7 +4096,7 @@ void endgame_solve(EndgameCtx **ctx, const EndgameArgs *endgame_args,
   cpthread_mutex_unlock(&solver->add_mutex);
   for (int thread_index = solver->threads; thread_index < total_workers;
        thread_index++) {
-    cpthread_join(solver->worker_ids[thread_index]);
+    thread_pool_join(solver->worker_ids[thread_index]);
   }
 
   endgame_results_stop_ctimer(results);
@@ -3680,8 +4203,8 @@ bool endgame_add_worker(EndgameCtx *solver) {
   // pruned KWGs + fresh cross-sets) — NOT from worker 0, whose game_copy is
   // mid-traversal. Seeds the worker PRNG by its ordinal.
   endgame_ctx_reset_worker_and_game(solver, solver->worker_base_seed, ordinal);
-  cpthread_create(&solver->worker_ids[ordinal], solver_worker_start,
-                  solver->workers[ordinal]);
+  solver->worker_ids[ordinal] =
+      thread_pool_start(solver_worker_start, solver->workers[ordinal]);
   atomic_store(&solver->live_workers, ordinal + 1);
   cpthread_mutex_unlock(&solver->add_mutex);
   return true;
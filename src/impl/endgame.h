@@ -21,6 +21,8 @@
 enum {
   DEFAULT_INITIAL_SMALL_MOVE_ARENA_SIZE = 1024 * 1024,
   MAX_ENDGAME_DISPLAY_PVS = 100,
+  // Largest rack the small-rack subgame tablebase solves exactly.
+  ENDGAME_TABLEBASE_MAX_TILES = 3,
 };
 
 typedef struct EndgameCtx EndgameCtx;
@@ -195,6 +197,13 @@ typedef struct EndgameArgs {
   // sweep entirely, >0 = evaluate at most this many top moves. Ignored unless
   // first_win is set.
   int first_win_fallback_moves;
+  // Largest rack, for both players, at which a position below the root is
+  // solved exactly to the end of the game through the small-rack tablebase
+  // instead of searched to the remaining depth and greedily played out.
+  // 0 = disabled (the default), otherwise capped at
+  // ENDGAME_TABLEBASE_MAX_TILES. Requires use_heuristics and a transposition
+  // table.
+  int tablebase_max_tiles;
   // Generalization of first_win: search every iterative-deepening pass
   // with the fixed window [initial_alpha, initial_beta] (in final-spread
   // units for the solving player, i.e. PVLine score plus the initial
@@ -252,7 +261,7 @@ static inline void endgame_args_fill(
     const int first_win_fallback_moves, const bool use_initial_window,
     const int32_t initial_alpha, const int32_t initial_beta,
     const int64_t external_deadline_ns, const Move *actual_move,
-    EndgameArgs *endgame_args) {
+    const int tablebase_max_tiles, EndgameArgs *endgame_args) {
   endgame_args->thread_control = thread_control;
   endgame_args->game = game;
   endgame_args->tt_fraction_of_mem = tt_fraction_of_mem;
@@ -283,6 +292,7 @@ static inline void endgame_args_fill(
   endgame_args->initial_beta = initial_beta;
   endgame_args->external_deadline_ns = external_deadline_ns;
   endgame_args->actual_move = actual_move;
+  endgame_args->tablebase_max_tiles = tablebase_max_tiles;
 }
 
 void pvline_extend_from_tt(PVLine *pv_line, Game *game_copy,
@@ -355,6 +365,14 @@ void endgame_ctx_get_progress(const EndgameCtx *ctx, int *current_depth,
 // long single-root subtree evaluations.
 uint64_t endgame_ctx_get_nodes_searched(const EndgameCtx *ctx);
 
+// Move ordering quality: the number of beta cutoffs across all worker threads
+// and how many of them came from the first move searched at the node. Their
+// ratio is the cutoff-on-first-move rate. Published and lagging like
+// endgame_ctx_get_nodes_searched, and exact once the solve completes.
+void endgame_ctx_get_move_ordering_stats(const EndgameCtx *ctx,
+                                         uint64_t *beta_cutoffs,
+                                         uint64_t *first_move_cutoffs);
+
 // Snapshot of the line currently being explored by worker `worker_index`
 // (0 = main worker; see conventions above). Writes up to `max_len` `tiny_move`
 // entries into `out_line` and returns the number written (0..max_len). The
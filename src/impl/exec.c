@@ -12,7 +12,9 @@
 #include "../util/io_util.h"
 #include "../util/string_util.h"
 #include "config.h"
+#include "job_server.h"
 #include "move_gen.h"
+#include "thread_pool.h"
 #include <assert.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -233,13 +235,11 @@ void save_config_settings(const Config *config, ErrorStack *error_stack) {
   string_builder_destroy(sb);
 }
 
-void load_config_settings(Config *config, ErrorStack *error_stack) {
-  // if file does not exist, just return
-  if (access(config_get_settings_filename(config), F_OK) != 0) {
-    return;
-  }
-  char *settings_string =
-      get_string_from_file(config_get_settings_filename(config), error_stack);
+// Runs each line of the settings without reporting them as commands.
+static void load_settings_string(Config *config, ErrorStack *error_stack,
+                                 const char *settings_string) {
+  // To suppress 'finished' for internal load settings commands
+  config_set_loaded_settings(config, false);
   StringSplitter *settings_split_by_newline =
       split_string_by_newline(settings_string, true);
   const int num_lines =
@@ -252,77 +252,192 @@ void load_config_settings(Config *config, ErrorStack *error_stack) {
     }
   }
   string_splitter_destroy(settings_split_by_newline);
+  config_set_loaded_settings(config, true);
+}
+
+void load_config_settings(Config *config, ErrorStack *error_stack) {
+  // if file does not exist, just return
+  if (access(config_get_settings_filename(config), F_OK) != 0) {
+    return;
+  }
+  char *settings_string =
+      get_string_from_file(config_get_settings_filename(config), error_stack);
+  if (error_stack_is_empty(error_stack)) {
+    load_settings_string(config, error_stack, settings_string);
+  }
   free(settings_string);
 }
 
-void sync_command_scan_loop(Config *config, ErrorStack *error_stack,
-                            const char *initial_command_string) {
-  // To suppress 'finished' for internal load settings commands
-  config_set_loaded_settings(config, false);
-  load_config_settings(config, error_stack);
-  config_set_loaded_settings(config, true);
+// Runs the job server if the command is 'serve [<socket_path>]' and returns
+// true, or returns false for any other command. Jobs start from the current
+// settings and may use up to the current number of threads in total.
+static bool execute_serve_command(const Config *config,
+                                  ErrorStack *error_stack,
+                           const char *command) {
+  StringSplitter *split_command = split_string_by_whitespace(command, true);
+  const int number_of_items =
+      string_splitter_get_number_of_items(split_command);
+  if (number_of_items == 0 || number_of_items > 2 ||
+      !strings_iequal(string_splitter_get_item(split_command, 0),
+                      SERVE_KEYWORD)) {
+    string_splitter_destroy(split_command);
+    return false;
+  }
+  StringBuilder *settings_sb = string_builder_create();
+  config_add_settings_to_string_builder(config, settings_sb);
+  const JobServerArgs args = {
+      .data_paths = config_get_data_paths(config),
+      .use_wmp = players_data_get_use_when_available(
+          config_get_players_data(config), PLAYERS_DATA_TYPE_WMP, 0),
+      .settings = string_builder_peek(settings_sb),
+      .thread_budget = config_get_num_threads(config),
+  };
+  if (number_of_items == 1) {
+    job_server_run(&args, get_stream_in(), get_stream_out());
+  } else {
+    job_server_run_on_socket(&args, string_splitter_get_item(split_command, 1),
+                             error_stack);
+  }
+  string_builder_destroy(settings_sb);
+  string_splitter_destroy(split_command);
+  return true;
+}
+
+struct ExecSession {
+  Config *config;
+  ErrorStack *error_stack;
+};
+
+ExecSession *exec_session_create(const ConfigArgs *config_args) {
+  log_set_level(LOG_FATAL);
+  ErrorStack *error_stack = error_stack_create();
+  Config *config = config_create(config_args, error_stack);
   if (!error_stack_is_empty(error_stack)) {
     error_stack_print_and_reset(error_stack);
+    config_destroy(config);
+    error_stack_destroy(error_stack);
+    return NULL;
+  }
+  ExecSession *session = malloc_or_die(sizeof(ExecSession));
+  session->config = config;
+  session->error_stack = error_stack;
+  return session;
+}
+
+void exec_session_destroy(ExecSession *session) {
+  if (!session) {
     return;
   }
-  execute_command_sync(config, error_stack, initial_command_string);
+  config_destroy(session->config);
+  error_stack_destroy(session->error_stack);
+  free(session);
+}
+
+bool exec_session_start(ExecSession *session,
+                        const char *initial_command_string) {
+  Config *config = session->config;
+  ErrorStack *error_stack = session->error_stack;
+  load_config_settings(config, error_stack);
   if (!error_stack_is_empty(error_stack)) {
     error_stack_print_and_reset(error_stack);
-    return;
+    return false;
   }
-  if (!config_continue_on_coldstart(config)) {
-    return;
+  if (execute_serve_command(config, error_stack, initial_command_string)) {
+    error_stack_print_and_reset(error_stack);
+    return false;
+  }
+  execute_command_sync(config, error_stack, initial_command_string);
+  if (!error_stack_is_empty(error_stack)) {
+    error_stack_print_and_reset(error_stack);
+    return false;
   }
-  char *input = NULL;
   linenoiseHistorySetMaxLen(1000);
+  return config_continue_on_coldstart(config);
+}
+
+void exec_session_load_settings(ExecSession *session, const char *settings) {
+  load_settings_string(session->config, session->error_stack, settings);
+  error_stack_print_and_reset(session->error_stack);
+}
+
+char *exec_session_get_settings(const ExecSession *session) {
+  StringBuilder *sb = string_builder_create();
+  config_add_settings_to_string_builder(session->config, sb);
+  char *settings = string_builder_dump(sb, NULL);
+  string_builder_destroy(sb);
+  return settings;
+}
+
+char *exec_session_read_command(const ExecSession *session) {
   while (1) {
     const char *prompt_text = "";
-    if (config_get_show_prompt(config)) {
+    if (config_get_show_prompt(session->config)) {
       prompt_text = MAGPIE_PROMPT " ";
     }
-    free(input);
-    input = linenoise(prompt_text);
+    char *input = linenoise(prompt_text);
     if (!input) {
       // NULL input indicates an EOF
-      break;
+      return NULL;
     }
 
     trim_whitespace(input);
 
     if (is_string_empty_or_null(input)) {
+      free(input);
       continue;
     }
 
     if (strings_iequal(TERMINATE_KEYWORD, input) ||
         strings_iequal(TERMINATE_KEYWORD_ALIAS_EXIT, input) ||
         strings_iequal(TERMINATE_KEYWORD_ALIAS_SHORT, input)) {
-      break;
+      free(input);
+      return NULL;
     }
+    return input;
+  }
+}
 
-    if (strings_iequal(input, ASYNC_STOP_COMMAND_STRING)) {
-      error_stack_push(
-          error_stack, ERROR_STATUS_COMMAND_NOTHING_TO_STOP,
-          string_duplicate("no currently running command to stop"));
-    } else {
-      linenoiseHistoryAdd(input);
-      switch (config_get_exec_mode(config)) {
-      case EXEC_MODE_SYNC:
-        execute_command_sync(config, error_stack, input);
-        break;
-      case EXEC_MODE_ASYNC:
-        execute_command_async(config, error_stack, input);
-        break;
-      case EXEC_MODE_UNKNOWN:
-        log_fatal("attempted to execute command in unknown mode");
-        break;
-      }
-    }
-    if (error_stack_is_empty(error_stack)) {
-      save_config_settings(config, error_stack);
-    }
+void exec_session_run_command(ExecSession *session, const char *command) {
+  Config *config = session->config;
+  ErrorStack *error_stack = session->error_stack;
+  if (execute_serve_command(config, error_stack, command)) {
     error_stack_print_and_reset(error_stack);
+    return;
+  }
+
+  if (strings_iequal(command, ASYNC_STOP_COMMAND_STRING)) {
+    error_stack_push(error_stack, ERROR_STATUS_COMMAND_NOTHING_TO_STOP,
+                     string_duplicate("no currently running command to stop"));
+  } else {
+    linenoiseHistoryAdd(command);
+    switch (config_get_exec_mode(config)) {
+    case EXEC_MODE_SYNC:
+      execute_command_sync(config, error_stack, command);
+      break;
+    case EXEC_MODE_ASYNC:
+      execute_command_async(config, error_stack, command);
+      break;
+    case EXEC_MODE_UNKNOWN:
+      log_fatal("attempted to execute command in unknown mode");
+      break;
+    }
+  }
+  if (error_stack_is_empty(error_stack)) {
+    save_config_settings(config, error_stack);
+  }
+  error_stack_print_and_reset(error_stack);
+}
+
+void sync_command_scan_loop(ExecSession *session,
+                            const char *initial_command_string) {
+  if (!exec_session_start(session, initial_command_string)) {
+    return;
+  }
+  char *command;
+  while ((command = exec_session_read_command(session))) {
+    exec_session_run_command(session, command);
+    free(command);
   }
-  free(input);
 }
 
 char *create_command_from_args(int argc, char *argv[]) {
@@ -336,25 +451,21 @@ char *create_command_from_args(int argc, char *argv[]) {
 }
 
 void caches_destroy(void) {
+  thread_pool_destroy();
   gen_destroy_cache();
   fileproxy_destroy_cache();
 }
 
 void process_command_internal(int argc, char *argv[],
                               const ConfigArgs *config_args) {
-  log_set_level(LOG_FATAL);
-  ErrorStack *error_stack = error_stack_create();
-  Config *config = config_create(config_args, error_stack);
-  if (error_stack_is_empty(error_stack)) {
+  ExecSession *session = exec_session_create(config_args);
+  if (session) {
     char *initial_command_string = create_command_from_args(argc, argv);
-    sync_command_scan_loop(config, error_stack, initial_command_string);
+    sync_command_scan_loop(session, initial_command_string);
     free(initial_command_string);
     caches_destroy();
-  } else {
-    error_stack_print_and_reset(error_stack);
   }
-  config_destroy(config);
-  error_stack_destroy(error_stack);
+  exec_session_destroy(session);
 }
 
 void process_command_default(int argc, char *argv[]) {
@@ -16,6 +16,30 @@ bool load_command_sync(Config *config, ErrorStack *error_stack,
                        const char *command);
 char *command_search_status(Config *config, bool should_exit);
 void caches_destroy(void);
+
+// An interactive session on one config, as run by process_command_default.
+// magpie_multi keeps one session per board size and runs each command in the
+// session of the board size the command needs.
+typedef struct ExecSession ExecSession;
+
+// Returns NULL after printing the errors if the config cannot be created.
+ExecSession *exec_session_create(const ConfigArgs *config_args);
+void exec_session_destroy(ExecSession *session);
+// Loads the saved settings and runs the command from the command line.
+// Returns true if commands should then be read from the input.
+bool exec_session_start(ExecSession *session,
+                        const char *initial_command_string);
+// Applies settings returned by exec_session_get_settings, which are not
+// reported as commands or saved.
+void exec_session_load_settings(ExecSession *session, const char *settings);
+char *exec_session_get_settings(const ExecSession *session);
+// Returns the next command from the input, or NULL at the end of the input
+// or when the user quits.
+char *exec_session_read_command(const ExecSession *session);
+// Runs a command read from the input, saves the settings and prints any
+// errors.
+void exec_session_run_command(ExecSession *session, const char *command);
+
 void process_command_default(int argc, char *argv[]);
 void process_command_with_config_args(int argc, char *argv[],
                                       const ConfigArgs *config_args);
@@ -16,6 +16,7 @@
 #include "../ent/letter_distribution.h"
 #include "../ent/move.h"
 #include "../ent/move_undo.h"
+#include "../ent/perf_counters.h"
 #include "../ent/player.h"
 #include "../ent/rack.h"
 #include "../ent/validated_move.h"
@@ -206,6 +207,7 @@ static void calc_for_across_after_unplay(const Move *move, const Game *game,
 // This version doesn't rely on board_get_word_edge (which assumes tiles are on
 // board).
 void update_cross_sets_after_unplay(const Move *move, const Game *game) {
+  PERF_TIMER_START(cross_set_start);
   Board *board = game_get_board(game);
   if (board_is_dir_vertical(move_get_dir(move))) {
     calc_for_across_after_unplay(move, game, move_get_row_start(move),
@@ -224,6 +226,7 @@ void update_cross_sets_after_unplay(const Move *move, const Game *game) {
                                  BOARD_VERTICAL_DIRECTION);
     board_transpose(board);
   }
+  PERF_TIMER_STOP(PERF_COUNTER_CROSS_SET_UPDATE, cross_set_start);
 }
 
 // --- MoveUndo-based cross-set update functions ---
@@ -315,6 +318,7 @@ static void calc_for_self_from_undo(MoveUndo *undo, const Game *game,
 // Every square written is first saved into the undo, so unplaying the move
 // restores the cross-sets without recomputation.
 void update_cross_set_for_move_from_undo(MoveUndo *undo, const Game *game) {
+  PERF_TIMER_START(cross_set_start);
   Board *board = game_get_board(game);
   if (board_is_dir_vertical(undo->move_dir)) {
     calc_for_across_from_undo(undo, game, undo->move_row_start,
@@ -331,9 +335,11 @@ void update_cross_set_for_move_from_undo(MoveUndo *undo, const Game *game) {
                               undo->move_row_start, BOARD_VERTICAL_DIRECTION);
     board_transpose(board);
   }
+  PERF_TIMER_STOP(PERF_COUNTER_CROSS_SET_UPDATE, cross_set_start);
 }
 
 void update_cross_set_for_move(const Move *move, const Game *game) {
+  PERF_TIMER_START(cross_set_start);
   Board *board = game_get_board(game);
   if (board_is_dir_vertical(move_get_dir(move))) {
     calc_for_across(move, game, move_get_row_start(move),
@@ -350,6 +356,7 @@ void update_cross_set_for_move(const Move *move, const Game *game) {
                     move_get_row_start(move), BOARD_VERTICAL_DIRECTION);
     board_transpose(board);
   }
+  PERF_TIMER_STOP(PERF_COUNTER_CROSS_SET_UPDATE, cross_set_start);
 }
 
 // Draws the required number of tiles to fill the rack to RACK_SIZE.
@@ -588,14 +595,18 @@ static void play_move_internal(const Move *move, Game *game, Rack *leave,
 }
 
 void play_move(const Move *move, Game *game, Rack *leave) {
+  PERF_TIMER_START(play_start);
   play_move_internal(move, game, leave, true);
+  PERF_TIMER_STOP(PERF_COUNTER_PLAY_MOVE, play_start);
 }
 
 // Like play_move, but skips updating the board's cross-sets. Only safe when the
 // resulting position is not used for move generation before being unplayed
 // (which restores the cross-sets via the game backup).
 void play_move_no_cross_set_update(const Move *move, Game *game, Rack *leave) {
+  PERF_TIMER_START(play_start);
   play_move_internal(move, game, leave, false);
+  PERF_TIMER_STOP(PERF_COUNTER_PLAY_MOVE, play_start);
 }
 
 void play_move_without_drawing_tiles(const Move *move, Game *game) {
@@ -689,6 +700,7 @@ static void play_move_on_board_tracked(const Move *move, const Game *game,
 }
 
 void play_move_incremental(const Move *move, Game *game, MoveUndo *undo) {
+  PERF_TIMER_START(play_start);
   move_undo_reset(undo);
 
   // Save game state
@@ -774,9 +786,11 @@ void play_move_incremental(const Move *move, Game *game, MoveUndo *undo) {
     game_set_game_end_reason(game, GAME_END_REASON_CONSECUTIVE_ZEROS);
   }
   game_start_next_player_turn(game);
+  PERF_TIMER_STOP(PERF_COUNTER_PLAY_MOVE, play_start);
 }
 
 void unplay_move_incremental(Game *game, const MoveUndo *undo) {
+  PERF_TIMER_START(unplay_start);
   // Restore player turn
   game_set_player_on_turn_index(game, undo->player_on_turn_index);
 
@@ -803,6 +817,7 @@ void unplay_move_incremental(Game *game, const MoveUndo *undo) {
   board_set_cross_sets_valid(board, undo->old_cross_sets_valid);
   memcpy(board->number_of_row_anchors, undo->old_number_of_row_anchors,
          sizeof(board->number_of_row_anchors));
+  PERF_TIMER_STOP(PERF_COUNTER_UNPLAY_MOVE, unplay_start);
 }
 
 // Optimized play for endgame outplays (player plays all tiles).
@@ -865,6 +880,7 @@ void generate_moves_for_game_override_record_type(
       .eq_margin_movegen = args->eq_margin_movegen,
       .target_equity = EQUITY_MAX_VALUE,
       .target_leave_size_for_exchange_cutoff = UNSET_LEAVE_SIZE,
+      .num_threads = args->num_threads,
   };
 
   generate_moves(&args_with_overwritten_record_and_sort);
@@ -894,22 +910,6 @@ const Move *get_top_equity_move(Game *game, MoveList *move_list) {
   return move_list_get_move(move_list, 0);
 }
 
-Move *get_top_equity_move_for_inferences(
-    Game *game, MoveList *move_list, Equity target_equity,
-    int target_leave_size_for_exchange_cutoff, Equity equity_margin) {
-  const MoveGenArgs args = {.game = game,
-                            .move_list = move_list,
-                            .move_record_type = MOVE_RECORD_BEST,
-                            .move_sort_type = MOVE_SORT_EQUITY,
-                            .override_kwg = NULL,
-                            .eq_margin_movegen = equity_margin,
-                            .target_equity = target_equity,
-                            .target_leave_size_for_exchange_cutoff =
-                                target_leave_size_for_exchange_cutoff};
-  generate_moves(&args);
-  return move_list_get_move(move_list, 0);
-}
-
 void validate_challenge_bonus_order(const GameEvent *game_event,
                                     const GameEvent *previous_game_event,
                                     ErrorStack *error_stack) {
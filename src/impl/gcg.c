@@ -18,7 +18,7 @@
 #include "../str/rack_string.h"
 #include "../util/io_util.h"
 #include "../util/string_util.h"
-#include <regex.h>
+#include <ctype.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -64,10 +64,11 @@ typedef enum {
   NUMBER_OF_GCG_TOKENS,
 } gcg_token_t;
 
-typedef struct TokenRegexPair {
-  gcg_token_t token;
-  regex_t regex;
-} TokenRegexPair;
+// Byte offsets of a matching group within its line, end exclusive.
+typedef struct GCGMatchingGroup {
+  int start;
+  int end;
+} GCGMatchingGroup;
 
 typedef enum {
   PARSE_GCG_MODE_SETTINGS,
@@ -75,15 +76,17 @@ typedef enum {
 } parse_gcg_mode_t;
 
 struct GCGParser {
-  regmatch_t matching_groups[(MAX_GROUPS)];
+  GCGMatchingGroup matching_groups[(MAX_GROUPS)];
   StringBuilder *note_builder;
   gcg_token_t previous_token;
-  TokenRegexPair **token_regex_pairs;
-  int number_of_token_regex_pairs;
   int gcg_token_count[NUMBER_OF_GCG_TOKENS];
   int current_gcg_line_index;
   bool player_is_reset[2];
-  StringSplitter *gcg_lines;
+  // The decoded UTF-8 text of the GCG. Lines are terminated in place and
+  // gcg_lines points into this buffer, so no line is copied.
+  char *gcg_text;
+  char **gcg_lines;
+  int number_of_gcg_lines;
   const char *existing_p0_lexicon;
   // Owned by the caller
   GameHistory *game_history;
@@ -105,132 +108,393 @@ struct GCGParser {
 
 #define GCG_DESCRIPTION_CREATION_TEXT "Created with MAGPIE"
 
-typedef struct TokenStringRegexPair {
+// The token grammar only needs literals, a few character classes, greedy
+// repetition and flat groups, so each token is described by a short
+// pattern that is matched by hand. Matching follows the POSIX extended
+// regular expressions the grammar was first written in: a pattern may
+// match anywhere in the line, the leftmost match wins and repetitions are
+// as long as the rest of the pattern allows.
+typedef enum {
+  GCG_PATTERN_LITERAL,
+  GCG_PATTERN_SPACE,
+  GCG_PATTERN_NON_SPACE,
+  GCG_PATTERN_ANY,
+  GCG_PATTERN_ALNUM,
+  GCG_PATTERN_DIGIT,
+  GCG_PATTERN_GRAPH,
+  GCG_PATTERN_PLAYER_NUMBER,
+  GCG_PATTERN_GROUP_START,
+  GCG_PATTERN_GROUP_END,
+  GCG_PATTERN_END,
+} gcg_pattern_t;
+
+typedef struct GCGPatternElement {
+  gcg_pattern_t type;
+  // Repetition bounds, max_repeats < 0 is unbounded. Literals repeat as a
+  // whole string.
+  int min_repeats;
+  int max_repeats;
+  const char *literal;
+} GCGPatternElement;
+
+enum { MAX_GCG_PATTERN_ELEMENTS = 32 };
+
+typedef struct GCGTokenPattern {
   gcg_token_t token;
-  const char *regex_string;
-} TokenStringRegexPair;
-
-// Define the array of token enum and regex pairs
-const TokenStringRegexPair token_string_regex_pairs[] = {
-    {GCG_PLAYER_TOKEN, "#" GCG_PLAYER_STRING
-                       "([1-2])[[:space:]]+([^[:space:]]+)[[:space:]]+(.+)"},
-    {GCG_TITLE_TOKEN, "#" GCG_TITLE_STRING "[[:space:]]*(.*)"},
-    {GCG_DESCRIPTION_TOKEN, "#" GCG_DESCRIPTION_STRING "[[:space:]]*(.*)"},
-    {GCG_ID_TOKEN, "#" GCG_ID_STRING
-                   "[[:space:]]*([^[:space:]]+)[[:space:]]+([^[:space:]]+)"},
-    {GCG_RACK1_TOKEN, "#" GCG_RACK_STRING "1 ([^[:space:]]+)"},
-    {GCG_RACK2_TOKEN, "#" GCG_RACK_STRING "2 ([^[:space:]]+)"},
-    {GCG_ENCODING_TOKEN, "#" GCG_CHAR_ENCODING_STRING " ([[:graph:]]+)"},
-    {GCG_MOVE_TOKEN, ">([^[:space:]]+):[[:space:]]+([^[:space:]]+)[[:space:"
-                     "]]+([[:alnum:]]+)[[:space:]]+([^[:space:]]+)[[:space:]]+"
-                     "[+]([[:digit:]]+)[[:space:]]+(-?[[:digit:]]+)"},
-    {GCG_NOTE_TOKEN, "#" GCG_NOTE_STRING " (.+)"},
-    {GCG_LEXICON_TOKEN, "#" GCG_LEXICON_STRING " (.+)"},
-    {GCG_PHONY_TILES_RETURNED_TOKEN, ">([^[:space:]]+):[[:space:]]+([^[:space:]"
-                                     "]+)[[:space:]]+--[[:space:]]+-([["
-                                     ":digit:]]+)[[:space:]]+(-?[[:digit:]]+)"},
-    {GCG_PASS_TOKEN, ">([^[:space:]]+):[[:space:]]+([^[:space:]]+)[[:space:"
-                     "]]+-[[:space:]]+\\+0[[:space:]]+(-?[[:digit:]]+)"},
-    {GCG_CHALLENGE_BONUS_TOKEN, ">([^[:space:]]+):[[:space:]]+([^[:space:]]*)[["
-                                ":space:]]+\\(challenge\\)[[:"
-                                "space:]]+(\\+[[:digit:]]+"
-                                ")[[:space:]]+(-?[[:digit:]]+)"},
+  GCGPatternElement elements[MAX_GCG_PATTERN_ELEMENTS];
+} GCGTokenPattern;
+
+#define GCG_LITERAL(s) {GCG_PATTERN_LITERAL, 1, 1, s}
+#define GCG_OPTIONAL_LITERAL(s) {GCG_PATTERN_LITERAL, 0, 1, s}
+#define GCG_ONE(type) {type, 1, 1, NULL}
+#define GCG_ZERO_OR_MORE(type) {type, 0, -1, NULL}
+#define GCG_ONE_OR_MORE(type) {type, 1, -1, NULL}
+#define GCG_SPACES GCG_ONE_OR_MORE(GCG_PATTERN_SPACE)
+#define GCG_WORD GCG_ONE_OR_MORE(GCG_PATTERN_NON_SPACE)
+#define GCG_GROUP_START {GCG_PATTERN_GROUP_START, 1, 1, NULL}
+#define GCG_GROUP_END {GCG_PATTERN_GROUP_END, 1, 1, NULL}
+#define GCG_PATTERN_END_ELEMENT {GCG_PATTERN_END, 1, 1, NULL}
+#define GCG_GROUP(element) GCG_GROUP_START, element, GCG_GROUP_END
+#define GCG_PRAGMA_WITH_REST(pragma_string)                                    \
+  GCG_LITERAL("#" pragma_string " "),                                          \
+      GCG_GROUP(GCG_ZERO_OR_MORE(GCG_PATTERN_ANY)), GCG_PATTERN_END_ELEMENT
+#define GCG_EVENT_PLAYER                                                       \
+  GCG_LITERAL(">"), GCG_GROUP(GCG_WORD), GCG_LITERAL(":"), GCG_SPACES
+#define GCG_CUMULATIVE_SCORE                                                   \
+  GCG_GROUP_START, GCG_OPTIONAL_LITERAL("-"),                                  \
+      GCG_ONE_OR_MORE(GCG_PATTERN_DIGIT), GCG_GROUP_END, GCG_PATTERN_END_ELEMENT
+
+// Tokens are tried in this order and the first one that matches anywhere
+// in the line is used.
+static const GCGTokenPattern gcg_token_patterns[] = {
+    // #player([1-2])\s+(\S+)\s+(.+)
+    {GCG_PLAYER_TOKEN,
+     {GCG_LITERAL("#" GCG_PLAYER_STRING),
+      GCG_GROUP(GCG_ONE(GCG_PATTERN_PLAYER_NUMBER)), GCG_SPACES,
+      GCG_GROUP(GCG_WORD), GCG_SPACES,
+      GCG_GROUP(GCG_ONE_OR_MORE(GCG_PATTERN_ANY)), GCG_PATTERN_END_ELEMENT}},
+    // #title\s*(.*)
+    {GCG_TITLE_TOKEN,
+     {GCG_LITERAL("#" GCG_TITLE_STRING), GCG_ZERO_OR_MORE(GCG_PATTERN_SPACE),
+      GCG_GROUP(GCG_ZERO_OR_MORE(GCG_PATTERN_ANY)), GCG_PATTERN_END_ELEMENT}},
+    // #description\s*(.*)
+    {GCG_DESCRIPTION_TOKEN,
+     {GCG_LITERAL("#" GCG_DESCRIPTION_STRING),
+      GCG_ZERO_OR_MORE(GCG_PATTERN_SPACE),
+      GCG_GROUP(GCG_ZERO_OR_MORE(GCG_PATTERN_ANY)), GCG_PATTERN_END_ELEMENT}},
+    // #id\s*(\S+)\s+(\S+)
+    {GCG_ID_TOKEN,
+     {GCG_LITERAL("#" GCG_ID_STRING), GCG_ZERO_OR_MORE(GCG_PATTERN_SPACE),
+      GCG_GROUP(GCG_WORD), GCG_SPACES, GCG_GROUP(GCG_WORD),
+      GCG_PATTERN_END_ELEMENT}},
+    // #rack1 (\S+)
+    {GCG_RACK1_TOKEN,
+     {GCG_LITERAL("#" GCG_RACK_STRING "1 "), GCG_GROUP(GCG_WORD),
+      GCG_PATTERN_END_ELEMENT}},
+    // #rack2 (\S+)
+    {GCG_RACK2_TOKEN,
+     {GCG_LITERAL("#" GCG_RACK_STRING "2 "), GCG_GROUP(GCG_WORD),
+      GCG_PATTERN_END_ELEMENT}},
+    // #character-encoding ([[:graph:]]+)
+    {GCG_ENCODING_TOKEN,
+     {GCG_LITERAL("#" GCG_CHAR_ENCODING_STRING " "),
+      GCG_GROUP(GCG_ONE_OR_MORE(GCG_PATTERN_GRAPH)), GCG_PATTERN_END_ELEMENT}},
+    // >(\S+):\s+(\S+)\s+([[:alnum:]]+)\s+(\S+)\s+[+](\d+)\s+(-?\d+)
+    {GCG_MOVE_TOKEN,
+     {GCG_EVENT_PLAYER, GCG_GROUP(GCG_WORD), GCG_SPACES,
+      GCG_GROUP(GCG_ONE_OR_MORE(GCG_PATTERN_ALNUM)), GCG_SPACES,
+      GCG_GROUP(GCG_WORD), GCG_SPACES, GCG_LITERAL("+"),
+      GCG_GROUP(GCG_ONE_OR_MORE(GCG_PATTERN_DIGIT)), GCG_SPACES,
+      GCG_CUMULATIVE_SCORE}},
+    // #note (.+)
+    {GCG_NOTE_TOKEN,
+     {GCG_LITERAL("#" GCG_NOTE_STRING " "),
+      GCG_GROUP(GCG_ONE_OR_MORE(GCG_PATTERN_ANY)), GCG_PATTERN_END_ELEMENT}},
+    // #lexicon (.+)
+    {GCG_LEXICON_TOKEN,
+     {GCG_LITERAL("#" GCG_LEXICON_STRING " "),
+      GCG_GROUP(GCG_ONE_OR_MORE(GCG_PATTERN_ANY)), GCG_PATTERN_END_ELEMENT}},
+    // >(\S+):\s+(\S+)\s+--\s+-(\d+)\s+(-?\d+)
+    {GCG_PHONY_TILES_RETURNED_TOKEN,
+     {GCG_EVENT_PLAYER, GCG_GROUP(GCG_WORD), GCG_SPACES, GCG_LITERAL("--"),
+      GCG_SPACES, GCG_LITERAL("-"),
+      GCG_GROUP(GCG_ONE_OR_MORE(GCG_PATTERN_DIGIT)), GCG_SPACES,
+      GCG_CUMULATIVE_SCORE}},
+    // >(\S+):\s+(\S+)\s+-\s+\+0\s+(-?\d+)
+    {GCG_PASS_TOKEN,
+     {GCG_EVENT_PLAYER, GCG_GROUP(GCG_WORD), GCG_SPACES, GCG_LITERAL("-"),
+      GCG_SPACES, GCG_LITERAL("+0"), GCG_SPACES, GCG_CUMULATIVE_SCORE}},
+    // >(\S+):\s+(\S*)\s+\(challenge\)\s+(\+\d+)\s+(-?\d+)
+    {GCG_CHALLENGE_BONUS_TOKEN,
+     {GCG_EVENT_PLAYER, GCG_GROUP(GCG_ZERO_OR_MORE(GCG_PATTERN_NON_SPACE)),
+      GCG_SPACES, GCG_LITERAL("(challenge)"), GCG_SPACES, GCG_GROUP_START,
+      GCG_LITERAL("+"), GCG_ONE_OR_MORE(GCG_PATTERN_DIGIT), GCG_GROUP_END,
+      GCG_SPACES, GCG_CUMULATIVE_SCORE}},
+    // >(\S+):\s+(\S+)\s+-(\S+)\s+\+0\s+(-?\d+)
     {GCG_EXCHANGE_TOKEN,
-     ">([^[:space:]]+):[[:space:]]+([^[:space:]]+)[[:space:]]+-([^[:"
-     "space:]]+)[[:space:]]+\\+0[[:space:]]+(-?[[:digit:]]+)"},
+     {GCG_EVENT_PLAYER, GCG_GROUP(GCG_WORD), GCG_SPACES, GCG_LITERAL("-"),
+      GCG_GROUP(GCG_WORD), GCG_SPACES, GCG_LITERAL("+0"), GCG_SPACES,
+      GCG_CUMULATIVE_SCORE}},
+    // >(\S+):\s+\((\S+)\)\s+(\+\d+)\s+(-?\d+)
     {GCG_END_RACK_POINTS_TOKEN,
-     ">([^[:space:]]+):[[:space:]]+\\(([^[:space:]]+)\\)[[:space:]]+(\\+[[:"
-     "digit:]]+)[[:space:]]+(-?[[:digit:]]+)"},
+     {GCG_EVENT_PLAYER, GCG_LITERAL("("), GCG_GROUP(GCG_WORD),
+      GCG_LITERAL(")"), GCG_SPACES, GCG_GROUP_START, GCG_LITERAL("+"),
+      GCG_ONE_OR_MORE(GCG_PATTERN_DIGIT), GCG_GROUP_END, GCG_SPACES,
+      GCG_CUMULATIVE_SCORE}},
+    // >(\S+):\s+(\S*)\s+\(time\)\s+(-\d+)\s+(-?\d+)
     {GCG_TIME_PENALTY_TOKEN,
-     ">([^[:space:]]+):[[:space:]]+([^[:space:]]*)[[:space:]]+\\(time\\)[[:"
-     "space:]]+(\\-[[:digit:]]+)"
-     "[[:space:]]+(-?[[:digit:]]+)"},
-    {GCG_END_RACK_PENALTY_TOKEN, ">([^[:space:]]+):[[:space:]]+([^[:space:]]+)["
-                                 "[:space:]]+\\(([^[:space:]]+)"
-                                 "\\)[[:space:]]+(\\-[[:digit:]]+)"
-                                 "[[:space:]]+(-?[[:digit:]]+)"},
-    {GCG_GAME_TYPE_TOKEN, "#" GCG_GAME_TYPE_STRING " (.*)"},
-    {GCG_TILE_SET_TOKEN, "#" GCG_TILE_SET_STRING " (.*)"},
-    {GCG_BOARD_LAYOUT_TOKEN, "#" GCG_BOARD_LAYOUT_STRING " (.*)"},
+     {GCG_EVENT_PLAYER, GCG_GROUP(GCG_ZERO_OR_MORE(GCG_PATTERN_NON_SPACE)),
+      GCG_SPACES, GCG_LITERAL("(time)"), GCG_SPACES, GCG_GROUP_START,
+      GCG_LITERAL("-"), GCG_ONE_OR_MORE(GCG_PATTERN_DIGIT), GCG_GROUP_END,
+      GCG_SPACES, GCG_CUMULATIVE_SCORE}},
+    // >(\S+):\s+(\S+)\s+\((\S+)\)\s+(-\d+)\s+(-?\d+)
+    {GCG_END_RACK_PENALTY_TOKEN,
+     {GCG_EVENT_PLAYER, GCG_GROUP(GCG_WORD), GCG_SPACES, GCG_LITERAL("("),
+      GCG_GROUP(GCG_WORD), GCG_LITERAL(")"), GCG_SPACES, GCG_GROUP_START,
+      GCG_LITERAL("-"), GCG_ONE_OR_MORE(GCG_PATTERN_DIGIT), GCG_GROUP_END,
+      GCG_SPACES, GCG_CUMULATIVE_SCORE}},
+    // #game-type (.*)
+    {GCG_GAME_TYPE_TOKEN, {GCG_PRAGMA_WITH_REST(GCG_GAME_TYPE_STRING)}},
+    // #tile-set (.*)
+    {GCG_TILE_SET_TOKEN, {GCG_PRAGMA_WITH_REST(GCG_TILE_SET_STRING)}},
+    // #board-layout (.*)
+    {GCG_BOARD_LAYOUT_TOKEN, {GCG_PRAGMA_WITH_REST(GCG_BOARD_LAYOUT_STRING)}},
+    // #tile-distribution (.*)
     {GCG_TILE_DISTRIBUTION_NAME_TOKEN,
-     "#" GCG_TILE_DISTRIBUTION_STRING " (.*)"}};
-
-TokenRegexPair *token_regex_pair_create(gcg_token_t token,
-                                        const char *regex_string) {
-  TokenRegexPair *token_regex_pair = malloc_or_die(sizeof(TokenRegexPair));
-  token_regex_pair->token = token;
-  int regex_compilation_result =
-      regcomp(&token_regex_pair->regex, regex_string, REG_EXTENDED);
-  if (regex_compilation_result) {
-    log_fatal("could not compile regex: %s", regex_string);
+     {GCG_PRAGMA_WITH_REST(GCG_TILE_DISTRIBUTION_STRING)}},
+};
+
+enum {
+  NUMBER_OF_GCG_TOKEN_PATTERNS =
+      sizeof(gcg_token_patterns) / sizeof(GCGTokenPattern),
+};
+
+// The classes use the C locale like the regular expressions did, so every
+// byte of a multibyte UTF-8 character is non-space and not alphanumeric.
+static inline bool gcg_pattern_char_matches(gcg_pattern_t type, char c) {
+  const unsigned char uc = (unsigned char)c;
+  switch (type) {
+  case GCG_PATTERN_SPACE:
+    return isspace(uc);
+  case GCG_PATTERN_NON_SPACE:
+    return !isspace(uc);
+  case GCG_PATTERN_ANY:
+    return true;
+  case GCG_PATTERN_ALNUM:
+    return isalnum(uc);
+  case GCG_PATTERN_DIGIT:
+    return isdigit(uc);
+  case GCG_PATTERN_GRAPH:
+    return isgraph(uc);
+  case GCG_PATTERN_PLAYER_NUMBER:
+    return c == '1' || c == '2';
+  default:
+    log_fatal("unexpected gcg pattern character class: %d", type);
   }
-  return token_regex_pair;
+  return false;
 }
 
-void token_regex_pair_destroy(TokenRegexPair *token_regex_pair) {
-  if (!token_regex_pair) {
-    return;
+// Matches the elements against the line starting at position and returns
+// the end of the match, or -1 if there is none. Repetitions are greedy and
+// give back characters only as far as the rest of the pattern needs.
+static int gcg_pattern_match(const GCGPatternElement *element,
+                             const char *gcg_line, int position,
+                             int group_index,
+                             GCGMatchingGroup *matching_groups) {
+  switch (element->type) {
+  case GCG_PATTERN_END:
+    return position;
+  case GCG_PATTERN_GROUP_START:
+    matching_groups[group_index + 1].start = position;
+    return gcg_pattern_match(element + 1, gcg_line, position, group_index + 1,
+                             matching_groups);
+  case GCG_PATTERN_GROUP_END:
+    matching_groups[group_index].end = position;
+    return gcg_pattern_match(element + 1, gcg_line, position, group_index,
+                             matching_groups);
+  case GCG_PATTERN_LITERAL: {
+    const size_t literal_length = string_length(element->literal);
+    if (strncmp(gcg_line + position, element->literal, literal_length) == 0) {
+      const int end =
+          gcg_pattern_match(element + 1, gcg_line,
+                            position + (int)literal_length, group_index,
+                            matching_groups);
+      if (end >= 0 || element->min_repeats > 0) {
+        return end;
+      }
+    } else if (element->min_repeats > 0) {
+      return -1;
+    }
+    return gcg_pattern_match(element + 1, gcg_line, position, group_index,
+                             matching_groups);
+  }
+  default: {
+    int repeats = 0;
+    while (gcg_line[position + repeats] != '\0' &&
+           (element->max_repeats < 0 || repeats < element->max_repeats) &&
+           gcg_pattern_char_matches(element->type,
+                                    gcg_line[position + repeats])) {
+      repeats++;
+    }
+    for (; repeats >= element->min_repeats; repeats--) {
+      const int end = gcg_pattern_match(element + 1, gcg_line,
+                                        position + repeats, group_index,
+                                        matching_groups);
+      if (end >= 0) {
+        return end;
+      }
+    }
+    return -1;
+  }
   }
-  regfree(&token_regex_pair->regex);
-  free(token_regex_pair);
+}
+
+// Finds the leftmost match of the token pattern in the line. Every pattern
+// starts with a literal, so only the places where that literal occurs are
+// tried.
+static bool gcg_token_pattern_match(const GCGTokenPattern *token_pattern,
+                                    const char *gcg_line,
+                                    GCGMatchingGroup *matching_groups) {
+  const char *leading_literal = token_pattern->elements[0].literal;
+  for (const char *candidate = strstr(gcg_line, leading_literal);
+       candidate != NULL; candidate = strstr(candidate + 1, leading_literal)) {
+    const int start = (int)(candidate - gcg_line);
+    const int end = gcg_pattern_match(token_pattern->elements, gcg_line, start,
+                                      0, matching_groups);
+    if (end >= 0) {
+      matching_groups[0].start = start;
+      matching_groups[0].end = end;
+      return true;
+    }
+  }
+  return false;
+}
+
+static const GCGTokenPattern *get_gcg_token_pattern(gcg_token_t token) {
+  for (int i = 0; i < NUMBER_OF_GCG_TOKEN_PATTERNS; i++) {
+    if (gcg_token_patterns[i].token == token) {
+      return &gcg_token_patterns[i];
+    }
+  }
+  log_fatal("gcg token pattern not found: %d", token);
+  return NULL;
 }
 
 int get_matching_group_string_length(const GCGParser *gcg_parser,
                                      int group_index) {
-  int start_index = gcg_parser->matching_groups[group_index].rm_so;
-  int end_index = gcg_parser->matching_groups[group_index].rm_eo;
-  return end_index - start_index;
+  return gcg_parser->matching_groups[group_index].end -
+         gcg_parser->matching_groups[group_index].start;
 }
 
 char *get_matching_group_as_string(const GCGParser *gcg_parser,
                                    const char *gcg_line, int group_index) {
-  int start_index = gcg_parser->matching_groups[group_index].rm_so;
-  int end_index = gcg_parser->matching_groups[group_index].rm_eo;
-  return get_substring(gcg_line, start_index, end_index);
+  return get_substring(gcg_line, gcg_parser->matching_groups[group_index].start,
+                       gcg_parser->matching_groups[group_index].end);
 }
 
-int get_matching_group_as_int(const GCGParser *gcg_parser, const char *gcg_line,
+// Lines live in the parser's own buffer, so a matching group is read in
+// place by terminating it temporarily instead of copying it out. The
+// returned character must be handed back to restore_matching_group before
+// the line is used again, for instance in an error message.
+static char terminate_matching_group(const GCGParser *gcg_parser,
+                                     char *gcg_line, int group_index) {
+  char *group_end = gcg_line + gcg_parser->matching_groups[group_index].end;
+  const char replaced_char = *group_end;
+  *group_end = '\0';
+  return replaced_char;
+}
+
+static void restore_matching_group(const GCGParser *gcg_parser, char *gcg_line,
+                                   int group_index, char replaced_char) {
+  gcg_line[gcg_parser->matching_groups[group_index].end] = replaced_char;
+}
+
+static const char *get_matching_group_start(const GCGParser *gcg_parser,
+                                            const char *gcg_line,
+                                            int group_index) {
+  return gcg_line + gcg_parser->matching_groups[group_index].start;
+}
+
+int get_matching_group_as_int(const GCGParser *gcg_parser, char *gcg_line,
                               int group_index, ErrorStack *error_stack) {
-  char *matching_group_string =
-      get_matching_group_as_string(gcg_parser, gcg_line, group_index);
-  int matching_group_int = string_to_int(matching_group_string, error_stack);
-  free(matching_group_string);
+  const char replaced_char =
+      terminate_matching_group(gcg_parser, gcg_line, group_index);
+  const int matching_group_int = string_to_int(
+      get_matching_group_start(gcg_parser, gcg_line, group_index),
+      error_stack);
+  restore_matching_group(gcg_parser, gcg_line, group_index, replaced_char);
   return matching_group_int;
 }
 
-StringSplitter *decode_gcg_with_gcg_lines(const StringSplitter *gcg_lines,
-                                          GCGParser *gcg_parser,
-                                          ErrorStack *error_stack) {
-  // Find encoding token
-  TokenRegexPair *encoding_token_regex_pair = NULL;
-  for (int i = 0; i < gcg_parser->number_of_token_regex_pairs; i++) {
-    if (gcg_parser->token_regex_pairs[i]->token == GCG_ENCODING_TOKEN) {
-      encoding_token_regex_pair = gcg_parser->token_regex_pairs[i];
-      break;
+// Returns the number of lines, skipping empty ones. Each line is
+// terminated in place and loses any trailing carriage returns.
+static int split_gcg_text_into_lines(char *gcg_text, char ***gcg_lines) {
+  int capacity = 1;
+  for (const char *c = gcg_text; *c != '\0'; c++) {
+    capacity += *c == '\n';
+  }
+  *gcg_lines = malloc_or_die(sizeof(char *) * capacity);
+  int number_of_lines = 0;
+  char *line_start = gcg_text;
+  while (*line_start != '\0') {
+    char *line_end = strchr(line_start, '\n');
+    char *next_line_start = NULL;
+    if (line_end) {
+      next_line_start = line_end + 1;
+    } else {
+      line_end = line_start + string_length(line_start);
+      next_line_start = line_end;
+    }
+    *line_end = '\0';
+    while (line_end > line_start && *(line_end - 1) == '\r') {
+      *--line_end = '\0';
     }
+    if (line_end > line_start) {
+      (*gcg_lines)[number_of_lines++] = line_start;
+    }
+    line_start = next_line_start;
   }
+  return number_of_lines;
+}
 
-  if (!encoding_token_regex_pair) {
-    log_fatal("encoding token not found");
+static bool gcg_lines_have_non_ascii_chars(char *const *gcg_lines,
+                                           int first_line,
+                                           int number_of_lines) {
+  for (int i = first_line; i < number_of_lines; i++) {
+    for (const char *c = gcg_lines[i]; *c != '\0'; c++) {
+      if ((unsigned char)*c >= 0x80) {
+        return true;
+      }
+    }
   }
+  return false;
+}
 
-  const char *first_gcg_line = string_splitter_get_item(gcg_lines, 0);
+// Splits the GCG into lines, drops a leading encoding pragma and converts
+// ISO-8859-1 text to UTF-8. Pure ASCII text is valid in both encodings, so
+// the usual case only copies the GCG once.
+static void gcg_parser_load_lines(GCGParser *gcg_parser,
+                                  const char *gcg_string,
+                                  ErrorStack *error_stack) {
+  char *gcg_text = string_duplicate(gcg_string);
+  char **gcg_lines = NULL;
+  int number_of_gcg_lines = split_gcg_text_into_lines(gcg_text, &gcg_lines);
 
   // ISO_8859-1 is the default encoding
   gcg_encoding_t gcg_encoding = GCG_ENCODING_ISO_8859_1;
-
-  int regexec_result =
-      regexec(&encoding_token_regex_pair->regex, first_gcg_line, (MAX_GROUPS),
-              gcg_parser->matching_groups, 0);
-  int join_start_index = 0;
-  if (!regexec_result) {
-    char *encoding_string =
-        get_matching_group_as_string(gcg_parser, first_gcg_line, 1);
-    bool is_utf8 = strings_iequal("utf-8", encoding_string) ||
-                   strings_iequal("utf8", encoding_string);
-    bool is_iso_8859_1 = strings_iequal("iso-8859-1", encoding_string) ||
-                         strings_iequal("iso 8859-1", encoding_string);
-    free(encoding_string);
+  int first_line = 0;
+  if (number_of_gcg_lines > 0 &&
+      gcg_token_pattern_match(get_gcg_token_pattern(GCG_ENCODING_TOKEN),
+                              gcg_lines[0], gcg_parser->matching_groups)) {
+    const char replaced_char =
+        terminate_matching_group(gcg_parser, gcg_lines[0], 1);
+    const char *encoding_string =
+        get_matching_group_start(gcg_parser, gcg_lines[0], 1);
+    const bool is_utf8 = strings_iequal("utf-8", encoding_string) ||
+                         strings_iequal("utf8", encoding_string);
+    const bool is_iso_8859_1 = strings_iequal("iso-8859-1", encoding_string) ||
+                               strings_iequal("iso 8859-1", encoding_string);
+    restore_matching_group(gcg_parser, gcg_lines[0], 1, replaced_char);
     if (is_utf8) {
       gcg_encoding = GCG_ENCODING_UTF8;
     } else if (!is_iso_8859_1) {
@@ -238,45 +502,52 @@ StringSplitter *decode_gcg_with_gcg_lines(const StringSplitter *gcg_lines,
           error_stack, ERROR_STATUS_GCG_PARSE_UNSUPPORTED_CHARACTER_ENCODING,
           get_formatted_string(
               "cannot parse GCG with unsupported character encoding: %s",
-              first_gcg_line));
-      return NULL;
+              gcg_lines[0]));
+      free(gcg_lines);
+      free(gcg_text);
+      return;
     }
     // If the first line was the encoding line, we want
     // to ignore this when processing the GCG.
-    join_start_index = 1;
-  } else if (regexec_result != REG_NOMATCH) {
-    char msgbuf[100];
-    regerror(regexec_result, &encoding_token_regex_pair->regex, msgbuf,
-             sizeof(msgbuf));
-    log_fatal("regex match failed for encoding token: %s", msgbuf);
+    first_line = 1;
   }
 
-  StringSplitter *utf8_gcg_lines = NULL;
-  int number_of_gcg_lines = string_splitter_get_number_of_items(gcg_lines);
-  char *utf8_gcg_without_encoding = NULL;
-
-  if (gcg_encoding == GCG_ENCODING_ISO_8859_1) {
-    char *gcg_without_encoding = string_splitter_join(
-        gcg_lines, join_start_index, number_of_gcg_lines, "\n");
-    utf8_gcg_without_encoding = iso_8859_1_to_utf8(gcg_without_encoding);
-    free(gcg_without_encoding);
-  } else {
-    utf8_gcg_without_encoding = string_splitter_join(
-        gcg_lines, join_start_index, number_of_gcg_lines, "\n");
+  if (gcg_encoding == GCG_ENCODING_ISO_8859_1 &&
+      gcg_lines_have_non_ascii_chars(gcg_lines, first_line,
+                                     number_of_gcg_lines)) {
+    // Every ISO-8859-1 character above 0x7F takes two bytes in UTF-8.
+    size_t utf8_size = 0;
+    for (int i = first_line; i < number_of_gcg_lines; i++) {
+      utf8_size += string_length(gcg_lines[i]) * 2 + 1;
+    }
+    char *utf8_text = malloc_or_die(utf8_size + 1);
+    char *utf8_char = utf8_text;
+    for (int i = first_line; i < number_of_gcg_lines; i++) {
+      const char *iso_line = gcg_lines[i];
+      gcg_lines[i] = utf8_char;
+      for (const char *c = iso_line; *c != '\0'; c++) {
+        const unsigned char uc = (unsigned char)*c;
+        if (uc >= 0x80) {
+          *utf8_char++ = (char)(0xC0 | (uc >> 6));
+          *utf8_char++ = (char)(0x80 | (uc & 0x3F));
+        } else {
+          *utf8_char++ = *c;
+        }
+      }
+      *utf8_char++ = '\0';
+    }
+    *utf8_char = '\0';
+    free(gcg_text);
+    gcg_text = utf8_text;
   }
 
-  utf8_gcg_lines = split_string_by_newline(utf8_gcg_without_encoding, true);
-  free(utf8_gcg_without_encoding);
-  return utf8_gcg_lines;
-}
-
-StringSplitter *decode_gcg(GCGParser *gcg_parser, const char *gcg_string,
-                           ErrorStack *error_stack) {
-  StringSplitter *gcg_lines = split_string_by_newline(gcg_string, true);
-  StringSplitter *utf8_gcg_lines =
-      decode_gcg_with_gcg_lines(gcg_lines, gcg_parser, error_stack);
-  string_splitter_destroy(gcg_lines);
-  return utf8_gcg_lines;
+  gcg_parser->gcg_text = gcg_text;
+  gcg_parser->gcg_lines = gcg_lines;
+  gcg_parser->number_of_gcg_lines = number_of_gcg_lines - first_line;
+  if (first_line > 0) {
+    memmove(gcg_lines, gcg_lines + first_line,
+            sizeof(char *) * gcg_parser->number_of_gcg_lines);
+  }
 }
 
 GCGParser *gcg_parser_create(const char *gcg_string, GameHistory *game_history,
@@ -286,22 +557,17 @@ GCGParser *gcg_parser_create(const char *gcg_string, GameHistory *game_history,
   gcg_parser->game_history = game_history;
   gcg_parser->ld = NULL;
   gcg_parser->note_builder = string_builder_create();
-  gcg_parser->token_regex_pairs =
-      malloc_or_die(sizeof(TokenRegexPair *) * (NUMBER_OF_GCG_TOKENS));
-  gcg_parser->number_of_token_regex_pairs =
-      sizeof(token_string_regex_pairs) / sizeof(TokenStringRegexPair);
-  for (int i = 0; i < gcg_parser->number_of_token_regex_pairs; i++) {
-    gcg_parser->token_regex_pairs[i] =
-        token_regex_pair_create(token_string_regex_pairs[i].token,
-                                token_string_regex_pairs[i].regex_string);
-  }
+  gcg_parser->previous_token = GCG_UNKNOWN_TOKEN;
   memset(gcg_parser->gcg_token_count, 0, sizeof(gcg_parser->gcg_token_count));
   gcg_parser->player_is_reset[0] = false;
   gcg_parser->player_is_reset[1] = false;
   gcg_parser->existing_p0_lexicon = existing_p0_lexicon;
   gcg_parser->current_gcg_line_index = 0;
-  // The gcg_lines StringSplitter is NULL if the error stack is not empty
-  gcg_parser->gcg_lines = decode_gcg(gcg_parser, gcg_string, error_stack);
+  // The lines are NULL if the error stack is not empty
+  gcg_parser->gcg_text = NULL;
+  gcg_parser->gcg_lines = NULL;
+  gcg_parser->number_of_gcg_lines = 0;
+  gcg_parser_load_lines(gcg_parser, gcg_string, error_stack);
   return gcg_parser;
 }
 
@@ -309,29 +575,18 @@ void gcg_parser_destroy(GCGParser *gcg_parser) {
   if (!gcg_parser) {
     return;
   }
-  for (int i = 0; i < (gcg_parser->number_of_token_regex_pairs); i++) {
-    token_regex_pair_destroy(gcg_parser->token_regex_pairs[i]);
-  }
   string_builder_destroy(gcg_parser->note_builder);
-  string_splitter_destroy(gcg_parser->gcg_lines);
-  free(gcg_parser->token_regex_pairs);
+  free(gcg_parser->gcg_lines);
+  free(gcg_parser->gcg_text);
   free(gcg_parser);
 }
 
 gcg_token_t find_matching_gcg_token(GCGParser *gcg_parser,
                                     const char *gcg_line) {
-  for (int i = 0; i < gcg_parser->number_of_token_regex_pairs; i++) {
-    int regexec_result =
-        regexec(&gcg_parser->token_regex_pairs[i]->regex, gcg_line,
-                (MAX_GROUPS), gcg_parser->matching_groups, 0);
-    if (!regexec_result) {
-      return gcg_parser->token_regex_pairs[i]->token;
-    }
-    if (regexec_result != REG_NOMATCH) {
-      char msgbuf[100];
-      regerror(regexec_result, &gcg_parser->token_regex_pairs[i]->regex, msgbuf,
-               sizeof(msgbuf));
-      log_fatal("regex match failed: %s", msgbuf);
+  for (int i = 0; i < NUMBER_OF_GCG_TOKEN_PATTERNS; i++) {
+    if (gcg_token_pattern_match(&gcg_token_patterns[i], gcg_line,
+                                gcg_parser->matching_groups)) {
+      return gcg_token_patterns[i].token;
     }
   }
   return GCG_UNKNOWN_TOKEN;
@@ -339,116 +594,86 @@ gcg_token_t find_matching_gcg_token(GCGParser *gcg_parser,
 
 int get_player_index(const GCGParser *gcg_parser, const char *gcg_line,
                      int group_index) {
-  char *player_nickname =
-      get_matching_group_as_string(gcg_parser, gcg_line, group_index);
-
-  int player_index = -1;
+  const char *player_nickname =
+      get_matching_group_start(gcg_parser, gcg_line, group_index);
+  const size_t player_nickname_length =
+      get_matching_group_string_length(gcg_parser, group_index);
   for (int i = 0; i < 2; i++) {
-    if (strings_equal(
-            game_history_player_get_nickname(gcg_parser->game_history, i),
-            player_nickname)) {
-      player_index = i;
-      break;
+    const char *nickname =
+        game_history_player_get_nickname(gcg_parser->game_history, i);
+    if (nickname &&
+        strncmp(nickname, player_nickname, player_nickname_length) == 0 &&
+        nickname[player_nickname_length] == '\0') {
+      return i;
     }
   }
-  free(player_nickname);
-  return player_index;
+  return -1;
 }
 
 void copy_cumulative_score_to_game_event(const GCGParser *gcg_parser,
-                                         GameEvent *game_event,
-                                         const char *gcg_line, int group_index,
+                                         GameEvent *game_event, char *gcg_line,
+                                         int group_index,
                                          ErrorStack *error_stack) {
-  char *cumulative_score_string =
-      get_matching_group_as_string(gcg_parser, gcg_line, group_index);
   const int cumulative_score_int =
-      string_to_int(cumulative_score_string, error_stack);
+      get_matching_group_as_int(gcg_parser, gcg_line, group_index, error_stack);
   if (error_stack_is_empty(error_stack)) {
     game_event_set_cumulative_score(game_event,
                                     int_to_equity(cumulative_score_int));
   }
-  free(cumulative_score_string);
 }
 
 void copy_score_adjustment_to_game_event(const GCGParser *gcg_parser,
-                                         GameEvent *game_event,
-                                         const char *gcg_line, int group_index,
+                                         GameEvent *game_event, char *gcg_line,
+                                         int group_index,
                                          ErrorStack *error_stack) {
-  char *score_adjustment_string =
-      get_matching_group_as_string(gcg_parser, gcg_line, group_index);
   const int score_adjustment =
-      string_to_int(score_adjustment_string, error_stack);
+      get_matching_group_as_int(gcg_parser, gcg_line, group_index, error_stack);
   if (error_stack_is_empty(error_stack)) {
     game_event_set_score_adjustment(game_event,
                                     int_to_equity(score_adjustment));
   }
-  free(score_adjustment_string);
 }
 
 // Returns true if successful
-bool set_rack_from_matching_impl(const GCGParser *gcg_parser,
-                                 const char *gcg_line, int group_index,
-                                 Rack *rack_to_set, bool allow_empty) {
+bool set_rack_from_matching_impl(const GCGParser *gcg_parser, char *gcg_line,
+                                 int group_index, Rack *rack_to_set,
+                                 bool allow_empty) {
   rack_set_dist_size_and_reset(rack_to_set, ld_get_size(gcg_parser->ld));
   if (get_matching_group_string_length(gcg_parser, group_index) == 0) {
     return allow_empty;
   }
-  char *player_rack_string =
-      get_matching_group_as_string(gcg_parser, gcg_line, group_index);
+  const char replaced_char =
+      terminate_matching_group(gcg_parser, gcg_line, group_index);
   const bool success =
-      rack_set_to_string(gcg_parser->ld, rack_to_set, player_rack_string) > 0;
-  free(player_rack_string);
+      rack_set_to_string(
+          gcg_parser->ld, rack_to_set,
+          get_matching_group_start(gcg_parser, gcg_line, group_index)) > 0;
+  restore_matching_group(gcg_parser, gcg_line, group_index, replaced_char);
   return success;
 }
 
-bool set_rack_from_matching(const GCGParser *gcg_parser, const char *gcg_line,
+bool set_rack_from_matching(const GCGParser *gcg_parser, char *gcg_line,
                             int group_index, Rack *rack_to_set) {
   return set_rack_from_matching_impl(gcg_parser, gcg_line, group_index,
                                      rack_to_set, false);
 }
 
 bool set_rack_from_matching_allow_empty(const GCGParser *gcg_parser,
-                                        const char *gcg_line, int group_index,
+                                        char *gcg_line, int group_index,
                                         Rack *rack_to_set) {
   return set_rack_from_matching_impl(gcg_parser, gcg_line, group_index,
                                      rack_to_set, true);
 }
 
-void add_matching_group_to_string_builder(StringBuilder *sb,
-                                          const GCGParser *gcg_parser,
-                                          const char *gcg_line,
-                                          int group_index) {
-  char *matching_group_string =
-      get_matching_group_as_string(gcg_parser, gcg_line, group_index);
-  string_builder_add_string(sb, matching_group_string);
-  free(matching_group_string);
-}
-
-// Since the UCGI delimiter and the ASCII played through
-// character are the same, we needed to convert the ASCII played
-// through characters in the parse GCG move to ASCII UCGI played
-// through characters so that the play can be validated.
-void add_letters_played_to_string_builder(StringBuilder *sb,
-                                          const GCGParser *gcg_parser,
-                                          const char *gcg_line,
-                                          int group_index) {
-  char *matching_group_string =
-      get_matching_group_as_string(gcg_parser, gcg_line, group_index);
-  string_builder_add_string(sb, matching_group_string);
-  free(matching_group_string);
-}
-
 Equity get_move_score_from_gcg_line(const GCGParser *gcg_parser,
-                                    const char *gcg_line, int group_index,
+                                    char *gcg_line, int group_index,
                                     ErrorStack *error_stack) {
-  char *move_score_string =
-      get_matching_group_as_string(gcg_parser, gcg_line, group_index);
-  const int move_score_int = string_to_int(move_score_string, error_stack);
+  const int move_score_int =
+      get_matching_group_as_int(gcg_parser, gcg_line, group_index, error_stack);
   Equity move_score_eq = EQUITY_INITIAL_VALUE;
   if (error_stack_is_empty(error_stack)) {
     move_score_eq = int_to_equity(move_score_int);
   }
-  free(move_score_string);
   return move_score_eq;
 }
 
@@ -597,7 +822,7 @@ char *get_external_board_layout_name(const char *board_layout_name) {
 }
 
 // Returns true if processing should continue
-bool parse_gcg_line(GCGParser *gcg_parser, const char *gcg_line,
+bool parse_gcg_line(GCGParser *gcg_parser, char *gcg_line,
                     parse_gcg_mode_t parse_gcg_mode, ErrorStack *error_stack) {
   GameHistory *game_history = gcg_parser->game_history;
   gcg_token_t token = find_matching_gcg_token(gcg_parser, gcg_line);
@@ -665,7 +890,6 @@ bool parse_gcg_line(GCGParser *gcg_parser, const char *gcg_line,
   }
 
   GameEvent *game_event = NULL;
-  StringBuilder *move_string_builder = NULL;
   char *cgp_move_string = NULL;
   int move_score = 0;
   switch (token) {
@@ -777,28 +1001,20 @@ bool parse_gcg_line(GCGParser *gcg_parser, const char *gcg_line,
     // Write the move rack
     game_event_set_type(game_event, GAME_EVENT_TILE_PLACEMENT_MOVE);
 
-    move_string_builder = string_builder_create();
-
-    // Position
-    add_matching_group_to_string_builder(move_string_builder, gcg_parser,
-                                         gcg_line, 3);
-    string_builder_add_char(move_string_builder, ' ');
-
-    // Play
-    add_letters_played_to_string_builder(move_string_builder, gcg_parser,
-                                         gcg_line, 4);
-
     if (!set_rack_from_matching(gcg_parser, gcg_line, 2,
                                 game_event_get_rack(game_event))) {
-      string_builder_destroy(move_string_builder);
       error_stack_push(
           error_stack, ERROR_STATUS_GCG_PARSE_RACK_MALFORMED,
           get_formatted_string("could not parse move rack: %s", gcg_line));
       return false;
     }
 
-    cgp_move_string = string_builder_dump(move_string_builder, NULL);
-    string_builder_destroy(move_string_builder);
+    // Position and play
+    cgp_move_string = get_formatted_string(
+        "%.*s %.*s", get_matching_group_string_length(gcg_parser, 3),
+        get_matching_group_start(gcg_parser, gcg_line, 3),
+        get_matching_group_string_length(gcg_parser, 4),
+        get_matching_group_start(gcg_parser, gcg_line, 4));
 
     // Get the GCG score so it can be compared to the validated move score
     move_score =
@@ -1110,25 +1326,19 @@ bool parse_gcg_line(GCGParser *gcg_parser, const char *gcg_line,
     game_event_set_player_index(game_event, player_index);
     game_event_set_type(game_event, GAME_EVENT_EXCHANGE);
 
-    move_string_builder = string_builder_create();
-
-    // Exchange token and tiles exchanged
-    string_builder_add_formatted_string(move_string_builder, "%s ",
-                                        UCGI_EXCHANGE_MOVE);
-    add_matching_group_to_string_builder(move_string_builder, gcg_parser,
-                                         gcg_line, 3);
-
     if (!set_rack_from_matching(gcg_parser, gcg_line, 2,
                                 game_event_get_rack(game_event))) {
-      string_builder_destroy(move_string_builder);
       error_stack_push(
           error_stack, ERROR_STATUS_GCG_PARSE_RACK_MALFORMED,
           get_formatted_string("could not parse exchange rack: %s", gcg_line));
       return false;
     }
 
-    cgp_move_string = string_builder_dump(move_string_builder, NULL);
-    string_builder_destroy(move_string_builder);
+    // Exchange token and tiles exchanged
+    cgp_move_string = get_formatted_string(
+        "%s %.*s", UCGI_EXCHANGE_MOVE,
+        get_matching_group_string_length(gcg_parser, 3),
+        get_matching_group_start(gcg_parser, gcg_line, 3));
 
     copy_cumulative_score_to_game_event(gcg_parser, game_event, gcg_line, 4,
                                         error_stack);
@@ -1172,22 +1382,19 @@ bool parse_gcg_line_and_increment_index(GCGParser *gcg_parser,
                                         ErrorStack *error_stack) {
   const bool continue_parsing = parse_gcg_line(
       gcg_parser,
-      string_splitter_get_item(gcg_parser->gcg_lines,
-                               gcg_parser->current_gcg_line_index),
+      gcg_parser->gcg_lines[gcg_parser->current_gcg_line_index],
       parse_gcg_mode, error_stack);
   gcg_parser->current_gcg_line_index++;
   return continue_parsing;
 }
 
 void parse_gcg_settings(GCGParser *gcg_parser, ErrorStack *error_stack) {
-  int number_of_gcg_lines =
-      string_splitter_get_number_of_items(gcg_parser->gcg_lines);
+  const int number_of_gcg_lines = gcg_parser->number_of_gcg_lines;
   for (int i = gcg_parser->current_gcg_line_index; i < number_of_gcg_lines;
        i++) {
     const bool continue_parsing = parse_gcg_line(
         gcg_parser,
-        string_splitter_get_item(gcg_parser->gcg_lines,
-                                 gcg_parser->current_gcg_line_index),
+        gcg_parser->gcg_lines[gcg_parser->current_gcg_line_index],
         PARSE_GCG_MODE_SETTINGS, error_stack);
     if (!error_stack_is_empty(error_stack)) {
       return;
@@ -1202,14 +1409,12 @@ void parse_gcg_settings(GCGParser *gcg_parser, ErrorStack *error_stack) {
 void parse_gcg_events(GCGParser *gcg_parser, Game *game,
                       ErrorStack *error_stack) {
   gcg_parser->ld = game_get_ld(game);
-  int number_of_gcg_lines =
-      string_splitter_get_number_of_items(gcg_parser->gcg_lines);
+  const int number_of_gcg_lines = gcg_parser->number_of_gcg_lines;
   for (int i = gcg_parser->current_gcg_line_index; i < number_of_gcg_lines;
        i++) {
     const bool continue_parsing = parse_gcg_line(
         gcg_parser,
-        string_splitter_get_item(gcg_parser->gcg_lines,
-                                 gcg_parser->current_gcg_line_index),
+        gcg_parser->gcg_lines[gcg_parser->current_gcg_line_index],
         PARSE_GCG_MODE_EVENTS, error_stack);
     if (!error_stack_is_empty(error_stack)) {
       return;
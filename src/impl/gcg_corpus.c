@@ -0,0 +1,340 @@
+#include "gcg_corpus.h"
+
+#include "../compat/cpthread.h"
+#include "../ent/board_layout.h"
+#include "../ent/game.h"
+#include "../ent/game_history.h"
+#include "../ent/letter_distribution.h"
+#include "../util/io_util.h"
+#include "../util/string_util.h"
+#include "gcg.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GCG_CORPUS_FILE_EXTENSION ".gcg"
+
+typedef struct GCGCorpusEntry {
+  // Index into the corpus sources
+  int source_index;
+  // Owned copy of the GCG text of this game only
+  char *gcg_string;
+  GameHistory *game_history;
+  error_code_t error_code;
+  char *error_message;
+} GCGCorpusEntry;
+
+struct GCGCorpus {
+  int number_of_sources;
+  char **sources;
+  int number_of_games;
+  GCGCorpusEntry *entries;
+};
+
+typedef struct GCGCorpusSharedData {
+  GCGCorpus *corpus;
+  const GCGCorpusArgs *args;
+  atomic_int next_game_index;
+} GCGCorpusSharedData;
+
+typedef struct GCGCorpusWorker {
+  GCGCorpusSharedData *shared_data;
+  Game *game;
+  ErrorStack *error_stack;
+  cpthread_t thread_id;
+} GCGCorpusWorker;
+
+static bool gcg_corpus_line_starts_game(const char *line) {
+  return *line == '#' && !has_prefix("#note ", line) &&
+         !has_prefix("#rack1 ", line) && !has_prefix("#rack2 ", line);
+}
+
+int *gcg_corpus_split_games(const char *gcg_string, int *number_of_games) {
+  int capacity = 16;
+  int *game_offsets = malloc_or_die(sizeof(int) * capacity);
+  int count = 0;
+  bool previous_line_is_event = false;
+  const char *line = gcg_string;
+  while (*line != '\0') {
+    while (*line == '\r' || *line == '\n') {
+      line++;
+    }
+    if (*line == '\0') {
+      break;
+    }
+    if (count == 0 ||
+        (previous_line_is_event && gcg_corpus_line_starts_game(line))) {
+      if (count == capacity) {
+        capacity *= 2;
+        game_offsets = realloc_or_die(game_offsets, sizeof(int) * capacity);
+      }
+      game_offsets[count++] = (int)(line - gcg_string);
+      previous_line_is_event = false;
+    }
+    if (*line == '>') {
+      previous_line_is_event = true;
+    } else if (*line == '#' && gcg_corpus_line_starts_game(line)) {
+      previous_line_is_event = false;
+    }
+    const char *line_end = strchr(line, '\n');
+    if (!line_end) {
+      break;
+    }
+    line = line_end + 1;
+  }
+  *number_of_games = count;
+  return game_offsets;
+}
+
+static void gcg_corpus_add_source(GCGCorpus *corpus, char *source,
+                                  const char *gcg_string) {
+  const int source_index = corpus->number_of_sources++;
+  corpus->sources = realloc_or_die(
+      corpus->sources, sizeof(char *) * corpus->number_of_sources);
+  corpus->sources[source_index] = source;
+
+  int number_of_source_games;
+  int *game_offsets =
+      gcg_corpus_split_games(gcg_string, &number_of_source_games);
+  if (number_of_source_games == 0) {
+    // Keep empty files so they are reported rather than silently skipped.
+    game_offsets[0] = (int)string_length(gcg_string);
+    number_of_source_games = 1;
+  }
+  corpus->entries = realloc_or_die(
+      corpus->entries, sizeof(GCGCorpusEntry) *
+                           (corpus->number_of_games + number_of_source_games));
+  for (int i = 0; i < number_of_source_games; i++) {
+    const int start = game_offsets[i];
+    const int end = i + 1 < number_of_source_games
+                        ? game_offsets[i + 1]
+                        : (int)string_length(gcg_string);
+    GCGCorpusEntry *entry = &corpus->entries[corpus->number_of_games++];
+    entry->source_index = source_index;
+    entry->gcg_string = get_substring(gcg_string, start, end);
+    entry->game_history = NULL;
+    entry->error_code = ERROR_STATUS_SUCCESS;
+    entry->error_message = NULL;
+  }
+  free(game_offsets);
+}
+
+static void gcg_corpus_load_file(GCGCorpus *corpus, char *filepath,
+                                 ErrorStack *error_stack) {
+  char *gcg_string = get_string_from_file(filepath, error_stack);
+  if (!error_stack_is_empty(error_stack)) {
+    free(filepath);
+    free(gcg_string);
+    return;
+  }
+  gcg_corpus_add_source(corpus, filepath, gcg_string);
+  free(gcg_string);
+}
+
+static void gcg_corpus_load_directory(GCGCorpus *corpus, const char *path,
+                                      ErrorStack *error_stack) {
+  int number_of_files;
+  char **filenames = get_files_in_directory(path, GCG_CORPUS_FILE_EXTENSION,
+                                            &number_of_files, error_stack);
+  if (!error_stack_is_empty(error_stack)) {
+    return;
+  }
+  for (int i = 0; i < number_of_files; i++) {
+    if (error_stack_is_empty(error_stack)) {
+      gcg_corpus_load_file(
+          corpus, get_formatted_string("%s/%s", path, filenames[i]),
+          error_stack);
+    }
+    free(filenames[i]);
+  }
+  free(filenames);
+}
+
+static void gcg_corpus_entry_set_error(GCGCorpusEntry *entry,
+                                       ErrorStack *error_stack) {
+  entry->error_code = error_stack_top(error_stack);
+  entry->error_message = error_stack_get_string_and_reset(error_stack);
+}
+
+// Pushes an error if the game uses data other than what the corpus is parsed
+// against, since workers share the already loaded data and cannot load more.
+static void gcg_corpus_check_game_history_data(const GCGCorpusArgs *args,
+                                               const GameHistory *game_history,
+                                               ErrorStack *error_stack) {
+  const char *lexicon_name = game_history_get_lexicon_name(game_history);
+  const char *ld_name = game_history_get_ld_name(game_history);
+  const char *board_layout_name =
+      game_history_get_board_layout_name(game_history);
+  const char *expected_ld_name = ld_get_name(game_get_ld(args->game));
+  if (!strings_equal(lexicon_name, args->lexicon_name)) {
+    error_stack_push(
+        error_stack, ERROR_STATUS_GCG_PARSE_CONFIG_LOAD_ERROR,
+        get_formatted_string("game uses lexicon '%s' but the corpus is parsed "
+                             "with lexicon '%s'",
+                             lexicon_name, args->lexicon_name));
+  } else if (!strings_equal(ld_name, expected_ld_name)) {
+    error_stack_push(
+        error_stack, ERROR_STATUS_GCG_PARSE_CONFIG_LOAD_ERROR,
+        get_formatted_string("game uses letter distribution '%s' but the "
+                             "corpus is parsed with letter distribution '%s'",
+                             ld_name, expected_ld_name));
+  } else if (args->board_layout_name &&
+             !strings_equal(board_layout_name, args->board_layout_name)) {
+    error_stack_push(
+        error_stack, ERROR_STATUS_GCG_PARSE_CONFIG_LOAD_ERROR,
+        get_formatted_string("game uses board layout '%s' but the corpus is "
+                             "parsed with board layout '%s'",
+                             board_layout_name, args->board_layout_name));
+  } else if (game_history_get_game_variant(game_history) !=
+             game_get_variant(args->game)) {
+    error_stack_push(
+        error_stack, ERROR_STATUS_GCG_PARSE_CONFIG_LOAD_ERROR,
+        string_duplicate("game uses a different variant than the corpus"));
+  }
+}
+
+static void gcg_corpus_parse_entry(const GCGCorpusArgs *args,
+                                   GCGCorpusEntry *entry, Game *game,
+                                   ErrorStack *error_stack) {
+  if (is_string_empty_or_whitespace(entry->gcg_string)) {
+    error_stack_push(error_stack, ERROR_STATUS_GCG_PARSE_GCG_EMPTY,
+                     string_duplicate("GCG is empty"));
+    gcg_corpus_entry_set_error(entry, error_stack);
+    return;
+  }
+  GameHistory *game_history = game_history_create();
+  GCGParser *gcg_parser = gcg_parser_create(entry->gcg_string, game_history,
+                                            args->lexicon_name, error_stack);
+  if (error_stack_is_empty(error_stack)) {
+    parse_gcg_settings(gcg_parser, error_stack);
+  }
+  if (error_stack_is_empty(error_stack)) {
+    gcg_corpus_check_game_history_data(args, game_history, error_stack);
+  }
+  if (error_stack_is_empty(error_stack)) {
+    parse_gcg_events(gcg_parser, game, error_stack);
+  }
+  gcg_parser_destroy(gcg_parser);
+  if (error_stack_is_empty(error_stack)) {
+    entry->game_history = game_history;
+  } else {
+    game_history_destroy(game_history);
+    gcg_corpus_entry_set_error(entry, error_stack);
+  }
+  // The text is no longer needed once the game is parsed.
+  free(entry->gcg_string);
+  entry->gcg_string = NULL;
+}
+
+static void *gcg_corpus_worker(void *uncasted_worker) {
+  GCGCorpusWorker *worker = (GCGCorpusWorker *)uncasted_worker;
+  GCGCorpusSharedData *shared_data = worker->shared_data;
+  GCGCorpus *corpus = shared_data->corpus;
+  while (true) {
+    const int game_index = atomic_fetch_add_explicit(
+        &shared_data->next_game_index, 1, memory_order_relaxed);
+    if (game_index >= corpus->number_of_games) {
+      break;
+    }
+    gcg_corpus_parse_entry(shared_data->args, &corpus->entries[game_index],
+                           worker->game, worker->error_stack);
+  }
+  return NULL;
+}
+
+static void gcg_corpus_parse(GCGCorpus *corpus, const GCGCorpusArgs *args) {
+  int num_threads = args->num_threads;
+  if (num_threads > corpus->number_of_games) {
+    num_threads = corpus->number_of_games;
+  }
+  if (num_threads < 1) {
+    num_threads = 1;
+  }
+  GCGCorpusSharedData shared_data = {
+      .corpus = corpus,
+      .args = args,
+  };
+  atomic_init(&shared_data.next_game_index, 0);
+  GCGCorpusWorker *workers =
+      malloc_or_die(sizeof(GCGCorpusWorker) * num_threads);
+  for (int thread_index = 0; thread_index < num_threads; thread_index++) {
+    workers[thread_index].shared_data = &shared_data;
+    workers[thread_index].game = game_duplicate(args->game);
+    workers[thread_index].error_stack = error_stack_create();
+    cpthread_create(&workers[thread_index].thread_id, gcg_corpus_worker,
+                    &workers[thread_index]);
+  }
+  for (int thread_index = 0; thread_index < num_threads; thread_index++) {
+    cpthread_join(workers[thread_index].thread_id);
+    game_destroy(workers[thread_index].game);
+    error_stack_destroy(workers[thread_index].error_stack);
+  }
+  free(workers);
+}
+
+GCGCorpus *gcg_corpus_create(const GCGCorpusArgs *args,
+                             ErrorStack *error_stack) {
+  GCGCorpus *corpus = calloc_or_die(1, sizeof(GCGCorpus));
+  if (path_is_directory(args->path)) {
+    gcg_corpus_load_directory(corpus, args->path, error_stack);
+  } else {
+    gcg_corpus_load_file(corpus, string_duplicate(args->path), error_stack);
+  }
+  if (!error_stack_is_empty(error_stack)) {
+    gcg_corpus_destroy(corpus);
+    return NULL;
+  }
+  gcg_corpus_parse(corpus, args);
+  return corpus;
+}
+
+void gcg_corpus_destroy(GCGCorpus *corpus) {
+  if (!corpus) {
+    return;
+  }
+  for (int i = 0; i < corpus->number_of_games; i++) {
+    free(corpus->entries[i].gcg_string);
+    game_history_destroy(corpus->entries[i].game_history);
+    free(corpus->entries[i].error_message);
+  }
+  free(corpus->entries);
+  for (int i = 0; i < corpus->number_of_sources; i++) {
+    free(corpus->sources[i]);
+  }
+  free(corpus->sources);
+  free(corpus);
+}
+
+int gcg_corpus_get_number_of_games(const GCGCorpus *corpus) {
+  return corpus->number_of_games;
+}
+
+int gcg_corpus_get_number_of_failed_games(const GCGCorpus *corpus) {
+  int number_of_failed_games = 0;
+  for (int i = 0; i < corpus->number_of_games; i++) {
+    if (!corpus->entries[i].game_history) {
+      number_of_failed_games++;
+    }
+  }
+  return number_of_failed_games;
+}
+
+const char *gcg_corpus_get_source(const GCGCorpus *corpus, int game_index) {
+  return corpus->sources[corpus->entries[game_index].source_index];
+}
+
+const GameHistory *gcg_corpus_get_game_history(const GCGCorpus *corpus,
+                                               int game_index) {
+  return corpus->entries[game_index].game_history;
+}
+
+error_code_t gcg_corpus_get_error_code(const GCGCorpus *corpus,
+                                       int game_index) {
+  return corpus->entries[game_index].error_code;
+}
+
+const char *gcg_corpus_get_error_message(const GCGCorpus *corpus,
+                                         int game_index) {
+  return corpus->entries[game_index].error_message;
+}
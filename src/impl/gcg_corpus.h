@@ -0,0 +1,51 @@
+#ifndef GCG_CORPUS_H
+#define GCG_CORPUS_H
+
+#include "../ent/game.h"
+#include "../ent/game_history.h"
+#include "../util/io_util.h"
+
+// A collection of GCGs parsed in bulk into GameHistory objects. The games are
+// read either from every .gcg file in a directory or from a single file
+// holding several concatenated GCGs, and are parsed and validated by parallel
+// workers against the lexicon, letter distribution, board layout and variant
+// of an already loaded game. A game that fails to parse does not stop the
+// others; its error is kept with its entry in the corpus.
+typedef struct GCGCorpus GCGCorpus;
+
+typedef struct GCGCorpusArgs {
+  // Path to a directory of .gcg files or to a single, possibly
+  // multi-game, GCG file.
+  const char *path;
+  // Template for the per-worker games. Every GCG must use its letter
+  // distribution and variant.
+  const Game *game;
+  const char *lexicon_name;
+  const char *board_layout_name;
+  int num_threads;
+} GCGCorpusArgs;
+
+GCGCorpus *gcg_corpus_create(const GCGCorpusArgs *args,
+                             ErrorStack *error_stack);
+void gcg_corpus_destroy(GCGCorpus *corpus);
+
+int gcg_corpus_get_number_of_games(const GCGCorpus *corpus);
+int gcg_corpus_get_number_of_failed_games(const GCGCorpus *corpus);
+// Returns the file the game was read from.
+const char *gcg_corpus_get_source(const GCGCorpus *corpus, int game_index);
+// Returns NULL if the game failed to parse.
+const GameHistory *gcg_corpus_get_game_history(const GCGCorpus *corpus,
+                                               int game_index);
+// Returns ERROR_STATUS_SUCCESS and NULL if the game parsed successfully.
+error_code_t gcg_corpus_get_error_code(const GCGCorpus *corpus,
+                                       int game_index);
+const char *gcg_corpus_get_error_message(const GCGCorpus *corpus,
+                                         int game_index);
+
+// Returns the offsets at which each game in a concatenated GCG string starts.
+// A game starts at the beginning of the string and at every pragma line that
+// follows an event line, other than the #note, #rack1 and #rack2 pragmas that
+// annotate the event before them. The caller frees the returned array.
+int *gcg_corpus_split_games(const char *gcg_string, int *number_of_games);
+
+#endif
@@ -31,12 +31,52 @@
 #include "../util/math_util.h"
 #include "../util/string_util.h"
 #include "gameplay.h"
+#include "move_gen.h"
+#include "thread_pool.h"
 #include <assert.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
+// A candidate rack claimed by a worker and waiting for its top move to be
+// generated. The fields that depend on the enumeration state are captured
+// when the rack is claimed, since the enumeration moves on before the batch
+// is generated.
+typedef struct InferenceBatchEntry {
+  Rack leave;
+  Equity leave_value;
+  uint64_t number_of_draws_for_leave;
+  bool bag_is_empty;
+} InferenceBatchEntry;
+
+// A move that beat the equity cutoff for some candidate rack. The move is
+// also legal for any other candidate rack that contains its tiles, with the
+// same equity apart from the leave, so it refutes those racks as well when
+// its equity with their leave still beats their cutoff.
+typedef struct InferenceWitness {
+  Rack tiles;
+  Equity equity_without_leave;
+} InferenceWitness;
+
+// A candidate rack is split into its playable part, the blanks and the
+// letters that some rack could play on the board, and the letters that no
+// rack can play. Every tile placement of the rack only uses its playable
+// part, so the racks with the same playable part form one class whose tile
+// placements are generated once and shared, with only the leave depending
+// on the member of the class.
+typedef struct InferenceClassLeave {
+  // The leave of the playable part
+  Rack leave;
+  Equity equity_without_leave;
+} InferenceClassLeave;
+
+typedef struct InferenceClass {
+  Rack playable_rack;
+  int number_of_leaves;
+  InferenceClassLeave leaves[INFERENCE_MAX_CLASS_LEAVES];
+} InferenceClass;
+
 typedef struct Inference {
   // KLV used to evaluate leaves to determine
   // which moves are top equity. This should be
@@ -59,12 +99,27 @@ typedef struct Inference {
   // the top move.
   Equity equity_margin;
   bool use_infer_cutoff_optimization;
+  // Whether candidate racks are checked against the witnesses before their
+  // moves are generated. Only used for tile placements with tiles in the bag,
+  // where the equity of a move depends on the rack only through its leave.
+  bool use_witnesses;
+  int number_of_witnesses;
+  int next_witness_index;
+  InferenceWitness witnesses[INFERENCE_NUMBER_OF_WITNESSES];
+  // Whether racks with unplayable letters are checked against the tile
+  // placements of their class before their moves are generated.
+  bool use_classes;
+  uint64_t unplayable_letters;
+  int number_of_classes;
+  int next_class_index;
+  InferenceClass classes[INFERENCE_NUMBER_OF_CLASSES];
+  MoveList *class_move_list;
   uint64_t current_rack_index;
   int num_threads;
   int print_interval;
   uint64_t *shared_rack_index;
   cpthread_mutex_t *shared_rack_index_lock;
-  cpthread_t cpthread_id;
+  ThreadPoolThread *pool_thread;
   // Rack containing just the unknown leave, which is
   // the tiles on the target's rack unseen to
   // the observer making the inference.
@@ -79,8 +134,13 @@ typedef struct Inference {
   Rack *current_target_rack;
   // The bag represented by a rack for convenience
   Rack *bag_as_rack;
-  // MoveList used by the inference to generate moves
-  MoveList *move_list;
+  // Candidate racks waiting for movegen, with the full racks, cutoffs and
+  // move lists passed to generate_moves_for_racks in parallel arrays.
+  int batch_count;
+  InferenceBatchEntry batch[INFERENCE_MOVEGEN_BATCH_SIZE];
+  Rack batch_racks[INFERENCE_MOVEGEN_BATCH_SIZE];
+  Equity batch_target_equities[INFERENCE_MOVEGEN_BATCH_SIZE];
+  MoveList *batch_move_lists[INFERENCE_MOVEGEN_BATCH_SIZE];
   // Game used by the inference to generate moves
   Game *game;
   InferenceResults *results;
@@ -104,7 +164,10 @@ void inference_destroy(Inference *inference) {
   rack_destroy(inference->current_target_leave);
   rack_destroy(inference->current_target_exchanged);
   rack_destroy(inference->bag_as_rack);
-  move_list_destroy(inference->move_list);
+  for (int i = 0; i < INFERENCE_MOVEGEN_BATCH_SIZE; i++) {
+    move_list_destroy(inference->batch_move_lists[i]);
+  }
+  move_list_destroy(inference->class_move_list);
   inference_results_destroy(inference->results);
   game_destroy(inference->game);
   free(inference);
@@ -149,107 +212,333 @@ void record_valid_leave(const Rack *rack, InferenceResults *results,
                                   number_of_draws_for_leave);
 }
 
-void evaluate_possible_leave(Inference *inference) {
-  Equity current_leave_value =
-      klv_get_leave_value(inference->klv, inference->current_target_leave);
-
-  const Equity target_equity_cutoff =
-      inference->target_score + current_leave_value + inference->equity_margin;
-  int target_leave_size = UNSET_LEAVE_SIZE;
-  Equity eq_margin_movegen = 0;
-  if (inference->use_infer_cutoff_optimization &&
-      (inference->target_number_of_tiles_exchanged > 0)) {
-    target_leave_size = RACK_SIZE - inference->target_number_of_tiles_exchanged;
-    // For exchanges, pass the margin to move generation for best_leaves
-    // calculation
-    eq_margin_movegen = inference->equity_margin;
-  }
-
-  // For tile placements, margin is already in target_equity_cutoff, so pass 0
-  const Move *top_move = get_top_equity_move_for_inferences(
-      inference->game, inference->move_list,
-      inference->use_infer_cutoff_optimization ? target_equity_cutoff
-                                               : EQUITY_MAX_VALUE,
-      target_leave_size, eq_margin_movegen);
-
+static void record_possible_leave(Inference *inference,
+                                  InferenceBatchEntry *entry,
+                                  Equity target_equity_cutoff,
+                                  const Move *top_move) {
   const bool is_within_equity_margin =
       target_equity_cutoff >= move_get_equity(top_move);
   const int tiles_played = move_get_tiles_played(top_move);
   const bool number_exchanged_matches =
       move_get_type(top_move) == GAME_EVENT_EXCHANGE &&
       tiles_played == inference->target_number_of_tiles_exchanged;
-  const bool recordable = is_within_equity_margin || number_exchanged_matches ||
-                          rack_is_empty(inference->bag_as_rack);
-
-  if (recordable) {
-    uint64_t number_of_draws_for_leave = get_number_of_draws_for_rack(
-        inference->bag_as_rack, inference->current_target_leave);
-    if (inference->target_number_of_tiles_exchanged > 0) {
-      record_valid_leave(inference->current_target_leave, inference->results,
-                         INFERENCE_TYPE_RACK,
-                         equity_to_double(current_leave_value),
-                         number_of_draws_for_leave);
-
-      if (number_exchanged_matches) {
-        // The full rack for the exchange was recorded above,
-        // but now we have to record the leave and the exchanged tiles
-        for (int exchanged_tile_index = 0; exchanged_tile_index < tiles_played;
-             exchanged_tile_index++) {
-          MachineLetter tile_exchanged =
-              move_get_tile(top_move, exchanged_tile_index);
-          rack_add_letter(inference->current_target_exchanged, tile_exchanged);
-          rack_take_letter(inference->current_target_leave, tile_exchanged);
-        }
-        record_valid_leave(
-            inference->current_target_leave, inference->results,
-            INFERENCE_TYPE_LEAVE,
-            equity_to_double(klv_get_leave_value(
-                inference->klv, inference->current_target_leave)),
-            number_of_draws_for_leave);
-        record_valid_leave(
-            inference->current_target_exchanged, inference->results,
-            INFERENCE_TYPE_EXCHANGED,
-            equity_to_double(klv_get_leave_value(
-                inference->klv, inference->current_target_exchanged)),
-            number_of_draws_for_leave);
-        LeaveRackList *lrl =
-            inference_results_get_leave_rack_list(inference->results);
-        if (lrl) {
-          leave_rack_list_insert_rack(inference->current_target_leave,
-                                      inference->current_target_exchanged,
-                                      (int)number_of_draws_for_leave,
-                                      current_leave_value, lrl);
-        }
-        alias_method_add_rack(
-            inference_results_get_alias_method(inference->results),
-            inference->current_target_leave, (int)number_of_draws_for_leave);
-        rack_reset(inference->current_target_exchanged);
-        for (int exchanged_tile_index = 0; exchanged_tile_index < tiles_played;
-             exchanged_tile_index++) {
-          MachineLetter tile_exchanged =
-              move_get_tile(top_move, exchanged_tile_index);
-          rack_add_letter(inference->current_target_leave, tile_exchanged);
-        }
+  const bool recordable = is_within_equity_margin ||
+                          number_exchanged_matches || entry->bag_is_empty;
+
+  if (!recordable) {
+    return;
+  }
+  Rack *leave = &entry->leave;
+  const Equity current_leave_value = entry->leave_value;
+  const uint64_t number_of_draws_for_leave = entry->number_of_draws_for_leave;
+  if (inference->target_number_of_tiles_exchanged > 0) {
+    record_valid_leave(leave, inference->results, INFERENCE_TYPE_RACK,
+                       equity_to_double(current_leave_value),
+                       number_of_draws_for_leave);
+
+    if (number_exchanged_matches) {
+      // The full rack for the exchange was recorded above,
+      // but now we have to record the leave and the exchanged tiles
+      for (int exchanged_tile_index = 0; exchanged_tile_index < tiles_played;
+           exchanged_tile_index++) {
+        MachineLetter tile_exchanged =
+            move_get_tile(top_move, exchanged_tile_index);
+        rack_add_letter(inference->current_target_exchanged, tile_exchanged);
+        rack_take_letter(leave, tile_exchanged);
       }
-    } else {
-      record_valid_leave(inference->current_target_leave, inference->results,
-                         INFERENCE_TYPE_LEAVE,
-                         equity_to_double(current_leave_value),
-                         number_of_draws_for_leave);
-      alias_method_add_rack(
-          inference_results_get_alias_method(inference->results),
-          inference->current_target_leave, (int)number_of_draws_for_leave);
+      record_valid_leave(
+          leave, inference->results, INFERENCE_TYPE_LEAVE,
+          equity_to_double(klv_get_leave_value(inference->klv, leave)),
+          number_of_draws_for_leave);
+      record_valid_leave(
+          inference->current_target_exchanged, inference->results,
+          INFERENCE_TYPE_EXCHANGED,
+          equity_to_double(klv_get_leave_value(
+              inference->klv, inference->current_target_exchanged)),
+          number_of_draws_for_leave);
       LeaveRackList *lrl =
           inference_results_get_leave_rack_list(inference->results);
       if (lrl) {
-        leave_rack_list_insert_rack(inference->current_target_leave, NULL,
+        leave_rack_list_insert_rack(leave, inference->current_target_exchanged,
                                     (int)number_of_draws_for_leave,
                                     current_leave_value, lrl);
       }
+      alias_method_add_rack(
+          inference_results_get_alias_method(inference->results), leave,
+          (int)number_of_draws_for_leave);
+      rack_reset(inference->current_target_exchanged);
+    }
+  } else {
+    record_valid_leave(leave, inference->results, INFERENCE_TYPE_LEAVE,
+                       equity_to_double(current_leave_value),
+                       number_of_draws_for_leave);
+    alias_method_add_rack(
+        inference_results_get_alias_method(inference->results), leave,
+        (int)number_of_draws_for_leave);
+    LeaveRackList *lrl =
+        inference_results_get_leave_rack_list(inference->results);
+    if (lrl) {
+      leave_rack_list_insert_rack(leave, NULL, (int)number_of_draws_for_leave,
+                                  current_leave_value, lrl);
+    }
+  }
+}
+
+// Sets tiles, which must be empty, to the tiles the move takes from the rack.
+static void set_move_tiles(const Move *move, Rack *tiles) {
+  const int tiles_length = move_get_tiles_length(move);
+  for (int i = 0; i < tiles_length; i++) {
+    MachineLetter tile = move_get_tile(move, i);
+    if (tile == PLAYED_THROUGH_MARKER) {
+      continue;
+    }
+    if (get_is_blanked(tile)) {
+      tile = BLANK_MACHINE_LETTER;
+    }
+    rack_add_letter(tiles, tile);
+  }
+}
+
+// Keeps the top move of a rack that it refuted as a witness against later
+// racks, replacing the oldest witness once they are all in use.
+static void add_inference_witness(Inference *inference, const Rack *rack,
+                                  const Move *top_move) {
+  if (move_get_type(top_move) == GAME_EVENT_PASS) {
+    return;
+  }
+  InferenceWitness *witness =
+      &inference->witnesses[inference->next_witness_index];
+  rack_set_dist_size_and_reset(&witness->tiles, inference->ld_size);
+  set_move_tiles(top_move, &witness->tiles);
+  Rack leave;
+  rack_copy(&leave, rack);
+  rack_subtract(&leave, &witness->tiles);
+  witness->equity_without_leave =
+      move_get_equity(top_move) - klv_get_leave_value(inference->klv, &leave);
+  inference->next_witness_index =
+      (inference->next_witness_index + 1) % INFERENCE_NUMBER_OF_WITNESSES;
+  if (inference->number_of_witnesses < INFERENCE_NUMBER_OF_WITNESSES) {
+    inference->number_of_witnesses++;
+  }
+}
+
+// Returns true if one of the witnesses is a legal move for the rack with an
+// equity above target_equity, in which case the rack's top move beats the
+// target's play and the rack does not need its moves generated.
+static bool rack_is_refuted_by_witness(const Inference *inference,
+                                       const Rack *rack, Equity target_equity) {
+  for (int i = 0; i < inference->number_of_witnesses; i++) {
+    const InferenceWitness *witness = &inference->witnesses[i];
+    bool rack_has_tiles = true;
+    for (int ml = 0; ml < inference->ld_size; ml++) {
+      if (rack_get_letter(rack, ml) < rack_get_letter(&witness->tiles, ml)) {
+        rack_has_tiles = false;
+        break;
+      }
+    }
+    if (!rack_has_tiles) {
+      continue;
+    }
+    Rack leave;
+    rack_copy(&leave, rack);
+    rack_subtract(&leave, &witness->tiles);
+    if (witness->equity_without_leave +
+            klv_get_leave_value(inference->klv, &leave) >
+        target_equity) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Generates the tile placements of the playable rack and keeps the best
+// equity without the leave for each distinct leave they make.
+static void build_inference_class(Inference *inference,
+                                  InferenceClass *inference_class,
+                                  const Rack *playable_rack) {
+  rack_copy(&inference_class->playable_rack, playable_rack);
+  inference_class->number_of_leaves = 0;
+  const MoveGenArgs args = {
+      .game = inference->game,
+      .move_list = NULL,
+      .move_record_type = MOVE_RECORD_ALL,
+      .move_sort_type = MOVE_SORT_EQUITY,
+      .override_kwg = NULL,
+      .eq_margin_movegen = 0,
+      .target_equity = EQUITY_MAX_VALUE,
+      .target_leave_size_for_exchange_cutoff = UNSET_LEAVE_SIZE,
+  };
+  generate_moves_for_racks(&args, playable_rack, NULL,
+                           &inference->class_move_list, 1);
+  const MoveList *move_list = inference->class_move_list;
+  const int number_of_moves = move_list_get_count(move_list);
+  for (int i = 0; i < number_of_moves; i++) {
+    const Move *move = move_list_get_move(move_list, i);
+    if (move_get_type(move) != GAME_EVENT_TILE_PLACEMENT_MOVE) {
+      continue;
+    }
+    Rack tiles;
+    rack_set_dist_size_and_reset(&tiles, inference->ld_size);
+    set_move_tiles(move, &tiles);
+    Rack leave;
+    rack_copy(&leave, playable_rack);
+    rack_subtract(&leave, &tiles);
+    const Equity equity_without_leave =
+        move_get_equity(move) - klv_get_leave_value(inference->klv, &leave);
+    int leave_index = 0;
+    while (leave_index < inference_class->number_of_leaves &&
+           !racks_are_equal(&inference_class->leaves[leave_index].leave,
+                            &leave)) {
+      leave_index++;
+    }
+    InferenceClassLeave *class_leave = &inference_class->leaves[leave_index];
+    if (leave_index < inference_class->number_of_leaves) {
+      if (equity_without_leave > class_leave->equity_without_leave) {
+        class_leave->equity_without_leave = equity_without_leave;
+      }
+    } else if (leave_index < INFERENCE_MAX_CLASS_LEAVES) {
+      rack_copy(&class_leave->leave, &leave);
+      class_leave->equity_without_leave = equity_without_leave;
+      inference_class->number_of_leaves++;
     }
   }
 }
 
+static const InferenceClass *get_inference_class(Inference *inference,
+                                                 const Rack *playable_rack) {
+  for (int i = 0; i < inference->number_of_classes; i++) {
+    if (racks_are_equal(&inference->classes[i].playable_rack, playable_rack)) {
+      return &inference->classes[i];
+    }
+  }
+  InferenceClass *inference_class =
+      &inference->classes[inference->next_class_index];
+  build_inference_class(inference, inference_class, playable_rack);
+  inference->next_class_index =
+      (inference->next_class_index + 1) % INFERENCE_NUMBER_OF_CLASSES;
+  if (inference->number_of_classes < INFERENCE_NUMBER_OF_CLASSES) {
+    inference->number_of_classes++;
+  }
+  return inference_class;
+}
+
+// Returns true if the rack has unplayable letters and one of the tile
+// placements of its class has an equity above target_equity with the
+// rack's leave. The moves kept for the class may not be all of them, so a
+// rack that is not refuted still needs its moves generated.
+static bool rack_is_refuted_by_class(Inference *inference, const Rack *rack,
+                                     Equity target_equity) {
+  Rack playable_rack;
+  rack_set_dist_size_and_reset(&playable_rack, inference->ld_size);
+  Rack unplayable_rack;
+  rack_set_dist_size_and_reset(&unplayable_rack, inference->ld_size);
+  for (int ml = 0; ml < inference->ld_size; ml++) {
+    const int count = rack_get_letter(rack, ml);
+    if (count == 0) {
+      continue;
+    }
+    if (inference->unplayable_letters & ((uint64_t)1 << ml)) {
+      rack_add_letters(&unplayable_rack, ml, count);
+    } else {
+      rack_add_letters(&playable_rack, ml, count);
+    }
+  }
+  if (rack_is_empty(&unplayable_rack)) {
+    return false;
+  }
+  const InferenceClass *inference_class =
+      get_inference_class(inference, &playable_rack);
+  for (int i = 0; i < inference_class->number_of_leaves; i++) {
+    const InferenceClassLeave *class_leave = &inference_class->leaves[i];
+    Rack leave;
+    rack_copy(&leave, &class_leave->leave);
+    rack_union(&leave, &unplayable_rack);
+    if (class_leave->equity_without_leave +
+            klv_get_leave_value(inference->klv, &leave) >
+        target_equity) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Generates the top move for every batched rack with one
+// generate_moves_for_racks call, since the board is the same for all of
+// them, and records the leaves that are consistent with the target's play.
+static void flush_possible_leaves(Inference *inference) {
+  if (inference->batch_count == 0) {
+    return;
+  }
+  int target_leave_size = UNSET_LEAVE_SIZE;
+  Equity eq_margin_movegen = 0;
+  if (inference->use_infer_cutoff_optimization &&
+      (inference->target_number_of_tiles_exchanged > 0)) {
+    target_leave_size = RACK_SIZE - inference->target_number_of_tiles_exchanged;
+    // For exchanges, pass the margin to move generation for best_leaves
+    // calculation
+    eq_margin_movegen = inference->equity_margin;
+  }
+  // For tile placements, margin is already in the target equity cutoffs, so
+  // pass 0
+  const MoveGenArgs args = {
+      .game = inference->game,
+      .move_list = NULL,
+      .move_record_type = MOVE_RECORD_BEST,
+      .move_sort_type = MOVE_SORT_EQUITY,
+      .override_kwg = NULL,
+      .eq_margin_movegen = eq_margin_movegen,
+      .target_equity = EQUITY_MAX_VALUE,
+      .target_leave_size_for_exchange_cutoff = target_leave_size,
+  };
+  generate_moves_for_racks(&args, inference->batch_racks,
+                           inference->use_infer_cutoff_optimization
+                               ? inference->batch_target_equities
+                               : NULL,
+                           inference->batch_move_lists,
+                           inference->batch_count);
+  for (int i = 0; i < inference->batch_count; i++) {
+    const Move *top_move =
+        move_list_get_move(inference->batch_move_lists[i], 0);
+    record_possible_leave(inference, &inference->batch[i],
+                          inference->batch_target_equities[i], top_move);
+    if (inference->use_witnesses &&
+        move_get_equity(top_move) > inference->batch_target_equities[i]) {
+      add_inference_witness(inference, &inference->batch_racks[i], top_move);
+    }
+  }
+  inference->batch_count = 0;
+}
+
+void evaluate_possible_leave(Inference *inference) {
+  const Equity leave_value =
+      klv_get_leave_value(inference->klv, inference->current_target_leave);
+  const Equity target_equity =
+      inference->target_score + leave_value + inference->equity_margin;
+  // A rack is always recorded when the bag is empty, so it can only be
+  // refuted when there are tiles in the bag.
+  if (inference->use_witnesses && !rack_is_empty(inference->bag_as_rack) &&
+      (rack_is_refuted_by_witness(inference, inference->current_target_rack,
+                                  target_equity) ||
+       (inference->use_classes &&
+        rack_is_refuted_by_class(inference, inference->current_target_rack,
+                                 target_equity)))) {
+    return;
+  }
+  InferenceBatchEntry *entry = &inference->batch[inference->batch_count];
+  rack_copy(&entry->leave, inference->current_target_leave);
+  entry->leave_value = leave_value;
+  entry->number_of_draws_for_leave = get_number_of_draws_for_rack(
+      inference->bag_as_rack, inference->current_target_leave);
+  entry->bag_is_empty = rack_is_empty(inference->bag_as_rack);
+  rack_copy(&inference->batch_racks[inference->batch_count],
+            inference->current_target_rack);
+  inference->batch_target_equities[inference->batch_count] = target_equity;
+  inference->batch_count++;
+  if (inference->batch_count == INFERENCE_MOVEGEN_BATCH_SIZE) {
+    flush_possible_leaves(inference);
+  }
+}
+
 void increment_letter_for_inference(Inference *inference,
                                     MachineLetter letter) {
   rack_take_letter(inference->bag_as_rack, letter);
@@ -324,11 +613,78 @@ void complete_inference_setup(Inference *inference, const InferenceArgs *args) {
   }
 }
 
-Inference *inference_create(const Game *game, const InferenceArgs *args,
-                            const InferenceResults *results) {
+// Returns the letters that no rack can play on the board, found by playing a
+// rack of blanks and recording the letters they designate.
+static uint64_t get_unplayable_letters(Inference *inference) {
+  Rack blanks;
+  rack_set_dist_size_and_reset(&blanks, inference->ld_size);
+  rack_add_letters(&blanks, BLANK_MACHINE_LETTER, RACK_SIZE);
+  uint64_t playable_letters = 0;
+  const MoveGenArgs args = {
+      .game = inference->game,
+      .move_list = NULL,
+      .move_record_type = MOVE_RECORD_TILES_PLAYED,
+      .move_sort_type = MOVE_SORT_SCORE,
+      .override_kwg = NULL,
+      .target_equity = EQUITY_MAX_VALUE,
+      .target_leave_size_for_exchange_cutoff = UNSET_LEAVE_SIZE,
+      .tiles_played_bv = &playable_letters,
+      .record_designated_letters = true,
+  };
+  MoveList *move_list = move_list_create_small(1);
+  generate_moves_for_racks(&args, &blanks, NULL, &move_list, 1);
+  small_move_list_destroy(move_list);
+  uint64_t unplayable_letters = 0;
+  for (int ml = 0; ml < inference->ld_size; ml++) {
+    if (ml != BLANK_MACHINE_LETTER &&
+        !(playable_letters & ((uint64_t)1 << ml))) {
+      unplayable_letters |= (uint64_t)1 << ml;
+    }
+  }
+  return unplayable_letters;
+}
+
+// Sets up the witness moves used to refute candidate racks without
+// generating their moves. The rack classes are set up separately by
+// set_inference_unplayable_letters.
+void reset_inference_refutations(Inference *inference) {
+  inference->use_witnesses =
+      inference->use_infer_cutoff_optimization &&
+      inference->target_number_of_tiles_exchanged == 0 &&
+      bag_get_letters(game_get_bag(inference->game)) > 0;
+  inference->number_of_witnesses = 0;
+  inference->next_witness_index = 0;
+  inference->use_classes = false;
+  inference->unplayable_letters = 0;
+  inference->number_of_classes = 0;
+  inference->next_class_index = 0;
+}
+
+// Sets up the rack classes used to refute candidate racks with unplayable
+// letters.
+static void set_inference_unplayable_letters(Inference *inference,
+                                             uint64_t unplayable_letters) {
+  inference->unplayable_letters = unplayable_letters;
+  // Classes only help if a candidate rack can hold an unplayable letter.
+  for (int ml = 0; ml < inference->ld_size; ml++) {
+    if ((inference->unplayable_letters & ((uint64_t)1 << ml)) &&
+        (rack_get_letter(inference->bag_as_rack, ml) > 0 ||
+         rack_get_letter(inference->current_target_rack, ml) > 0)) {
+      inference->use_classes = true;
+      break;
+    }
+  }
+}
+
+Inference *inference_create(const Game *game, const InferenceArgs *args) {
   Inference *inference = malloc_or_die(sizeof(Inference));
   inference->game = game_duplicate(game);
-  inference->move_list = move_list_create(1);
+  inference->batch_count = 0;
+  for (int i = 0; i < INFERENCE_MOVEGEN_BATCH_SIZE; i++) {
+    inference->batch_move_lists[i] = move_list_create(1);
+  }
+  inference->class_move_list =
+      move_list_create(INFERENCE_CLASS_MOVE_LIST_CAPACITY);
   inference->klv =
       player_get_klv(game_get_player(inference->game, args->target_index));
 
@@ -354,8 +710,9 @@ Inference *inference_create(const Game *game, const InferenceArgs *args,
       player_get_rack(game_get_player(inference->game, args->target_index));
   inference->bag_as_rack = rack_create(inference->ld_size);
 
-  inference->results =
-      inference_results_create(inference_results_get_alias_method(results));
+  // Each worker records its racks into its own alias method, which
+  // add_inference_results merges into the shared one after the worker joins.
+  inference->results = inference_results_create(NULL);
   inference_results_reset(inference->results, inference->leave_list_capacity,
                           inference->ld_size);
 
@@ -364,6 +721,7 @@ Inference *inference_create(const Game *game, const InferenceArgs *args,
   inference->print_interval = args->print_interval;
   inference->thread_control = args->thread_control;
   complete_inference_setup(inference, args);
+  reset_inference_refutations(inference);
 
   return inference;
 }
@@ -386,6 +744,7 @@ void inference_reset(Inference *inference, const Game *game,
   inference->use_infer_cutoff_optimization =
       args->use_inference_cutoff_optimization && !is_small_exchange;
   inference->current_rack_index = 0;
+  inference->batch_count = 0;
 
   rack_reset(inference->current_target_leave);
   rack_reset(inference->current_target_exchanged);
@@ -397,12 +756,16 @@ void inference_reset(Inference *inference, const Game *game,
                           inference->ld_size);
 
   complete_inference_setup(inference, args);
+  reset_inference_refutations(inference);
 }
 
 void add_inference_results(InferenceResults *inference_results_to_add,
                            InferenceResults *inference_results_to_update) {
   inference_results_add_subtotals(inference_results_to_add,
                                   inference_results_to_update);
+  alias_method_merge(
+      inference_results_get_alias_method(inference_results_to_update),
+      inference_results_get_alias_method(inference_results_to_add));
   LeaveRackList *lrl_to_add =
       inference_results_get_leave_rack_list(inference_results_to_add);
   if (!lrl_to_add) {
@@ -468,6 +831,7 @@ void *infer_worker(void *uncasted_inference) {
       inference,
       (RACK_SIZE)-rack_get_total_letters(inference->current_target_rack),
       BLANK_MACHINE_LETTER);
+  flush_possible_leaves(inference);
   return NULL;
 }
 
@@ -480,15 +844,15 @@ void set_shared_variables_for_inference(
 
 void infer_manager(InferenceCtx *ctx, InferenceResults *results) {
   for (int thread_index = 0; thread_index < ctx->num_workers; thread_index++) {
-    cpthread_create(&ctx->worker_inferences[thread_index]->cpthread_id,
-                    infer_worker, ctx->worker_inferences[thread_index]);
+    ctx->worker_inferences[thread_index]->pool_thread = thread_pool_start(
+        infer_worker, ctx->worker_inferences[thread_index]);
   }
 
   const bool tiles_were_exchanged =
       ctx->worker_inferences[0]->target_number_of_tiles_exchanged > 0;
 
   for (int thread_index = 0; thread_index < ctx->num_workers; thread_index++) {
-    cpthread_join(ctx->worker_inferences[thread_index]->cpthread_id);
+    thread_pool_join(ctx->worker_inferences[thread_index]->pool_thread);
     InferenceResults *worker_results =
         ctx->worker_inferences[thread_index]->results;
     add_inference_results(worker_results, results);
@@ -740,7 +1104,7 @@ void inference_ctx_set_inferences(InferenceCtx *ctx, const InferenceArgs *args,
   } else {
     cpthread_mutex_init(&ctx->shared_rack_index_lock);
     for (int i = 0; i < ctx->num_workers; i++) {
-      ctx->worker_inferences[i] = inference_create(ctx->game, args, results);
+      ctx->worker_inferences[i] = inference_create(ctx->game, args);
       set_shared_variables_for_inference(ctx->worker_inferences[i],
                                          &ctx->shared_rack_index,
                                          &ctx->shared_rack_index_lock);
@@ -749,6 +1113,16 @@ void inference_ctx_set_inferences(InferenceCtx *ctx, const InferenceArgs *args,
     ctx->exchanged_stats = malloc_or_die((sizeof(Stat *)) * (ctx->num_workers));
     ctx->rack_stats = malloc_or_die((sizeof(Stat *)) * (ctx->num_workers));
   }
+  // The unplayable letters only depend on the board, which every worker
+  // shares, so the move generation that finds them runs once.
+  if (ctx->worker_inferences[0]->use_witnesses) {
+    const uint64_t unplayable_letters =
+        get_unplayable_letters(ctx->worker_inferences[0]);
+    for (int i = 0; i < ctx->num_workers; i++) {
+      set_inference_unplayable_letters(ctx->worker_inferences[i],
+                                       unplayable_letters);
+    }
+  }
 }
 
 void inference_ctx_destroy(InferenceCtx *ctx) {
@@ -0,0 +1,615 @@
+#include "job_server.h"
+
+#include "../compat/cpthread.h"
+#include "../def/cpthread_defs.h"
+#include "../def/thread_control_defs.h"
+#include "../ent/thread_control.h"
+#include "../util/io_util.h"
+#include "../util/string_util.h"
+#include "config.h"
+#include <ctype.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#define JOB_SERVER_SUBMIT_STRING "submit"
+#define JOB_SERVER_CANCEL_STRING "cancel"
+#define JOB_SERVER_STATUS_STRING "status"
+#define JOB_SERVER_QUIT_STRING "quit"
+#define JOB_SERVER_TAG "*"
+#define JOB_SERVER_COMMAND_SEPARATOR '|'
+
+enum {
+  // The scheduler wakes up at least this often to check deadlines.
+  JOB_SERVER_MAX_WAIT_MS = 100,
+  NANOSECONDS_PER_MILLISECOND = 1000000,
+  NANOSECONDS_PER_SECOND = 1000000000,
+};
+
+typedef enum {
+  JOB_STATE_QUEUED,
+  JOB_STATE_RUNNING,
+  JOB_STATE_FINISHED,
+} job_state_t;
+
+typedef struct JobServer JobServer;
+
+typedef struct Job {
+  JobServer *server;
+  char *tag;
+  int priority;
+  uint64_t submit_order;
+  // CLOCK_MONOTONIC nanoseconds, or 0 for no deadline
+  uint64_t deadline_ns;
+  StringSplitter *commands;
+  job_state_t state;
+  int num_threads;
+  // Set once the job is asked to stop early, reported as its done status
+  const char *stop_reason;
+  // The config of the job while it is running, guarded by the server mutex
+  Config *config;
+  cpthread_t thread_id;
+  struct Job *next;
+} Job;
+
+struct JobServer {
+  const JobServerArgs *args;
+  FILE *output;
+  cpthread_mutex_t mutex;
+  cpthread_cond_t cond;
+  cpthread_mutex_t output_mutex;
+  Job *jobs;
+  int threads_in_use;
+  uint64_t next_submit_order;
+  bool input_finished;
+};
+
+static uint64_t job_server_get_time_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * NANOSECONDS_PER_SECOND + (uint64_t)ts.tv_nsec;
+}
+
+// Writes one response line per line of content, each starting with the tag
+// and the response type, so that the lines of one response are never
+// interleaved with the lines of another.
+static void job_server_write(JobServer *server, const char *tag,
+                             const char *response_type, const char *content) {
+  StringBuilder *sb = string_builder_create();
+  const char *line = content;
+  do {
+    const char *line_end = strchr(line, '\n');
+    const int line_length =
+        line_end ? (int)(line_end - line) : (int)string_length(line);
+    if (line_length > 0 || line == content) {
+      string_builder_add_formatted_string(sb, "%s %s", tag, response_type);
+      if (line_length > 0) {
+        string_builder_add_formatted_string(sb, " %.*s", line_length, line);
+      }
+      string_builder_add_char(sb, '\n');
+    }
+    line = line_end ? line_end + 1 : NULL;
+  } while (line && *line != '\0');
+  cpthread_mutex_lock(&server->output_mutex);
+  fputs(string_builder_peek(sb), server->output);
+  fflush(server->output);
+  cpthread_mutex_unlock(&server->output_mutex);
+  string_builder_destroy(sb);
+}
+
+static void job_server_write_formatted(JobServer *server, const char *tag,
+                                       const char *response_type,
+                                       const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  char *content = format_string_with_va_list(format, &args);
+  va_end(args);
+  job_server_write(server, tag, response_type, content);
+  free(content);
+}
+
+static void job_destroy(Job *job) {
+  free(job->tag);
+  string_splitter_destroy(job->commands);
+  free(job);
+}
+
+// Asks a queued or running job to stop. Must hold the server mutex.
+static void job_request_stop(Job *job, const char *stop_reason) {
+  if (job->stop_reason) {
+    return;
+  }
+  job->stop_reason = stop_reason;
+  if (job->config) {
+    thread_control_set_status(config_get_thread_control(job->config),
+                              THREAD_CONTROL_STATUS_USER_INTERRUPT);
+  }
+}
+
+// Loads the command into the job config and marks it started, unless the
+// job was asked to stop. Returns false if the command should not run.
+static bool job_load_command(Job *job, const char *command,
+                             ErrorStack *error_stack) {
+  JobServer *server = job->server;
+  Config *config = job->config;
+  cpthread_mutex_lock(&server->mutex);
+  const bool stop_requested = job->stop_reason != NULL;
+  if (!stop_requested) {
+    thread_control_set_status(config_get_thread_control(config),
+                              THREAD_CONTROL_STATUS_STARTED);
+  }
+  cpthread_mutex_unlock(&server->mutex);
+  if (stop_requested) {
+    return false;
+  }
+  config_load_command(config, command, error_stack);
+  // The job may not use more threads than the scheduler gave it.
+  if (config_get_num_threads(config) != job->num_threads) {
+    config_set_num_threads(config, job->num_threads);
+  }
+  return error_stack_is_empty(error_stack);
+}
+
+static void *job_worker(void *uncasted_job) {
+  Job *job = (Job *)uncasted_job;
+  JobServer *server = job->server;
+  const JobServerArgs *args = server->args;
+  ErrorStack *error_stack = error_stack_create();
+  const ConfigArgs config_args = {
+      .data_paths = args->data_paths,
+      .use_wmp = args->use_wmp,
+      .share_loaded_data = true,
+  };
+  Config *config = config_create(&config_args, error_stack);
+  const char *done_status = "finished";
+  if (config) {
+    config_set_human_readable(config, false);
+    cpthread_mutex_lock(&server->mutex);
+    job->config = config;
+    cpthread_mutex_unlock(&server->mutex);
+    const int number_of_commands =
+        string_splitter_get_number_of_items(job->commands);
+    for (int i = -1; i < number_of_commands; i++) {
+      const char *command = i < 0 ? args->settings
+                                  : string_splitter_get_item(job->commands, i);
+      if (!command || is_string_empty_or_whitespace(command)) {
+        continue;
+      }
+      char *output = NULL;
+      if (job_load_command(job, command, error_stack)) {
+        config_run_str_api_command(config, error_stack, &output);
+      }
+      if (output && *output != '\0') {
+        job_server_write(server, job->tag, "output", output);
+      }
+      free(output);
+      if (!error_stack_is_empty(error_stack)) {
+        break;
+      }
+    }
+  }
+  if (!error_stack_is_empty(error_stack)) {
+    char *error_message = error_stack_get_string_and_reset(error_stack);
+    job_server_write(server, job->tag, "error", error_message);
+    free(error_message);
+    done_status = "error";
+  }
+  cpthread_mutex_lock(&server->mutex);
+  if (job->stop_reason && strings_equal(done_status, "finished")) {
+    done_status = job->stop_reason;
+  }
+  job->config = NULL;
+  cpthread_mutex_unlock(&server->mutex);
+  config_destroy(config);
+  error_stack_destroy(error_stack);
+  job_server_write(server, job->tag, "done", done_status);
+
+  cpthread_mutex_lock(&server->mutex);
+  job->state = JOB_STATE_FINISHED;
+  server->threads_in_use -= job->num_threads;
+  cpthread_cond_signal(&server->cond);
+  cpthread_mutex_unlock(&server->mutex);
+  return NULL;
+}
+
+static bool job_deadline_is_earlier(uint64_t deadline_ns,
+                                    uint64_t other_deadline_ns) {
+  if (deadline_ns == 0) {
+    return false;
+  }
+  return other_deadline_ns == 0 || deadline_ns < other_deadline_ns;
+}
+
+// Returns the queued job to start next: the highest priority first, then
+// the earliest deadline, then the earliest submitted.
+static Job *job_server_get_next_queued_job(const JobServer *server) {
+  Job *next_job = NULL;
+  for (Job *job = server->jobs; job; job = job->next) {
+    if (job->state != JOB_STATE_QUEUED) {
+      continue;
+    }
+    if (!next_job || job->priority > next_job->priority ||
+        (job->priority == next_job->priority &&
+         (job_deadline_is_earlier(job->deadline_ns, next_job->deadline_ns) ||
+          (job->deadline_ns == next_job->deadline_ns &&
+           job->submit_order < next_job->submit_order)))) {
+      next_job = job;
+    }
+  }
+  return next_job;
+}
+
+// Gives the job its priority weighted share of the whole budget among all
+// queued and running jobs, limited to the threads that are still free.
+static int job_server_get_job_threads(const JobServer *server,
+                                      const Job *job) {
+  int64_t total_weight = 0;
+  for (const Job *other = server->jobs; other; other = other->next) {
+    if (other->state != JOB_STATE_FINISHED) {
+      total_weight += other->priority + 1;
+    }
+  }
+  const int thread_budget = server->args->thread_budget;
+  int64_t num_threads =
+      ((int64_t)thread_budget * (job->priority + 1) + total_weight - 1) /
+      total_weight;
+  const int free_threads = thread_budget - server->threads_in_use;
+  if (num_threads > free_threads) {
+    num_threads = free_threads;
+  }
+  if (num_threads < 1) {
+    num_threads = 1;
+  }
+  return (int)num_threads;
+}
+
+// Must hold the server mutex.
+static void job_server_start_jobs(JobServer *server) {
+  while (server->threads_in_use < server->args->thread_budget) {
+    Job *job = job_server_get_next_queued_job(server);
+    if (!job) {
+      break;
+    }
+    job->num_threads = job_server_get_job_threads(server, job);
+    job->state = JOB_STATE_RUNNING;
+    server->threads_in_use += job->num_threads;
+    job_server_write_formatted(server, job->tag, "started", "%d",
+                               job->num_threads);
+    cpthread_create(&job->thread_id, job_worker, job);
+  }
+}
+
+// Stops running jobs that are past their deadline and drops queued jobs
+// that are past their deadline or were cancelled. Returns the earliest
+// deadline still ahead, or 0 if there is none. Must hold the server mutex.
+static uint64_t job_server_check_deadlines(JobServer *server) {
+  const uint64_t now_ns = job_server_get_time_ns();
+  uint64_t next_deadline_ns = 0;
+  for (Job *job = server->jobs; job; job = job->next) {
+    if (job->state == JOB_STATE_QUEUED && job->stop_reason) {
+      job->state = JOB_STATE_FINISHED;
+      job_server_write(server, job->tag, "done", job->stop_reason);
+      continue;
+    }
+    if (job->state == JOB_STATE_FINISHED || job->deadline_ns == 0) {
+      continue;
+    }
+    if (job->deadline_ns <= now_ns) {
+      if (job->state == JOB_STATE_QUEUED) {
+        job->state = JOB_STATE_FINISHED;
+        job_server_write(server, job->tag, "done", "expired");
+      } else {
+        job_request_stop(job, "interrupted");
+      }
+    } else if (job_deadline_is_earlier(job->deadline_ns, next_deadline_ns)) {
+      next_deadline_ns = job->deadline_ns;
+    }
+  }
+  return next_deadline_ns;
+}
+
+// Joins and removes finished jobs. Must hold the server mutex. A worker
+// does not touch the server after marking its job finished, so joining it
+// here cannot deadlock.
+static void job_server_remove_finished_jobs(JobServer *server) {
+  Job **job_ptr = &server->jobs;
+  while (*job_ptr) {
+    Job *job = *job_ptr;
+    if (job->state != JOB_STATE_FINISHED) {
+      job_ptr = &job->next;
+      continue;
+    }
+    if (job->num_threads > 0) {
+      cpthread_join(job->thread_id);
+    }
+    *job_ptr = job->next;
+    job_destroy(job);
+  }
+}
+
+static void job_server_wait(JobServer *server, uint64_t next_deadline_ns) {
+  uint64_t wait_ns = (uint64_t)JOB_SERVER_MAX_WAIT_MS *
+                     NANOSECONDS_PER_MILLISECOND;
+  if (next_deadline_ns != 0) {
+    const uint64_t now_ns = job_server_get_time_ns();
+    if (next_deadline_ns <= now_ns) {
+      return;
+    }
+    if (next_deadline_ns - now_ns < wait_ns) {
+      wait_ns = next_deadline_ns - now_ns;
+    }
+  }
+  struct timespec abstime;
+  clock_gettime(CLOCK_REALTIME, &abstime);
+  const uint64_t abstime_nsec = (uint64_t)abstime.tv_nsec + wait_ns;
+  abstime.tv_sec += (time_t)(abstime_nsec / NANOSECONDS_PER_SECOND);
+  abstime.tv_nsec = (long)(abstime_nsec % NANOSECONDS_PER_SECOND);
+  cpthread_cond_timedwait_or_timeout(&server->cond, &server->mutex, &abstime);
+}
+
+static void *job_server_scheduler(void *uncasted_server) {
+  JobServer *server = (JobServer *)uncasted_server;
+  cpthread_mutex_lock(&server->mutex);
+  while (true) {
+    const uint64_t next_deadline_ns = job_server_check_deadlines(server);
+    job_server_remove_finished_jobs(server);
+    job_server_start_jobs(server);
+    if (server->input_finished && !server->jobs) {
+      break;
+    }
+    job_server_wait(server, next_deadline_ns);
+  }
+  cpthread_mutex_unlock(&server->mutex);
+  return NULL;
+}
+
+// Returns the next whitespace separated word of the line and advances the
+// line past it, or returns NULL if there are no words left. The word is
+// terminated in place.
+static char *job_server_next_word(char **line) {
+  char *word = *line;
+  while (isspace((unsigned char)*word)) {
+    word++;
+  }
+  if (*word == '\0') {
+    *line = word;
+    return NULL;
+  }
+  char *word_end = word;
+  while (*word_end != '\0' && !isspace((unsigned char)*word_end)) {
+    word_end++;
+  }
+  *line = word_end;
+  if (*word_end != '\0') {
+    *word_end = '\0';
+    (*line)++;
+  }
+  return word;
+}
+
+// Must hold the server mutex.
+static Job *job_server_find_job(const JobServer *server, const char *tag) {
+  for (Job *job = server->jobs; job; job = job->next) {
+    if (job->state != JOB_STATE_FINISHED && strings_equal(job->tag, tag)) {
+      return job;
+    }
+  }
+  return NULL;
+}
+
+static int job_server_parse_nonnegative_int(const char *word,
+                                            ErrorStack *error_stack) {
+  if (!word || !is_all_digits_or_empty(word) || *word == '\0') {
+    error_stack_push(error_stack, ERROR_STATUS_JOB_SERVER_MALFORMED_REQUEST,
+                     get_formatted_string("expected a nonnegative integer "
+                                          "but got '%s'",
+                                          word ? word : ""));
+    return 0;
+  }
+  return string_to_int(word, error_stack);
+}
+
+static void job_server_submit(JobServer *server, char *request,
+                              ErrorStack *error_stack) {
+  const char *tag = job_server_next_word(&request);
+  if (!tag || strings_equal(tag, JOB_SERVER_TAG)) {
+    error_stack_push(error_stack, ERROR_STATUS_JOB_SERVER_MALFORMED_REQUEST,
+                     string_duplicate("submit requires a job tag"));
+    return;
+  }
+  const int priority = job_server_parse_nonnegative_int(
+      job_server_next_word(&request), error_stack);
+  if (!error_stack_is_empty(error_stack)) {
+    return;
+  }
+  const int deadline_ms = job_server_parse_nonnegative_int(
+      job_server_next_word(&request), error_stack);
+  if (!error_stack_is_empty(error_stack)) {
+    return;
+  }
+  if (is_string_empty_or_whitespace(request)) {
+    error_stack_push(
+        error_stack, ERROR_STATUS_JOB_SERVER_MALFORMED_REQUEST,
+        get_formatted_string("job '%s' does not have any commands", tag));
+    return;
+  }
+  cpthread_mutex_lock(&server->mutex);
+  if (job_server_find_job(server, tag)) {
+    cpthread_mutex_unlock(&server->mutex);
+    error_stack_push(
+        error_stack, ERROR_STATUS_JOB_SERVER_MALFORMED_REQUEST,
+        get_formatted_string("job '%s' is already queued or running", tag));
+    return;
+  }
+  Job *job = calloc_or_die(1, sizeof(Job));
+  job->server = server;
+  job->tag = string_duplicate(tag);
+  job->priority = priority;
+  job->submit_order = server->next_submit_order++;
+  if (deadline_ms > 0) {
+    job->deadline_ns = job_server_get_time_ns() +
+                       (uint64_t)deadline_ms * NANOSECONDS_PER_MILLISECOND;
+  }
+  job->commands = split_string(request, JOB_SERVER_COMMAND_SEPARATOR, true);
+  job->state = JOB_STATE_QUEUED;
+  job->next = server->jobs;
+  server->jobs = job;
+  job_server_write(server, job->tag, "queued", "");
+  cpthread_cond_signal(&server->cond);
+  cpthread_mutex_unlock(&server->mutex);
+}
+
+static void job_server_cancel(JobServer *server, char *request,
+                              ErrorStack *error_stack) {
+  const char *tag = job_server_next_word(&request);
+  cpthread_mutex_lock(&server->mutex);
+  Job *job = tag ? job_server_find_job(server, tag) : NULL;
+  if (job) {
+    job_request_stop(job, "cancelled");
+    cpthread_cond_signal(&server->cond);
+  }
+  cpthread_mutex_unlock(&server->mutex);
+  if (!job) {
+    error_stack_push(
+        error_stack, ERROR_STATUS_JOB_SERVER_MALFORMED_REQUEST,
+        get_formatted_string("no queued or running job '%s'", tag ? tag : ""));
+  }
+}
+
+static void job_server_status(JobServer *server) {
+  cpthread_mutex_lock(&server->mutex);
+  for (const Job *job = server->jobs; job; job = job->next) {
+    if (job->state == JOB_STATE_QUEUED) {
+      job_server_write(server, job->tag, "status", "queued 0");
+    } else if (job->state == JOB_STATE_RUNNING) {
+      job_server_write_formatted(server, job->tag, "status", "running %d",
+                                 job->num_threads);
+    }
+  }
+  cpthread_mutex_unlock(&server->mutex);
+}
+
+// Handles one request line. Returns false if the request is quit.
+static bool job_server_handle_request(JobServer *server, char *request) {
+  const char *request_type = job_server_next_word(&request);
+  if (!request_type) {
+    return true;
+  }
+  if (strings_iequal(request_type, JOB_SERVER_QUIT_STRING)) {
+    return false;
+  }
+  ErrorStack *error_stack = error_stack_create();
+  if (strings_iequal(request_type, JOB_SERVER_SUBMIT_STRING)) {
+    job_server_submit(server, request, error_stack);
+  } else if (strings_iequal(request_type, JOB_SERVER_CANCEL_STRING)) {
+    job_server_cancel(server, request, error_stack);
+  } else if (strings_iequal(request_type, JOB_SERVER_STATUS_STRING)) {
+    job_server_status(server);
+  } else {
+    error_stack_push(
+        error_stack, ERROR_STATUS_JOB_SERVER_MALFORMED_REQUEST,
+        get_formatted_string("unrecognized request '%s'", request_type));
+  }
+  if (!error_stack_is_empty(error_stack)) {
+    char *error_message = error_stack_get_string_and_reset(error_stack);
+    job_server_write(server, JOB_SERVER_TAG, "error", error_message);
+    free(error_message);
+  }
+  error_stack_destroy(error_stack);
+  return true;
+}
+
+// Returns true if the input ended with a quit request.
+static bool job_server_serve(const JobServerArgs *args, FILE *input,
+                             FILE *output) {
+  JobServer server = {
+      .args = args,
+      .output = output,
+  };
+  cpthread_mutex_init(&server.mutex);
+  cpthread_cond_init(&server.cond);
+  cpthread_mutex_init(&server.output_mutex);
+  cpthread_t scheduler_thread;
+  cpthread_create(&scheduler_thread, job_server_scheduler, &server);
+
+  bool quit = false;
+  char *line = NULL;
+  size_t line_capacity = 0;
+  while (!quit &&
+         getline_ignore_carriage_return(&line, &line_capacity, input) != -1) {
+    quit = !job_server_handle_request(&server, line);
+  }
+  free(line);
+
+  cpthread_mutex_lock(&server.mutex);
+  server.input_finished = true;
+  cpthread_cond_signal(&server.cond);
+  cpthread_mutex_unlock(&server.mutex);
+  cpthread_join(scheduler_thread);
+  return quit;
+}
+
+void job_server_run(const JobServerArgs *args, FILE *input, FILE *output) {
+  job_server_serve(args, input, output);
+}
+
+void job_server_run_on_socket(const JobServerArgs *args,
+                              const char *socket_path,
+                              ErrorStack *error_stack) {
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (string_length(socket_path) >= sizeof(address.sun_path)) {
+    error_stack_push(
+        error_stack, ERROR_STATUS_JOB_SERVER_SOCKET_ERROR,
+        get_formatted_string("socket path is too long: %s", socket_path));
+    return;
+  }
+  strncpy(address.sun_path, socket_path, sizeof(address.sun_path) - 1);
+  const int server_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (server_fd < 0) {
+    error_stack_push(error_stack, ERROR_STATUS_JOB_SERVER_SOCKET_ERROR,
+                     string_duplicate("failed to create socket"));
+    return;
+  }
+  (void)unlink(socket_path);
+  if (bind(server_fd, (struct sockaddr *)&address, sizeof(address)) != 0 ||
+      listen(server_fd, 1) != 0) {
+    close(server_fd);
+    error_stack_push(
+        error_stack, ERROR_STATUS_JOB_SERVER_SOCKET_ERROR,
+        get_formatted_string("failed to listen on socket: %s", socket_path));
+    return;
+  }
+  // A client that disconnects early must not kill the server on write.
+  signal(SIGPIPE, SIG_IGN);
+  bool quit = false;
+  while (!quit) {
+    const int client_fd = accept(server_fd, NULL, NULL);
+    if (client_fd < 0) {
+      error_stack_push(error_stack, ERROR_STATUS_JOB_SERVER_SOCKET_ERROR,
+                       string_duplicate("failed to accept connection"));
+      break;
+    }
+    const int client_output_fd = dup(client_fd);
+    FILE *client_input = fdopen(client_fd, "r");
+    FILE *client_output =
+        client_output_fd < 0 ? NULL : fdopen(client_output_fd, "w");
+    if (!client_input || !client_output) {
+      log_fatal("failed to open streams for socket connection");
+    }
+    quit = job_server_serve(args, client_input, client_output);
+    fclose(client_input);
+    fclose(client_output);
+  }
+  close(server_fd);
+  (void)unlink(socket_path);
+}
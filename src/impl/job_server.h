@@ -0,0 +1,60 @@
+#ifndef JOB_SERVER_H
+#define JOB_SERVER_H
+
+#include "../util/io_util.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+// The job server runs many independent, tagged jobs at once. Each job gets
+// its own Config and Game, and all jobs share one read-only copy of each
+// loaded lexicon. A leavegen job writes its leaves into its own copy. Every
+// job starts from the same settings and then runs its own commands, for
+// example a cgp and a simulate. Jobs wait in a queue and are started by
+// priority, then by deadline, while a global thread budget has threads
+// left. A job gets a share of the budget weighted by its priority. A job
+// still running at its deadline is stopped and reports the results it has
+// so far.
+//
+// Requests, one per line:
+//
+//   submit <tag> <priority> <deadline_ms> <command> [| <command> ...]
+//   cancel <tag>
+//   status
+//   quit
+//
+// The priority is a nonnegative integer where higher runs first. The
+// deadline is in milliseconds after submission, with 0 for no deadline.
+// Responses are lines that start with the tag of their job, or with '*'
+// for responses that do not belong to a job:
+//
+//   <tag> queued
+//   <tag> started <number_of_threads>
+//   <tag> output <line>
+//   <tag> error <message>
+//   <tag> done <finished|interrupted|cancelled|expired|error>
+//   <tag> status <queued|running> <number_of_threads>
+//   * error <message>
+//
+// All of a command's output lines are written together, and the done line
+// is always the last line for its job.
+
+typedef struct JobServerArgs {
+  const char *data_paths;
+  bool use_wmp;
+  // A 'set' command applied to every job before its own commands, or NULL
+  const char *settings;
+  int thread_budget;
+} JobServerArgs;
+
+// Serves requests read from input until quit or the end of input, writing
+// responses to output. Returns once every submitted job is done.
+void job_server_run(const JobServerArgs *args, FILE *input, FILE *output);
+
+// Serves requests from clients of a UNIX domain socket created at
+// socket_path, one connection at a time. The jobs of a connection finish
+// before the next connection is accepted. Returns once a client sends quit.
+void job_server_run_on_socket(const JobServerArgs *args,
+                              const char *socket_path,
+                              ErrorStack *error_stack);
+
+#endif
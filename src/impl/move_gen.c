@@ -1,6 +1,7 @@
 #include "move_gen.h"
 
 #include "../compat/cpthread.h"
+#include "../compat/isa_dispatch.h"
 #include "../def/board_defs.h"
 #include "../def/cpthread_defs.h"
 #include "../def/cross_set_defs.h"
@@ -13,6 +14,7 @@
 #include "../def/move_defs.h"
 #include "../def/players_data_defs.h"
 #include "../def/rack_defs.h"
+#include "../def/static_eval_defs.h"
 #include "../def/thread_control_defs.h"
 #include "../ent/anchor.h"
 #include "../ent/bag.h"
@@ -27,14 +29,18 @@
 #include "../ent/leave_map.h"
 #include "../ent/letter_distribution.h"
 #include "../ent/move.h"
+#include "../ent/opening_table.h"
+#include "../ent/perf_counters.h"
 #include "../ent/player.h"
 #include "../ent/rack.h"
 #include "../ent/rack_info_table.h"
 #include "../ent/static_eval.h"
 #include "../ent/wmp.h"
 #include "../util/io_util.h"
+#include "thread_pool.h"
 #include "wmp_move_gen.h"
 #include <assert.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -98,8 +104,17 @@ static void gen_release_slot(void *ptr) {
   cpthread_mutex_unlock(&cache_mutex);
 }
 
+// Thread pool park hook: a parked pool thread returns its slot too, so idle
+// pool threads never crowd out other threads. Its next routine acquires a
+// slot again on its first generate_moves.
+static void gen_release_thread_slot(void) {
+  gen_release_slot(cpthread_getspecific(gen_key));
+  cpthread_setspecific(gen_key, NULL);
+}
+
 static void gen_key_init(void) {
   cpthread_key_create(&gen_key, gen_release_slot);
+  thread_pool_add_park_hook(gen_release_thread_slot);
 }
 
 MoveGen *get_movegen(void) {
@@ -377,7 +392,12 @@ static inline void update_best_move_or_insert_into_movelist(
       if (tile == PLAYED_THROUGH_MARKER) {
         continue;
       }
-      uint8_t ml_val = get_is_blanked(tile) ? 0 : tile;
+      uint8_t ml_val = tile;
+      if (get_is_blanked(tile)) {
+        ml_val = gen->record_designated_letters
+                     ? get_unblanked_machine_letter(tile)
+                     : BLANK_MACHINE_LETTER;
+      }
       // NOLINTNEXTLINE(clang-analyzer-core.BitwiseShift)
       gen->tiles_played_bv |= ((uint64_t)1 << ml_val);
     }
@@ -540,9 +560,10 @@ static void record_best_exchange_from_table(MoveGen *gen) {
 // Look up leave values for all subsets of the player's rack and if add_exchange
 // is true, record exchange moves for them. KLV indices are retained to speed up
 // lookup of leaves with common lexicographical "prefixes".
-void generate_exchange_moves(MoveGen *gen, Rack *leave, uint32_t node_index,
-                             uint32_t word_index, MachineLetter ml,
-                             bool add_exchange) {
+ISA_DISPATCH void generate_exchange_moves(MoveGen *gen, Rack *leave,
+                                          uint32_t node_index,
+                                          uint32_t word_index, MachineLetter ml,
+                                          bool add_exchange) {
   const int ld_size = ld_get_size(&gen->ld);
   while (ml < ld_size && rack_get_letter(&gen->player_rack, ml) == 0) {
     ml++;
@@ -875,7 +896,7 @@ bool wordmap_gen_check_playthrough_and_crosses(MoveGen *gen, int word_idx,
   return true;
 }
 
-void wordmap_gen(MoveGen *gen, const Anchor *anchor) {
+ISA_DISPATCH void wordmap_gen(MoveGen *gen, const Anchor *anchor) {
   assert(gen != NULL);
   assert(anchor != NULL);
   gen->max_tiles_to_play = anchor->tiles_to_play;
@@ -964,14 +985,15 @@ void wordmap_gen(MoveGen *gen, const Anchor *anchor) {
   }
 }
 
-void go_on(MoveGen *gen, int current_col, MachineLetter L,
-           uint32_t new_node_index, bool accepts, int leftstrip, int rightstrip,
-           bool unique_play, int main_word_score, int word_multiplier,
-           Equity cross_score);
+ISA_DISPATCH void go_on(MoveGen *gen, int current_col, MachineLetter L,
+                        uint32_t new_node_index, bool accepts, int leftstrip,
+                        int rightstrip, bool unique_play, int main_word_score,
+                        int word_multiplier, Equity cross_score);
 
-void recursive_gen(MoveGen *gen, int col, uint32_t node_index, int leftstrip,
-                   int rightstrip, bool unique_play, int main_word_score,
-                   int word_multiplier, Equity cross_score) {
+ISA_DISPATCH void recursive_gen(MoveGen *gen, int col, uint32_t node_index,
+                                int leftstrip, int rightstrip, bool unique_play,
+                                int main_word_score, int word_multiplier,
+                                Equity cross_score) {
   if (gen->threshold_exceeded) {
     return;
   }
@@ -1061,10 +1083,11 @@ static inline bool play_is_nonempty_and_nonduplicate(int tiles_played,
   return (tiles_played > 1) || ((tiles_played == 1) && is_unique);
 }
 
-void go_on(MoveGen *gen, int current_col, MachineLetter L,
-           uint32_t new_node_index, bool accepts, int leftstrip, int rightstrip,
-           bool unique_play, Equity main_word_score, int word_multiplier,
-           Equity cross_score) {
+ISA_DISPATCH void go_on(MoveGen *gen, int current_col, MachineLetter L,
+                        uint32_t new_node_index, bool accepts, int leftstrip,
+                        int rightstrip, bool unique_play,
+                        Equity main_word_score, int word_multiplier,
+                        Equity cross_score) {
   if (gen->threshold_exceeded) {
     return;
   }
@@ -1354,13 +1377,15 @@ static inline void go_on_small(MoveGen *gen, int current_col, MachineLetter L,
   }
 }
 
-void go_on_alpha(MoveGen *gen, int current_col, MachineLetter L, int leftstrip,
-                 int rightstrip, bool unique_play, int main_word_score,
-                 int word_multiplier, Equity cross_score);
+ISA_DISPATCH void go_on_alpha(MoveGen *gen, int current_col, MachineLetter L,
+                              int leftstrip, int rightstrip, bool unique_play,
+                              int main_word_score, int word_multiplier,
+                              Equity cross_score);
 
-void recursive_gen_alpha(MoveGen *gen, int col, int leftstrip, int rightstrip,
-                         bool unique_play, Equity main_word_score,
-                         int word_multiplier, Equity cross_score) {
+ISA_DISPATCH void recursive_gen_alpha(MoveGen *gen, int col, int leftstrip,
+                                      int rightstrip, bool unique_play,
+                                      Equity main_word_score,
+                                      int word_multiplier, Equity cross_score) {
   const MachineLetter current_letter = gen_cache_get_letter(gen, col);
   uint64_t possible_letters_here = gen_cache_get_cross_set(gen, col);
   if (possible_letters_here == 1) {
@@ -1411,9 +1436,10 @@ void recursive_gen_alpha(MoveGen *gen, int col, int leftstrip, int rightstrip,
   }
 }
 
-void go_on_alpha(MoveGen *gen, int current_col, MachineLetter L, int leftstrip,
-                 int rightstrip, bool unique_play, Equity main_word_score,
-                 int word_multiplier, Equity cross_score) {
+ISA_DISPATCH void go_on_alpha(MoveGen *gen, int current_col, MachineLetter L,
+                              int leftstrip, int rightstrip, bool unique_play,
+                              Equity main_word_score, int word_multiplier,
+                              Equity cross_score) {
   // Handle incremental scoring
   const BonusSquare bonus_square = gen_cache_get_bonus_square(gen, current_col);
   int letter_multiplier = 1;
@@ -2560,7 +2586,7 @@ static inline void shadow_start_small(MoveGen *gen) {
 // shadow playing was originally developed in wolges.
 // For more details about the shadow playing algorithm, see
 // https://github.com/andy-k/wolges/blob/main/details.txt
-void shadow_play_for_anchor(MoveGen *gen, int col) {
+ISA_DISPATCH void shadow_play_for_anchor(MoveGen *gen, int col) {
   // Shadow playing is designed to find the best plays first. When we find plays
   // for endgame using MOVE_RECORD_ALL_SMALL, we need to find all of the plays,
   // and because they are ranked for search in the endgame code rather than
@@ -2632,7 +2658,7 @@ void shadow_play_for_anchor(MoveGen *gen, int col) {
 
 // Simplified shadow_play_for_anchor for small move types (BEST_SMALL).
 // Skips WMP operations.
-void shadow_play_for_anchor_small(MoveGen *gen, int col) {
+ISA_DISPATCH void shadow_play_for_anchor_small(MoveGen *gen, int col) {
   gen->current_left_col = col;
   gen->current_right_col = col;
 
@@ -2731,15 +2757,22 @@ static inline void set_descending_tile_scores(MoveGen *gen) {
          sizeof(gen->descending_tile_scores));
 }
 
-void gen_load_position(MoveGen *gen, const MoveGenArgs *args) {
+// Loads everything that depends on the position but not on the rack being
+// generated for. The on-turn player's rack is copied as well, so the WMP
+// state is seeded for it.
+static void gen_load_board(MoveGen *gen, const MoveGenArgs *args) {
   const Game *game = args->game;
   gen->move_record_type = args->move_record_type;
   gen->move_sort_type = args->move_sort_type;
-  MoveList *move_list = args->move_list;
+  gen->lane_move_cache = args->move_record_type == MOVE_RECORD_ALL_SMALL
+                             ? args->lane_move_cache
+                             : NULL;
   const KWG *override_kwg = args->override_kwg;
   gen->eq_margin_movegen = args->eq_margin_movegen;
-  gen->target_equity_cutoff = args->target_equity;
   gen->target_leave_size = args->target_leave_size_for_exchange_cutoff;
+  gen->anchor_stride = 1;
+  gen->anchor_offset = 0;
+  gen->shared_cutoff = NULL;
 
   gen->board = game_get_board(game);
   gen->player_index = game_get_player_on_turn_index(game);
@@ -2806,7 +2839,6 @@ void gen_load_position(MoveGen *gen, const MoveGenArgs *args) {
   gen->board_number_of_tiles_played = board_get_tiles_played(gen->board);
   rack_copy(&gen->opponent_rack, player_get_rack(opponent));
   rack_copy(&gen->player_rack, player_get_rack(player));
-  move_list_set_rack(move_list, &gen->player_rack);
   rack_set_dist_size(&gen->leave, ld_get_size(&gen->ld));
   const WMP *previous_wmp = gen->wmp_move_gen.wmp;
   // Decide up front whether WMP will be active. It is disabled for
@@ -2845,18 +2877,50 @@ void gen_load_position(MoveGen *gen, const MoveGenArgs *args) {
   gen->bingo_bonus = game_get_bingo_bonus(game);
   gen->number_of_tiles_in_bag = bag_get_letters(game_get_bag(game));
   gen->kwgs_are_shared = game_get_data_is_shared(game, PLAYERS_DATA_TYPE_KWG);
-  gen->move_list = move_list;
   gen->cross_index =
       board_get_cross_set_index(gen->kwgs_are_shared, gen->player_index);
 
+  if (gen->move_record_type == MOVE_RECORD_BEST_SMALL &&
+      gen->move_sort_type != MOVE_SORT_SCORE) {
+    log_fatal("MOVE_RECORD_BEST_SMALL only supports MOVE_SORT_SCORE");
+  }
+
+  // Cache ld's tile scores
+  memset(gen->tile_scores, 0, sizeof(gen->tile_scores));
+  for (int i = 0; i < ld_get_size(&gen->ld); i++) {
+    gen->tile_scores[i] = ld_get_score(&gen->ld, i);
+    gen->tile_scores[get_blanked_machine_letter(i)] =
+        ld_get_score(&gen->ld, BLANK_MACHINE_LETTER);
+  }
+
+  board_load_number_of_row_anchors_cache(gen->board,
+                                         gen->row_number_of_anchors_cache);
+  gen->lanes_cache = board_get_readonly_lanes(gen->board, gen->cross_index);
+
+  // opening_move_penalties is read only by gen_get_static_equity (the
+  // equity-recording paths). The endgame's small-record movegen types never
+  // read it, so skip the per-node 120-byte copy for them.
+  if (gen->move_record_type != MOVE_RECORD_ALL_SMALL &&
+      gen->move_record_type != MOVE_RECORD_TILES_PLAYED &&
+      gen->move_record_type != MOVE_RECORD_BEST_SMALL) {
+    board_copy_opening_penalties(gen->board, gen->opening_move_penalties);
+  }
+
+  gen->is_wordsmog = game_get_variant(game) == GAME_VARIANT_WORDSMOG;
+}
+
+// Loads the state derived from gen->player_rack and resets the move list
+// for a generation on the position loaded by gen_load_board.
+static void gen_load_rack(MoveGen *gen, MoveList *move_list,
+                          Equity target_equity) {
+  gen->move_list = move_list;
+  move_list_set_rack(move_list, &gen->player_rack);
+  gen->target_equity_cutoff = target_equity;
+
   // Reset the move list
   if (gen->move_record_type == MOVE_RECORD_ALL_SMALL ||
       gen->move_record_type == MOVE_RECORD_TILES_PLAYED ||
       gen->move_record_type == MOVE_RECORD_BEST_SMALL) {
-    if (gen->move_record_type == MOVE_RECORD_BEST_SMALL &&
-        gen->move_sort_type != MOVE_SORT_SCORE) {
-      log_fatal("MOVE_RECORD_BEST_SMALL only supports MOVE_SORT_SCORE");
-    }
     small_move_list_reset(gen->move_list);
   } else {
     move_list_reset(gen->move_list);
@@ -2868,39 +2932,26 @@ void gen_load_position(MoveGen *gen, const MoveGenArgs *args) {
   gen->best_move_equity_or_score = EQUITY_INITIAL_VALUE;
   gen->cutoff_equity_or_score = EQUITY_INITIAL_VALUE;
 
-  // Set rack cross set and cache ld's tile scores
+  // Set rack cross set
   gen->rack_cross_set = 0;
-  memset(gen->tile_scores, 0, sizeof(gen->tile_scores));
   for (int i = 0; i < ld_get_size(&gen->ld); i++) {
     if (rack_get_letter(&gen->player_rack, i) > 0) {
       gen->rack_cross_set = gen->rack_cross_set | ((uint64_t)1 << i);
     }
-    gen->tile_scores[i] = ld_get_score(&gen->ld, i);
-    gen->tile_scores[get_blanked_machine_letter(i)] =
-        ld_get_score(&gen->ld, BLANK_MACHINE_LETTER);
   }
 
   set_descending_tile_scores(gen);
 
-  board_load_number_of_row_anchors_cache(gen->board,
-                                         gen->row_number_of_anchors_cache);
-  gen->lanes_cache = board_get_readonly_lanes(gen->board, gen->cross_index);
-
-  // opening_move_penalties is read only by gen_get_static_equity (the
-  // equity-recording paths). The endgame's small-record movegen types never
-  // read it, so skip the per-node 120-byte copy for them.
-  if (gen->move_record_type != MOVE_RECORD_ALL_SMALL &&
-      gen->move_record_type != MOVE_RECORD_TILES_PLAYED &&
-      gen->move_record_type != MOVE_RECORD_BEST_SMALL) {
-    board_copy_opening_penalties(gen->board, gen->opening_move_penalties);
-  }
-
-  gen->is_wordsmog = game_get_variant(game) == GAME_VARIANT_WORDSMOG;
   gen->threshold_exceeded = false;
-  gen->stop_on_threshold = args->target_equity != EQUITY_MAX_VALUE;
+  gen->stop_on_threshold = target_equity != EQUITY_MAX_VALUE;
+}
+
+void gen_load_position(MoveGen *gen, const MoveGenArgs *args) {
+  gen_load_board(gen, args);
+  gen_load_rack(gen, args->move_list, args->target_equity);
 }
 
-void gen_look_up_leaves_and_record_exchanges(MoveGen *gen) {
+ISA_DISPATCH void gen_look_up_leaves_and_record_exchanges(MoveGen *gen) {
   leave_map_init(&gen->player_rack, &gen->leave_map);
   if (rack_get_total_letters(&gen->player_rack) < RACK_SIZE) {
     leave_map_set_current_value(
@@ -3092,6 +3143,14 @@ void gen_record_scoring_plays_small(MoveGen *gen) {
       gen->current_row_index = row;
       board_copy_row_cache(gen->lanes_cache, gen->row_cache, row, dir);
 
+      const int lane_first_move_index = gen->move_list->count;
+      if (gen->lane_move_cache != NULL &&
+          lane_move_cache_load(gen->lane_move_cache, gen->kwg,
+                               &gen->player_rack, gen->row_cache,
+                               BOARD_DIM * dir + row, gen->move_list)) {
+        continue;
+      }
+
       int last_anchor_col = INITIAL_LAST_ANCHOR_COL;
       for (int col = 0; col < BOARD_DIM; col++) {
         if (gen_cache_get_is_anchor(gen, col)) {
@@ -3109,10 +3168,27 @@ void gen_record_scoring_plays_small(MoveGen *gen) {
           }
         }
       }
+      if (gen->lane_move_cache != NULL) {
+        lane_move_cache_store(gen->lane_move_cache, gen->move_list,
+                              lane_first_move_index);
+      }
     }
   }
 }
 
+// Raises the cutoff shared by the threads generating the same position to
+// this generator's cutoff.
+static void gen_share_cutoff(MoveGen *gen) {
+  const Equity cutoff = gen_get_cutoff_equity_or_score(gen);
+  Equity shared_cutoff =
+      atomic_load_explicit(gen->shared_cutoff, memory_order_relaxed);
+  while (cutoff > shared_cutoff &&
+         !atomic_compare_exchange_weak_explicit(
+             gen->shared_cutoff, &shared_cutoff, cutoff, memory_order_relaxed,
+             memory_order_relaxed)) {
+  }
+}
+
 void gen_record_scoring_plays(MoveGen *gen) {
   if (gen->threshold_exceeded) {
     return;
@@ -3129,6 +3205,10 @@ void gen_record_scoring_plays(MoveGen *gen) {
   if (gen->is_wordsmog) {
     rack_reset(&gen->full_player_rack);
   }
+#ifdef MAGPIE_PERF_COUNTERS
+  const int initial_anchor_count = gen->anchor_heap.count;
+#endif
+  int anchor_index = 0;
   while (gen->anchor_heap.count > 0) {
     if (gen->threshold_exceeded) {
       break;
@@ -3137,6 +3217,16 @@ void gen_record_scoring_plays(MoveGen *gen) {
     if (better_play_has_been_found(gen, anchor.highest_possible_equity)) {
       break;
     }
+    // Anchors come out in descending order of their highest possible equity,
+    // so once one cannot reach another thread's best, none of the rest can.
+    if (gen->shared_cutoff &&
+        anchor.highest_possible_equity <
+            atomic_load_explicit(gen->shared_cutoff, memory_order_relaxed)) {
+      break;
+    }
+    if (anchor_index++ % gen->anchor_stride != gen->anchor_offset) {
+      continue;
+    }
     gen->current_anchor_col = anchor.col;
     // Don't recopy the row cache if we're working on the same board lane
     // as the previous anchor. When anchors have been sorted by descending
@@ -3160,7 +3250,9 @@ void gen_record_scoring_plays(MoveGen *gen) {
       recursive_gen_alpha(gen, anchor.col, anchor.col, anchor.col,
                           gen->dir == BOARD_HORIZONTAL_DIRECTION, 0, 1, 0);
     } else if (wmp_move_gen_is_active(&gen->wmp_move_gen)) {
+      PERF_TIMER_START(wmp_anchor_start);
       wordmap_gen(gen, &anchor);
+      PERF_TIMER_STOP(PERF_COUNTER_MOVEGEN_WMP_ANCHOR, wmp_anchor_start);
     } else {
       recursive_gen(gen, anchor.col, kwg_root_node_index, anchor.col,
                     anchor.col, gen->dir == BOARD_HORIZONTAL_DIRECTION, 0, 1,
@@ -3170,7 +3262,12 @@ void gen_record_scoring_plays(MoveGen *gen) {
     // If a better play has been found than should have been possible for
     // this anchor, highest_possible_equity was invalid.
     assert(!better_play_has_been_found(gen, anchor.highest_possible_equity));
+    if (gen->shared_cutoff) {
+      gen_share_cutoff(gen);
+    }
   }
+  PERF_COUNTER_ADD(PERF_COUNTER_MOVEGEN_ANCHORS,
+                   (uint64_t)(initial_anchor_count - gen->anchor_heap.count));
 }
 
 void gen_record_pass(MoveGen *gen) {
@@ -3209,19 +3306,107 @@ void gen_record_pass(MoveGen *gen) {
   }
 }
 
-void generate_moves(const MoveGenArgs *args) {
-  MoveGen *gen = get_movegen();
-  gen_load_position(gen, args);
+// Seeds the WMP nonplaythrough subracks for the rack, from the per thread
+// subrack cache when possible. Needs the leaves looked up first.
+static void gen_load_wmp_subracks(MoveGen *gen) {
+  if (!wmp_move_gen_is_active(&gen->wmp_move_gen)) {
+    return;
+  }
+  const bool check_leaves = (gen->number_of_tiles_in_bag > 0) &&
+                            (gen->move_sort_type != MOVE_SORT_SCORE);
+  // Per-thread subrack enumeration cache. The enumeration output is
+  // rack-determined, so we hit on repeat racks (common in sims).
+  // IMPORTANT: leave_values written by the enumeration read from
+  // leave_map.leave_values, which is only populated when
+  // gen_look_up_leaves_and_record_exchanges actually walked the leave
+  // space -- i.e. when rit_entry != NULL (RIT unpacked leaves) or when
+  // (check_leaves || add_exchange) (KLV walk ran generate_exchange_moves).
+  // Otherwise leave_map.leave_values retains stale values from a prior
+  // rack and enumerating reads garbage. We only use the cache when
+  // those values are known-fresh, on both write and read.
+  WMPMoveGen *wgen = &gen->wmp_move_gen;
+  // Mirror the condition in gen_look_up_leaves_and_record_exchanges:
+  // add_exchange=true iff there are enough unseen tiles for the
+  // exchange walk to make sense.
+  const bool add_exchange =
+      gen->number_of_tiles_in_bag +
+          rack_get_total_letters(&gen->opponent_rack) >=
+      (RACK_SIZE * 2);
+  const bool leaves_are_populated =
+      (gen->rit_entry != NULL) || check_leaves || add_exchange;
+  const uint32_t subrack_slot = bit_rack_get_bucket_index(
+      &wgen->player_bit_rack, MOVEGEN_SUBRACK_CACHE_SIZE);
+  SubrackEnumCacheEntry *subrack_entry = &gen->subrack_cache[subrack_slot];
+  const bool subrack_cache_hit =
+      leaves_are_populated && subrack_entry->valid &&
+      bit_rack_equals(&subrack_entry->key, &wgen->player_bit_rack);
+  if (subrack_cache_hit) {
+    // Restore enumerate_nonplaythrough_subracks output AND the
+    // per-subrack wmp_entry pointers from cache. Both pieces are
+    // rack-determined (subracks via combinatoric walk, wmp_entries
+    // via WMP hash), so on hit we skip both the enumeration and the
+    // per-subrack wmp_get_word_entry calls that the size walk would
+    // otherwise run.
+    memcpy(wgen->count_by_size, subrack_entry->count_by_size,
+           sizeof(wgen->count_by_size));
+    for (int i = 0; i < MOVEGEN_SUBRACK_CACHE_ENTRIES; i++) {
+      wgen->nonplaythrough_infos[i].subrack = subrack_entry->subracks[i];
+      wgen->nonplaythrough_infos[i].leave_value =
+          subrack_entry->leave_values[i];
+      wgen->nonplaythrough_infos[i].wmp_entry =
+          subrack_entry->wmp_entries[i];
+    }
+  }
+  if (gen->rit_entry != NULL) {
+    // RIT-backed fast path: skip the per-size wmp_get_word_entry loop
+    // for any played size where the RIT entry says no canonical
+    // k-subrack of this rack forms a k-letter word on its own. Seeds
+    // nonplaythrough_best_leave_values directly from the cached max
+    // the RIT already computed at build time.
+    wmp_move_gen_check_nonplaythrough_existence_with_rit(
+        wgen, check_leaves, &gen->leave_map, gen->rit_entry,
+        /*subracks_precomputed=*/subrack_cache_hit,
+        /*wmp_entries_precomputed=*/subrack_cache_hit);
+  } else {
+    wmp_move_gen_check_nonplaythrough_existence(
+        wgen, check_leaves, &gen->leave_map,
+        /*subracks_precomputed=*/subrack_cache_hit,
+        /*wmp_entries_precomputed=*/subrack_cache_hit);
+  }
+  if (!subrack_cache_hit && leaves_are_populated) {
+    // Store the newly-computed enumeration and wmp_entry pointers
+    // into the cache. Only cache when leaves_are_populated so we
+    // don't stash garbage leave_values from an uninitialized leave_map.
+    subrack_entry->key = wgen->player_bit_rack;
+    subrack_entry->valid = true;
+    memcpy(subrack_entry->count_by_size, wgen->count_by_size,
+           sizeof(wgen->count_by_size));
+    for (int i = 0; i < MOVEGEN_SUBRACK_CACHE_ENTRIES; i++) {
+      subrack_entry->subracks[i] = wgen->nonplaythrough_infos[i].subrack;
+      subrack_entry->leave_values[i] =
+          wgen->nonplaythrough_infos[i].leave_value;
+      subrack_entry->wmp_entries[i] =
+          wgen->nonplaythrough_infos[i].wmp_entry;
+    }
+  }
+}
+
+// Generates the moves for the position and rack already loaded into gen.
+static void gen_generate_loaded(MoveGen *gen, const MoveGenArgs *args) {
   if (gen->move_record_type == MOVE_RECORD_ALL_SMALL ||
       gen->move_record_type == MOVE_RECORD_TILES_PLAYED) {
     if (gen->move_record_type == MOVE_RECORD_TILES_PLAYED) {
       gen->tiles_played_bv = args->initial_tiles_bv;
       gen->stop_on_threshold = true;
-      // Build target bitvector from the rack
+      gen->record_designated_letters = args->record_designated_letters;
+      // Build target bitvector from the rack, or from every letter when
+      // recording designated letters
       gen->target_tiles_bv = 0;
       const uint16_t dist_size = rack_get_dist_size(&gen->player_rack);
       for (uint16_t ml = 0; ml < dist_size; ml++) {
-        if (rack_get_letter(&gen->player_rack, ml) > 0) {
+        if (gen->record_designated_letters
+                ? ml != BLANK_MACHINE_LETTER
+                : rack_get_letter(&gen->player_rack, ml) > 0) {
           gen->target_tiles_bv |= ((uint64_t)1 << ml);
         }
       }
@@ -3241,102 +3426,295 @@ void generate_moves(const MoveGenArgs *args) {
   } else if (gen->move_record_type == MOVE_RECORD_BEST_SMALL) {
     // BEST_SMALL uses small shadow and small recursive_gen paths that skip
     // leave_map, WMP, and wordsmog operations entirely.
+    PERF_TIMER_START(shadow_small_start);
     gen_shadow_small(gen);
+    PERF_TIMER_STOP(PERF_COUNTER_MOVEGEN_SHADOW, shadow_small_start);
+    PERF_TIMER_START(record_small_start);
     gen_record_scoring_plays(gen);
+    PERF_TIMER_STOP(PERF_COUNTER_MOVEGEN_RECORD, record_small_start);
   } else {
     gen_look_up_leaves_and_record_exchanges(gen);
 
-    if (wmp_move_gen_is_active(&gen->wmp_move_gen)) {
-      const bool check_leaves = (gen->number_of_tiles_in_bag > 0) &&
-                                (gen->move_sort_type != MOVE_SORT_SCORE);
-      // Per-thread subrack enumeration cache. The enumeration output is
-      // rack-determined, so we hit on repeat racks (common in sims).
-      // IMPORTANT: leave_values written by the enumeration read from
-      // leave_map.leave_values, which is only populated when
-      // gen_look_up_leaves_and_record_exchanges actually walked the leave
-      // space -- i.e. when rit_entry != NULL (RIT unpacked leaves) or when
-      // (check_leaves || add_exchange) (KLV walk ran generate_exchange_moves).
-      // Otherwise leave_map.leave_values retains stale values from a prior
-      // rack and enumerating reads garbage. We only use the cache when
-      // those values are known-fresh, on both write and read.
-      WMPMoveGen *wgen = &gen->wmp_move_gen;
-      // Mirror the condition in gen_look_up_leaves_and_record_exchanges:
-      // add_exchange=true iff there are enough unseen tiles for the
-      // exchange walk to make sense.
-      const bool add_exchange =
-          gen->number_of_tiles_in_bag +
-              rack_get_total_letters(&gen->opponent_rack) >=
-          (RACK_SIZE * 2);
-      const bool leaves_are_populated =
-          (gen->rit_entry != NULL) || check_leaves || add_exchange;
-      const uint32_t subrack_slot = bit_rack_get_bucket_index(
-          &wgen->player_bit_rack, MOVEGEN_SUBRACK_CACHE_SIZE);
-      SubrackEnumCacheEntry *subrack_entry = &gen->subrack_cache[subrack_slot];
-      const bool subrack_cache_hit =
-          leaves_are_populated && subrack_entry->valid &&
-          bit_rack_equals(&subrack_entry->key, &wgen->player_bit_rack);
-      if (subrack_cache_hit) {
-        // Restore enumerate_nonplaythrough_subracks output AND the
-        // per-subrack wmp_entry pointers from cache. Both pieces are
-        // rack-determined (subracks via combinatoric walk, wmp_entries
-        // via WMP hash), so on hit we skip both the enumeration and the
-        // per-subrack wmp_get_word_entry calls that the size walk would
-        // otherwise run.
-        memcpy(wgen->count_by_size, subrack_entry->count_by_size,
-               sizeof(wgen->count_by_size));
-        for (int i = 0; i < MOVEGEN_SUBRACK_CACHE_ENTRIES; i++) {
-          wgen->nonplaythrough_infos[i].subrack = subrack_entry->subracks[i];
-          wgen->nonplaythrough_infos[i].leave_value =
-              subrack_entry->leave_values[i];
-          wgen->nonplaythrough_infos[i].wmp_entry =
-              subrack_entry->wmp_entries[i];
-        }
-      }
-      if (gen->rit_entry != NULL) {
-        // RIT-backed fast path: skip the per-size wmp_get_word_entry loop
-        // for any played size where the RIT entry says no canonical
-        // k-subrack of this rack forms a k-letter word on its own. Seeds
-        // nonplaythrough_best_leave_values directly from the cached max
-        // the RIT already computed at build time.
-        wmp_move_gen_check_nonplaythrough_existence_with_rit(
-            wgen, check_leaves, &gen->leave_map, gen->rit_entry,
-            /*subracks_precomputed=*/subrack_cache_hit,
-            /*wmp_entries_precomputed=*/subrack_cache_hit);
-      } else {
-        wmp_move_gen_check_nonplaythrough_existence(
-            wgen, check_leaves, &gen->leave_map,
-            /*subracks_precomputed=*/subrack_cache_hit,
-            /*wmp_entries_precomputed=*/subrack_cache_hit);
-      }
-      if (!subrack_cache_hit && leaves_are_populated) {
-        // Store the newly-computed enumeration and wmp_entry pointers
-        // into the cache. Only cache when leaves_are_populated so we
-        // don't stash garbage leave_values from an uninitialized leave_map.
-        subrack_entry->key = wgen->player_bit_rack;
-        subrack_entry->valid = true;
-        memcpy(subrack_entry->count_by_size, wgen->count_by_size,
-               sizeof(wgen->count_by_size));
-        for (int i = 0; i < MOVEGEN_SUBRACK_CACHE_ENTRIES; i++) {
-          subrack_entry->subracks[i] = wgen->nonplaythrough_infos[i].subrack;
-          subrack_entry->leave_values[i] =
-              wgen->nonplaythrough_infos[i].leave_value;
-          subrack_entry->wmp_entries[i] =
-              wgen->nonplaythrough_infos[i].wmp_entry;
-        }
-      }
-    }
+    gen_load_wmp_subracks(gen);
 
     if (gen->stop_on_threshold && gen->threshold_exceeded) {
       gen_record_pass(gen);
       return;
     }
 
+    PERF_TIMER_START(shadow_start);
     gen_shadow(gen);
+    PERF_TIMER_STOP(PERF_COUNTER_MOVEGEN_SHADOW, shadow_start);
     if (gen->threshold_exceeded) {
       gen_record_pass(gen);
       return;
     }
+    PERF_TIMER_START(record_start);
     gen_record_scoring_plays(gen);
+    PERF_TIMER_STOP(PERF_COUNTER_MOVEGEN_RECORD, record_start);
+  }
+  gen_record_pass(gen);
+}
+
+// What the exchange walk and the shadow of a position leave in the generator
+// for recording its plays, saved once by the calling thread for the other
+// threads of the split.
+typedef struct MoveGenShadowedAnchors {
+  LeaveMap leave_map;
+  Equity best_leaves[RACK_SIZE + 1];
+  const RackInfoTableEntry *rit_entry;
+  SubrackInfo nonplaythrough_infos[1 << RACK_SIZE];
+  Equity nonplaythrough_best_leave_values[RACK_SIZE + 1];
+  bool nonplaythrough_has_word_of_length[RACK_SIZE + 1];
+  uint8_t count_by_size[RACK_SIZE + 1];
+  AnchorHeap anchor_heap;
+} MoveGenShadowedAnchors;
+
+static void gen_save_shadowed_anchors(const MoveGen *gen,
+                                      MoveGenShadowedAnchors *shadowed) {
+  const WMPMoveGen *wgen = &gen->wmp_move_gen;
+  shadowed->leave_map = gen->leave_map;
+  memcpy(shadowed->best_leaves, gen->best_leaves, sizeof(gen->best_leaves));
+  shadowed->rit_entry = gen->rit_entry;
+  memcpy(shadowed->nonplaythrough_infos, wgen->nonplaythrough_infos,
+         sizeof(wgen->nonplaythrough_infos));
+  memcpy(shadowed->nonplaythrough_best_leave_values,
+         wgen->nonplaythrough_best_leave_values,
+         sizeof(wgen->nonplaythrough_best_leave_values));
+  memcpy(shadowed->nonplaythrough_has_word_of_length,
+         wgen->nonplaythrough_has_word_of_length,
+         sizeof(wgen->nonplaythrough_has_word_of_length));
+  memcpy(shadowed->count_by_size, wgen->count_by_size,
+         sizeof(wgen->count_by_size));
+  shadowed->anchor_heap.count = gen->anchor_heap.count;
+  memcpy(shadowed->anchor_heap.anchors, gen->anchor_heap.anchors,
+         sizeof(Anchor) * gen->anchor_heap.count);
+}
+
+static void gen_load_shadowed_anchors(MoveGen *gen,
+                                      const MoveGenShadowedAnchors *shadowed) {
+  WMPMoveGen *wgen = &gen->wmp_move_gen;
+  gen->leave_map = shadowed->leave_map;
+  memcpy(gen->best_leaves, shadowed->best_leaves, sizeof(gen->best_leaves));
+  gen->rit_entry = shadowed->rit_entry;
+  memcpy(wgen->nonplaythrough_infos, shadowed->nonplaythrough_infos,
+         sizeof(wgen->nonplaythrough_infos));
+  memcpy(wgen->nonplaythrough_best_leave_values,
+         shadowed->nonplaythrough_best_leave_values,
+         sizeof(wgen->nonplaythrough_best_leave_values));
+  memcpy(wgen->nonplaythrough_has_word_of_length,
+         shadowed->nonplaythrough_has_word_of_length,
+         sizeof(wgen->nonplaythrough_has_word_of_length));
+  memcpy(wgen->count_by_size, shadowed->count_by_size,
+         sizeof(wgen->count_by_size));
+  gen->anchor_heap.count = shadowed->anchor_heap.count;
+  memcpy(gen->anchor_heap.anchors, shadowed->anchor_heap.anchors,
+         sizeof(Anchor) * shadowed->anchor_heap.count);
+}
+
+// One thread's share of a position whose anchors are split across threads.
+typedef struct MoveGenAnchorWorker {
+  MoveGenArgs args;
+  const MoveGenShadowedAnchors *shadowed;
+  int anchor_offset;
+  int anchor_stride;
+  _Atomic Equity *shared_cutoff;
+  // The best move found by this thread for MOVE_RECORD_BEST, copied out of
+  // its MoveGen, which may be reused once the thread exits.
+  Move best_move;
+} MoveGenAnchorWorker;
+
+static void gen_set_anchor_split(MoveGen *gen, int anchor_offset,
+                                 int anchor_stride,
+                                 _Atomic Equity *shared_cutoff) {
+  gen->anchor_offset = anchor_offset;
+  gen->anchor_stride = anchor_stride;
+  gen->shared_cutoff = shared_cutoff;
+}
+
+// Records the plays from the anchors of one of the other threads, starting
+// from the anchor heap and leaves of the calling thread.
+static void gen_generate_anchors(MoveGenAnchorWorker *worker) {
+  MoveGen *gen = get_movegen();
+  gen_load_position(gen, &worker->args);
+  gen_load_shadowed_anchors(gen, worker->shadowed);
+  gen_set_anchor_split(gen, worker->anchor_offset, worker->anchor_stride,
+                       worker->shared_cutoff);
+  gen_record_scoring_plays(gen);
+  if (gen->move_record_type == MOVE_RECORD_BEST) {
+    move_copy(&worker->best_move, gen_get_readonly_best_move(gen));
+  }
+  gen_set_anchor_split(gen, 0, 1, NULL);
+}
+
+static void *gen_generate_anchors_worker(void *uncasted_worker) {
+  gen_generate_anchors((MoveGenAnchorWorker *)uncasted_worker);
+  return NULL;
+}
+
+static bool gen_can_split_anchors(const MoveGenArgs *args) {
+  return args->num_threads > 1 &&
+         (args->move_record_type == MOVE_RECORD_ALL ||
+          args->move_record_type == MOVE_RECORD_BEST) &&
+         args->target_equity == EQUITY_MAX_VALUE &&
+         args->target_leave_size_for_exchange_cutoff == UNSET_LEAVE_SIZE &&
+         args->lane_move_cache == NULL;
+}
+
+// Generates the moves of one position with its anchors dealt round robin, in
+// the order they come off the anchor heap, to args->num_threads threads, the
+// calling thread included. The calling thread records the exchanges and builds
+// the anchor heap once, and the other threads start from a copy of it, so the
+// split is deterministic. Their moves are merged into the calling thread's
+// results before the pass is recorded.
+static void generate_moves_split_anchors(const MoveGenArgs *args) {
+  const int num_threads = args->num_threads;
+  MoveGen *gen = get_movegen();
+  gen_load_position(gen, args);
+  gen_look_up_leaves_and_record_exchanges(gen);
+  gen_load_wmp_subracks(gen);
+  PERF_TIMER_START(shadow_start);
+  gen_shadow(gen);
+  PERF_TIMER_STOP(PERF_COUNTER_MOVEGEN_SHADOW, shadow_start);
+
+  _Atomic Equity shared_cutoff = EQUITY_INITIAL_VALUE;
+  _Atomic Equity *worker_shared_cutoff = NULL;
+  if (args->move_record_type == MOVE_RECORD_BEST) {
+    // The best exchange, if any, is the first cutoff of every thread.
+    worker_shared_cutoff = &shared_cutoff;
+    gen->shared_cutoff = worker_shared_cutoff;
+    gen_share_cutoff(gen);
+  }
+  MoveGenShadowedAnchors *shadowed =
+      (MoveGenShadowedAnchors *)malloc_or_die(sizeof(MoveGenShadowedAnchors));
+  gen_save_shadowed_anchors(gen, shadowed);
+  MoveGenAnchorWorker *workers = (MoveGenAnchorWorker *)calloc_or_die(
+      num_threads, sizeof(MoveGenAnchorWorker));
+  ThreadPoolThread **worker_ids = (ThreadPoolThread **)malloc_or_die(
+      sizeof(ThreadPoolThread *) * num_threads);
+  for (int thread_index = 1; thread_index < num_threads; thread_index++) {
+    MoveGenAnchorWorker *worker = &workers[thread_index];
+    worker->args = *args;
+    worker->args.move_list =
+        move_list_create(move_list_get_capacity(args->move_list));
+    worker->shadowed = shadowed;
+    worker->anchor_offset = thread_index;
+    worker->anchor_stride = num_threads;
+    worker->shared_cutoff = worker_shared_cutoff;
+    worker_ids[thread_index] =
+        thread_pool_start(gen_generate_anchors_worker, worker);
+  }
+  gen_set_anchor_split(gen, 0, num_threads, worker_shared_cutoff);
+  PERF_TIMER_START(record_start);
+  gen_record_scoring_plays(gen);
+  PERF_TIMER_STOP(PERF_COUNTER_MOVEGEN_RECORD, record_start);
+  gen_set_anchor_split(gen, 0, 1, NULL);
+  for (int thread_index = 1; thread_index < num_threads; thread_index++) {
+    thread_pool_join(worker_ids[thread_index]);
+    const MoveGenAnchorWorker *worker = &workers[thread_index];
+    if (gen->move_record_type == MOVE_RECORD_ALL) {
+      const MoveList *worker_move_list = worker->args.move_list;
+      for (int i = 0; i < move_list_get_count(worker_move_list); i++) {
+        move_list_add_move(gen->move_list,
+                           move_list_get_move(worker_move_list, i));
+      }
+    } else if (compare_moves(&worker->best_move,
+                             gen_get_readonly_best_move(gen), true) == 1) {
+      move_copy(gen_get_best_move(gen), &worker->best_move);
+    }
+    move_list_destroy(worker->args.move_list);
   }
   gen_record_pass(gen);
+  free(worker_ids);
+  free(workers);
+  free(shadowed);
+}
+
+// Records the stored best move for the rack of the player on turn if the
+// position is one the player's opening table was built for: the empty board
+// of the same layout and bingo bonus, a full rack, unmodified leaves and
+// enough tiles in the bag that exchanges are allowed and no preendgame
+// adjustment applies. Returns false, leaving the move list untouched,
+// otherwise.
+static bool gen_probe_opening_table(const MoveGenArgs *args) {
+  if (args->move_record_type != MOVE_RECORD_BEST ||
+      args->move_sort_type != MOVE_SORT_EQUITY || args->override_kwg ||
+      args->target_equity != EQUITY_MAX_VALUE ||
+      args->target_leave_size_for_exchange_cutoff != UNSET_LEAVE_SIZE) {
+    return false;
+  }
+  const Game *game = args->game;
+  const Board *board = game_get_board(game);
+  if (board_get_tiles_played(board) != 0) {
+    return false;
+  }
+  const int player_index = game_get_player_on_turn_index(game);
+  const Player *player = game_get_player(game, player_index);
+  const OpeningTable *opening_table = player_get_opening_table(player);
+  if (!opening_table) {
+    return false;
+  }
+  const Rack *rack = player_get_rack(player);
+  const int number_of_tiles_in_bag = bag_get_letters(game_get_bag(game));
+  const int opp_rack_size = rack_get_total_letters(
+      player_get_rack(game_get_player(game, 1 - player_index)));
+  if (rack_get_total_letters(rack) != RACK_SIZE ||
+      number_of_tiles_in_bag < PEG_ADJUST_VALUES_LENGTH ||
+      number_of_tiles_in_bag + opp_rack_size < RACK_SIZE * 2 ||
+      game_get_variant(game) == GAME_VARIANT_WORDSMOG ||
+      game_get_bingo_bonus(game) !=
+          opening_table_get_bingo_bonus(opening_table) ||
+      board_get_layout_fingerprint(board) !=
+          opening_table_get_layout_fingerprint(opening_table) ||
+      klv_get_mutation_counter(player_get_klv(player)) != 0) {
+    return false;
+  }
+  const BitRack bit_rack = bit_rack_create_from_rack(game_get_ld(game), rack);
+  const int entry_index = opening_table_lookup(opening_table, &bit_rack);
+  if (entry_index < 0) {
+    return false;
+  }
+  MoveList *move_list = args->move_list;
+  move_list_set_rack(move_list, rack);
+  move_list_reset(move_list);
+  Move *spare_move = move_list_get_spare_move(move_list);
+  opening_table_get_move(opening_table, entry_index, 0, spare_move);
+  move_list_insert_spare_move_top_equity(move_list,
+                                         move_get_equity(spare_move));
+  return true;
+}
+
+void generate_moves(const MoveGenArgs *args) {
+  PERF_TIMER_START(movegen_start);
+  if (gen_probe_opening_table(args)) {
+    PERF_TIMER_STOP(PERF_COUNTER_MOVEGEN, movegen_start);
+    return;
+  }
+  if (gen_can_split_anchors(args)) {
+    generate_moves_split_anchors(args);
+  } else {
+    MoveGen *gen = get_movegen();
+    gen_load_position(gen, args);
+    gen_generate_loaded(gen, args);
+  }
+  PERF_TIMER_STOP(PERF_COUNTER_MOVEGEN, movegen_start);
+}
+
+void generate_moves_for_racks(const MoveGenArgs *args, const Rack *racks,
+                              const Equity *target_equities,
+                              MoveList **move_lists, int number_of_racks) {
+  MoveGen *gen = get_movegen();
+  gen_load_board(gen, args);
+  for (int i = 0; i < number_of_racks; i++) {
+    PERF_TIMER_START(movegen_start);
+    rack_copy(&gen->player_rack, &racks[i]);
+    if (wmp_move_gen_is_active(&gen->wmp_move_gen)) {
+      wmp_move_gen_load_rack(&gen->wmp_move_gen, &gen->ld, &gen->player_rack);
+    }
+    gen_load_rack(gen, move_lists[i],
+                  target_equities != NULL ? target_equities[i]
+                                          : args->target_equity);
+    gen_generate_loaded(gen, args);
+    PERF_TIMER_STOP(PERF_COUNTER_MOVEGEN, movegen_start);
+  }
 }
@@ -11,6 +11,7 @@
 #include "../ent/game.h"
 #include "../ent/klv.h"
 #include "../ent/kwg.h"
+#include "../ent/lane_move_cache.h"
 #include "../ent/leave_map.h"
 #include "../ent/letter_distribution.h"
 #include "../ent/move.h"
@@ -127,6 +128,14 @@ typedef struct MoveGen {
   bool stop_on_threshold;
   bool threshold_exceeded;
 
+  // Set by generate_moves when one position is split across threads: this
+  // generator only records the anchors whose position in extraction order is
+  // anchor_offset modulo anchor_stride, and, if shared_cutoff is not NULL,
+  // stops at anchors that cannot reach the best cutoff of any thread.
+  int anchor_stride;
+  int anchor_offset;
+  _Atomic Equity *shared_cutoff;
+
   MachineLetter strip[(MOVE_MAX_TILES)];
   MachineLetter exchange_strip[(MOVE_MAX_TILES)];
   // MOVE_RECORD_TILES_PLAYED mode fields:
@@ -137,6 +146,9 @@ typedef struct MoveGen {
   // Generation stops when (tiles_played_bv & target_tiles_bv) ==
   // target_tiles_bv.
   uint64_t target_tiles_bv;
+  // If set, a played blank sets the bit of the letter it designates instead
+  // of the blank's bit.
+  bool record_designated_letters;
   LeaveMap leave_map;
   BitRack player_bit_rack;
   // Shadow plays
@@ -219,6 +231,8 @@ typedef struct MoveGen {
   // amortize the KLV descent cost across the rollout. Invalidated when
   // the KLV pointer or its mutation_counter changes.
   KlvLeavesCacheEntry klv_leaves_cache[MOVEGEN_KLV_LEAVES_CACHE_SIZE];
+  // Caller-owned per-lane move cache, only set for MOVE_RECORD_ALL_SMALL.
+  LaneMoveCache *lane_move_cache;
   const Board *board;
   LetterDistribution ld;
   // Whether ld fits a BitRack: <= BIT_RACK_MAX_ALPHABET_SIZE machine letters
@@ -271,6 +285,20 @@ typedef struct MoveGenArgs {
   // Input: initial set of known-playable tiles for MOVE_RECORD_TILES_PLAYED.
   // Movegen ORs further discoveries in. Default 0 (no known tiles).
   uint64_t initial_tiles_bv;
+  // Only used with MOVE_RECORD_TILES_PLAYED. If true, blanks record the
+  // letters they designate and generation stops once every letter of the
+  // distribution has been played, so a rack of blanks finds the letters that
+  // any rack could play on the board. Default false.
+  bool record_designated_letters;
+  // Optional per-lane move cache, only used with MOVE_RECORD_ALL_SMALL. Lanes
+  // whose squares and rack match a cached lane reuse its moves instead of
+  // being regenerated. Default NULL (no caching).
+  LaneMoveCache *lane_move_cache;
+  // Opt-in: the number of threads generate_moves splits the anchors of the
+  // position across, each with its own MoveGen. Only used with
+  // MOVE_RECORD_ALL and MOVE_RECORD_BEST without a target equity; the moves
+  // are the same as with one thread. Default 0 (single threaded).
+  int num_threads;
 } MoveGenArgs;
 
 void gen_destroy_cache(void);
@@ -281,6 +309,18 @@ void gen_destroy_cache(void);
 // solving.
 void generate_moves(const MoveGenArgs *args);
 
+// Generates moves on one position for each of the given racks in turn, as if
+// each were the rack of the player on turn. The position-dependent setup
+// (data pointers and their caches, row anchor counts, board lanes, tile
+// scores, WMP anchor seeding) runs once for the whole batch, and the per
+// thread subrack cache shares WMP lookups between racks with the same
+// subracks. The moves for racks[i] are written to move_lists[i], and
+// args->move_list is ignored. If target_equities is NULL, args->target_equity
+// is used for every rack.
+void generate_moves_for_racks(const MoveGenArgs *args, const Rack *racks,
+                              const Equity *target_equities,
+                              MoveList **move_lists, int number_of_racks);
+
 MoveGen *get_movegen(void);
 
 void gen_load_position(MoveGen *gen, const MoveGenArgs *args);
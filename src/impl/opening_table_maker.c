@@ -0,0 +1,212 @@
+#include "opening_table_maker.h"
+
+#include "../def/equity_defs.h"
+#include "../def/game_defs.h"
+#include "../def/move_defs.h"
+#include "../def/rack_defs.h"
+#include "../def/static_eval_defs.h"
+#include "../ent/bag.h"
+#include "../ent/bit_rack.h"
+#include "../ent/board.h"
+#include "../ent/game.h"
+#include "../ent/kwg.h"
+#include "../ent/letter_distribution.h"
+#include "../ent/move.h"
+#include "../ent/opening_table.h"
+#include "../ent/player.h"
+#include "../ent/rack.h"
+#include "../util/io_util.h"
+#include "gameplay.h"
+#include "move_gen.h"
+#include "thread_pool.h"
+#include <stdlib.h>
+
+typedef struct RackArray {
+  BitRack *bit_racks;
+  int count;
+  int capacity;
+} RackArray;
+
+static void enumerate_racks_recursive(const LetterDistribution *ld, int ml,
+                                      int remaining, BitRack *current,
+                                      RackArray *racks) {
+  if (remaining == 0) {
+    if (racks->count == racks->capacity) {
+      racks->capacity *= 2;
+      racks->bit_racks = realloc_or_die(
+          racks->bit_racks, sizeof(BitRack) * (size_t)racks->capacity);
+    }
+    racks->bit_racks[racks->count++] = *current;
+    return;
+  }
+  if (ml >= ld_get_size(ld)) {
+    return;
+  }
+  int max_this = ld_get_dist(ld, ml);
+  if (max_this > remaining) {
+    max_this = remaining;
+  }
+  for (int num = 0; num <= max_this; num++) {
+    enumerate_racks_recursive(ld, ml + 1, remaining - num, current, racks);
+    if (num < max_this) {
+      bit_rack_add_letter(current, ml);
+    }
+  }
+  for (int num = 0; num < max_this; num++) {
+    bit_rack_take_letter(current, ml);
+  }
+}
+
+typedef struct OpeningTableWorker {
+  const Game *game;
+  OpeningTable *table;
+  int thread_index;
+  int num_threads;
+} OpeningTableWorker;
+
+// Sets the game to the empty board with the given full rack for the player
+// on turn and a full rack of random tiles for the opponent.
+static void set_opening_racks(Game *game, const BitRack *bit_rack,
+                              Rack *rack) {
+  return_rack_to_bag(game, 0);
+  return_rack_to_bag(game, 1);
+  const LetterDistribution *ld = game_get_ld(game);
+  rack_reset(rack);
+  for (int ml = 0; ml < ld_get_size(ld); ml++) {
+    for (int i = 0; i < bit_rack_get_letter(bit_rack, ml); i++) {
+      rack_add_letter(rack, ml);
+    }
+  }
+  if (!draw_rack_from_bag(game, 0, rack)) {
+    log_fatal("opening table rack is not in the bag");
+  }
+  draw_to_full_rack(game, 1);
+}
+
+static void *make_opening_table_worker(void *uncasted_worker) {
+  const OpeningTableWorker *worker = (OpeningTableWorker *)uncasted_worker;
+  OpeningTable *table = worker->table;
+  const int number_of_moves = opening_table_get_number_of_moves(table);
+  Game *game = game_duplicate(worker->game);
+  game_reset(game);
+  // Generate every move instead of reading it from an existing table.
+  for (int player_index = 0; player_index < 2; player_index++) {
+    player_set_opening_table(game_get_player(game, player_index), NULL);
+  }
+  Rack *rack = rack_create(ld_get_size(game_get_ld(game)));
+  MoveList *best_move_list = move_list_create(1);
+  // The ALL record type keeps the top capacity moves, which is enough to
+  // fill the entry even if one of them is the best move.
+  MoveList *top_move_list =
+      number_of_moves > 1 ? move_list_create(number_of_moves) : NULL;
+  const int number_of_entries = opening_table_get_number_of_entries(table);
+  for (int entry_index = worker->thread_index; entry_index < number_of_entries;
+       entry_index += worker->num_threads) {
+    const BitRack bit_rack = opening_table_get_bit_rack(table, entry_index);
+    set_opening_racks(game, &bit_rack, rack);
+    const Move *best_move = get_top_equity_move(game, best_move_list);
+    opening_table_set_move(table, entry_index, 0, best_move);
+    if (!top_move_list) {
+      continue;
+    }
+    const MoveGenArgs args = {.game = game,
+                              .move_list = top_move_list,
+                              .move_record_type = MOVE_RECORD_ALL,
+                              .move_sort_type = MOVE_SORT_EQUITY,
+                              .override_kwg = NULL,
+                              .eq_margin_movegen = 0,
+                              .target_equity = EQUITY_MAX_VALUE,
+                              .target_leave_size_for_exchange_cutoff =
+                                  UNSET_LEAVE_SIZE};
+    generate_moves(&args);
+    move_list_sort_moves(top_move_list);
+    int move_index = 1;
+    for (int i = 0; i < move_list_get_count(top_move_list) &&
+                    move_index < number_of_moves;
+         i++) {
+      const Move *move = move_list_get_move(top_move_list, i);
+      if (compare_moves(move, best_move, true) != -1) {
+        opening_table_set_move(table, entry_index, move_index++, move);
+      }
+    }
+  }
+  move_list_destroy(top_move_list);
+  move_list_destroy(best_move_list);
+  rack_destroy(rack);
+  game_destroy(game);
+  return NULL;
+}
+
+OpeningTable *make_opening_table_for_racks(const Game *game,
+                                           const BitRack *bit_racks,
+                                           int number_of_racks,
+                                           int number_of_moves,
+                                           int num_threads,
+                                           ErrorStack *error_stack) {
+  const LetterDistribution *ld = game_get_ld(game);
+  if (!bit_rack_is_compatible_with_ld(ld)) {
+    error_stack_push(
+        error_stack, ERROR_STATUS_CREATE_DATA_INCOMPATIBLE_LETTER_DISTRIBUTION,
+        get_formatted_string("letter distribution %s is not supported by "
+                             "opening tables",
+                             ld_get_name(ld)));
+    return NULL;
+  }
+  // The table is only probed when the bag holds enough tiles that exchanges
+  // are allowed and no preendgame adjustment applies, which must also hold
+  // for the position the moves are generated in.
+  if (ld_get_total_tiles(ld) - RACK_SIZE * 2 < PEG_ADJUST_VALUES_LENGTH) {
+    error_stack_push(
+        error_stack, ERROR_STATUS_CREATE_DATA_INCOMPATIBLE_LETTER_DISTRIBUTION,
+        get_formatted_string("letter distribution %s has too few tiles for an "
+                             "opening table",
+                             ld_get_name(ld)));
+    return NULL;
+  }
+  if (num_threads <= 0) {
+    num_threads = 1;
+  }
+  const Player *player = game_get_player(game, 0);
+  OpeningTable *table = opening_table_create_empty(
+      bit_racks, number_of_racks, number_of_moves,
+      kwg_get_name(player_get_kwg(player)), ld_get_name(ld),
+      board_get_layout_fingerprint(game_get_board(game)),
+      game_get_bingo_bonus(game));
+
+  OpeningTableWorker *workers =
+      malloc_or_die(sizeof(OpeningTableWorker) * num_threads);
+  ThreadPoolThread **worker_ids =
+      malloc_or_die(sizeof(ThreadPoolThread *) * num_threads);
+  for (int thread_index = 0; thread_index < num_threads; thread_index++) {
+    workers[thread_index] = (OpeningTableWorker){.game = game,
+                                                 .table = table,
+                                                 .thread_index = thread_index,
+                                                 .num_threads = num_threads};
+    worker_ids[thread_index] =
+        thread_pool_start(make_opening_table_worker, &workers[thread_index]);
+  }
+  for (int thread_index = 0; thread_index < num_threads; thread_index++) {
+    thread_pool_join(worker_ids[thread_index]);
+  }
+  free(worker_ids);
+  free(workers);
+  return table;
+}
+
+OpeningTable *make_opening_table(const Game *game, int number_of_moves,
+                                 int num_threads, ErrorStack *error_stack) {
+  RackArray racks = {.count = 0, .capacity = 1024};
+  racks.bit_racks = malloc_or_die(sizeof(BitRack) * (size_t)racks.capacity);
+  // Racks of an incompatible distribution are left out and reported by
+  // make_opening_table_for_racks.
+  if (bit_rack_is_compatible_with_ld(game_get_ld(game))) {
+    BitRack current = bit_rack_create_empty();
+    enumerate_racks_recursive(game_get_ld(game), 0, RACK_SIZE, &current,
+                              &racks);
+  }
+  OpeningTable *table =
+      make_opening_table_for_racks(game, racks.bit_racks, racks.count,
+                                   number_of_moves, num_threads, error_stack);
+  free(racks.bit_racks);
+  return table;
+}
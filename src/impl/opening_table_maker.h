@@ -0,0 +1,33 @@
+#ifndef OPENING_TABLE_MAKER_H
+#define OPENING_TABLE_MAKER_H
+
+#include "../ent/bit_rack.h"
+#include "../ent/game.h"
+#include "../ent/opening_table.h"
+#include "../util/io_util.h"
+
+// Build an OpeningTable covering every possible RACK_SIZE-tile rack in the
+// letter distribution of the game.
+//
+// The moves are generated with the lexicon, leaves, board layout and bingo
+// bonus of the first player of the game, on the empty board with a full bag
+// minus the racks of both players. The first move of each entry is the one
+// generate_moves returns with MOVE_RECORD_BEST and MOVE_SORT_EQUITY, and the
+// other number_of_moves - 1 are the next best moves by equity.
+//
+// num_threads: number of threads to use (<= 0 means single-threaded).
+//
+// Returns NULL and pushes an error if the letter distribution is not BitRack
+// compatible or has too few tiles for the opening position described above.
+OpeningTable *make_opening_table(const Game *game, int number_of_moves,
+                                 int num_threads, ErrorStack *error_stack);
+
+// Same as make_opening_table, but only for the given racks.
+OpeningTable *make_opening_table_for_racks(const Game *game,
+                                           const BitRack *bit_racks,
+                                           int number_of_racks,
+                                           int number_of_moves,
+                                           int num_threads,
+                                           ErrorStack *error_stack);
+
+#endif
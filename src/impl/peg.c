@@ -21,12 +21,14 @@
 #include "../ent/kwg.h"
 #include "../ent/letter_distribution.h"
 #include "../ent/move.h"
+#include "../ent/perf_counters.h"
 #include "../ent/player.h"
 #include "../ent/rack.h"
 #include "../ent/thread_control.h"
 #include "../ent/transposition_table.h"
 #include "../util/fnv.h"
 #include "../util/io_util.h"
+#include "core_lender.h"
 #include "endgame.h"
 #include "gameplay.h"
 #include "kwg_maker.h"
@@ -35,11 +37,9 @@
 #include "peg_pool.h"
 #include "word_prune.h"
 #include <limits.h>
-#include <stdatomic.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
 
 // Default schedule for the halving stages, which run AFTER the root. Stage 0 is
 // not in this table: it greedy-evaluates EVERY candidate play (a fast playout,
@@ -1105,7 +1105,7 @@ static int32_t peg_nested_endgame_value(PegWorker *worker, Game *game,
       // nested endgames are small and many; no core injection
       /*max_workers=*/0, /*first_win=*/false, /*first_win_fallback_moves=*/0,
       /*use_initial_window=*/false, /*initial_alpha=*/0, /*initial_beta=*/0,
-      deadline_ns, /*actual_move=*/NULL, &ea);
+      deadline_ns, /*actual_move=*/NULL, /*tablebase_max_tiles=*/0, &ea);
   endgame_results_reset(worker->eg_results);
   endgame_solve_inline(&worker->eg_ctx, &ea, worker->eg_results);
   if (endgame_results_get_depth(worker->eg_results, ENDGAME_RESULT_BEST) < 0) {
@@ -1498,7 +1498,7 @@ static int32_t peg_inner_cascade(PegWorker *worker, Game *game, int depth,
 // Evaluate the leaf of one fully-resolved scenario (a specific post-cand game).
 // Returns mover's signed spread (points) — exact via endgame_solve for emptier
 // scenarios at fidelity > 0, else the greedy playout.
-static int32_t peg_eval_leaf(PegEvalCtx *ctx, Game *game) {
+static int32_t peg_eval_leaf_internal(PegEvalCtx *ctx, Game *game) {
   const bool emptier = bag_get_letters(game_get_bag(game)) == 0 &&
                        game_get_game_end_reason(game) == GAME_END_REASON_NONE;
   if (ctx->fidelity_plies <= 0 || !emptier) {
@@ -1565,7 +1565,7 @@ static int32_t peg_eval_leaf(PegEvalCtx *ctx, Game *game) {
       /*max_workers=*/ctx->injection_cap, /*first_win=*/false,
       /*first_win_fallback_moves=*/0, /*use_initial_window=*/false,
       /*initial_alpha=*/0, /*initial_beta=*/0, ctx->deadline_ns,
-      /*actual_move=*/NULL, &ea);
+      /*actual_move=*/NULL, /*tablebase_max_tiles=*/0, &ea);
   endgame_results_reset(ctx->worker->eg_results);
   endgame_solve_inline(&ctx->worker->eg_ctx, &ea, ctx->worker->eg_results);
   // If the solver was interrupted before completing any search depth (depth
@@ -1585,6 +1585,13 @@ static int32_t peg_eval_leaf(PegEvalCtx *ctx, Game *game) {
   return (turn == ctx->mover_idx) ? mover_lead + eg_val : mover_lead - eg_val;
 }
 
+static int32_t peg_eval_leaf(PegEvalCtx *ctx, Game *game) {
+  PERF_TIMER_START(leaf_start);
+  const int32_t value = peg_eval_leaf_internal(ctx, game);
+  PERF_TIMER_STOP(PERF_COUNTER_PEG_SCENARIO_LEAF, leaf_start);
+  return value;
+}
+
 // Append the human-readable letters of tiles[0..n) to out (for per-scenario
 // detail rows). PEG distributions use single-byte letters, so a few tiles fit
 // the small fixed PegPerScenario buffers.
@@ -2194,7 +2201,7 @@ static void peg_eval_candidates_scenario(
     const uint8_t *unseen, int ld_size, const LetterDistribution *ld,
     int bag_size, const Move *const *cands, int n, PegOppModel opp_model,
     int inner_top_k, int fidelity_plies, int scenario_stride,
-    int64_t deadline_ns, ThreadControl *thread_control,
+    int injection_cap, int64_t deadline_ns, ThreadControl *thread_control,
     const PegProgress *progress, PegPoll *poll, PegRankedCand *ranked,
     PegCandOutcomes *out_outcomes) {
   // Shared per-cand templates: post-cand board + cross-sets + pruned override,
@@ -2206,9 +2213,8 @@ static void peg_eval_candidates_scenario(
     game_gen_all_cross_sets(templates[i]);
   }
 
-  // Expand all (cand, split) jobs. The injection cap (== pool size) opens each
-  // leaf endgame's window so the monitor can lend idle cores to the long ones.
-  const int injection_cap = pool ? peg_pool_num_workers(pool) : 0;
+  // Expand all (cand, split) jobs. The injection cap (the core lender's cores)
+  // opens each leaf endgame's window so the lender can grow the long ones.
   PegScenarioJobList list = {0};
   for (int i = 0; i < n; i++) {
     PegEvalCtx ctx;
@@ -2354,54 +2360,10 @@ static void peg_publish(PegResult *out, const PegRankedCand *ranked, int count,
 
 // ----- injection monitor ---------------------------------------------------
 
-typedef struct PegInjector {
-  PegPool *pool;
-  PegWorker *workers;
-  int n_workers;
-  int core_target; // cap on total live ABDADA workers across active endgames
-  atomic_int stop;
-} PegInjector;
-
-// Background monitor: while pool workers are idle, lend a core to the
-// least-parallelized in-flight leaf endgame by injecting an ABDADA helper.
-// Keeps the total live ABDADA worker count (masters + helpers) near the core
-// target, so the few long deep-stage endgames soak up the otherwise-idle cores.
-static void *peg_injector_main(void *arg) {
-  // Only help endgames that have been running at least this long: the many
-  // sub-millisecond leaf solves close before this, so we never pay ABDADA
-  // spawn/coordination overhead on them — only the few long "monster" endgames
-  // (the deep-stage realized lines) get helpers.
-  const int64_t min_age_ns = 30LL * 1000 * 1000; // 30 ms
-  PegInjector *inj = (PegInjector *)arg;
-  while (!atomic_load(&inj->stop)) {
-    if (peg_pool_idle_workers(inj->pool) > 0) {
-      const int64_t now = ctimer_monotonic_ns();
-      int total_live = 0;
-      EndgameCtx *least = NULL;
-      int least_live = INT_MAX;
-      for (int worker_idx = 0; worker_idx < inj->n_workers; worker_idx++) {
-        EndgameCtx *ctx = inj->workers[worker_idx].eg_ctx;
-        if (ctx == NULL || !endgame_injecting(ctx)) {
-          continue;
-        }
-        const int live = endgame_live_workers(ctx);
-        total_live += live;
-        if (live < least_live &&
-            now - endgame_window_open_ns(ctx) >= min_age_ns) {
-          least_live = live;
-          least = ctx;
-        }
-      }
-      if (least != NULL && total_live < inj->core_target) {
-        // The injected worker draws its MoveGen cache slot on demand from
-        // get_movegen() (per-pthread), so no slot bookkeeping is needed here.
-        endgame_add_worker(least);
-      }
-    }
-    const struct timespec nap = {0, 2L * 1000 * 1000}; // 2 ms
-    nanosleep(&nap, NULL);
-  }
-  return NULL;
+// The pool's idle workers are the cores the core lender may hand to in-flight
+// leaf endgames.
+static int peg_pool_idle_cores(void *pool) {
+  return peg_pool_idle_workers((PegPool *)pool);
 }
 
 // ----- public entry --------------------------------------------------------
@@ -2612,21 +2574,29 @@ void peg_solve(const PegArgs *args, PegResult *out, ErrorStack *error_stack) {
     workers[worker_idx].nest_all = NULL;
   }
 
-  // Injection monitor: lends idle cores to in-flight leaf endgames. Only
-  // meaningful with a pool; the deep stages have few candidates, so their long
-  // endgames would otherwise leave most cores idle.
-  PegInjector injector;
-  cpthread_t injector_thread;
-  bool injector_running = false;
-  if (pool) {
-    injector.pool = pool;
-    injector.workers = workers;
-    injector.n_workers = n_scratch;
-    injector.core_target = n_threads;
-    atomic_init(&injector.stop, 0);
-    cpthread_create(&injector_thread, peg_injector_main, &injector);
-    injector_running = true;
+  // Injection monitor: lends idle cores to in-flight leaf endgames; the deep
+  // stages have few candidates, so their long endgames would otherwise leave
+  // most cores idle. Without a caller's lender, a lender of our own is only
+  // meaningful with a pool: it holds all of the solver's cores, so it lends
+  // nothing but the pool's idle workers. A caller's lender also lends the
+  // pool's idle workers to the searches running alongside this one, and the
+  // cores those searches free up to our leaf endgames.
+  CoreLender *core_lender = args->core_lender;
+  if (!core_lender && pool) {
+    core_lender = core_lender_create(n_threads);
+    core_lender_acquire(core_lender, n_threads);
+  }
+  if (core_lender) {
+    if (pool) {
+      core_lender_add_idle_source(core_lender, peg_pool_idle_cores, pool);
+    }
+    for (int worker_idx = 0; worker_idx < n_scratch; worker_idx++) {
+      core_lender_add_endgame(core_lender, workers[worker_idx].eg_ctx,
+                              deadline_ns);
+    }
   }
+  const int injection_cap =
+      core_lender ? core_lender_get_num_cores(core_lender) : 0;
 
   // Candidate set: either the caller-supplied "only solve" list (used as-is),
   // or the full generated, equity-sorted move list. Stage 0 re-ranks by win%
@@ -2838,7 +2808,7 @@ void peg_solve(const PegArgs *args, PegResult *out, ErrorStack *error_stack) {
           peg_eval_candidates_scenario(
               pool, workers, prepared_base, mover_idx, unseen, ld_size, ld,
               bag_size, &moves[cand_idx], 1, args->opp_model, args->inner_top_k,
-              stage_fidelity, scenario_stride, deadline_ns,
+              stage_fidelity, scenario_stride, injection_cap, deadline_ns,
               args->thread_control, &inner, /*poll=*/NULL, &restaged[cand_idx],
               args->include_per_scenario ? &stage_outcomes[cand_idx] : NULL);
           restaged[cand_idx].eval_seconds = ctimer_elapsed_seconds(&cand_timer);
@@ -2876,8 +2846,9 @@ void peg_solve(const PegArgs *args, PegResult *out, ErrorStack *error_stack) {
         peg_eval_candidates_scenario(
             pool, workers, prepared_base, mover_idx, unseen, ld_size, ld,
             bag_size, moves, eval_count, args->opp_model, args->inner_top_k,
-            stage_fidelity, scenario_stride, deadline_ns, args->thread_control,
-            &progress, args->poll, restaged, stage_outcomes);
+            stage_fidelity, scenario_stride, injection_cap, deadline_ns,
+            args->thread_control, &progress, args->poll, restaged,
+            stage_outcomes);
         // A deadline can cut the stage mid-flight: a candidate whose scenario
         // jobs bailed has a short weight_sum, so keep only the fully-scored
         // ones (as the live path does) instead of ranking partial scores.
@@ -3076,10 +3047,17 @@ void peg_solve(const PegArgs *args, PegResult *out, ErrorStack *error_stack) {
            (size_t)poll_snap.n_stage_history * sizeof(PegStageSnapshot));
   }
 
-  // Stop the injection monitor before tearing down the workers it observes.
-  if (injector_running) {
-    atomic_store(&injector.stop, 1);
-    cpthread_join(injector_thread);
+  // Stop lending to the workers before tearing them down.
+  if (core_lender) {
+    for (int worker_idx = 0; worker_idx < n_scratch; worker_idx++) {
+      core_lender_remove_endgame(core_lender, workers[worker_idx].eg_ctx);
+    }
+    if (pool) {
+      core_lender_remove_idle_source(core_lender, pool);
+    }
+    if (core_lender != args->core_lender) {
+      core_lender_destroy(core_lender);
+    }
   }
 
   if (cand_ml) {
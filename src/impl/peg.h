@@ -8,6 +8,7 @@
 #include "../ent/move.h"
 #include "../ent/thread_control.h"
 #include "../util/io_util.h"
+#include "core_lender.h"
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -241,6 +242,14 @@ typedef struct PegArgs {
   // a separate thread (e.g. a TUI render loop) can read the current ranking
   // concurrently via peg_poll_read. The caller owns the PegPoll.
   PegPoll *poll;
+
+  // Optional core lender shared with searches running alongside this one, from
+  // which the caller acquired num_threads cores. NULL = the solver lends its
+  // own pool's idle cores to its leaf endgames. When set, the leaf endgames
+  // may also grow with cores the other searches free up, and the pool's idle
+  // workers are offered to those searches while a stage drains. The caller
+  // owns the lender.
+  CoreLender *core_lender;
 } PegArgs;
 
 // Fills every PegArgs field from an explicit argument, so that adding a field
@@ -264,7 +273,8 @@ peg_args_fill(const Game *game, ThreadControl *thread_control,
               const Move *const *protect_moves, const int n_protect_moves,
               const bool include_per_scenario, PegOnStageStart on_stage_start,
               PegOnCandDone on_cand_done, PegOnScenarioDone on_scenario_done,
-              void *user_data, PegPoll *poll, PegArgs *peg_args) {
+              void *user_data, PegPoll *poll, CoreLender *core_lender,
+              PegArgs *peg_args) {
   peg_args->game = game;
   peg_args->thread_control = thread_control;
   peg_args->num_threads = num_threads;
@@ -295,6 +305,7 @@ peg_args_fill(const Game *game, ThreadControl *thread_control,
   peg_args->on_scenario_done = on_scenario_done;
   peg_args->user_data = user_data;
   peg_args->poll = poll;
+  peg_args->core_lender = core_lender;
 }
 
 // ----- Stage progress snapshot ------------------------------------------
@@ -5,6 +5,7 @@
 #include "../def/cpthread_defs.h"
 #include "../def/peg_defs.h"
 #include "../util/io_util.h"
+#include "thread_pool.h"
 #include <errno.h>
 #include <pthread.h>
 #include <stdatomic.h>
@@ -52,7 +53,7 @@ typedef struct PegPoolWorkerCtx {
 struct PegPool {
   int num_workers;
   int thread_index_offset;
-  cpthread_t *threads;
+  ThreadPoolThread **threads;
   PegPoolWorkerCtx *worker_ctxs;
   // Ring-ish queue. Simpler: linear buffer with head/tail; grow on overflow.
   PegPoolItem *queue;
@@ -326,20 +327,22 @@ PegPool *peg_pool_create(int num_workers, int thread_index_offset) {
   pool->stuck_timeout_s = to_env ? (int)strtol(to_env, NULL, 10) : 60;
   cpthread_mutex_init(&pool->q_mutex);
   cpthread_cond_init(&pool->q_cv_nonempty);
-  pool->threads = malloc_or_die((size_t)num_workers * sizeof(cpthread_t));
+  pool->threads =
+      malloc_or_die((size_t)num_workers * sizeof(ThreadPoolThread *));
   pool->worker_ctxs =
       malloc_or_die((size_t)num_workers * sizeof(PegPoolWorkerCtx));
   // Workers help-drain the queue while blocked on a submitted batch, so a
   // worker can recurse into nested solves on its own stack (bounded by the
   // PEG fork-nesting cap). The 512 KB default secondary-thread stack overflows
   // there; request a large stack (lazily committed, so only the depth actually
-  // used is paid for) to keep deep nesting stack-safe.
+  // used is paid for) to keep deep nesting stack-safe. The workers run on the
+  // process wide thread pool, so consecutive solves reuse the same threads.
   for (int worker_idx = 0; worker_idx < num_workers; worker_idx++) {
     pool->worker_ctxs[worker_idx].pool = pool;
     pool->worker_ctxs[worker_idx].worker_idx = thread_index_offset + worker_idx;
-    cpthread_create_with_stack(&pool->threads[worker_idx], pp_worker_main,
-                               &pool->worker_ctxs[worker_idx],
-                               PEG_POOL_WORKER_STACK_BYTES);
+    pool->threads[worker_idx] = thread_pool_start_with_stack(
+        pp_worker_main, &pool->worker_ctxs[worker_idx],
+        PEG_POOL_WORKER_STACK_BYTES);
   }
   return pool;
 }
@@ -353,7 +356,7 @@ void peg_pool_destroy(PegPool *pool) {
   cpthread_cond_broadcast(&pool->q_cv_nonempty);
   cpthread_mutex_unlock(&pool->q_mutex);
   for (int worker_idx = 0; worker_idx < pool->num_workers; worker_idx++) {
-    cpthread_join(pool->threads[worker_idx]);
+    thread_pool_join(pool->threads[worker_idx]);
   }
   free(pool->threads);
   free(pool->worker_ctxs);
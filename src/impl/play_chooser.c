@@ -26,6 +26,7 @@
 #include "../ent/transposition_table.h"
 #include "../ent/words.h"
 #include "../util/io_util.h"
+#include "core_lender.h"
 #include "endgame.h"
 #include "gameplay.h"
 #include "move_gen.h"
@@ -223,13 +224,15 @@ static double play_chooser_util_w_winpct(const PlayChooserStrategy *strategy);
 static double
 play_chooser_util_spread_scale(const PlayChooserStrategy *strategy);
 
-// Chooses the on-turn player's best move by simulation, returning it in
-// out_move. out_simulated (optional) reports whether a sim actually ran: a
-// single-candidate position is short-circuited to that move WITHOUT simming, so
-// sim_results is left untouched and callers that read it must not use it.
+// Chooses the on-turn player's best move by simulation on num_threads threads,
+// returning it in out_move. out_simulated (optional) reports whether a sim
+// actually ran: a single-candidate position is short-circuited to that move
+// WITHOUT simming, so sim_results is left untouched and callers that read it
+// must not use it.
 static bool play_chooser_run_sim(PlayChooser *play_chooser, Game *game,
-                                 double budget_seconds, Move *out_move,
-                                 bool *out_simulated, ErrorStack *error_stack) {
+                                 double budget_seconds, int num_threads,
+                                 Move *out_move, bool *out_simulated,
+                                 ErrorStack *error_stack) {
   if (out_simulated != NULL) {
     *out_simulated = false;
   }
@@ -258,7 +261,6 @@ static bool play_chooser_run_sim(PlayChooser *play_chooser, Game *game,
     return true;
   }
 
-  const int num_threads = play_chooser_get_num_threads(strategy);
   const int sim_plies = strategy->sim_plies > 0
                             ? strategy->sim_plies
                             : PLAY_CHOOSER_DEFAULT_SIM_PLIES;
@@ -322,20 +324,32 @@ static int play_chooser_get_endgame_plies(const PlayChooserStrategy *strategy) {
 // one allows another thread to interrupt the solve. When use_window is
 // true, the solve searches the fixed [window_alpha, window_beta] window
 // (in final-spread units) and the reported value is a bound relative to
-// that window rather than an exact value. Returns false if no move could
-// be produced.
+// that window rather than an exact value. When core_lender is not NULL, the
+// solve may grow up to the lender's number of cores as other searches sharing
+// the lender finish. Returns false if no move could be produced.
 static bool play_chooser_run_endgame(
     const PlayChooserStrategy *strategy, EndgameCtx **endgame_ctx,
     EndgameResults *endgame_results, TranspositionTable *shared_tt,
     const Game *game, int num_threads, double budget_seconds,
-    ThreadControl *external_thread_control, bool use_window,
-    int32_t window_alpha, int32_t window_beta, Move *out_move,
-    int32_t *out_value, ErrorStack *error_stack) {
+    ThreadControl *external_thread_control, CoreLender *core_lender,
+    bool use_window, int32_t window_alpha, int32_t window_beta,
+    Move *out_move, int32_t *out_value, ErrorStack *error_stack) {
   ThreadControl *thread_control = external_thread_control;
   if (thread_control == NULL) {
     thread_control = thread_control_create();
     thread_control_set_status(thread_control, THREAD_CONTROL_STATUS_STARTED);
   }
+  int max_workers = 0;
+  if (core_lender != NULL) {
+    max_workers = core_lender_get_num_cores(core_lender);
+    // The lender observes the context, so it must exist before the solve.
+    if (*endgame_ctx == NULL) {
+      *endgame_ctx = endgame_ctx_create();
+    }
+    core_lender_add_endgame(core_lender, *endgame_ctx,
+                            ctimer_monotonic_ns() +
+                                (int64_t)(budget_seconds * 1.0e9));
+  }
   EndgameArgs endgame_args = {0};
   endgame_args_fill(
       thread_control, game, /*tt_fraction_of_mem=*/0.0,
@@ -348,12 +362,15 @@ static bool play_chooser_run_endgame(
       DUAL_LEXICON_MODE_IGNORANT, /*forced_pass_bypass=*/false,
       /*enable_pv_display=*/false, /*soft_time_limit=*/budget_seconds * 0.9,
       /*hard_time_limit=*/budget_seconds, strategy->seed,
-      /*skip_word_pruning=*/false, shared_tt, /*max_workers=*/0,
+      /*skip_word_pruning=*/false, shared_tt, max_workers,
       /*first_win=*/false, /*first_win_fallback_moves=*/0, use_window,
       window_alpha, window_beta, /*external_deadline_ns=*/0,
-      /*actual_move=*/NULL, &endgame_args);
+      /*actual_move=*/NULL, /*tablebase_max_tiles=*/0, &endgame_args);
 
   endgame_solve(endgame_ctx, &endgame_args, endgame_results, error_stack);
+  if (core_lender != NULL) {
+    core_lender_remove_endgame(core_lender, *endgame_ctx);
+  }
   if (external_thread_control == NULL) {
     thread_control_destroy(thread_control);
   }
@@ -451,11 +468,13 @@ static double play_chooser_peg_decided_utility(const PlayChooserStrategy *s,
 // position. Requires the bag size to be in [PEG_MIN_BAG, PEG_MAX_BAG];
 // returns false otherwise, or when the solve produced no usable evaluation
 // (no candidate finished within the budget, leaving a negative-win% sentinel),
-// so the caller can fall back.
+// so the caller can fall back. core_lender (may be NULL) is a lender shared
+// with a search running alongside this one; see PegArgs.
 static bool play_chooser_run_peg(PlayChooser *play_chooser, const Game *game,
                                  double budget_seconds, int num_threads,
-                                 bool greedy_only, Move *out_move,
-                                 double *out_value, ErrorStack *error_stack) {
+                                 CoreLender *core_lender, bool greedy_only,
+                                 Move *out_move, double *out_value,
+                                 ErrorStack *error_stack) {
   const int bag_letters = bag_get_letters(game_get_bag(game));
   if (bag_letters < PEG_MIN_BAG || bag_letters > PEG_MAX_BAG) {
     return false;
@@ -478,7 +497,7 @@ static bool play_chooser_run_peg(PlayChooser *play_chooser, const Game *game,
                 /*protect_moves=*/NULL, /*n_protect_moves=*/0,
                 /*include_per_scenario=*/false, /*on_stage_start=*/NULL,
                 /*on_cand_done=*/NULL, /*on_scenario_done=*/NULL,
-                /*user_data=*/NULL, /*poll=*/NULL, &peg_args);
+                /*user_data=*/NULL, /*poll=*/NULL, core_lender, &peg_args);
   PegResult peg_result = {0};
   peg_solve(&peg_args, &peg_result, error_stack);
   thread_control_destroy(thread_control);
@@ -511,7 +530,8 @@ void play_chooser_choose_move(PlayChooser *play_chooser, Game *game,
     break;
   case PLAY_CHOOSER_EVAL_SIM:
     chose_move =
-        play_chooser_run_sim(play_chooser, game, budget_seconds, out_move,
+        play_chooser_run_sim(play_chooser, game, budget_seconds,
+                             play_chooser_get_num_threads(strategy), out_move,
                              /*out_simulated=*/NULL, error_stack);
     break;
   case PLAY_CHOOSER_EVAL_ENDGAME:
@@ -519,16 +539,16 @@ void play_chooser_choose_move(PlayChooser *play_chooser, Game *game,
         strategy, &play_chooser->endgame_ctx, play_chooser->endgame_results,
         play_chooser_get_endgame_tt(play_chooser), game,
         play_chooser_get_num_threads(strategy), budget_seconds,
-        /*external_thread_control=*/NULL, /*use_window=*/false, 0, 0, out_move,
-        NULL, error_stack);
+        /*external_thread_control=*/NULL, /*core_lender=*/NULL,
+        /*use_window=*/false, 0, 0, out_move, NULL, error_stack);
     break;
   case PLAY_CHOOSER_EVAL_PEG:
     // Selecting the actual play: run the full cascade so the halving stages'
     // exact endgame refinement picks between the top candidates.
-    chose_move = play_chooser_run_peg(play_chooser, game, budget_seconds,
-                                      play_chooser_get_num_threads(strategy),
-                                      /*greedy_only=*/false, out_move,
-                                      /*out_value=*/NULL, error_stack);
+    chose_move = play_chooser_run_peg(
+        play_chooser, game, budget_seconds,
+        play_chooser_get_num_threads(strategy), /*core_lender=*/NULL,
+        /*greedy_only=*/false, out_move, /*out_value=*/NULL, error_stack);
     break;
   }
   if (!error_stack_is_empty(error_stack)) {
@@ -597,9 +617,12 @@ static double play_chooser_get_final_spread(const Game *game) {
 // scale, but a STATIC decision uses it for both branches, so they stay
 // comparable. The result is invalid when the branch could not be evaluated
 // (e.g. a sim/PEG/endgame solve that produced nothing within the budget).
+// The solve runs on num_threads threads; an endgame or PEG solve may grow with
+// cores lent by core_lender when it is not NULL.
 static PlayChooserBranchValue
 play_chooser_evaluate_position(PlayChooser *play_chooser, Game *game,
                                play_chooser_eval_t eval, double budget_seconds,
+                               int num_threads, CoreLender *core_lender,
                                ErrorStack *error_stack) {
   const PlayChooserStrategy *strategy = &play_chooser->strategy;
   if (game_over(game)) {
@@ -621,8 +644,8 @@ play_chooser_evaluate_position(PlayChooser *play_chooser, Game *game,
   case PLAY_CHOOSER_EVAL_SIM: {
     Move best_move;
     bool simulated = false;
-    if (!play_chooser_run_sim(play_chooser, game, budget_seconds, &best_move,
-                              &simulated, error_stack)) {
+    if (!play_chooser_run_sim(play_chooser, game, budget_seconds, num_threads,
+                              &best_move, &simulated, error_stack)) {
       return PLAY_CHOOSER_BRANCH_INVALID;
     }
     if (!simulated) {
@@ -642,10 +665,10 @@ play_chooser_evaluate_position(PlayChooser *play_chooser, Game *game,
     int32_t endgame_value = 0;
     if (!play_chooser_run_endgame(
             strategy, &play_chooser->endgame_ctx, play_chooser->endgame_results,
-            play_chooser_get_endgame_tt(play_chooser), game,
-            play_chooser_get_num_threads(strategy), budget_seconds,
-            /*external_thread_control=*/NULL, /*use_window=*/false, 0, 0,
-            /*out_move=*/NULL, &endgame_value, error_stack)) {
+            play_chooser_get_endgame_tt(play_chooser), game, num_threads,
+            budget_seconds, /*external_thread_control=*/NULL, core_lender,
+            /*use_window=*/false, 0, 0, /*out_move=*/NULL, &endgame_value,
+            error_stack)) {
       return PLAY_CHOOSER_BRANCH_INVALID;
     }
     return play_chooser_branch_value(play_chooser_peg_decided_utility(
@@ -655,10 +678,10 @@ play_chooser_evaluate_position(PlayChooser *play_chooser, Game *game,
     // Greedy pre-endgame seed: a bounded, deterministic score+win utility over
     // the full scenario field.
     double branch_utility = 0.0;
-    if (!play_chooser_run_peg(play_chooser, game, budget_seconds,
-                              play_chooser_get_num_threads(strategy),
-                              /*greedy_only=*/true, /*out_move=*/NULL,
-                              &branch_utility, error_stack)) {
+    if (!play_chooser_run_peg(play_chooser, game, budget_seconds, num_threads,
+                              core_lender, /*greedy_only=*/true,
+                              /*out_move=*/NULL, &branch_utility,
+                              error_stack)) {
       return PLAY_CHOOSER_BRANCH_INVALID;
     }
     return play_chooser_branch_value(branch_utility);
@@ -676,6 +699,9 @@ typedef struct PlayChooserEndgameBranch {
   EndgameResults *endgame_results;
   TranspositionTable *endgame_tt;
   int num_threads;
+  // Shared by both branches: a branch that stops at its soft time limit
+  // returns its cores, which are then lent to the branch still solving.
+  CoreLender *core_lender;
   ThreadControl *thread_control;
   // Interrupted when this branch solves exactly, so the decision can
   // switch the sibling to a cheaper does-it-beat-this search.
@@ -696,8 +722,8 @@ play_chooser_solve_endgame_branch(PlayChooserEndgameBranch *branch) {
           &branch->play_chooser->strategy, branch->endgame_ctx,
           branch->endgame_results, branch->endgame_tt, branch->game,
           branch->num_threads, branch->budget_seconds, branch->thread_control,
-          /*use_window=*/false, 0, 0, NULL, &endgame_value,
-          branch->error_stack)) {
+          branch->core_lender, /*use_window=*/false, 0, 0, NULL,
+          &endgame_value, branch->error_stack)) {
     branch->value =
         play_chooser_get_spread(branch->game) + (double)endgame_value;
     branch->valid = true;
@@ -709,9 +735,14 @@ play_chooser_solve_endgame_branch(PlayChooserEndgameBranch *branch) {
                                   ENDGAME_RESULT_BEST) >=
         play_chooser_get_endgame_plies(&branch->play_chooser->strategy);
   }
+  // An exact value interrupts the sibling, which is then re-solved with a null
+  // window on all of the threads. Otherwise this branch ran out of time first,
+  // and its cores are lent to the sibling for whatever time it has left.
   if (branch->exact) {
     thread_control_set_status(branch->sibling_thread_control,
                               THREAD_CONTROL_STATUS_USER_INTERRUPT);
+  } else if (branch->core_lender != NULL) {
+    core_lender_release(branch->core_lender, branch->num_threads);
   }
 }
 
@@ -720,6 +751,24 @@ static void *play_chooser_endgame_branch_thread(void *arg) {
   return NULL;
 }
 
+// Moves the errors of the keep branch, which was valued on its own thread,
+// onto the decision's error stack.
+static void play_chooser_push_keep_branch_errors(ErrorStack *keep_error_stack,
+                                                 ErrorStack *error_stack) {
+  if (error_stack_is_empty(keep_error_stack)) {
+    return;
+  }
+  // Preserve the keep branch's detailed message(s) rather than dropping them
+  // for a generic string.
+  const error_code_t keep_error_code = error_stack_top(keep_error_stack);
+  char *keep_error_message = error_stack_get_string_and_reset(keep_error_stack);
+  error_stack_push(
+      error_stack, keep_error_code,
+      get_formatted_string("keep branch challenge evaluation failed: %s",
+                           keep_error_message));
+  free(keep_error_message);
+}
+
 // Decide an endgame challenge by solving the keep and challenge branches
 // concurrently against the shared transposition table. A branch whose
 // game is already over (for example a kept phony that goes out) has an
@@ -758,15 +807,24 @@ static void play_chooser_decide_challenge_endgame(PlayChooser *play_chooser,
     // null-window resolve below can take over cheaply. With a single thread,
     // honor the budget rather than spawning a second solver thread: solve
     // sequentially, splitting the window in half, with no cross-branch
-    // interrupt (each branch's sibling control points at itself).
+    // interrupt (each branch's sibling control points at itself). Concurrent
+    // branches share a core lender, so when one branch stops short of an
+    // exact value, its cores join the other branch's solve instead of sitting
+    // idle.
     const bool run_concurrent = total_threads > 1;
-    const int keep_threads = run_concurrent ? (total_threads + 1) / 2 : 1;
+    int keep_threads = run_concurrent ? (total_threads + 1) / 2 : 1;
     int challenge_threads = run_concurrent ? total_threads - keep_threads : 1;
     if (challenge_threads < 1) {
       challenge_threads = 1;
     }
     const double branch_seconds =
         run_concurrent ? decision_seconds : decision_seconds / 2.0;
+    CoreLender *core_lender = NULL;
+    if (run_concurrent) {
+      core_lender = core_lender_create(total_threads);
+      challenge_threads = core_lender_acquire(core_lender, challenge_threads);
+      keep_threads = core_lender_acquire(core_lender, keep_threads);
+    }
     ThreadControl *keep_thread_control = thread_control_create();
     thread_control_set_status(keep_thread_control,
                               THREAD_CONTROL_STATUS_STARTED);
@@ -782,6 +840,7 @@ static void play_chooser_decide_challenge_endgame(PlayChooser *play_chooser,
         .endgame_results = play_chooser->keep_endgame_results,
         .endgame_tt = endgame_tt,
         .num_threads = keep_threads,
+        .core_lender = core_lender,
         .thread_control = keep_thread_control,
         .sibling_thread_control =
             run_concurrent ? challenge_thread_control : keep_thread_control,
@@ -798,6 +857,7 @@ static void play_chooser_decide_challenge_endgame(PlayChooser *play_chooser,
         .endgame_results = play_chooser->challenge_endgame_results,
         .endgame_tt = endgame_tt,
         .num_threads = challenge_threads,
+        .core_lender = core_lender,
         .thread_control = challenge_thread_control,
         .sibling_thread_control =
             run_concurrent ? keep_thread_control : challenge_thread_control,
@@ -812,24 +872,14 @@ static void play_chooser_decide_challenge_endgame(PlayChooser *play_chooser,
                       &keep_branch);
       play_chooser_solve_endgame_branch(&challenge_branch);
       cpthread_join(keep_thread);
+      core_lender_destroy(core_lender);
     } else {
       play_chooser_solve_endgame_branch(&keep_branch);
       play_chooser_solve_endgame_branch(&challenge_branch);
     }
     thread_control_destroy(keep_thread_control);
     thread_control_destroy(challenge_thread_control);
-    if (!error_stack_is_empty(keep_error_stack)) {
-      // Preserve the keep branch's detailed message(s) rather than dropping
-      // them for a generic string.
-      const error_code_t keep_error_code = error_stack_top(keep_error_stack);
-      char *keep_error_message =
-          error_stack_get_string_and_reset(keep_error_stack);
-      error_stack_push(
-          error_stack, keep_error_code,
-          get_formatted_string("keep branch challenge evaluation failed: %s",
-                               keep_error_message));
-      free(keep_error_message);
-    }
+    play_chooser_push_keep_branch_errors(keep_error_stack, error_stack);
     error_stack_destroy(keep_error_stack);
     if (!error_stack_is_empty(error_stack)) {
       return;
@@ -896,8 +946,8 @@ static void play_chooser_decide_challenge_endgame(PlayChooser *play_chooser,
   const bool resolved = play_chooser_run_endgame(
       strategy, resolve_ctx, resolve_results, endgame_tt, resolve_game,
       total_threads, remaining_seconds, /*external_thread_control=*/NULL,
-      /*use_window=*/true, window_alpha, window_beta, NULL,
-      &resolve_endgame_value, error_stack);
+      /*core_lender=*/NULL, /*use_window=*/true, window_alpha, window_beta,
+      NULL, &resolve_endgame_value, error_stack);
   if (!error_stack_is_empty(error_stack)) {
     return;
   }
@@ -925,6 +975,89 @@ static void play_chooser_decide_challenge_endgame(PlayChooser *play_chooser,
   decision->challenge_value = challenge_value;
 }
 
+// One side of a mixed-stage challenge decision, valued on its own thread.
+typedef struct PlayChooserMixedBranch {
+  PlayChooser *play_chooser;
+  Game *game;
+  play_chooser_eval_t eval;
+  double budget_seconds;
+  int num_threads;
+  // Shared by both branches: the branch that finishes first returns its cores,
+  // which are then lent to the sibling if it is an endgame still solving.
+  CoreLender *core_lender;
+  ErrorStack *error_stack;
+  PlayChooserBranchValue value;
+} PlayChooserMixedBranch;
+
+static void play_chooser_value_mixed_branch(PlayChooserMixedBranch *branch) {
+  branch->value = play_chooser_evaluate_position(
+      branch->play_chooser, branch->game, branch->eval, branch->budget_seconds,
+      branch->num_threads, branch->core_lender, branch->error_stack);
+  core_lender_release(branch->core_lender, branch->num_threads);
+}
+
+static void *play_chooser_mixed_branch_thread(void *arg) {
+  play_chooser_value_mixed_branch((PlayChooserMixedBranch *)arg);
+  return NULL;
+}
+
+// Decide a challenge whose branches are in different stages, one an endgame
+// and the other a sim or PEG, by valuing both concurrently over the whole
+// decision window on a split of the threads. The branches share a core
+// lender: when the sim or PEG finishes, its cores join the endgame solve, and
+// while a PEG stage drains, its idle pool workers do too. The sim and PEG
+// themselves cannot grow (the sim's BAI workers are fixed at its start and the
+// greedy PEG solves no endgames), so an endgame that finishes first only
+// returns its cores.
+static void play_chooser_decide_challenge_mixed(
+    PlayChooser *play_chooser, Game *keep_game, play_chooser_eval_t keep_eval,
+    Game *challenge_game, play_chooser_eval_t challenge_eval,
+    double decision_seconds, ChallengeDecision *decision,
+    ErrorStack *error_stack) {
+  const int total_threads =
+      play_chooser_get_num_threads(&play_chooser->strategy);
+  CoreLender *core_lender = core_lender_create(total_threads);
+  const int challenge_threads =
+      core_lender_acquire(core_lender, total_threads / 2);
+  const int keep_threads =
+      core_lender_acquire(core_lender, total_threads - challenge_threads);
+  ErrorStack *keep_error_stack = error_stack_create();
+  PlayChooserMixedBranch keep_branch = {
+      .play_chooser = play_chooser,
+      .game = keep_game,
+      .eval = keep_eval,
+      .budget_seconds = decision_seconds,
+      .num_threads = keep_threads,
+      .core_lender = core_lender,
+      .error_stack = keep_error_stack,
+      .value = PLAY_CHOOSER_BRANCH_INVALID,
+  };
+  PlayChooserMixedBranch challenge_branch = {
+      .play_chooser = play_chooser,
+      .game = challenge_game,
+      .eval = challenge_eval,
+      .budget_seconds = decision_seconds,
+      .num_threads = challenge_threads,
+      .core_lender = core_lender,
+      .error_stack = error_stack,
+      .value = PLAY_CHOOSER_BRANCH_INVALID,
+  };
+  cpthread_t keep_thread;
+  cpthread_create(&keep_thread, play_chooser_mixed_branch_thread,
+                  &keep_branch);
+  play_chooser_value_mixed_branch(&challenge_branch);
+  cpthread_join(keep_thread);
+  core_lender_destroy(core_lender);
+  play_chooser_push_keep_branch_errors(keep_error_stack, error_stack);
+  error_stack_destroy(keep_error_stack);
+  decision->keep_value = keep_branch.value.value;
+  decision->challenge_value = challenge_branch.value.value;
+  if (error_stack_is_empty(error_stack)) {
+    decision->should_challenge = play_chooser_should_challenge(
+        keep_branch.value, challenge_branch.value);
+  }
+}
+
 void play_chooser_decide_challenge(PlayChooser *play_chooser,
                                    const Game *game_before_move,
                                    const Move *opp_move,
@@ -1029,19 +1162,30 @@ void play_chooser_decide_challenge(PlayChooser *play_chooser,
     play_chooser_decide_challenge_endgame(play_chooser, keep_game,
                                           challenge_game, decision_seconds,
                                           decision, error_stack);
+  } else if (play_chooser_get_num_threads(strategy) > 1 &&
+             (keep_eval == PLAY_CHOOSER_EVAL_ENDGAME) !=
+                 (challenge_eval == PLAY_CHOOSER_EVAL_ENDGAME)) {
+    // An endgame against a sim or PEG: the two use separate scratch, so they
+    // run concurrently and the endgame absorbs the other branch's cores.
+    play_chooser_decide_challenge_mixed(play_chooser, keep_game, keep_eval,
+                                        challenge_game, challenge_eval,
+                                        decision_seconds, decision,
+                                        error_stack);
   } else {
-    // Mixed / non-endgame stages. Sequential, half the budget each: the SIM
-    // path uses the chooser's shared sim scratch, so two branches cannot be
-    // valued concurrently when either is a sim.
+    // Sequential, half the budget each, on all of the threads: the SIM path
+    // uses the chooser's shared sim scratch, so two sims cannot be valued
+    // concurrently, and with a single thread there is nothing to overlap.
     const double per_branch_seconds = decision_seconds / 2.0;
+    const int num_threads = play_chooser_get_num_threads(strategy);
     const PlayChooserBranchValue keep_bv = play_chooser_evaluate_position(
-        play_chooser, keep_game, keep_eval, per_branch_seconds, error_stack);
+        play_chooser, keep_game, keep_eval, per_branch_seconds, num_threads,
+        /*core_lender=*/NULL, error_stack);
     decision->keep_value = keep_bv.value;
     if (error_stack_is_empty(error_stack)) {
       const PlayChooserBranchValue challenge_bv =
-          play_chooser_evaluate_position(play_chooser, challenge_game,
-                                         challenge_eval, per_branch_seconds,
-                                         error_stack);
+          play_chooser_evaluate_position(
+              play_chooser, challenge_game, challenge_eval, per_branch_seconds,
+              num_threads, /*core_lender=*/NULL, error_stack);
       decision->challenge_value = challenge_bv.value;
       decision->should_challenge =
           play_chooser_should_challenge(keep_bv, challenge_bv);
@@ -129,6 +129,12 @@ typedef struct {
   const LetterDistribution *ld;
   int ld_size;
   uint8_t playthrough_min_played_size;
+  // When true, only the KLV-derived fields (leaves, best_leaves, best
+  // exchange and nonplaythrough_best_leave_values) are recomputed. The
+  // lexicon-derived fields already in the entry are left untouched and
+  // nonplaythrough_has_word_of_length_bitmask is used to skip WMP lookups
+  // for played sizes that have no word at all.
+  bool leaves_only;
   // Mutable state, updated as we recurse into a single rack.
   Rack *player_rack;
   Rack *leave;
@@ -235,7 +241,10 @@ static void compute_entry_recursive(EntryComputeState *state,
         // Replaces the per-movegen wmp_move_gen_check_nonplaythrough_
         // existence warmup that otherwise runs C(RACK_SIZE, k) WMP
         // lookups per size k on every movegen call.
-        if (played_size >= MINIMUM_WORD_LENGTH && played_size <= BOARD_DIM) {
+        if (played_size >= MINIMUM_WORD_LENGTH && played_size <= BOARD_DIM &&
+            (!state->leaves_only ||
+             (state->entry->nonplaythrough_has_word_of_length_bitmask &
+              (1U << played_size)) != 0)) {
           const WMPEntry *np_wmp_entry =
               wmp_get_word_entry(state->wmp, &played_bit_rack, played_size);
           if (np_wmp_entry != NULL) {
@@ -249,7 +258,8 @@ static void compute_entry_recursive(EntryComputeState *state,
           }
         }
 
-        if (played_size >= (int)state->playthrough_min_played_size) {
+        if (!state->leaves_only &&
+            played_size >= (int)state->playthrough_min_played_size) {
           const int word_length = played_size + 1;
           if (word_length >= MINIMUM_WORD_LENGTH && word_length <= BOARD_DIM) {
             // For each concrete letter L in the alphabet, ask the WMP
@@ -310,7 +320,7 @@ static void compute_entry_recursive(EntryComputeState *state,
 static void compute_entry_for_rack(const KLV *klv, const WMP *wmp,
                                    const LetterDistribution *ld,
                                    uint8_t playthrough_min_played_size,
-                                   const BitRack *bit_rack,
+                                   const BitRack *bit_rack, bool leaves_only,
                                    RackInfoTableEntry *entry) {
   const int ld_size = ld_get_size(ld);
 
@@ -340,17 +350,19 @@ static void compute_entry_for_rack(const KLV *klv, const WMP *wmp,
   rack_set_dist_size(&leave, ld_size);
   rack_reset(&leave);
 
+  if (!leaves_only) {
+    memset(entry->playthrough_union, 0,
+           RACK_INFO_TABLE_UNIONS_PER_ENTRY * sizeof(uint32_t));
+    memset(entry->multi_pt_tp7_bitvec, 0,
+           RIT_MULTI_PT_TP7_NUM_WORD_LENGTHS * sizeof(uint32_t));
+    memset(entry->multi_pt_tp6_bitvec, 0,
+           RIT_MULTI_PT_TP6_NUM_WORD_LENGTHS * sizeof(uint32_t));
+    entry->nonplaythrough_has_word_of_length_bitmask = 0;
+    memset(entry->pad, 0, sizeof(entry->pad));
+    entry->num_bingo_words = 0;
+    memset(entry->bingo_words, 0, sizeof(entry->bingo_words));
+  }
   memset(entry->leaves_packed, 0, RACK_INFO_TABLE_LEAVES_PACKED_BYTES);
-  memset(entry->playthrough_union, 0,
-         RACK_INFO_TABLE_UNIONS_PER_ENTRY * sizeof(uint32_t));
-  memset(entry->multi_pt_tp7_bitvec, 0,
-         RIT_MULTI_PT_TP7_NUM_WORD_LENGTHS * sizeof(uint32_t));
-  memset(entry->multi_pt_tp6_bitvec, 0,
-         RIT_MULTI_PT_TP6_NUM_WORD_LENGTHS * sizeof(uint32_t));
-  entry->nonplaythrough_has_word_of_length_bitmask = 0;
-  memset(entry->pad, 0, sizeof(entry->pad));
-  entry->num_bingo_words = 0;
-  memset(entry->bingo_words, 0, sizeof(entry->bingo_words));
   memset(entry->best_exchange_strip, 0, sizeof(entry->best_exchange_strip));
   entry->best_exchange_tiles_exchanged = 0;
   for (int leave_idx = 0;
@@ -369,6 +381,7 @@ static void compute_entry_for_rack(const KLV *klv, const WMP *wmp,
       .ld = ld,
       .ld_size = ld_size,
       .playthrough_min_played_size = playthrough_min_played_size,
+      .leaves_only = leaves_only,
       .player_rack = &player_rack,
       .leave = &leave,
       .leave_map = &leave_map,
@@ -391,8 +404,9 @@ static void compute_entry_for_rack(const KLV *klv, const WMP *wmp,
   }
 
   // Populate inline bingo words (nonplaythrough full-rack anagrams).
-  if (wmp != NULL && (entry->nonplaythrough_has_word_of_length_bitmask &
-                      (1U << RACK_SIZE)) != 0) {
+  const bool has_nonplaythrough_bingo =
+      entry->nonplaythrough_has_word_of_length_bitmask & (1U << RACK_SIZE);
+  if (!leaves_only && wmp != NULL && has_nonplaythrough_bingo) {
     BitRack full_bit_rack = bit_rack_create_from_rack(ld, &player_rack);
     MachineLetter buf[WMP_RESULT_BUFFER_SIZE];
     const int bytes =
@@ -798,6 +812,10 @@ typedef struct {
   const WMP *wmp;
   const LetterDistribution *ld;
   uint8_t playthrough_min_played_size;
+  bool leaves_only;
+  // When all_racks is NULL, rack_idx indexes entries directly and the rack
+  // is read back from the entry itself (used when refilling an existing
+  // table).
   const BitRack *all_racks;
   RackInfoTableEntry *entries;
   const uint32_t *entry_indices;
@@ -808,15 +826,64 @@ typedef struct {
 static void *compute_entries_thread(void *arg) {
   const EntryComputeArg *a = (const EntryComputeArg *)arg;
   for (uint32_t rack_idx = a->start; rack_idx < a->end; rack_idx++) {
+    if (a->all_racks == NULL) {
+      RackInfoTableEntry *entry = &a->entries[rack_idx];
+      const BitRack bit_rack = rack_info_table_entry_read_bit_rack(entry);
+      compute_entry_for_rack(a->klv, a->wmp, a->ld,
+                             a->playthrough_min_played_size, &bit_rack,
+                             a->leaves_only, entry);
+      continue;
+    }
     const uint32_t entry_idx = a->entry_indices[rack_idx];
     RackInfoTableEntry *entry = &a->entries[entry_idx];
     compute_entry_for_rack(a->klv, a->wmp, a->ld,
                            a->playthrough_min_played_size,
-                           &a->all_racks[rack_idx], entry);
+                           &a->all_racks[rack_idx], a->leaves_only, entry);
   }
   return NULL;
 }
 
+// Runs compute_entries_thread over [0, total_racks) split into
+// num_threads contiguous chunks. template_arg supplies every field except
+// start and end.
+static void compute_entries(const EntryComputeArg *template_arg,
+                            uint32_t total_racks, int num_threads) {
+  if (num_threads == 1 || total_racks < (uint32_t)num_threads) {
+    EntryComputeArg arg = *template_arg;
+    arg.start = 0;
+    arg.end = total_racks;
+    compute_entries_thread(&arg);
+    return;
+  }
+  cpthread_t *threads = malloc_or_die((size_t)num_threads * sizeof(cpthread_t));
+  EntryComputeArg *args =
+      malloc_or_die((size_t)num_threads * sizeof(EntryComputeArg));
+
+  const uint32_t chunk = total_racks / (uint32_t)num_threads;
+  uint32_t remainder = total_racks % (uint32_t)num_threads;
+
+  uint32_t start = 0;
+  for (int thread_idx = 0; thread_idx < num_threads; thread_idx++) {
+    uint32_t this_chunk = chunk + (remainder > 0 ? 1 : 0);
+    if (remainder > 0) {
+      remainder--;
+    }
+    args[thread_idx] = *template_arg;
+    args[thread_idx].start = start;
+    args[thread_idx].end = start + this_chunk;
+    cpthread_create(&threads[thread_idx], compute_entries_thread,
+                    &args[thread_idx]);
+    start += this_chunk;
+  }
+
+  for (int thread_idx = 0; thread_idx < num_threads; thread_idx++) {
+    cpthread_join(threads[thread_idx]);
+  }
+
+  free(threads);
+  free(args);
+}
+
 // ============================================================================
 // Main construction function
 // ============================================================================
@@ -901,57 +968,17 @@ RackInfoTable *make_rack_info_table(const KLV *klv, const WMP *wmp,
   free(bucket_counts);
 
   // 6. Compute per-entry data (parallel)
-  if (num_threads == 1 || total_racks < (uint32_t)num_threads) {
-    EntryComputeArg arg = {
-        .klv = klv,
-        .wmp = wmp,
-        .ld = ld,
-        .playthrough_min_played_size = effective_min,
-        .all_racks = all_racks,
-        .entries = entries,
-        .entry_indices = entry_indices,
-        .start = 0,
-        .end = total_racks,
-    };
-    compute_entries_thread(&arg);
-  } else {
-    cpthread_t *threads =
-        malloc_or_die((size_t)num_threads * sizeof(cpthread_t));
-    EntryComputeArg *args =
-        malloc_or_die((size_t)num_threads * sizeof(EntryComputeArg));
-
-    const uint32_t chunk = total_racks / (uint32_t)num_threads;
-    uint32_t remainder = total_racks % (uint32_t)num_threads;
-
-    uint32_t start = 0;
-    for (int thread_idx = 0; thread_idx < num_threads; thread_idx++) {
-      uint32_t this_chunk = chunk + (remainder > 0 ? 1 : 0);
-      if (remainder > 0) {
-        remainder--;
-      }
-      args[thread_idx] = (EntryComputeArg){
-          .klv = klv,
-          .wmp = wmp,
-          .ld = ld,
-          .playthrough_min_played_size = effective_min,
-          .all_racks = all_racks,
-          .entries = entries,
-          .entry_indices = entry_indices,
-          .start = start,
-          .end = start + this_chunk,
-      };
-      cpthread_create(&threads[thread_idx], compute_entries_thread,
-                      &args[thread_idx]);
-      start += this_chunk;
-    }
-
-    for (int thread_idx = 0; thread_idx < num_threads; thread_idx++) {
-      cpthread_join(threads[thread_idx]);
-    }
-
-    free(threads);
-    free(args);
-  }
+  const EntryComputeArg template_arg = {
+      .klv = klv,
+      .wmp = wmp,
+      .ld = ld,
+      .playthrough_min_played_size = effective_min,
+      .leaves_only = false,
+      .all_racks = all_racks,
+      .entries = entries,
+      .entry_indices = entry_indices,
+  };
+  compute_entries(&template_arg, total_racks, num_threads);
 
   free(entry_indices);
   free(all_racks);
@@ -978,3 +1005,26 @@ RackInfoTable *make_rack_info_table(const KLV *klv, const WMP *wmp,
 
   return rit;
 }
+
+void rack_info_table_refill_leaves(RackInfoTable *rit, const KLV *klv,
+                                   const WMP *wmp, const LetterDistribution *ld,
+                                   int num_threads) {
+  if (num_threads <= 0) {
+    num_threads = 1;
+  }
+  if (rit->num_entries == 0) {
+    return;
+  }
+  rack_info_table_make_writable(rit);
+  const EntryComputeArg template_arg = {
+      .klv = klv,
+      .wmp = wmp,
+      .ld = ld,
+      .playthrough_min_played_size = rit->playthrough_min_played_size,
+      .leaves_only = true,
+      .all_racks = NULL,
+      .entries = rit->entries,
+      .entry_indices = NULL,
+  };
+  compute_entries(&template_arg, rit->num_entries, num_threads);
+}
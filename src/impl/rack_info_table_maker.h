@@ -28,4 +28,18 @@ RackInfoTable *make_rack_info_table(const KLV *klv, const WMP *wmp,
                                     int num_threads,
                                     uint8_t playthrough_min_played_size);
 
+// Recompute only the KLV-derived fields of an existing table (packed
+// leaves, best_leaves, the best exchange and the nonplaythrough best leave
+// values) from a new KLV, keeping everything that depends only on the
+// lexicon. This is much cheaper than a full rebuild: no playthrough
+// probes, bingo words or multi-playthrough bitvecs are recomputed, and
+// nonplaythrough word lookups are limited to the played sizes the entry
+// already knows to have a word. The result is identical to
+// make_rack_info_table with the new KLV provided the WMP (or NULL) is the
+// one the table was built with. A memory-mapped table is first copied
+// into owned memory.
+void rack_info_table_refill_leaves(RackInfoTable *rit, const KLV *klv,
+                                   const WMP *wmp, const LetterDistribution *ld,
+                                   int num_threads);
+
 #endif
@@ -13,6 +13,7 @@
 #include "../ent/player.h"
 #include "../ent/rack.h"
 #include "../ent/sim_args.h"
+#include "../ent/sim_reply_cache.h"
 #include "../ent/sim_results.h"
 #include "../ent/thread_control.h"
 #include "../ent/win_pct.h"
@@ -375,6 +376,7 @@ typedef struct SimmerWorker {
   Game *game;
   MoveList *move_list;
   XoshiroPRNG *prng;
+  SimPlyStatsShard *ply_stats_shard;
 } SimmerWorker;
 
 typedef struct Simmer {
@@ -398,6 +400,14 @@ typedef struct Simmer {
   int print_interval;
   int max_num_display_plays;
   int max_num_display_plies;
+  // The per ply stats are collected for one in every ply_stats_rate
+  // rollouts, picked by their seeds.
+  int ply_stats_rate;
+  // When sharing rollouts, the moves found in the rollouts are shared through
+  // the reply cache, which is kept across resets. Sharing does not change
+  // which arms are similar, so BAI samples the same way with or without it.
+  bool share_rollouts;
+  SimReplyCache *reply_cache;
   // Utility blend weights consumed by rv_sim_sample (see sim_utility_blend
   // in sim_args.h). Copied from SimArgs on create/reset.
   double utility_w_winpct;
@@ -413,6 +423,7 @@ SimmerWorker *simmer_create_worker(const Game *game) {
   game_set_backup_mode(simmer_worker->game, BACKUP_MODE_SIMULATION);
   simmer_worker->move_list = move_list_create(1);
   simmer_worker->prng = prng_create(0);
+  simmer_worker->ply_stats_shard = sim_ply_stats_shard_create();
   return simmer_worker;
 }
 
@@ -427,9 +438,50 @@ void simmer_worker_destroy(SimmerWorker *simmer_worker) {
   game_destroy(simmer_worker->game);
   move_list_destroy(simmer_worker->move_list);
   prng_destroy(simmer_worker->prng);
+  sim_ply_stats_shard_destroy(simmer_worker->ply_stats_shard);
   free(simmer_worker);
 }
 
+static void simmer_reset_share_rollouts(Simmer *simmer,
+                                        const SimArgs *sim_args) {
+  simmer->share_rollouts = sim_args->share_rollouts;
+  if (!simmer->share_rollouts) {
+    return;
+  }
+  if (simmer->reply_cache) {
+    sim_reply_cache_reset(simmer->reply_cache);
+  } else {
+    simmer->reply_cache = sim_reply_cache_create(sim_args->seed);
+  }
+}
+
+// Returns the top equity move of the player on turn, from the reply cache
+// when sharing rollouts and another rollout has already reached the position,
+// in which case it is copied into shared_move.
+static const Move *simmer_get_top_equity_move(const Simmer *simmer,
+                                              Game *game, MoveList *move_list,
+                                              Move *shared_move) {
+  if (!simmer->share_rollouts) {
+    return get_top_equity_move(game, move_list);
+  }
+  const uint64_t key = sim_reply_cache_get_key(simmer->reply_cache, game);
+  if (sim_reply_cache_lookup(simmer->reply_cache, key, shared_move)) {
+    sim_results_increment_shared_reply_count(simmer->sim_results);
+    return shared_move;
+  }
+  const Move *move = get_top_equity_move(game, move_list);
+  sim_reply_cache_store(simmer->reply_cache, key, move);
+  return move;
+}
+
+static void simmer_reset_ply_stats_shards(Simmer *simmer, bool use_heat_map) {
+  for (int thread_index = 0; thread_index < simmer->num_threads;
+       thread_index++) {
+    sim_ply_stats_shard_reset(simmer->workers[thread_index]->ply_stats_shard,
+                              simmer->sim_results, use_heat_map);
+  }
+}
+
 double rv_sim_sample(RandomVariables *rvs, const uint64_t play_index,
                      const int thread_index, const uint64_t sample_count,
                      BAILogger __attribute__((unused)) * bai_logger) {
@@ -457,6 +509,9 @@ double rv_sim_sample(RandomVariables *rvs, const uint64_t play_index,
   // This will shuffle the bag, so there is no need
   // to call bag_shuffle explicitly.
   const uint64_t seed = simmed_play_get_seed(simmed_play);
+  // Picking by seed rather than by sample count keeps the collected rollouts
+  // independent of how the samples are spread over the threads.
+  const bool collect_ply_stats = seed % (uint64_t)simmer->ply_stats_rate == 0;
   prng_seed(simmer_worker->prng, seed);
   game_seed(game, seed);
 
@@ -498,6 +553,7 @@ double rv_sim_sample(RandomVariables *rvs, const uint64_t play_index,
   game_set_backup_mode(game, BACKUP_MODE_OFF);
   // further plies will NOT be backed up.
   Rack spare_rack;
+  Move shared_move;
   for (int ply = 0; ply < plies; ply++) {
     const int player_on_turn_index = game_get_player_on_turn_index(game);
     const Player *player_on_turn = game_get_player(game, player_on_turn_index);
@@ -506,7 +562,8 @@ double rv_sim_sample(RandomVariables *rvs, const uint64_t play_index,
       break;
     }
 
-    const Move *best_play = get_top_equity_move(game, move_list);
+    const Move *best_play =
+        simmer_get_top_equity_move(simmer, game, move_list, &shared_move);
     rack_copy(&spare_rack, player_get_rack(player_on_turn));
 
     // On the final ply the resulting cross-sets are never read (no further move
@@ -527,7 +584,14 @@ double rv_sim_sample(RandomVariables *rvs, const uint64_t play_index,
         leftover -= this_leftover;
       }
     }
-    simmed_play_add_stats_for_ply(simmed_play, ply, best_play);
+    if (collect_ply_stats) {
+      sim_ply_stats_shard_add_stats_for_ply(simmer_worker->ply_stats_shard,
+                                            (int)play_index, ply, best_play);
+    }
+  }
+  if (collect_ply_stats) {
+    sim_ply_stats_shard_finish_rollout(simmer_worker->ply_stats_shard,
+                                       sim_results, (int)play_index);
   }
 
   const Equity spread =
@@ -549,6 +613,7 @@ double rv_sim_sample(RandomVariables *rvs, const uint64_t play_index,
 
   if (simmer->print_interval > 0 &&
       sample_count % simmer->print_interval == 0) {
+    sim_ply_stats_shard_merge(simmer_worker->ply_stats_shard, sim_results);
     sim_results_print(simmer->thread_control, simmer_worker->game,
                       simmer->sim_results, simmer->max_num_display_plays,
                       simmer->max_num_display_plies, true, false, NULL);
@@ -587,6 +652,7 @@ void rv_sim_destroy(RandomVariables *rvs) {
     simmer_worker_destroy(simmer->workers[thread_index]);
   }
   free(simmer->workers);
+  sim_reply_cache_destroy(simmer->reply_cache);
   free(simmer);
 }
 
@@ -626,6 +692,9 @@ RandomVariables *rv_sim_create(RandomVariables *rvs, const SimArgs *sim_args,
   simmer->print_interval = sim_args->print_interval;
   simmer->max_num_display_plays = sim_args->max_num_display_plays;
   simmer->max_num_display_plies = sim_args->max_num_display_plies;
+  simmer->ply_stats_rate = sim_args->ply_stats_rate;
+  simmer->reply_cache = NULL;
+  simmer_reset_share_rollouts(simmer, sim_args);
 
   simmer->workers =
       malloc_or_die((sizeof(SimmerWorker *)) * (simmer->num_threads));
@@ -650,6 +719,7 @@ RandomVariables *rv_sim_create(RandomVariables *rvs, const SimArgs *sim_args,
   sim_results_reset(sim_args->move_list, sim_results, sim_args->num_plies,
                     sim_args->seed, sim_args->use_heat_map);
   simmer->sim_results = sim_results;
+  simmer_reset_ply_stats_shards(simmer, sim_args->use_heat_map);
 
   rvs->data = simmer;
   return rvs;
@@ -697,9 +767,22 @@ void rv_sim_reset(RandomVariables *rvs, const SimArgs *sim_args) {
   simmer->utility_w_spread = sim_args->utility_w_spread;
   simmer->utility_spread_scale = sim_args->utility_spread_scale;
 
+  simmer->ply_stats_rate = sim_args->ply_stats_rate;
+  simmer_reset_share_rollouts(simmer, sim_args);
+
   sim_results_reset(sim_args->move_list, simmer->sim_results,
                     sim_args->num_plies, sim_args->seed,
                     sim_args->use_heat_map);
+  simmer_reset_ply_stats_shards(simmer, sim_args->use_heat_map);
+}
+
+void rv_sim_merge_ply_stats(RandomVariables *rvs) {
+  Simmer *simmer = (Simmer *)rvs->data;
+  for (int thread_index = 0; thread_index < simmer->num_threads;
+       thread_index++) {
+    sim_ply_stats_shard_merge(simmer->workers[thread_index]->ply_stats_shard,
+                              simmer->sim_results);
+  }
 }
 
 RandomVariables *rvs_create(const RandomVariablesArgs *rvs_args) {
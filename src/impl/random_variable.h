@@ -43,5 +43,8 @@ bool rvs_are_similar(RandomVariables *rvs, int i, int j);
 uint64_t rvs_get_num_rvs(const RandomVariables *rvs);
 uint64_t rvs_get_total_samples(const RandomVariables *rvs);
 int rvs_get_best_arm_index(const RandomVariables *rvs);
+// Merges the per ply stats the sim workers have not merged yet into the sim
+// results. Only for RANDOM_VARIABLES_SIMMED_PLAYS and while no worker runs.
+void rv_sim_merge_ply_stats(RandomVariables *rvs);
 
 #endif
\ No newline at end of file
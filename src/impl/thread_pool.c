@@ -0,0 +1,220 @@
+// pthread_setaffinity_np and the CPU_SET macros are GNU extensions.
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "thread_pool.h"
+
+#include "../compat/cpthread.h"
+#include "../compat/memory_info.h"
+#include "../def/cpthread_defs.h"
+#include "../ent/perf_counters.h"
+#include "../util/io_util.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+struct ThreadPoolThread {
+  cpthread_t thread_id;
+  // Guards the routine handoff below and is waited on by both the pool
+  // thread, for a routine, and the joiner, for its completion.
+  cpthread_mutex_t mutex;
+  cpthread_cond_t cond;
+  void *(*start_routine)(void *);
+  void *arg;
+  bool has_routine;
+  bool routine_done;
+  bool exit_requested;
+  // Creation order of the thread, which picks its core when pinned.
+  int index;
+  // Stack size the thread was created with, 0 for the default.
+  size_t stack_bytes;
+  bool is_pinned;
+  ThreadPoolThread *next_parked;
+};
+
+static cpthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER; // NOLINT
+static ThreadPoolThread *parked_threads = NULL;
+static int num_threads = 0;
+static atomic_bool pin_threads = false;
+
+enum { THREAD_POOL_MAX_PARK_HOOKS = 4 };
+static void (*park_hooks[THREAD_POOL_MAX_PARK_HOOKS])(void);
+static int num_park_hooks = 0;
+
+static void thread_pool_thread_update_affinity(ThreadPoolThread *thread) {
+  const bool should_pin = atomic_load(&pin_threads);
+  if (thread->is_pinned == should_pin) {
+    return;
+  }
+  thread->is_pinned = should_pin;
+#if defined(__linux__)
+  const int num_cores = get_num_cores();
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  if (should_pin) {
+    CPU_SET(thread->index % num_cores, &cpu_set);
+  } else {
+    for (int core = 0; core < num_cores; core++) {
+      CPU_SET(core, &cpu_set);
+    }
+  }
+  // Affinity is only a placement hint, so a refusal is not an error.
+  (void)pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+#endif
+}
+
+// Returns the per thread slots the finished routine acquired, so that parked
+// threads hold none.
+static void thread_pool_thread_release_slots(void) {
+  void (*hooks[THREAD_POOL_MAX_PARK_HOOKS])(void);
+  cpthread_mutex_lock(&pool_mutex);
+  const int num_hooks = num_park_hooks;
+  for (int i = 0; i < num_hooks; i++) {
+    hooks[i] = park_hooks[i];
+  }
+  cpthread_mutex_unlock(&pool_mutex);
+  for (int i = 0; i < num_hooks; i++) {
+    hooks[i]();
+  }
+  perf_counters_release_thread_slot();
+}
+
+static void *thread_pool_thread_main(void *uncasted_thread) {
+  ThreadPoolThread *thread = (ThreadPoolThread *)uncasted_thread;
+  cpthread_mutex_lock(&thread->mutex);
+  while (true) {
+    while (!thread->has_routine && !thread->exit_requested) {
+      cpthread_cond_wait(&thread->cond, &thread->mutex);
+    }
+    if (!thread->has_routine) {
+      break;
+    }
+    void *(*start_routine)(void *) = thread->start_routine;
+    void *arg = thread->arg;
+    cpthread_mutex_unlock(&thread->mutex);
+    thread_pool_thread_update_affinity(thread);
+    start_routine(arg);
+    thread_pool_thread_release_slots();
+    cpthread_mutex_lock(&thread->mutex);
+    thread->has_routine = false;
+    thread->routine_done = true;
+    cpthread_cond_broadcast(&thread->cond);
+  }
+  cpthread_mutex_unlock(&thread->mutex);
+  return NULL;
+}
+
+static ThreadPoolThread *thread_pool_thread_create(int index,
+                                                   size_t stack_bytes) {
+  ThreadPoolThread *thread = calloc_or_die(1, sizeof(ThreadPoolThread));
+  cpthread_mutex_init(&thread->mutex);
+  cpthread_cond_init(&thread->cond);
+  thread->index = index;
+  thread->stack_bytes = stack_bytes;
+  if (stack_bytes > 0) {
+    cpthread_create_with_stack(&thread->thread_id, thread_pool_thread_main,
+                               thread, stack_bytes);
+  } else {
+    cpthread_create(&thread->thread_id, thread_pool_thread_main, thread);
+  }
+  return thread;
+}
+
+// Removes and returns a parked thread whose stack is at least stack_bytes
+// large, or returns NULL if there is none. Requires the pool mutex.
+static ThreadPoolThread *thread_pool_unpark(size_t stack_bytes) {
+  ThreadPoolThread **link = &parked_threads;
+  while (*link && (*link)->stack_bytes < stack_bytes) {
+    link = &(*link)->next_parked;
+  }
+  ThreadPoolThread *thread = *link;
+  if (thread) {
+    *link = thread->next_parked;
+  }
+  return thread;
+}
+
+ThreadPoolThread *thread_pool_start(void *(*start_routine)(void *),
+                                    void *arg) {
+  return thread_pool_start_with_stack(start_routine, arg, 0);
+}
+
+ThreadPoolThread *thread_pool_start_with_stack(void *(*start_routine)(void *),
+                                               void *arg, size_t stack_bytes) {
+  cpthread_mutex_lock(&pool_mutex);
+  ThreadPoolThread *thread = thread_pool_unpark(stack_bytes);
+  if (!thread) {
+    thread = thread_pool_thread_create(num_threads++, stack_bytes);
+  }
+  cpthread_mutex_unlock(&pool_mutex);
+  thread->next_parked = NULL;
+
+  cpthread_mutex_lock(&thread->mutex);
+  thread->start_routine = start_routine;
+  thread->arg = arg;
+  thread->has_routine = true;
+  thread->routine_done = false;
+  cpthread_cond_broadcast(&thread->cond);
+  cpthread_mutex_unlock(&thread->mutex);
+  return thread;
+}
+
+void thread_pool_join(ThreadPoolThread *thread) {
+  cpthread_mutex_lock(&thread->mutex);
+  while (!thread->routine_done) {
+    cpthread_cond_wait(&thread->cond, &thread->mutex);
+  }
+  thread->routine_done = false;
+  cpthread_mutex_unlock(&thread->mutex);
+
+  cpthread_mutex_lock(&pool_mutex);
+  thread->next_parked = parked_threads;
+  parked_threads = thread;
+  cpthread_mutex_unlock(&pool_mutex);
+}
+
+void thread_pool_add_park_hook(void (*park_hook)(void)) {
+  cpthread_mutex_lock(&pool_mutex);
+  if (num_park_hooks == THREAD_POOL_MAX_PARK_HOOKS) {
+    cpthread_mutex_unlock(&pool_mutex);
+    log_fatal("more than %d thread pool park hooks",
+              THREAD_POOL_MAX_PARK_HOOKS);
+  }
+  park_hooks[num_park_hooks++] = park_hook;
+  cpthread_mutex_unlock(&pool_mutex);
+}
+
+void thread_pool_set_cpu_affinity(bool should_pin_threads) {
+  atomic_store(&pin_threads, should_pin_threads);
+}
+
+int thread_pool_get_num_threads(void) {
+  cpthread_mutex_lock(&pool_mutex);
+  const int count = num_threads;
+  cpthread_mutex_unlock(&pool_mutex);
+  return count;
+}
+
+void thread_pool_destroy(void) {
+  cpthread_mutex_lock(&pool_mutex);
+  ThreadPoolThread *thread = parked_threads;
+  parked_threads = NULL;
+  while (thread) {
+    ThreadPoolThread *next_thread = thread->next_parked;
+    cpthread_mutex_lock(&thread->mutex);
+    thread->exit_requested = true;
+    cpthread_cond_broadcast(&thread->cond);
+    cpthread_mutex_unlock(&thread->mutex);
+    cpthread_join(thread->thread_id);
+    free(thread);
+    num_threads--;
+    thread = next_thread;
+  }
+  cpthread_mutex_unlock(&pool_mutex);
+}
@@ -0,0 +1,49 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Process wide pool of persistent threads shared by every engine that runs a
+// fixed set of workers per call (simulation, inference, endgame, autoplay,
+// split move generation). thread_pool_start and thread_pool_join are drop in
+// replacements for cpthread_create and cpthread_join: the routine runs on a
+// parked pool thread when one is free, and on a newly created one otherwise,
+// so every started routine runs concurrently with the others and workers that
+// wait on each other (checkpoints, barriers) cannot deadlock. A joined thread
+// parks instead of exiting, which keeps the caches of the core it last ran
+// on warm for the next call. Before parking it returns its MoveGen and perf
+// counter slots, so the pool only holds slots for running routines and
+// threads created outside of it can use the rest.
+typedef struct ThreadPoolThread ThreadPoolThread;
+
+// Runs start_routine(arg) on a pool thread. The returned handle must be
+// passed to thread_pool_join exactly once.
+ThreadPoolThread *thread_pool_start(void *(*start_routine)(void *), void *arg);
+
+// Same as thread_pool_start, on a thread with a stack of at least
+// stack_bytes.
+ThreadPoolThread *thread_pool_start_with_stack(void *(*start_routine)(void *),
+                                               void *arg, size_t stack_bytes);
+
+// Waits for the routine started on the thread to return and parks the thread
+// for reuse.
+void thread_pool_join(ThreadPoolThread *thread);
+
+// Registers a function that each pool thread calls after every routine,
+// before it parks, to return the per thread state it acquired.
+void thread_pool_add_park_hook(void (*park_hook)(void));
+
+// Pins each pool thread to one core, round robin by the order in which the
+// threads were created, from their next routine on. Only supported on Linux;
+// elsewhere the setting is ignored. Off by default.
+void thread_pool_set_cpu_affinity(bool pin_threads);
+
+// Returns the number of threads the pool has created, parked or running.
+int thread_pool_get_num_threads(void);
+
+// Ends and joins the parked threads. Must not be called while a routine is
+// running on a pool thread. The pool can still be used afterward.
+void thread_pool_destroy(void);
+
+#endif
@@ -17,6 +17,7 @@
 #include <assert.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -533,6 +534,442 @@ static void *build_words_and_extract_racks(void *arg) {
   return NULL;
 }
 
+// ============================================================================
+// External-memory blank phases
+//
+// With a memory limit set, the blank and double-blank phases no longer
+// materialize every (rack, letter bit) pair at once. Pairs are generated into
+// a bounded chunk; each full chunk is radix sorted, collapsed to one record
+// per rack (letter bits OR'd together) and spilled to a temp file as a sorted
+// run. The runs are then k-way merged, collapsing equal racks again, into a
+// sorted stream of unique racks from which the final entries are bucketed.
+// If every pair fits in the first chunk nothing touches the disk.
+//
+// Both phases only need the OR of a single letter bit per rack (the blank
+// letter for single blanks, the first blank letter for double blanks), so
+// they share BlankPair as their record type.
+// ============================================================================
+
+// Floor on chunk size so a very small limit yields more runs, not empty ones
+enum { MIN_SPILL_CHUNK_PAIRS = 1024 };
+
+typedef struct {
+  FILE *file;
+  BlankPair *chunk;
+  BlankPair *temp;
+  uint32_t chunk_capacity;
+  uint32_t chunk_count;
+  int radix_passes;
+  // Runs are stored back to back in file; offsets and lengths are in records
+  uint64_t *run_offsets;
+  uint64_t *run_lengths;
+  int num_runs;
+  int run_capacity;
+  uint64_t num_file_records;
+} PairSpiller;
+
+// Collapses a sorted array in place so that each rack appears once with the
+// OR of its letter bits. Returns the number of unique racks.
+static uint32_t collapse_sorted_blank_pairs(BlankPair *pairs, uint32_t count) {
+  if (count == 0) {
+    return 0;
+  }
+  uint32_t num_unique = 1;
+  for (uint32_t i = 1; i < count; i++) {
+    if (bit_rack_equals(&pairs[i].bit_rack,
+                        &pairs[num_unique - 1].bit_rack)) {
+      pairs[num_unique - 1].blank_letter_bit |= pairs[i].blank_letter_bit;
+    } else {
+      pairs[num_unique++] = pairs[i];
+    }
+  }
+  return num_unique;
+}
+
+static FILE *create_spill_file(void) {
+  FILE *file = tmpfile();
+  if (!file) {
+    log_fatal("failed to create temporary file for wordmap construction");
+  }
+  return file;
+}
+
+static void pair_spiller_flush_run(PairSpiller *spiller) {
+  if (spiller->chunk_count == 0) {
+    return;
+  }
+  radix_sort_blank_pairs(spiller->chunk, spiller->temp, spiller->chunk_count,
+                         spiller->radix_passes);
+  const uint32_t num_unique =
+      collapse_sorted_blank_pairs(spiller->chunk, spiller->chunk_count);
+  if (!spiller->file) {
+    spiller->file = create_spill_file();
+  }
+  if (spiller->num_runs == spiller->run_capacity) {
+    spiller->run_capacity *= 2;
+    spiller->run_offsets = realloc_or_die(
+        spiller->run_offsets, spiller->run_capacity * sizeof(uint64_t));
+    spiller->run_lengths = realloc_or_die(
+        spiller->run_lengths, spiller->run_capacity * sizeof(uint64_t));
+  }
+  fwrite_or_die(spiller->chunk, sizeof(BlankPair), num_unique, spiller->file,
+                "wordmap spill run");
+  spiller->run_offsets[spiller->num_runs] = spiller->num_file_records;
+  spiller->run_lengths[spiller->num_runs] = num_unique;
+  spiller->num_runs++;
+  spiller->num_file_records += num_unique;
+  spiller->chunk_count = 0;
+}
+
+static inline void pair_spiller_add(PairSpiller *spiller,
+                                    const BitRack *bit_rack,
+                                    uint32_t letter_bit) {
+  BlankPair *pair = &spiller->chunk[spiller->chunk_count++];
+  pair->bit_rack = *bit_rack;
+  pair->blank_letter_bit = letter_bit;
+  if (spiller->chunk_count == spiller->chunk_capacity) {
+    pair_spiller_flush_run(spiller);
+  }
+}
+
+// Sequential reader over a sorted stream of unique (rack, letter bits)
+// records, which either still sit in memory or were merged to a file.
+typedef struct {
+  FILE *file;
+  const BlankPair *records;
+  BlankPair *buffer;
+  uint32_t buffer_capacity;
+  uint32_t num_records;
+  uint32_t num_read;
+} UniquePairReader;
+
+static void unique_pair_reader_rewind(UniquePairReader *reader) {
+  reader->num_read = 0;
+  if (reader->file) {
+    fseek_or_die(reader->file, 0, SEEK_SET);
+  }
+}
+
+// Returns the number of records in the next block, 0 when exhausted
+static uint32_t unique_pair_reader_next_block(UniquePairReader *reader,
+                                              const BlankPair **block) {
+  const uint32_t remaining = reader->num_records - reader->num_read;
+  if (remaining == 0) {
+    return 0;
+  }
+  if (!reader->file) {
+    *block = reader->records;
+    reader->num_read = reader->num_records;
+    return remaining;
+  }
+  const uint32_t n = remaining < reader->buffer_capacity
+                         ? remaining
+                         : reader->buffer_capacity;
+  if (fread(reader->buffer, sizeof(BlankPair), n, reader->file) != n) {
+    log_fatal("failed to read merged wordmap spill records");
+  }
+  *block = reader->buffer;
+  reader->num_read += n;
+  return n;
+}
+
+static inline bool bit_rack_less_than(const BitRack *a, const BitRack *b) {
+  const uint64_t a_high = bit_rack_get_high_64(a);
+  const uint64_t b_high = bit_rack_get_high_64(b);
+  if (a_high != b_high) {
+    return a_high < b_high;
+  }
+  return bit_rack_get_low_64(a) < bit_rack_get_low_64(b);
+}
+
+typedef struct {
+  BlankPair *buffer;
+  uint32_t buffer_capacity;
+  uint32_t buffer_count;
+  uint32_t buffer_pos;
+  uint64_t next_offset;
+  uint64_t remaining;
+} SpillRunCursor;
+
+static bool spill_run_cursor_refill(SpillRunCursor *cursor, FILE *file) {
+  if (cursor->remaining == 0) {
+    return false;
+  }
+  const uint32_t n = cursor->remaining < cursor->buffer_capacity
+                         ? (uint32_t)cursor->remaining
+                         : cursor->buffer_capacity;
+  fseek_or_die(file, (long)(cursor->next_offset * sizeof(BlankPair)),
+               SEEK_SET);
+  if (fread(cursor->buffer, sizeof(BlankPair), n, file) != n) {
+    log_fatal("failed to read wordmap spill run");
+  }
+  cursor->buffer_count = n;
+  cursor->buffer_pos = 0;
+  cursor->next_offset += n;
+  cursor->remaining -= n;
+  return true;
+}
+
+static inline const BitRack *spill_run_cursor_head(const SpillRunCursor *c) {
+  return &c->buffer[c->buffer_pos].bit_rack;
+}
+
+static void spill_heap_sift_down(int *heap, int heap_size, int pos,
+                                 const SpillRunCursor *cursors) {
+  for (;;) {
+    int smallest = pos;
+    const int left = 2 * pos + 1;
+    const int right = left + 1;
+    if (left < heap_size &&
+        bit_rack_less_than(spill_run_cursor_head(&cursors[heap[left]]),
+                           spill_run_cursor_head(&cursors[heap[smallest]]))) {
+      smallest = left;
+    }
+    if (right < heap_size &&
+        bit_rack_less_than(spill_run_cursor_head(&cursors[heap[right]]),
+                           spill_run_cursor_head(&cursors[heap[smallest]]))) {
+      smallest = right;
+    }
+    if (smallest == pos) {
+      return;
+    }
+    const int tmp = heap[pos];
+    heap[pos] = heap[smallest];
+    heap[smallest] = tmp;
+    pos = smallest;
+  }
+}
+
+// K-way merges the spilled runs into a new temp file of unique racks, using
+// the spiller's temp buffer for run input and its chunk buffer for output.
+// Returns the merged file, positioned at its start.
+static FILE *pair_spiller_merge_runs(PairSpiller *spiller,
+                                     uint32_t *num_unique) {
+  const int num_runs = spiller->num_runs;
+  uint32_t slice = spiller->chunk_capacity / (uint32_t)num_runs;
+  if (slice == 0) {
+    slice = 1;
+    spiller->temp = realloc_or_die(spiller->temp,
+                                   (size_t)num_runs * sizeof(BlankPair));
+  }
+  SpillRunCursor *cursors = malloc_or_die(num_runs * sizeof(SpillRunCursor));
+  int *heap = malloc_or_die(num_runs * sizeof(int));
+  int heap_size = 0;
+  for (int i = 0; i < num_runs; i++) {
+    cursors[i].buffer = spiller->temp + (size_t)i * slice;
+    cursors[i].buffer_capacity = slice;
+    cursors[i].next_offset = spiller->run_offsets[i];
+    cursors[i].remaining = spiller->run_lengths[i];
+    if (spill_run_cursor_refill(&cursors[i], spiller->file)) {
+      heap[heap_size++] = i;
+    }
+  }
+  for (int i = heap_size / 2 - 1; i >= 0; i--) {
+    spill_heap_sift_down(heap, heap_size, i, cursors);
+  }
+
+  FILE *merged = create_spill_file();
+  BlankPair *out = spiller->chunk;
+  uint32_t out_count = 0;
+  uint32_t total_unique = 0;
+  while (heap_size > 0) {
+    SpillRunCursor *cursor = &cursors[heap[0]];
+    const BlankPair *pair = &cursor->buffer[cursor->buffer_pos];
+    if (out_count > 0 &&
+        bit_rack_equals(&out[out_count - 1].bit_rack, &pair->bit_rack)) {
+      out[out_count - 1].blank_letter_bit |= pair->blank_letter_bit;
+    } else {
+      // Records come out in sorted order, so a new rack finalizes the
+      // buffered ones
+      if (out_count == spiller->chunk_capacity) {
+        fwrite_or_die(out, sizeof(BlankPair), out_count, merged,
+                      "wordmap merged spill");
+        out_count = 0;
+      }
+      out[out_count++] = *pair;
+      total_unique++;
+    }
+    cursor->buffer_pos++;
+    if (cursor->buffer_pos == cursor->buffer_count &&
+        !spill_run_cursor_refill(cursor, spiller->file)) {
+      heap[0] = heap[--heap_size];
+    }
+    spill_heap_sift_down(heap, heap_size, 0, cursors);
+  }
+  fwrite_or_die(out, sizeof(BlankPair), out_count, merged,
+                "wordmap merged spill");
+  fseek_or_die(merged, 0, SEEK_SET);
+
+  free(heap);
+  free(cursors);
+  *num_unique = total_unique;
+  return merged;
+}
+
+// Buckets a sorted stream of unique racks into a WMPForLength table. The
+// letter bits land in blank_letters, which shares storage with
+// first_blank_letters, so this serves both blank phases.
+static void write_letter_bit_entries(UniquePairReader *reader,
+                                     LengthScratchBuffers *scratch,
+                                     uint32_t *num_buckets_out,
+                                     uint32_t *num_entries_out,
+                                     uint32_t **bucket_starts_out,
+                                     WMPEntry **entries_out) {
+  const uint32_t num_unique = reader->num_records;
+  uint32_t num_buckets = next_power_of_2(num_unique);
+  if (num_buckets < MIN_BUCKETS) {
+    num_buckets = MIN_BUCKETS;
+  }
+
+  if (num_buckets > scratch->bucket_counts_size) {
+    free(scratch->bucket_counts);
+    scratch->bucket_counts = calloc_or_die(num_buckets, sizeof(uint32_t));
+    scratch->bucket_counts_size = num_buckets;
+  } else {
+    memset(scratch->bucket_counts, 0, num_buckets * sizeof(uint32_t));
+  }
+  uint32_t *bucket_counts = scratch->bucket_counts;
+
+  const BlankPair *block;
+  uint32_t block_count;
+  unique_pair_reader_rewind(reader);
+  while ((block_count = unique_pair_reader_next_block(reader, &block)) > 0) {
+    for (uint32_t i = 0; i < block_count; i++) {
+      bucket_counts[bit_rack_get_bucket_index(&block[i].bit_rack,
+                                              num_buckets)]++;
+    }
+  }
+
+  WMPEntry *entries = malloc_or_die(
+      (num_unique > 0 ? num_unique : 1) * sizeof(WMPEntry));
+  uint32_t *bucket_starts =
+      malloc_or_die((num_buckets + 1) * sizeof(uint32_t));
+  uint32_t offset = 0;
+  for (uint32_t b = 0; b < num_buckets; b++) {
+    bucket_starts[b] = offset;
+    offset += bucket_counts[b];
+  }
+  bucket_starts[num_buckets] = offset;
+  memset(bucket_counts, 0, num_buckets * sizeof(uint32_t));
+
+  unique_pair_reader_rewind(reader);
+  while ((block_count = unique_pair_reader_next_block(reader, &block)) > 0) {
+    for (uint32_t i = 0; i < block_count; i++) {
+      const uint32_t bucket_idx =
+          bit_rack_get_bucket_index(&block[i].bit_rack, num_buckets);
+      WMPEntry *entry =
+          &entries[bucket_starts[bucket_idx] + bucket_counts[bucket_idx]++];
+      memset(entry->bucket_or_inline, 0, WMP_INLINE_VALUE_BYTES);
+      entry->blank_letters = block[i].blank_letter_bit;
+      wmp_entry_write_bit_rack(entry, &block[i].bit_rack);
+    }
+  }
+
+  *num_buckets_out = num_buckets;
+  *num_entries_out = num_unique;
+  *bucket_starts_out = bucket_starts;
+  *entries_out = entries;
+}
+
+// Builds the single-blank (num_blanks == 1) or double-blank (num_blanks == 2)
+// table for one length while keeping pair scratch within max_scratch_bytes.
+static void build_letter_bit_entries_spilled(LengthScratchBuffers *scratch,
+                                             int num_blanks,
+                                             size_t max_scratch_bytes,
+                                             uint32_t *num_buckets,
+                                             uint32_t *num_entries,
+                                             uint32_t **bucket_starts,
+                                             WMPEntry **entries) {
+  // The chunk and its radix sort buffer share the limit
+  size_t chunk_capacity = max_scratch_bytes / (2 * sizeof(BlankPair));
+  if (chunk_capacity < MIN_SPILL_CHUNK_PAIRS) {
+    chunk_capacity = MIN_SPILL_CHUNK_PAIRS;
+  }
+  if (chunk_capacity > UINT32_MAX) {
+    chunk_capacity = UINT32_MAX;
+  }
+  // Release the oversized word phase buffers rather than keep them around
+  free(scratch->scratch1);
+  free(scratch->scratch2);
+  scratch->scratch_size = chunk_capacity * sizeof(BlankPair);
+  scratch->scratch1 = malloc_or_die(scratch->scratch_size);
+  scratch->scratch2 = malloc_or_die(scratch->scratch_size);
+
+  PairSpiller spiller = {
+      .file = NULL,
+      .chunk = (BlankPair *)scratch->scratch1,
+      .temp = (BlankPair *)scratch->scratch2,
+      .chunk_capacity = (uint32_t)chunk_capacity,
+      .chunk_count = 0,
+      .radix_passes = scratch->radix_passes,
+      .run_offsets = malloc_or_die(16 * sizeof(uint64_t)),
+      .run_lengths = malloc_or_die(16 * sizeof(uint64_t)),
+      .num_runs = 0,
+      .run_capacity = 16,
+      .num_file_records = 0,
+  };
+
+  const BitRack *unique_racks = scratch->unique_racks;
+  for (uint32_t r = 0; r < scratch->num_unique_racks; r++) {
+    BitRack rack = unique_racks[r];
+    uint32_t present1 = bit_rack_get_letter_mask(&rack) & ~1U;
+    while (present1) {
+      const MachineLetter ml1 = (MachineLetter)bit_ctz32(present1);
+      present1 &= present1 - 1;
+      bit_rack_take_letter(&rack, ml1);
+      bit_rack_add_letter(&rack, BLANK_MACHINE_LETTER);
+      if (num_blanks == 1) {
+        pair_spiller_add(&spiller, &rack, 1U << ml1);
+      } else {
+        uint32_t present2 =
+            bit_rack_get_letter_mask(&rack) & ~((1U << ml1) - 1) & ~1U;
+        while (present2) {
+          const MachineLetter ml2 = (MachineLetter)bit_ctz32(present2);
+          present2 &= present2 - 1;
+          bit_rack_take_letter(&rack, ml2);
+          bit_rack_add_letter(&rack, BLANK_MACHINE_LETTER);
+          pair_spiller_add(&spiller, &rack, 1U << ml1);
+          bit_rack_take_letter(&rack, BLANK_MACHINE_LETTER);
+          bit_rack_add_letter(&rack, ml2);
+        }
+      }
+      bit_rack_take_letter(&rack, BLANK_MACHINE_LETTER);
+      bit_rack_add_letter(&rack, ml1);
+    }
+  }
+
+  UniquePairReader reader = {0};
+  FILE *merged = NULL;
+  if (spiller.num_runs == 0) {
+    // Everything fit in one chunk; finish in memory
+    radix_sort_blank_pairs(spiller.chunk, spiller.temp, spiller.chunk_count,
+                           spiller.radix_passes);
+    reader.records = spiller.chunk;
+    reader.num_records =
+        collapse_sorted_blank_pairs(spiller.chunk, spiller.chunk_count);
+  } else {
+    pair_spiller_flush_run(&spiller);
+    merged = pair_spiller_merge_runs(&spiller, &reader.num_records);
+    reader.file = merged;
+    reader.buffer = spiller.chunk;
+    reader.buffer_capacity = spiller.chunk_capacity;
+  }
+
+  write_letter_bit_entries(&reader, scratch, num_buckets, num_entries,
+                           bucket_starts, entries);
+
+  if (merged) {
+    fclose_or_die(merged);
+  }
+  if (spiller.file) {
+    fclose_or_die(spiller.file);
+  }
+  // The merge may have grown the temp buffer
+  scratch->scratch2 = spiller.temp;
+  free(spiller.run_offsets);
+  free(spiller.run_lengths);
+}
+
 // ============================================================================
 // Phase 2: Build blank entries using scratch buffers
 // ============================================================================
@@ -542,6 +979,8 @@ typedef struct {
   WMPForLength *wfl;
   int length;
   ThreadSemaphore *sem;
+  // 0 means unbounded (always build in memory)
+  size_t max_scratch_bytes;
 } BlankBuildArg;
 
 static void *build_blank_entries_direct(void *arg) {
@@ -555,6 +994,17 @@ static void *build_blank_entries_direct(void *arg) {
   size_t max_pairs = (size_t)num_racks * (size_t)a->length;
   size_t needed_size = sizeof(BlankPair) * max_pairs;
 
+  if (a->max_scratch_bytes > 0 && 2 * needed_size > a->max_scratch_bytes) {
+    build_letter_bit_entries_spilled(
+        scratch, 1, a->max_scratch_bytes, &wfl->num_blank_buckets,
+        &wfl->num_blank_entries, &wfl->blank_bucket_starts,
+        &wfl->blank_map_entries);
+    if (a->sem) {
+      thread_sem_release(a->sem);
+    }
+    return NULL;
+  }
+
   // Reuse scratch buffers if large enough, otherwise reallocate
   if (needed_size > scratch->scratch_size) {
     free(scratch->scratch1);
@@ -688,6 +1138,8 @@ typedef struct {
   WMPForLength *wfl;
   int length;
   ThreadSemaphore *sem;
+  // 0 means unbounded (always build in memory)
+  size_t max_scratch_bytes;
 } DoubleBlankBuildArg;
 
 static void *build_double_blank_entries_direct(void *arg) {
@@ -702,6 +1154,17 @@ static void *build_double_blank_entries_direct(void *arg) {
   size_t max_pairs = (size_t)num_racks * (size_t)length * (size_t)length / 2;
   size_t needed_size = sizeof(DoubleBlankPair) * max_pairs;
 
+  if (a->max_scratch_bytes > 0 && 2 * needed_size > a->max_scratch_bytes) {
+    build_letter_bit_entries_spilled(
+        scratch, 2, a->max_scratch_bytes, &wfl->num_double_blank_buckets,
+        &wfl->num_double_blank_entries, &wfl->double_blank_bucket_starts,
+        &wfl->double_blank_map_entries);
+    if (a->sem) {
+      thread_sem_release(a->sem);
+    }
+    return NULL;
+  }
+
   // Reuse scratch buffers if large enough
   if (needed_size > scratch->scratch_size) {
     free(scratch->scratch1);
@@ -934,6 +1397,9 @@ static uint32_t calculate_max_word_lookup_bytes(WMP *wmp) {
 //
 // A counting semaphore limits concurrent threads to respect the user's
 // -threads N setting, ensuring politeness on shared machines.
+//
+// With a memory limit, phases 2 and 3 switch to the external-memory build
+// above for any length whose pairs would not fit in its share of the limit.
 // ============================================================================
 
 // Sort lengths by work descending so heavy workloads (7-8 letter words) start
@@ -953,8 +1419,9 @@ static void sort_lengths_by_work(int *lengths, const uint32_t *work,
   }
 }
 
-WMP *make_wmp_from_words(const DictionaryWordList *words,
-                         const LetterDistribution *ld, int num_threads) {
+WMP *make_wmp_from_words_bounded(const DictionaryWordList *words,
+                                 const LetterDistribution *ld, int num_threads,
+                                 size_t max_memory_bytes) {
   if (ld->distribution[BLANK_MACHINE_LETTER] > 2) {
     log_fatal("cannot create WMP with more than 2 blanks");
     return NULL;
@@ -968,6 +1435,12 @@ WMP *make_wmp_from_words(const DictionaryWordList *words,
   if (num_threads > BOARD_DIM - 1) {
     num_threads = BOARD_DIM - 1;
   }
+  // Up to num_threads lengths hold blank pair scratch at the same time. A
+  // nonzero limit must stay nonzero per length, since 0 means unbounded.
+  size_t max_scratch_bytes_per_length = max_memory_bytes / (size_t)num_threads;
+  if (max_memory_bytes > 0 && max_scratch_bytes_per_length == 0) {
+    max_scratch_bytes_per_length = 1;
+  }
 
   const int total_words = dictionary_word_list_get_count(words);
 
@@ -1128,6 +1601,7 @@ WMP *make_wmp_from_words(const DictionaryWordList *words,
       blank_args[len].wfl = &wmp->wfls[len];
       blank_args[len].length = len;
       blank_args[len].sem = NULL;
+      blank_args[len].max_scratch_bytes = max_scratch_bytes_per_length;
       build_blank_entries_direct(&blank_args[len]);
     }
   } else {
@@ -1137,6 +1611,7 @@ WMP *make_wmp_from_words(const DictionaryWordList *words,
       blank_args[len].wfl = &wmp->wfls[len];
       blank_args[len].length = len;
       blank_args[len].sem = &sem;
+      blank_args[len].max_scratch_bytes = max_scratch_bytes_per_length;
       thread_sem_acquire(&sem);
       cpthread_create(&blank_threads[len], build_blank_entries_direct,
                       &blank_args[len]);
@@ -1157,6 +1632,7 @@ WMP *make_wmp_from_words(const DictionaryWordList *words,
       dbl_args[len].wfl = &wmp->wfls[len];
       dbl_args[len].length = len;
       dbl_args[len].sem = NULL;
+      dbl_args[len].max_scratch_bytes = max_scratch_bytes_per_length;
       build_double_blank_entries_direct(&dbl_args[len]);
     }
   } else {
@@ -1166,6 +1642,7 @@ WMP *make_wmp_from_words(const DictionaryWordList *words,
       dbl_args[len].wfl = &wmp->wfls[len];
       dbl_args[len].length = len;
       dbl_args[len].sem = &sem;
+      dbl_args[len].max_scratch_bytes = max_scratch_bytes_per_length;
       thread_sem_acquire(&sem);
       cpthread_create(&dbl_threads[len], build_double_blank_entries_direct,
                       &dbl_args[len]);
@@ -1189,11 +1666,22 @@ WMP *make_wmp_from_words(const DictionaryWordList *words,
   return wmp;
 }
 
-WMP *make_wmp_from_kwg(const KWG *kwg, const LetterDistribution *ld,
-                       int num_threads) {
+WMP *make_wmp_from_words(const DictionaryWordList *words,
+                         const LetterDistribution *ld, int num_threads) {
+  return make_wmp_from_words_bounded(words, ld, num_threads, 0);
+}
+
+WMP *make_wmp_from_kwg_bounded(const KWG *kwg, const LetterDistribution *ld,
+                               int num_threads, size_t max_memory_bytes) {
   DictionaryWordList *words = dictionary_word_list_create();
   kwg_write_words(kwg, kwg_get_dawg_root_node_index(kwg), words, NULL);
-  WMP *wmp = make_wmp_from_words(words, ld, num_threads);
+  WMP *wmp =
+      make_wmp_from_words_bounded(words, ld, num_threads, max_memory_bytes);
   dictionary_word_list_destroy(words);
   return wmp;
 }
+
+WMP *make_wmp_from_kwg(const KWG *kwg, const LetterDistribution *ld,
+                       int num_threads) {
+  return make_wmp_from_kwg_bounded(kwg, ld, num_threads, 0);
+}
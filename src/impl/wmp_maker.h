@@ -4,15 +4,27 @@
 #include "../ent/dictionary_word.h"
 #include "../ent/kwg.h"
 #include "../ent/wmp.h"
+#include <stddef.h>
 
 // num_threads: number of threads to use (0 means use all available cores)
 WMP *make_wmp_from_words(const DictionaryWordList *words,
                          const LetterDistribution *ld, int num_threads);
 
+// Like make_wmp_from_words, but keeps the blank and double-blank pair scratch
+// within roughly max_memory_bytes by spilling sorted runs to temporary files
+// and merging them. 0 means unbounded. The resulting WMP is identical. The
+// word phase, which holds one record per word of a length, is not bounded.
+WMP *make_wmp_from_words_bounded(const DictionaryWordList *words,
+                                 const LetterDistribution *ld, int num_threads,
+                                 size_t max_memory_bytes);
+
 // Creates a WMP from a KWG using the DAWG portion only.
 // The GADDAG portion of the KWG is not used.
 // num_threads: number of threads to use (0 means use all available cores)
 WMP *make_wmp_from_kwg(const KWG *kwg, const LetterDistribution *ld,
                        int num_threads);
 
+WMP *make_wmp_from_kwg_bounded(const KWG *kwg, const LetterDistribution *ld,
+                               int num_threads, size_t max_memory_bytes);
+
 #endif
\ No newline at end of file
@@ -98,6 +98,9 @@ typedef enum {
   ERROR_STATUS_CONVERT_UNIMPLEMENTED_CONVERSION_TYPE,
   // Create data errors
   ERROR_STATUS_CREATE_DATA_MISSING_LETTER_DISTRIBUTION,
+  ERROR_STATUS_CREATE_DATA_MISSING_LEXICON,
+  ERROR_STATUS_CREATE_DATA_INVALID_NUMBER_OF_MOVES,
+  ERROR_STATUS_CREATE_DATA_INCOMPATIBLE_LETTER_DISTRIBUTION,
   // GCG Parse errors
   ERROR_STATUS_GCG_PARSE_LEXICON_NOT_SPECIFIED,
   ERROR_STATUS_GCG_PARSE_DUPLICATE_NAMES,
@@ -197,6 +200,9 @@ typedef enum {
   // WMP errors
   ERROR_STATUS_WMP_UNSUPPORTED_VERSION,
   ERROR_STATUS_WMP_INCOMPATIBLE_BOARD_DIM,
+  // Opening table errors
+  ERROR_STATUS_OPENING_TABLE_UNSUPPORTED_VERSION,
+  ERROR_STATUS_OPENING_TABLE_INCOMPATIBLE_DATA,
   // KLV errors
   ERROR_STATUS_KLV_LINE_EXCEEDS_MAX_LENGTH,
   ERROR_STATUS_KLV_DUPLICATE_LEAVE,
@@ -260,6 +266,9 @@ typedef enum {
   ERROR_STATUS_HEAT_MAP_UNRECOGNIZED_TYPE,
   // Command API errors
   ERROR_STATUS_CMD_API_UNINITIALIZED,
+  // Job server errors
+  ERROR_STATUS_JOB_SERVER_MALFORMED_REQUEST,
+  ERROR_STATUS_JOB_SERVER_SOCKET_ERROR,
 } error_code_t;
 
 typedef enum {
@@ -69,6 +69,41 @@ void test_alias_method_dist(const Config *config, AliasMethod *am,
   prng_destroy(prng);
 }
 
+// Racks recorded into separate alias methods and merged are sampled as if
+// they had all been recorded into one.
+void test_alias_method_merge(const Config *config) {
+  const LetterDistribution *ld = config_get_ld(config);
+  const int ld_size = ld_get_size(ld);
+  AliasMethod *am = alias_method_create();
+  AliasMethod *other = alias_method_create();
+  XoshiroPRNG *prng = prng_create(0);
+  Rack rack;
+  rack_set_dist_size_and_reset(&rack, ld_size);
+  Rack expected_rack;
+  rack_set_dist_size_and_reset(&expected_rack, ld_size);
+
+  // Enough zero count racks to grow past the initial capacity.
+  rack_set_to_string(ld, &rack, "A");
+  for (int i = 0; i < INITIAL_AM_ENTRIES_SIZE; i++) {
+    alias_method_add_rack(am, &rack, 0);
+  }
+  rack_set_to_string(ld, &expected_rack, "QZ");
+  alias_method_add_rack(other, &expected_rack, 5);
+  alias_method_merge(am, other);
+  assert(am->num_items == INITIAL_AM_ENTRIES_SIZE + 1);
+  assert(am->total_item_count == 5);
+
+  assert(alias_method_generate_tables(am));
+  for (int i = 0; i < 1000; i++) {
+    assert(alias_method_sample(am, prng, &rack));
+    assert(racks_are_equal(&rack, &expected_rack));
+  }
+
+  alias_method_destroy(other);
+  alias_method_destroy(am);
+  prng_destroy(prng);
+}
+
 void test_alias_method(void) {
   Config *config =
       config_create_or_die("set -lex CSW21 -s1 equity -s2 equity -r1 all -r2 "
@@ -140,6 +175,7 @@ void test_alias_method(void) {
                              {"K", 1, 0, 0},
                              {NULL, 0, 0, 0},
                          });
+  test_alias_method_merge(config);
   alias_method_destroy(am);
   prng_destroy(prng);
   config_destroy(config);
@@ -0,0 +1,441 @@
+// Benchmark suite: runs a fixed set of cases covering movegen, sims,
+// inference, endgames, PEG, autoplay and data loading, and emits one JSON
+// document with the median, p95 and throughput of every case. Positions,
+// settings and seeds are fixed so numbers from two builds are directly
+// comparable. Run it with `make bench`, which builds the release test binary
+// first.
+//
+// Usage: ./bin/magpie_test bench
+// Env vars:
+//   BENCH_SUITES     comma separated suites to run (default all): movegen,
+//                    sim, infer, endgame, peg, autoplay, load
+//   BENCH_ITERS      timed iterations per case (default per case)
+//   BENCH_THREADS    threads for the multithreaded cases (default 4)
+//   BENCH_RIT        "true" adds the movegen cases that need .rit files
+//   BENCH_OUT        write the JSON here instead of stdout
+//   BENCH_BASELINE   JSON from an earlier run; cases whose median got slower
+//                    by more than the threshold are reported and the run
+//                    fails
+//   BENCH_THRESHOLD  allowed median slowdown as a fraction (default 0.05)
+
+#include "bench_suite_test.h"
+
+#include "../src/compat/ctime.h"
+#include "../src/compat/isa_dispatch.h"
+#include "../src/def/equity_defs.h"
+#include "../src/def/move_defs.h"
+#include "../src/def/thread_control_defs.h"
+#include "../src/ent/move.h"
+#include "../src/ent/sim_results.h"
+#include "../src/ent/thread_control.h"
+#include "../src/impl/config.h"
+#include "../src/impl/move_gen.h"
+#include "../src/util/io_util.h"
+#include "../src/util/string_util.h"
+#include "test_constants.h"
+#include "test_util.h"
+#include <assert.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+enum {
+  BENCH_SCHEMA_VERSION = 1,
+  BENCH_MAX_SETUP_CMDS = 3,
+  BENCH_DEFAULT_THREADS = 4,
+  // Enough to record every move of the dense position.
+  BENCH_MOVE_LIST_CAPACITY = 250000,
+};
+
+#define BENCH_DEFAULT_THRESHOLD 0.05
+
+#define BENCH_EMPTY_CGP                                                        \
+  "15/15/15/15/15/15/15/15/15/15/15/15/15/15/15 AEINST?/ 0/0 0 -lex CSW21"
+
+#define BENCH_ENDGAME_NONSTUCK_CGP                                             \
+  "9A1PIXY/9S1L3/2ToWNLETS1O3/9U1DA1R/3GERANIAL1U1I/9g2T1C/8WE2OBI/"           \
+  "6EMU4ON/6AID3GO1/5HUN4ET1/4ZA1T4ME1/1Q1FAKEY3JOES/FIVE1E5IT1C/"             \
+  "5SPORRAN2A/6ORE2N2D BGIV/DEHILOR 384/389 0 -lex NWL20"
+
+// Nigel is stuck with the Z, so the first move must be a pass.
+#define BENCH_ENDGAME_STUCK_CGP                                                \
+  "GATELEGs1POGOED/R4MOOLI3X1/AA10U2/YU4BREDRIN2/1TITULE3E1IN1/1E4N3c1BOK/"    \
+  "1C2O4CHARD1/QI1FLAWN2E1OE1/IS2E1HIN1A1W2/1MOTIVATE1T1S2/1S2N5S4/"           \
+  "3PERJURY5/15/15/15 FV/AADIZ 442/388 0 -lex CSW21"
+
+#define BENCH_PEG_CGP                                                          \
+  "15/3Q7U3/3U2TAURINE2/1CHANSONS2W3/2AI6JO3/DIRL1PO3IN3/E1D2EF3V4/"           \
+  "F1I2p1TRAIK3/O1L2T4E4/ABy1PIT2BRIG2/ME1MOZELLE5/1GRADE1O1NOH3/"             \
+  "WE3R1V7/AT5E7/G6D7 ENOSTXY/ACEISUY 356/378 0 -lex NWL20"
+
+typedef struct BenchCase BenchCase;
+
+// Runs one timed iteration and returns the units of work done, which are
+// divided by the elapsed time to get the case throughput.
+typedef uint64_t (*bench_run_func_t)(const BenchCase *bench_case,
+                                     Config *config);
+
+struct BenchCase {
+  const char *name;
+  const char *suite;
+  // Throughput unit, per second.
+  const char *unit;
+  int iterations;
+  bool requires_rit;
+  // Settings for the case config. The thread count is appended.
+  const char *settings;
+  // Untimed commands run before every iteration.
+  const char *setup_cmds[BENCH_MAX_SETUP_CMDS];
+  bench_run_func_t run;
+  // Timed command for bench_run_command and bench_run_sim.
+  const char *cmd;
+  // Movegen calls per iteration for bench_run_movegen, units of work done
+  // by one run of cmd for bench_run_command.
+  int count;
+};
+
+typedef struct BenchResult {
+  const BenchCase *bench_case;
+  int iterations;
+  double median_seconds;
+  double p95_seconds;
+  double throughput;
+} BenchResult;
+
+// Run `cmd` against `config` with stdout suppressed so the JSON stays clean.
+static void exec_config_quiet(Config *config, const char *cmd) {
+  (void)fflush(stdout);
+  int saved_stdout = fcntl(STDOUT_FILENO, F_DUPFD_CLOEXEC, 0);
+  int devnull = open("/dev/null", O_WRONLY | O_CLOEXEC);
+  (void)dup2(devnull, STDOUT_FILENO);
+  close(devnull);
+
+  ErrorStack *error_stack = error_stack_create();
+  thread_control_set_status(config_get_thread_control(config),
+                            THREAD_CONTROL_STATUS_STARTED);
+  config_load_command(config, cmd, error_stack);
+  assert(error_stack_is_empty(error_stack));
+  config_execute_command(config, error_stack);
+  assert(error_stack_is_empty(error_stack));
+  error_stack_destroy(error_stack);
+  thread_control_set_status(config_get_thread_control(config),
+                            THREAD_CONTROL_STATUS_FINISHED);
+
+  (void)fflush(stdout);
+  (void)dup2(saved_stdout, STDOUT_FILENO);
+  close(saved_stdout);
+}
+
+static int env_int(const char *name, int fallback) {
+  const char *value = getenv(name);
+  if (value == NULL || *value == '\0') {
+    return fallback;
+  }
+  return (int)strtol(value, NULL, 10);
+}
+
+static double env_double(const char *name, double fallback) {
+  const char *value = getenv(name);
+  if (value == NULL || *value == '\0') {
+    return fallback;
+  }
+  return strtod(value, NULL);
+}
+
+// Shared by the movegen cases and allocated once so its setup is not timed.
+static MoveList *bench_move_list = NULL;
+
+static uint64_t bench_run_movegen(const BenchCase *bench_case,
+                                  Config *config) {
+  const MoveGenArgs args = {
+      .game = config_get_game(config),
+      .move_list = bench_move_list,
+      .move_record_type = MOVE_RECORD_ALL,
+      .move_sort_type = MOVE_SORT_EQUITY,
+      .override_kwg = NULL,
+      .eq_margin_movegen = 0,
+      .target_equity = EQUITY_MAX_VALUE,
+      .target_leave_size_for_exchange_cutoff = UNSET_LEAVE_SIZE,
+  };
+  uint64_t moves = 0;
+  for (int i = 0; i < bench_case->count; i++) {
+    generate_moves(&args);
+    moves += (uint64_t)move_list_get_count(bench_move_list);
+  }
+  return moves;
+}
+
+static uint64_t bench_run_command(const BenchCase *bench_case,
+                                  Config *config) {
+  exec_config_quiet(config, bench_case->cmd);
+  return (uint64_t)bench_case->count;
+}
+
+static uint64_t bench_run_sim(const BenchCase *bench_case, Config *config) {
+  exec_config_quiet(config, bench_case->cmd);
+  return sim_results_get_iteration_count(config_get_sim_results(config));
+}
+
+// Times a full config creation, which loads the lexicon, leaves and WMP
+// named in the settings. The config passed in is unused.
+static uint64_t bench_run_load(const BenchCase *bench_case,
+                               Config __attribute__((unused)) * config) {
+  config_destroy(config_create_or_die(bench_case->settings));
+  return 1;
+}
+
+static const BenchCase bench_cases[] = {
+    {"movegen.empty", "movegen", "moves", 20, false, "set -wmp false",
+     {"cgp " BENCH_EMPTY_CGP}, bench_run_movegen, NULL, 100},
+    {"movegen.empty.wmp", "movegen", "moves", 20, false, "set -wmp true",
+     {"cgp " BENCH_EMPTY_CGP}, bench_run_movegen, NULL, 100},
+    {"movegen.midgame", "movegen", "moves", 20, false, "set -wmp false",
+     {"cgp " NOAH_VS_MISHU_CGP}, bench_run_movegen, NULL, 100},
+    {"movegen.midgame.wmp", "movegen", "moves", 20, false, "set -wmp true",
+     {"cgp " NOAH_VS_MISHU_CGP}, bench_run_movegen, NULL, 100},
+    {"movegen.midgame.rit", "movegen", "moves", 20, true,
+     "set -wmp true -rit true", {"cgp " NOAH_VS_MISHU_CGP}, bench_run_movegen,
+     NULL, 100},
+    // Over 200k moves per call, so fewer calls per iteration.
+    {"movegen.dense", "movegen", "moves", 10, false, "set -wmp false",
+     {"cgp " MANY_MOVES}, bench_run_movegen, NULL, 5},
+    {"movegen.dense.wmp", "movegen", "moves", 10, false, "set -wmp true",
+     {"cgp " MANY_MOVES}, bench_run_movegen, NULL, 5},
+    {"movegen.dense.rit", "movegen", "moves", 10, true,
+     "set -wmp true -rit true", {"cgp " MANY_MOVES}, bench_run_movegen, NULL,
+     5},
+    {"sim.2ply", "sim", "iterations", 5, false,
+     "set -wmp true -s1 equity -s2 equity -r1 all -r2 all -numplays 10 "
+     "-plies 2 -iter 300 -scond none -seed 10",
+     {"cgp " NOAH_VS_MISHU_CGP, "gen"}, bench_run_sim, "sim", 0},
+    {"sim.5ply", "sim", "iterations", 5, false,
+     "set -wmp true -s1 equity -s2 equity -r1 all -r2 all -numplays 10 "
+     "-plies 5 -iter 100 -scond none -seed 10",
+     {"cgp " NOAH_VS_MISHU_CGP, "gen"}, bench_run_sim, "sim", 0},
+    {"infer.empty", "infer", "inferences", 5, false,
+     "set -wmp true -numplays 20", {"cgp " EMPTY_CGP}, bench_run_command,
+     "infer 1 MUZAKY 58", 1},
+    {"endgame.nonstuck", "endgame", "solves", 5, false,
+     "set -s1 score -s2 score -eplies 4",
+     {"cgp " BENCH_ENDGAME_NONSTUCK_CGP}, bench_run_command, "endgame", 1},
+    {"endgame.stuck", "endgame", "solves", 3, false,
+     "set -s1 score -s2 score -eplies 5", {"cgp " BENCH_ENDGAME_STUCK_CGP},
+     bench_run_command, "endgame", 1},
+    {"peg.1bag", "peg", "solves", 3, false, "set -s1 score -s2 score",
+     {"cgp " BENCH_PEG_CGP, "set -pegonly 13L.ONYX,13L.OXY"},
+     bench_run_command, "peg", 1},
+    {"autoplay.games", "autoplay", "games", 3, false,
+     "set -lex CSW21 -wmp true -s1 equity -s2 equity -r1 all -r2 all "
+     "-numplays 1 -seed 7",
+     {NULL}, bench_run_command, "autoplay games 20", 20},
+    {"load.csw21", "load", "loads", 5, false, "set -lex CSW21 -wmp true",
+     {NULL}, bench_run_load, NULL, 0},
+};
+
+static bool bench_suite_selected(const char *suites, const char *suite) {
+  if (suites == NULL || *suites == '\0') {
+    return true;
+  }
+  StringSplitter *splitter = split_string(suites, ',', true);
+  bool selected = false;
+  const int number_of_items = string_splitter_get_number_of_items(splitter);
+  for (int i = 0; i < number_of_items; i++) {
+    if (strings_equal(string_splitter_get_item(splitter, i), suite)) {
+      selected = true;
+      break;
+    }
+  }
+  string_splitter_destroy(splitter);
+  return selected;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+  const double da = *(const double *)a;
+  const double db = *(const double *)b;
+  return (da > db) - (da < db);
+}
+
+static void bench_run_case(const BenchCase *bench_case, int iterations,
+                           int threads, BenchResult *result) {
+  char *settings =
+      get_formatted_string("%s -threads %d", bench_case->settings, threads);
+  Config *config = config_create_or_die(settings);
+  free(settings);
+  double *seconds = malloc_or_die(sizeof(double) * iterations);
+  double total_seconds = 0;
+  uint64_t total_units = 0;
+  // The first run is a warmup and is not recorded.
+  for (int i = -1; i < iterations; i++) {
+    for (int j = 0; j < BENCH_MAX_SETUP_CMDS; j++) {
+      if (bench_case->setup_cmds[j] != NULL) {
+        exec_config_quiet(config, bench_case->setup_cmds[j]);
+      }
+    }
+    Timer timer;
+    ctimer_start(&timer);
+    const uint64_t units = bench_case->run(bench_case, config);
+    ctimer_stop(&timer);
+    if (i < 0) {
+      continue;
+    }
+    seconds[i] = ctimer_elapsed_seconds(&timer);
+    total_seconds += seconds[i];
+    total_units += units;
+  }
+  config_destroy(config);
+
+  qsort(seconds, iterations, sizeof(double), compare_doubles);
+  result->bench_case = bench_case;
+  result->iterations = iterations;
+  result->median_seconds =
+      iterations % 2 == 1
+          ? seconds[iterations / 2]
+          : (seconds[iterations / 2 - 1] + seconds[iterations / 2]) / 2;
+  // Nearest rank, so with fewer than 20 iterations this is the slowest run.
+  int p95_rank = (int)((double)iterations * 0.95 + 0.999999);
+  result->p95_seconds = seconds[p95_rank - 1];
+  result->throughput =
+      total_seconds > 0 ? (double)total_units / total_seconds : 0;
+  free(seconds);
+}
+
+// The layout is fixed (one result per line, keys in a fixed order) so runs
+// diff cleanly and the baseline reader below stays trivial.
+static char *bench_results_to_json(const BenchResult *results,
+                                   int number_of_results, int threads) {
+  StringBuilder *sb = string_builder_create();
+  string_builder_add_formatted_string(
+      sb,
+      "{\n  \"schema\": %d,\n  \"board_dim\": %d,\n  \"rack_size\": %d,\n"
+      "  \"isa\": \"%s\",\n  \"threads\": %d,\n  \"results\": [\n",
+      BENCH_SCHEMA_VERSION, BOARD_DIM, RACK_SIZE, isa_dispatch_get_level(),
+      threads);
+  for (int i = 0; i < number_of_results; i++) {
+    const BenchResult *result = &results[i];
+    string_builder_add_formatted_string(
+        sb,
+        "    {\"name\": \"%s\", \"suite\": \"%s\", \"iterations\": %d, "
+        "\"median_s\": %.9f, \"p95_s\": %.9f, \"throughput\": %.3f, "
+        "\"unit\": \"%s/s\"}%s\n",
+        result->bench_case->name, result->bench_case->suite,
+        result->iterations, result->median_seconds, result->p95_seconds,
+        result->throughput, result->bench_case->unit,
+        i + 1 < number_of_results ? "," : "");
+  }
+  string_builder_add_string(sb, "  ]\n}\n");
+  char *json = string_builder_dump(sb, NULL);
+  string_builder_destroy(sb);
+  return json;
+}
+
+// Returns the baseline median for the named case, or a negative value if
+// the baseline has no such case.
+static double bench_baseline_median(const char *baseline, const char *name) {
+  char *key = get_formatted_string("\"name\": \"%s\"", name);
+  const char *entry = strstr(baseline, key);
+  free(key);
+  if (entry == NULL) {
+    return -1;
+  }
+  const char *median = strstr(entry, "\"median_s\": ");
+  if (median == NULL) {
+    return -1;
+  }
+  return strtod(median + strlen("\"median_s\": "), NULL);
+}
+
+// Prints a comparison table to stderr and returns the number of cases whose
+// median regressed by more than the threshold.
+static int bench_compare_to_baseline(const BenchResult *results,
+                                     int number_of_results,
+                                     const char *baseline_filename,
+                                     double threshold) {
+  char *baseline = get_string_from_file_or_die(baseline_filename);
+  int regressions = 0;
+  fprintf(stderr, "\n%-24s %12s %12s %9s\n", "case", "base_s", "median_s",
+          "change");
+  for (int i = 0; i < number_of_results; i++) {
+    const BenchResult *result = &results[i];
+    const double base =
+        bench_baseline_median(baseline, result->bench_case->name);
+    if (base <= 0) {
+      fprintf(stderr, "%-24s %12s %12.6f %9s\n", result->bench_case->name,
+              "-", result->median_seconds, "new");
+      continue;
+    }
+    const double change = result->median_seconds / base - 1;
+    const bool regressed = change > threshold;
+    if (regressed) {
+      regressions++;
+    }
+    fprintf(stderr, "%-24s %12.6f %12.6f %+8.1f%%%s\n",
+            result->bench_case->name, base, result->median_seconds,
+            change * 100, regressed ? "  REGRESSION" : "");
+  }
+  free(baseline);
+  return regressions;
+}
+
+void test_bench_suite(void) {
+  const char *suites = getenv("BENCH_SUITES");
+  const int iterations_override = env_int("BENCH_ITERS", 0);
+  const int threads = env_int("BENCH_THREADS", BENCH_DEFAULT_THREADS);
+  const char *rit_env = getenv("BENCH_RIT");
+  const bool use_rit = rit_env != NULL && strings_equal(rit_env, "true");
+  const char *out_filename = getenv("BENCH_OUT");
+  const char *baseline_filename = getenv("BENCH_BASELINE");
+  const double threshold =
+      env_double("BENCH_THRESHOLD", BENCH_DEFAULT_THRESHOLD);
+
+  const int number_of_cases = (int)(sizeof(bench_cases) / sizeof(BenchCase));
+  BenchResult *results = malloc_or_die(sizeof(BenchResult) * number_of_cases);
+  bench_move_list = move_list_create(BENCH_MOVE_LIST_CAPACITY);
+  int number_of_results = 0;
+  for (int i = 0; i < number_of_cases; i++) {
+    const BenchCase *bench_case = &bench_cases[i];
+    if (!bench_suite_selected(suites, bench_case->suite) ||
+        (bench_case->requires_rit && !use_rit)) {
+      continue;
+    }
+    const int iterations =
+        iterations_override > 0 ? iterations_override : bench_case->iterations;
+    fprintf(stderr, "bench %-24s ", bench_case->name);
+    BenchResult *result = &results[number_of_results++];
+    bench_run_case(bench_case, iterations, threads, result);
+    fprintf(stderr, "median %.6fs p95 %.6fs %.1f %s/s\n",
+            result->median_seconds, result->p95_seconds, result->throughput,
+            bench_case->unit);
+  }
+
+  move_list_destroy(bench_move_list);
+  bench_move_list = NULL;
+
+  char *json = bench_results_to_json(results, number_of_results, threads);
+  if (out_filename != NULL && *out_filename != '\0') {
+    ErrorStack *error_stack = error_stack_create();
+    write_string_to_file(out_filename, "w", json, error_stack);
+    if (!error_stack_is_empty(error_stack)) {
+      error_stack_print_and_reset(error_stack);
+      log_fatal("failed to write benchmark results to %s", out_filename);
+    }
+    error_stack_destroy(error_stack);
+  } else {
+    printf("%s", json);
+  }
+  free(json);
+
+  int regressions = 0;
+  if (baseline_filename != NULL && *baseline_filename != '\0') {
+    regressions = bench_compare_to_baseline(results, number_of_results,
+                                            baseline_filename, threshold);
+  }
+  free(results);
+  if (regressions > 0) {
+    log_fatal("%d benchmark(s) regressed by more than %.1f%%", regressions,
+              threshold * 100);
+  }
+}
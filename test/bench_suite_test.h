@@ -0,0 +1,6 @@
+#ifndef BENCH_SUITE_TEST_H
+#define BENCH_SUITE_TEST_H
+
+void test_bench_suite(void);
+
+#endif
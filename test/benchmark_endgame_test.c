@@ -484,13 +484,17 @@ void test_benchmark_nonstuck_3v3(void) {
 //
 //   BENCHROW <idx> <value> <nodes> <time_s>
 //
-// followed by a summary line. This is designed for baseline-vs-optimized A/B
-// across git revisions: run on the baseline binary, save the output, then run
-// on the optimized binary and diff. Correctness = <value> must match exactly on
-// every position (endgame is exact). When run single-threaded (the default),
-// <nodes> is also deterministic, so an unchanged <nodes> proves a refactor left
-// the search tree identical, while a pruning change shows as fewer nodes with
-// an unchanged value.
+// followed by a summary line with the total time, the total nodes and the
+// percentage of beta cutoffs produced by the first move searched, which
+// measures move ordering quality.
+//
+// To compare two builds, for example before and after a change: build
+// magpie_test at each revision, run './bin/magpie_test egspeedbench' with the
+// same environment on both and diff the BENCHROW lines. <value> must match on
+// every position, since the endgame solve is exact. <time_s> and the summary
+// give the speed difference. Single-threaded runs (the default) also search a
+// deterministic number of <nodes>: equal nodes mean the change left the search
+// tree unchanged, and fewer nodes with equal values mean it pruned more.
 //
 // Parameterized entirely by environment so the same binary can sweep depth /
 // thread count / battery without recompiling:
@@ -569,6 +573,8 @@ void test_endgame_speed_bench(void) {
 
   double total_time = 0.0;
   uint64_t total_nodes = 0;
+  uint64_t total_beta_cutoffs = 0;
+  uint64_t total_first_move_cutoffs = 0;
 
   for (int ci = 0; ci < num_cgps; ci++) {
     ErrorStack *err = error_stack_create();
@@ -606,20 +612,29 @@ void test_endgame_speed_bench(void) {
     int32_t value =
         endgame_results_get_pvline(results, ENDGAME_RESULT_BEST)->score;
     uint64_t nodes = endgame_ctx_get_nodes_searched(solver);
+    uint64_t beta_cutoffs = 0;
+    uint64_t first_move_cutoffs = 0;
+    endgame_ctx_get_move_ordering_stats(solver, &beta_cutoffs,
+                                        &first_move_cutoffs);
 
     printf("BENCHROW %d %d %llu %.6f\n", ci, value, (unsigned long long)nodes,
            elapsed);
     total_time += elapsed;
     total_nodes += nodes;
+    total_beta_cutoffs += beta_cutoffs;
+    total_first_move_cutoffs += first_move_cutoffs;
     if ((ci + 1) % 25 == 0) {
       (void)fflush(stdout);
     }
   }
 
   printf("BENCHSUM tag=%s positions=%d total_time=%.4f total_nodes=%llu "
-         "nps=%.0f\n",
+         "nps=%.0f first_move_cutoff_pct=%.2f\n",
          tag, num_cgps, total_time, (unsigned long long)total_nodes,
-         total_time > 0 ? (double)total_nodes / total_time : 0.0);
+         total_time > 0 ? (double)total_nodes / total_time : 0.0,
+         total_beta_cutoffs > 0 ? 100.0 * (double)total_first_move_cutoffs /
+                                      (double)total_beta_cutoffs
+                                : 0.0);
   (void)fflush(stdout);
 
   free(cgp_lines);
@@ -616,7 +616,54 @@ void test_board_get_playable_tiles_bv(void) {
   config_destroy(config);
 }
 
+// A single blank recording the letters it designates can play exactly the
+// letters that have a single tile play.
+void test_board_designated_letters_bv(void) {
+  Config *config = config_create_or_die(
+      "set -lex CSW21 -s1 score -s2 score -r1 all -r2 all -numplays 1");
+  Game *game = config_game_create(config);
+  const LetterDistribution *ld = game_get_ld(game);
+  const Board *board = game_get_board(game);
+  MoveList *move_list = move_list_create_small(1);
+  load_cgp_or_die(game, VS_OXY);
+
+  const int player_idx = game_get_player_on_turn_index(game);
+  const bool kwgs_shared =
+      game_get_data_is_shared(game, PLAYERS_DATA_TYPE_KWG);
+  const int ci = board_get_cross_set_index(kwgs_shared, player_idx);
+  const int ld_size = ld_get_size(ld);
+  const uint64_t all_non_blank_bv =
+      (((uint64_t)1 << ld_size) - 1) & ~(uint64_t)1;
+  const uint64_t playable_bv =
+      board_get_playable_tiles_bv(board, ci, all_non_blank_bv);
+
+  Rack *rack = player_get_rack(game_get_player(game, player_idx));
+  rack_reset(rack);
+  rack_add_letter(rack, BLANK_MACHINE_LETTER);
+  uint64_t tiles_bv = 0;
+  const MoveGenArgs args = {
+      .game = game,
+      .move_list = move_list,
+      .move_record_type = MOVE_RECORD_TILES_PLAYED,
+      .move_sort_type = MOVE_SORT_SCORE,
+      .override_kwg = NULL,
+      .eq_margin_movegen = 0,
+      .target_equity = EQUITY_MAX_VALUE,
+      .target_leave_size_for_exchange_cutoff = UNSET_LEAVE_SIZE,
+      .tiles_played_bv = &tiles_bv,
+      .record_designated_letters = true,
+  };
+  generate_moves(&args);
+  // Cross sets may include the blank's bit.
+  assert(tiles_bv == (playable_bv & all_non_blank_bv));
+
+  small_move_list_destroy(move_list);
+  game_destroy(game);
+  config_destroy(config);
+}
+
 void test_board(void) {
   test_board_all();
   test_board_get_playable_tiles_bv();
+  test_board_designated_letters_bv();
 }
\ No newline at end of file
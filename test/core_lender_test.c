@@ -0,0 +1,111 @@
+#include "../src/ent/endgame_results.h"
+#include "../src/ent/game.h"
+#include "../src/impl/config.h"
+#include "../src/impl/core_lender.h"
+#include "../src/impl/endgame.h"
+#include "test_util.h"
+#include <assert.h>
+#include <stdint.h>
+
+void test_core_lender_accounting(void) {
+  CoreLender *lender = core_lender_create(4);
+  assert(core_lender_get_num_cores(lender) == 4);
+  assert(core_lender_get_free_cores(lender) == 4);
+  assert(core_lender_acquire(lender, 3) == 3);
+  // Only one core is left.
+  assert(core_lender_acquire(lender, 3) == 1);
+  assert(core_lender_acquire(lender, 1) == 0);
+  assert(core_lender_get_free_cores(lender) == 0);
+  core_lender_release(lender, 1);
+  assert(core_lender_get_free_cores(lender) == 1);
+  core_lender_release(lender, 3);
+  assert(core_lender_get_free_cores(lender) == 4);
+  core_lender_destroy(lender);
+}
+
+// Solves the endgame with one initial worker, growing up to num_cores workers
+// with cores lent by core_lender when it is not NULL, and returns the value.
+int32_t solve_core_lender_endgame(Config *config, CoreLender *core_lender,
+                                  int num_cores) {
+  EndgameResults *results = config_get_endgame_results(config);
+  EndgameCtx *ctx = endgame_ctx_create();
+  if (core_lender) {
+    core_lender_add_endgame(core_lender, ctx, /*deadline_ns=*/0);
+  }
+  EndgameArgs args = {0};
+  args.thread_control = config_get_thread_control(config);
+  args.game = config_get_game(config);
+  args.plies = config_get_endgame_plies(config);
+  args.tt_fraction_of_mem = 0.0001;
+  args.initial_small_move_arena_size = DEFAULT_INITIAL_SMALL_MOVE_ARENA_SIZE;
+  args.num_threads = 1;
+  args.max_workers = core_lender ? num_cores : 0;
+  args.use_heuristics = true;
+  args.forced_pass_bypass = true;
+  args.num_top_moves = 1;
+  args.seed = 42;
+  ErrorStack *error_stack = error_stack_create();
+  endgame_solve(&ctx, &args, results, error_stack);
+  assert(error_stack_is_empty(error_stack));
+  assert(endgame_live_workers(ctx) <= num_cores);
+  if (core_lender) {
+    // The solve outlasted the lender's minimum solve age, so it was grown by
+    // at least one lent worker.
+    assert(endgame_live_workers(ctx) > 1);
+    core_lender_remove_endgame(core_lender, ctx);
+  }
+  endgame_ctx_destroy(ctx);
+  error_stack_destroy(error_stack);
+  return endgame_results_get_pvline(results, ENDGAME_RESULT_BEST)->score;
+}
+
+static int core_lender_test_idle_cores(void *idle_cores) {
+  return *(int *)idle_cores;
+}
+
+// A single threaded solve registered with a lender that has idle cores is
+// grown mid-search, and must still find the exact value. The idle cores are
+// either free cores or cores a search acquired and reports as idle. Every lent
+// core is returned once the solve is removed.
+void test_core_lender_endgame(void) {
+  Config *config =
+      config_create_or_die("set -s1 score -s2 score -threads 1 -eplies 6");
+  load_and_exec_config_or_die(
+      config, "cgp "
+              "GATELEGs1POGOED/R4MOOLI3X1/AA10U2/YU4BREDRIN2/1TITULE3E1IN1/"
+              "1E4N3c1BOK/1C2O4CHARD1/QI1FLAWN2E1OE1/IS2E1HIN1A1W2/"
+              "1MOTIVATE1T1S2/1S2N5S4/3PERJURY5/15/15/15 FV/AADIZ 442/388 0 "
+              "-lex CSW21");
+  const int num_cores = 4;
+  const int32_t expected_value =
+      solve_core_lender_endgame(config, NULL, num_cores);
+  CoreLender *lender = core_lender_create(num_cores);
+  assert(core_lender_acquire(lender, 1) == 1);
+  assert(solve_core_lender_endgame(config, lender, num_cores) ==
+         expected_value);
+  assert(core_lender_get_num_loans(lender) >= 1);
+  core_lender_release(lender, 1);
+  assert(core_lender_get_free_cores(lender) == num_cores);
+
+  // Every core is acquired, so only the cores a search reports as idle can
+  // be lent.
+  assert(core_lender_acquire(lender, num_cores) == num_cores);
+  int idle_cores = num_cores - 1;
+  core_lender_add_idle_source(lender, core_lender_test_idle_cores,
+                              &idle_cores);
+  const int num_loans = core_lender_get_num_loans(lender);
+  assert(solve_core_lender_endgame(config, lender, num_cores) ==
+         expected_value);
+  assert(core_lender_get_num_loans(lender) > num_loans);
+  core_lender_remove_idle_source(lender, &idle_cores);
+  assert(core_lender_get_free_cores(lender) == 0);
+  core_lender_release(lender, num_cores);
+  assert(core_lender_get_free_cores(lender) == num_cores);
+  core_lender_destroy(lender);
+  config_destroy(config);
+}
+
+void test_core_lender(void) {
+  test_core_lender_accounting();
+  test_core_lender_endgame();
+}
@@ -0,0 +1,6 @@
+#ifndef CORE_LENDER_TEST_H
+#define CORE_LENDER_TEST_H
+
+void test_core_lender(void);
+
+#endif
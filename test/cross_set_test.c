@@ -1,5 +1,6 @@
 #include "../src/def/board_defs.h"
 #include "../src/ent/board.h"
+#include "../src/ent/cross_check_index.h"
 #include "../src/ent/equity.h"
 #include "../src/ent/game.h"
 #include "../src/ent/letter_distribution.h"
@@ -229,7 +230,45 @@ void test_alpha_cross_set(void) {
   config_destroy(config);
 }
 
+void test_cross_check_index(void) {
+  Config *config = config_create_or_die(
+      "set -lex CSW21 -s1 score -s2 score -r1 all -r2 all -numplays 1");
+  Game *warm_game = config_game_create(config);
+  const CrossCheckIndex *index = game_get_cross_check_index(warm_game);
+  const char *cgps[] = {VS_MATT,         VS_ED,          VS_JEREMY,
+                        VS_ANDY_CGP,     VS_FRENTZ_CGP,  GUY_VS_BOT_CGP,
+                        DOUG_V_EMELY_CGP};
+  const int number_of_cgps = sizeof(cgps) / sizeof(cgps[0]);
+  for (int i = 0; i < number_of_cgps; i++) {
+    load_cgp_or_die(warm_game, cgps[i]);
+  }
+  assert(cross_check_index_get_misses(index) > 0);
+
+  // Cross-sets read from an index warmed by every position match the ones
+  // computed by a game that has not seen any other position.
+  for (int i = 0; i < number_of_cgps; i++) {
+    load_cgp_or_die(warm_game, cgps[i]);
+    Game *cold_game = config_game_create(config);
+    load_cgp_or_die(cold_game, cgps[i]);
+    assert_boards_are_equal(game_get_board(warm_game),
+                            game_get_board(cold_game));
+    game_destroy(cold_game);
+  }
+  assert(cross_check_index_get_hits(index) > 0);
+
+  // Changing the KWGs used for cross-sets empties the index.
+  const KWG *kwg = player_get_kwg(game_get_player(warm_game, 0));
+  game_set_override_kwgs(warm_game, kwg, NULL, DUAL_LEXICON_MODE_IGNORANT);
+  assert(cross_check_index_get_hits(index) == 0);
+  assert(cross_check_index_get_misses(index) == 0);
+  game_clear_override_kwgs(warm_game);
+
+  game_destroy(warm_game);
+  config_destroy(config);
+}
+
 void test_cross_set(void) {
+  test_cross_check_index();
   test_classic_cross_set();
   test_alpha_cross_set();
 }
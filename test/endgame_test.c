@@ -597,6 +597,62 @@ void test_small_arena_realloc(void) {
       512, ERROR_STATUS_SUCCESS, 11, false, 0);
 }
 
+void test_tablebase_matches_search(void) {
+  // A full-depth solve gives the same value whether or not the subgames
+  // below the root are solved exactly by the tablebase.
+  Config *config =
+      config_create_or_die("set -s1 score -s2 score -threads 1 -eplies 10");
+  load_and_exec_config_or_die(
+      config,
+      "cgp "
+      "4EXODE6/1DOFF1KERATIN1U/1OHO8YEN/1POOJA1B3MEWS/5SQUINTY2A/4RHINO1e3V/"
+      "2B4C2R3E/GOAT1D1E2ZIN1d/1URACILS2E4/1PIG1S4T4/2L2R4T4/2L2A1GENII3/"
+      "2A2T1L7/5E1A7/5D1M7 AEEIRUW/V 410/409 0 -lex CSW21;");
+  assert_config_exec_status(config, "set -etbtiles 4",
+                            ERROR_STATUS_CONFIG_LOAD_INT_ARG_OUT_OF_BOUNDS);
+
+  Game *game = config_get_game(config);
+  EndgameResults *endgame_results = config_get_endgame_results(config);
+  ErrorStack *error_stack = error_stack_create();
+  EndgameCtx *endgame_ctx = NULL;
+
+  const char *tablebase_settings[] = {"set -etbtiles 0", "set -etbtiles 3"};
+  const int thread_counts[] = {1, 3};
+  int32_t expected_score = 0;
+  for (int i = 0; i < 2; i++) {
+    load_and_exec_config_or_die(config, tablebase_settings[i]);
+    for (int j = 0; j < 2; j++) {
+      EndgameArgs endgame_args = {0};
+      endgame_args.thread_control = config_get_thread_control(config);
+      endgame_args.game = game;
+      endgame_args.plies = config_get_endgame_plies(config);
+      endgame_args.tt_fraction_of_mem = config_get_tt_fraction_of_mem(config);
+      endgame_args.initial_small_move_arena_size =
+          DEFAULT_INITIAL_SMALL_MOVE_ARENA_SIZE;
+      endgame_args.num_threads = thread_counts[j];
+      endgame_args.use_heuristics = true;
+      endgame_args.num_top_moves = 1;
+      endgame_args.seed = 42;
+      endgame_args.tablebase_max_tiles =
+          config_get_endgame_tablebase_max_tiles(config);
+      endgame_solve(&endgame_ctx, &endgame_args, endgame_results, error_stack);
+      assert(error_stack_is_empty(error_stack));
+
+      const PVLine *pv_line =
+          endgame_results_get_pvline(endgame_results, ENDGAME_RESULT_BEST);
+      if (i == 0 && j == 0) {
+        expected_score = pv_line->score;
+      }
+      assert(pv_line->score == expected_score);
+    }
+  }
+  assert(expected_score == 18);
+
+  endgame_ctx_destroy(endgame_ctx);
+  error_stack_destroy(error_stack);
+  config_destroy(config);
+}
+
 void test_endgame_interrupt(void) {
   test_single_endgame(
       "set -s1 score -s2 score -threads 1 -eplies 25 -etopk 10",
@@ -1489,6 +1545,7 @@ void test_endgame_progress_stream(void) {
 }
 
 void test_endgame(void) {
+  test_tablebase_matches_search();
   test_before_search_callback();
   test_single_pv_display();
   test_ctx_reuse();
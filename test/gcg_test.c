@@ -13,6 +13,7 @@
 #include "../src/ent/validated_move.h"
 #include "../src/impl/config.h"
 #include "../src/impl/gcg.h"
+#include "../src/impl/gcg_corpus.h"
 #include "../src/util/io_util.h"
 #include "../src/util/string_util.h"
 #include "test_util.h"
@@ -22,6 +23,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 char *parse_and_write_gcg(const char *gcg_filepath_read,
                           const char *gcg_filepath_write, Config *config,
@@ -1368,6 +1370,82 @@ void test_success_trailing_overtime_penalty(GameHistory *game_history) {
   config_destroy(config);
 }
 
+void test_gcg_corpus(void) {
+  Config *config = config_create_or_die("set -lex CSW21 -threads 4");
+  const char *header = "#character-encoding UTF-8\n"
+                       "#player1 Tim Tim\n"
+                       "#player2 Josh Josh\n";
+  const char *events = ">Tim: AEITW 8D WAITE +24 24\n"
+                       "#note a #note does not start a new game\n"
+                       ">Josh: DEEFINO 7C DEFO +22 22\n";
+  char *multi_game_gcg = get_formatted_string(
+      "%s%s\n%s#lexicon NWL20\n%s", header, events, header, events);
+  char *bad_score_gcg =
+      get_formatted_string("%s>Tim: AEITW 8D WAITE +25 25\n", header);
+
+  int number_of_games;
+  int *game_offsets = gcg_corpus_split_games(multi_game_gcg, &number_of_games);
+  assert(number_of_games == 2);
+  assert(game_offsets[0] == 0);
+  assert(has_prefix(header, multi_game_gcg + game_offsets[1]));
+  free(game_offsets);
+
+  char tmp_template[] = "/tmp/magpie_gcg_corpus_XXXXXX";
+  const char *tmp_dir = mkdtemp(tmp_template);
+  assert(tmp_dir != NULL);
+  char *multi_game_path = get_formatted_string("%s/1.gcg", tmp_dir);
+  char *bad_score_path = get_formatted_string("%s/2.gcg", tmp_dir);
+  ErrorStack *error_stack = error_stack_create();
+  write_string_to_file(multi_game_path, "w", multi_game_gcg, error_stack);
+  write_string_to_file(bad_score_path, "w", bad_score_gcg, error_stack);
+  assert(error_stack_is_empty(error_stack));
+
+  // A directory holds one game per GCG, except for concatenated files.
+  GCGCorpus *corpus = config_create_gcg_corpus(config, tmp_dir, error_stack);
+  assert(error_stack_is_empty(error_stack));
+  assert(gcg_corpus_get_number_of_games(corpus) == 3);
+  assert(gcg_corpus_get_number_of_failed_games(corpus) == 2);
+  assert(strings_equal(gcg_corpus_get_source(corpus, 0), multi_game_path));
+  assert(strings_equal(gcg_corpus_get_source(corpus, 1), multi_game_path));
+  assert(strings_equal(gcg_corpus_get_source(corpus, 2), bad_score_path));
+
+  const GameHistory *game_history = gcg_corpus_get_game_history(corpus, 0);
+  assert(game_history);
+  assert(gcg_corpus_get_error_code(corpus, 0) == ERROR_STATUS_SUCCESS);
+  assert(game_history_get_num_events(game_history) == 2);
+  assert(strings_equal(game_history_get_lexicon_name(game_history), "CSW21"));
+  assert(has_prefix(
+      "a #note does not start a new game",
+      game_event_get_note(game_history_get_event(game_history, 0))));
+
+  // Games that need other data fail without affecting the rest.
+  assert(!gcg_corpus_get_game_history(corpus, 1));
+  assert(gcg_corpus_get_error_code(corpus, 1) ==
+         ERROR_STATUS_GCG_PARSE_CONFIG_LOAD_ERROR);
+  assert(has_substring(gcg_corpus_get_error_message(corpus, 1), "NWL20"));
+  assert(!gcg_corpus_get_game_history(corpus, 2));
+  assert(gcg_corpus_get_error_code(corpus, 2) ==
+         ERROR_STATUS_GCG_PARSE_MOVE_SCORING_ERROR);
+  gcg_corpus_destroy(corpus);
+
+  // A single file is split into its games.
+  corpus = config_create_gcg_corpus(config, multi_game_path, error_stack);
+  assert(error_stack_is_empty(error_stack));
+  assert(gcg_corpus_get_number_of_games(corpus) == 2);
+  assert(gcg_corpus_get_number_of_failed_games(corpus) == 1);
+  gcg_corpus_destroy(corpus);
+
+  (void)remove(multi_game_path);
+  (void)remove(bad_score_path);
+  (void)rmdir(tmp_dir);
+  free(multi_game_path);
+  free(bad_score_path);
+  free(multi_game_gcg);
+  free(bad_score_gcg);
+  error_stack_destroy(error_stack);
+  config_destroy(config);
+}
+
 void test_gcg(void) {
   // Use the same game_history for all tests to thoroughly test the
   // game_history_reset function
@@ -1393,4 +1471,5 @@ void test_gcg(void) {
   test_description_write(game_history);
   test_success_trailing_overtime_penalty(game_history);
   game_history_destroy(game_history);
+  test_gcg_corpus();
 }
@@ -1195,6 +1195,89 @@ void test_infer_nonerror_cases(const int number_of_threads,
   config_destroy(config);
 }
 
+// Runs the inference of the target playing the tiles for the score with or
+// without the cutoff optimization and the witness moves and rack classes that
+// it enables.
+void infer_played_tiles(const Config *config, const char *played_tiles,
+                        int score, bool use_cutoff,
+                        InferenceResults *inference_results) {
+  const Game *game = config_get_game(config);
+  const LetterDistribution *ld = game_get_ld(game);
+  const int ld_size = ld_get_size(ld);
+  Rack target_played_tiles;
+  rack_set_dist_size_and_reset(&target_played_tiles, ld_size);
+  rack_set_to_string(ld, &target_played_tiles, played_tiles);
+  Rack empty_rack;
+  rack_set_dist_size_and_reset(&empty_rack, ld_size);
+  ErrorStack *error_stack = error_stack_create();
+  thread_control_set_status(config_get_thread_control(config),
+                            THREAD_CONTROL_STATUS_STARTED);
+  InferenceArgs args;
+  infer_args_fill(&args, config_get_num_plays(config),
+                  config_get_eq_margin_inference(config), NULL, game,
+                  config_get_num_threads(config), 0,
+                  config_get_print_interval(config),
+                  config_get_thread_control(config), false, use_cutoff, 0,
+                  int_to_equity(score), 0, &target_played_tiles, &empty_rack,
+                  &empty_rack);
+  infer_without_ctx(&args, inference_results, error_stack);
+  assert(error_stack_is_empty(error_stack));
+  error_stack_destroy(error_stack);
+}
+
+// Racks refuted without generating their moves must be exactly the racks
+// that full move generation rejects.
+void assert_inference_matches_full_movegen(const Config *config,
+                                           const char *played_tiles,
+                                           int score) {
+  InferenceResults *full_results = inference_results_create(NULL);
+  InferenceResults *cutoff_results = inference_results_create(NULL);
+  infer_played_tiles(config, played_tiles, score, false, full_results);
+  infer_played_tiles(config, played_tiles, score, true, cutoff_results);
+  for (int i = 0; i < NUMBER_OF_INFER_TYPES; i++) {
+    const Stat *full_stat =
+        inference_results_get_equity_values(full_results, i);
+    const Stat *cutoff_stat =
+        inference_results_get_equity_values(cutoff_results, i);
+    assert(stat_get_num_samples(full_stat) ==
+           stat_get_num_samples(cutoff_stat));
+    assert(stat_get_num_unique_samples(full_stat) ==
+           stat_get_num_unique_samples(cutoff_stat));
+    assert(within_epsilon(stat_get_mean(full_stat),
+                          stat_get_mean(cutoff_stat)));
+  }
+  assert(stat_get_num_samples(inference_results_get_equity_values(
+             full_results, INFERENCE_TYPE_LEAVE)) > 0);
+  assert(inference_results_get_alias_method(full_results)->total_item_count ==
+         inference_results_get_alias_method(cutoff_results)->total_item_count);
+  inference_results_destroy(full_results);
+  inference_results_destroy(cutoff_results);
+}
+
+// On the empty board every letter can be played, so the racks are only
+// refuted by witness moves.
+void test_infer_witnesses_match_full_movegen(void) {
+  Config *config =
+      config_create_or_die("set -lex CSW21 -wmp true -s1 equity -s2 equity -r1 "
+                           "all -r2 all -numplays 1 -threads 2");
+  load_and_exec_config_or_die(config, "cgp " EMPTY_CGP);
+  // A low equity opening play, where most racks have a better play
+  assert_inference_matches_full_movegen(config, "ETA", 6);
+  config_destroy(config);
+}
+
+// The wall of tiles only leaves plays through ZEBRA and QUAKE, so the racks
+// holding the letters in the bag that no rack can play, such as V, W and X,
+// are refuted by the tile placements of their class.
+void test_infer_classes_match_full_movegen(void) {
+  Config *config =
+      config_create_or_die("set -lex CSW21 -wmp true -s1 equity -s2 equity -r1 "
+                           "all -r2 all -numplays 1 -threads 2");
+  load_and_exec_config_or_die(config, "cgp " ZEBRA_QUAKE_WALL_CGP);
+  assert_inference_matches_full_movegen(config, "S", 10);
+  config_destroy(config);
+}
+
 void test_infer(void) {
   test_leave_rack_reset();
   test_trivial_random_probability();
@@ -1205,6 +1288,8 @@ void test_infer(void) {
   test_infer_exchange_not_board_is_letter_allowed_in_cross_set();
   test_infer_tiles_played_not_in_bag();
   test_infer_empty_game_history();
+  test_infer_witnesses_match_full_movegen();
+  test_infer_classes_match_full_movegen();
   for (int i = 0; i < 2; i++) {
     const bool use_game_history = i == 1;
     test_infer_nonerror_cases(1, use_game_history);
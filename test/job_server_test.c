@@ -0,0 +1,283 @@
+#include "../src/compat/cpthread.h"
+#include "../src/def/cpthread_defs.h"
+#include "../src/def/players_data_defs.h"
+#include "../src/ent/klv.h"
+#include "../src/ent/players_data.h"
+#include "../src/impl/config.h"
+#include "../src/impl/job_server.h"
+#include "../src/util/io_util.h"
+#include "../src/util/string_util.h"
+#include "test_util.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define JOB_SERVER_TEST_SETTINGS "set -lex CSW21 -numplays 3 -wmp false"
+#define JOB_SERVER_TEST_CGP                                                    \
+  "cgp 15/15/15/15/15/15/15/15/15/15/15/15/15/15/15 AQRTUYZ/ 0/0 0"
+#define JOB_SERVER_TEST_AB_SETTINGS                                            \
+  "set -lex CSW21_ab -ld english_ab -wmp false -s1 equity -s2 equity -r1 "     \
+  "best -r2 best -numplays 1"
+#define JOB_SERVER_TEST_LONG_SIM                                               \
+  JOB_SERVER_TEST_CGP " | generate | simulate -iter 100000000 -scond none "    \
+                      "-plies 2"
+
+// Returns the number of response lines that start with the prefix and
+// asserts that the last response line for the tag starts with last_prefix.
+int count_job_server_lines(const char *output, const char *tag,
+                           const char *prefix, const char *last_prefix) {
+  StringSplitter *lines = split_string_by_newline(output, true);
+  const int number_of_lines = string_splitter_get_number_of_items(lines);
+  char *tag_prefix = get_formatted_string("%s ", tag);
+  char *full_prefix = get_formatted_string("%s %s", tag, prefix);
+  const char *last_line = NULL;
+  int count = 0;
+  for (int i = 0; i < number_of_lines; i++) {
+    const char *line = string_splitter_get_item(lines, i);
+    if (has_prefix(full_prefix, line)) {
+      count++;
+    }
+    if (has_prefix(tag_prefix, line)) {
+      last_line = line;
+    }
+  }
+  if (last_prefix) {
+    char *full_last_prefix = get_formatted_string("%s %s", tag, last_prefix);
+    if (!last_line || !has_prefix(full_last_prefix, last_line)) {
+      printf("last line for job '%s' is '%s' but expected '%s'\n", tag,
+             last_line ? last_line : "", full_last_prefix);
+      assert(false);
+    }
+    free(full_last_prefix);
+  }
+  free(full_prefix);
+  free(tag_prefix);
+  string_splitter_destroy(lines);
+  return count;
+}
+
+void test_job_server_shared_data(void) {
+  const ConfigArgs config_args = {
+      .data_paths = DEFAULT_TEST_DATA_PATH,
+      .share_loaded_data = true,
+  };
+  ErrorStack *error_stack = error_stack_create();
+  Config *config1 = config_create(&config_args, error_stack);
+  Config *config2 = config_create(&config_args, error_stack);
+  assert(error_stack_is_empty(error_stack));
+  load_and_exec_config_or_die(config1, "set -lex CSW21 -wmp false");
+  load_and_exec_config_or_die(config2, "set -lex CSW21 -wmp false");
+  // Both configs use the one loaded copy of the lexicon and leaves.
+  assert(players_data_get_kwg(config_get_players_data(config1), 0) ==
+         players_data_get_kwg(config_get_players_data(config2), 0));
+  assert(players_data_get_klv(config_get_players_data(config1), 0) ==
+         players_data_get_klv(config_get_players_data(config2), 0));
+  config_destroy(config1);
+  // The shared data outlives the config that loaded it.
+  load_and_exec_config_or_die(config2, JOB_SERVER_TEST_CGP);
+  load_and_exec_config_or_die(config2, "generate");
+  config_destroy(config2);
+  error_stack_destroy(error_stack);
+}
+
+void test_job_server_leavegen(void) {
+  const ConfigArgs config_args = {
+      .data_paths = DEFAULT_TEST_DATA_PATH,
+      .share_loaded_data = true,
+  };
+  ErrorStack *error_stack = error_stack_create();
+  Config *leavegen_config = config_create(&config_args, error_stack);
+  Config *reader_config = config_create(&config_args, error_stack);
+  assert(error_stack_is_empty(error_stack));
+  load_and_exec_config_or_die(leavegen_config, JOB_SERVER_TEST_AB_SETTINGS);
+  load_and_exec_config_or_die(reader_config, JOB_SERVER_TEST_AB_SETTINGS);
+  const KLV *shared_klv =
+      players_data_get_klv(config_get_players_data(reader_config), 0);
+  assert(players_data_get_klv(config_get_players_data(leavegen_config), 0) ==
+         shared_klv);
+  const uint32_t number_of_leaves = klv_get_number_of_leaves(shared_klv);
+  Equity *leave_values = malloc_or_die(number_of_leaves * sizeof(Equity));
+  memcpy(leave_values, shared_klv->leave_values,
+         number_of_leaves * sizeof(Equity));
+  const uint64_t mutation_counter = klv_get_mutation_counter(shared_klv);
+
+  // Leavegen writes its leaves into a private copy of the KLV, so the
+  // config that shares the loaded KLV with it never sees them.
+  load_and_exec_config_or_die_timed(leavegen_config, "leavegen 1 0 -seed 3",
+                                    60);
+  assert(players_data_get_klv(config_get_players_data(reader_config), 0) ==
+         shared_klv);
+  assert(players_data_get_klv(config_get_players_data(leavegen_config), 0) !=
+         shared_klv);
+  assert(klv_get_mutation_counter(shared_klv) == mutation_counter);
+  assert(memcmp(leave_values, shared_klv->leave_values,
+                number_of_leaves * sizeof(Equity)) == 0);
+  load_and_exec_config_or_die(reader_config, "autoplay games 10 -seed 4");
+  free(leave_values);
+  config_destroy(leavegen_config);
+  config_destroy(reader_config);
+  error_stack_destroy(error_stack);
+
+  // A leavegen job runs next to a job that plays with the same leaves.
+  const JobServerArgs args = {
+      .data_paths = DEFAULT_TEST_DATA_PATH,
+      .settings = JOB_SERVER_TEST_AB_SETTINGS,
+      .thread_budget = 2,
+  };
+  const char *requests = "submit leavegen 0 0 leavegen 1 0 -seed 3\n"
+                         "submit games 0 0 autoplay games 200 -seed 4\n";
+  FILE *input = fmemopen((void *)requests, string_length(requests), "r");
+  char *output = NULL;
+  size_t output_size = 0;
+  FILE *output_stream = open_memstream(&output, &output_size);
+  assert(input && output_stream);
+  job_server_run(&args, input, output_stream);
+  fclose(input);
+  fclose(output_stream);
+  assert(count_job_server_lines(output, "leavegen", "done finished",
+                                "done") == 1);
+  assert(count_job_server_lines(output, "games", "done finished", "done") ==
+         1);
+  free(output);
+}
+
+void test_job_server_requests(void) {
+  const JobServerArgs args = {
+      .data_paths = DEFAULT_TEST_DATA_PATH,
+      .settings = JOB_SERVER_TEST_SETTINGS,
+      .thread_budget = 2,
+  };
+  // The high priority job takes the whole budget until its deadline, so
+  // the job with the short deadline expires in the queue and the job to
+  // cancel is still queued when the status is requested. The status comes
+  // before the cancel because a cancelled job can be dropped at any time.
+  const char *requests =
+      "submit long 5 300 " JOB_SERVER_TEST_LONG_SIM "\n"
+      "submit short 0 50 generate\n"
+      "submit long 0 0 generate\n"
+      "submit gen 0 0 " JOB_SERVER_TEST_CGP " | generate | shmoves\n"
+      "submit bad 0 0 notacommand\n"
+      "submit nocommand 0 0\n"
+      "submit badprio x 0 generate\n"
+      "submit cancelled 0 0 " JOB_SERVER_TEST_LONG_SIM "\n"
+      "status\n"
+      "cancel cancelled\n"
+      "cancel missing\n"
+      "unknown\n"
+      "quit\n"
+      "submit ignored 0 0 generate\n";
+  FILE *input = fmemopen((void *)requests, string_length(requests), "r");
+  char *output = NULL;
+  size_t output_size = 0;
+  FILE *output_stream = open_memstream(&output, &output_size);
+  assert(input && output_stream);
+  job_server_run(&args, input, output_stream);
+  fclose(input);
+  fclose(output_stream);
+
+  assert(count_job_server_lines(output, "long", "started 2", "done") == 1);
+  assert(count_job_server_lines(output, "long", "output", NULL) > 0);
+  assert(count_job_server_lines(output, "long", "done interrupted", NULL) ==
+         1);
+  assert(count_job_server_lines(output, "short", "done expired", "done") ==
+         1);
+  assert(count_job_server_lines(output, "short", "started", NULL) == 0);
+  assert(count_job_server_lines(output, "gen", "queued", "done") == 1);
+  assert(count_job_server_lines(output, "gen", "started", NULL) == 1);
+  assert(count_job_server_lines(output, "gen", "output", NULL) > 0);
+  assert(count_job_server_lines(output, "gen", "done finished", NULL) == 1);
+  assert(count_job_server_lines(output, "bad", "error", "done") == 1);
+  assert(count_job_server_lines(output, "bad", "done error", NULL) == 1);
+  assert(count_job_server_lines(output, "cancelled", "done cancelled",
+                                "done") == 1);
+  assert(count_job_server_lines(output, "cancelled", "status queued", NULL) ==
+         1);
+  assert(count_job_server_lines(output, "ignored", "", NULL) == 0);
+  // Duplicate tag, missing commands, bad priority, missing job and
+  // unknown request.
+  assert(count_job_server_lines(output, "*", "error", NULL) == 5);
+  assert(has_substring(output, "job 'long' is already queued or running"));
+  assert(has_substring(output, "unrecognized request 'unknown'"));
+  free(output);
+}
+
+typedef struct JobServerSocketArgs {
+  const JobServerArgs *args;
+  const char *socket_path;
+} JobServerSocketArgs;
+
+void *job_server_socket_worker(void *uncasted_args) {
+  const JobServerSocketArgs *socket_args =
+      (const JobServerSocketArgs *)uncasted_args;
+  ErrorStack *error_stack = error_stack_create();
+  job_server_run_on_socket(socket_args->args, socket_args->socket_path,
+                           error_stack);
+  assert(error_stack_is_empty(error_stack));
+  error_stack_destroy(error_stack);
+  return NULL;
+}
+
+void test_job_server_socket(void) {
+  const JobServerArgs args = {
+      .data_paths = DEFAULT_TEST_DATA_PATH,
+      .settings = JOB_SERVER_TEST_SETTINGS,
+      .thread_budget = 1,
+  };
+  char tmp_template[] = "/tmp/magpie_job_server_XXXXXX";
+  const char *tmp_dir = mkdtemp(tmp_template);
+  assert(tmp_dir != NULL);
+  char *socket_path = get_formatted_string("%s/server.sock", tmp_dir);
+  const JobServerSocketArgs socket_args = {
+      .args = &args,
+      .socket_path = socket_path,
+  };
+  cpthread_t server_thread;
+  cpthread_create(&server_thread, job_server_socket_worker,
+                  (void *)&socket_args);
+
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path, socket_path, sizeof(address.sun_path) - 1);
+  const int client_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  assert(client_fd >= 0);
+  // Wait for the server to start listening.
+  while (connect(client_fd, (struct sockaddr *)&address, sizeof(address)) !=
+         0) {
+    usleep(1000);
+  }
+  const char *requests =
+      "submit sock 0 0 " JOB_SERVER_TEST_CGP " | generate\nquit\n";
+  assert(write(client_fd, requests, string_length(requests)) ==
+         (ssize_t)string_length(requests));
+  StringBuilder *sb = string_builder_create();
+  char buffer[256];
+  ssize_t bytes_read;
+  while ((bytes_read = read(client_fd, buffer, sizeof(buffer))) > 0) {
+    string_builder_add_formatted_string(sb, "%.*s", (int)bytes_read, buffer);
+  }
+  close(client_fd);
+  cpthread_join(server_thread);
+
+  const char *output = string_builder_peek(sb);
+  assert(count_job_server_lines(output, "sock", "queued", "done") == 1);
+  assert(count_job_server_lines(output, "sock", "started 1", NULL) == 1);
+  assert(count_job_server_lines(output, "sock", "done finished", NULL) == 1);
+  // The server removes its socket when it shuts down.
+  assert(access(socket_path, F_OK) != 0);
+  string_builder_destroy(sb);
+  (void)rmdir(tmp_dir);
+  free(socket_path);
+}
+
+void test_job_server(void) {
+  test_job_server_shared_data();
+  test_job_server_leavegen();
+  test_job_server_requests();
+  test_job_server_socket();
+}
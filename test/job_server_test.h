@@ -0,0 +1,6 @@
+#ifndef JOB_SERVER_TEST_H
+#define JOB_SERVER_TEST_H
+
+void test_job_server(void);
+
+#endif
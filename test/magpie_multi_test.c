@@ -0,0 +1,88 @@
+#include "magpie_multi_test.h"
+
+#include "../src/util/io_util.h"
+#include "../src/util/string_util.h"
+#include "test_util.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Runs the commands through bin/magpie_multi, which must be built with
+// 'make magpie_multi', and returns everything it prints. The commands run in
+// a directory with only a link to the data so that no saved settings are
+// loaded.
+static char *run_magpie_multi(const char *commands) {
+  char *repo_dir = getcwd(NULL, 0);
+  assert(repo_dir);
+  char tmp_template[] = "/tmp/magpie_multi_XXXXXX";
+  const char *tmp_dir = mkdtemp(tmp_template);
+  assert(tmp_dir);
+  char *data_dir = get_formatted_string("%s/data", repo_dir);
+  char *data_link = get_formatted_string("%s/data", tmp_dir);
+  assert(symlink(data_dir, data_link) == 0);
+  char *commands_filename = get_formatted_string("%s/commands.txt", tmp_dir);
+  ErrorStack *error_stack = error_stack_create();
+  write_string_to_file(commands_filename, "w", commands, error_stack);
+  assert(error_stack_is_empty(error_stack));
+  error_stack_destroy(error_stack);
+  char *command = get_formatted_string("cd %s && %s/bin/magpie_multi < %s 2>&1",
+                                       tmp_dir, repo_dir, commands_filename);
+  FILE *output_stream = popen(command, "r");
+  assert(output_stream);
+  StringBuilder *output_sb = string_builder_create();
+  char buffer[4096];
+  size_t bytes_read;
+  while ((bytes_read = fread(buffer, 1, sizeof(buffer) - 1, output_stream)) >
+         0) {
+    buffer[bytes_read] = '\0';
+    string_builder_add_string(output_sb, buffer);
+  }
+  assert(pclose(output_stream) == 0);
+  char *output = string_builder_dump(output_sb, NULL);
+  string_builder_destroy(output_sb);
+  delete_file(commands_filename);
+  delete_file(data_link);
+  assert(rmdir(tmp_dir) == 0);
+  free(command);
+  free(commands_filename);
+  free(data_link);
+  free(data_dir);
+  free(repo_dir);
+  return output;
+}
+
+// Returns the position in the output just past the play, and fails if the
+// output does not contain it.
+static const char *assert_play_in_output(const char *output,
+                                         const char *play) {
+  const char *play_in_output = strstr(output, play);
+  if (!play_in_output) {
+    log_fatal("play '%s' not found in output:\n%s\n", play, output);
+  }
+  return play_in_output + strlen(play);
+}
+
+void test_magpie_multi(void) {
+  // Each gen runs on an empty board, so the best play starts on the center
+  // row: 8 on the 15x15 board and 11 on the 21x21 board. The lexicon set for
+  // the 15x15 engine carries over to the 21x21 engine.
+  char *output = run_magpie_multi(
+      "set -lex CSW21 -bdn standard15 -mode sync -threads 1 -numplays 1 "
+      "-savesettings false\n"
+      "rack AEINRST\n"
+      "gen\n"
+      "set -bdn super21 -ld english_super\n"
+      "rack AEINRST\n"
+      "gen\n"
+      "set -bdn standard15 -ld english\n"
+      "rack AEINRST\n"
+      "gen\n");
+  const char *remaining_output = output;
+  remaining_output = assert_play_in_output(remaining_output, "8B ENATIRS");
+  remaining_output = assert_play_in_output(remaining_output, "11E ENATIRS");
+  remaining_output = assert_play_in_output(remaining_output, "8B ENATIRS");
+  assert(!strstr(output, "error"));
+  free(output);
+}
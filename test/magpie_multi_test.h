@@ -0,0 +1,6 @@
+#ifndef MAGPIE_MULTI_TEST_H
+#define MAGPIE_MULTI_TEST_H
+
+void test_magpie_multi(void);
+
+#endif
@@ -8,6 +8,7 @@
 #include "../src/ent/equity.h"
 #include "../src/ent/game.h"
 #include "../src/ent/klv.h"
+#include "../src/ent/lane_move_cache.h"
 #include "../src/ent/letter_distribution.h"
 #include "../src/ent/move.h"
 #include "../src/ent/player.h"
@@ -1659,7 +1660,207 @@ void large_alphabet_movegen_test(void) {
   config_destroy(config);
 }
 
+static void assert_move_lists_are_equal(const MoveList *ml1,
+                                        const MoveList *ml2) {
+  assert(move_list_get_count(ml1) == move_list_get_count(ml2));
+  for (int i = 0; i < move_list_get_count(ml1); i++) {
+    assert(compare_moves(move_list_get_move(ml1, i), move_list_get_move(ml2, i),
+                         true) == -1);
+  }
+}
+
+// Generating for many racks against one position must produce exactly what
+// per-rack generate_moves calls produce.
+void movegen_for_racks_test(bool use_wmp) {
+  enum { number_of_racks = 16 };
+  char *config_string = get_formatted_string(
+      "set -lex CSW21 -s1 equity -s2 equity -r1 all -r2 all -numplays 1 "
+      "-wmp %s",
+      use_wmp ? "true" : "false");
+  Config *config = config_create_or_die(config_string);
+  free(config_string);
+  Game *game = config_game_create(config);
+  game_seed(game, 31);
+  load_cgp_or_die(game, NOAH_VS_MISHU_CGP);
+  const int player_on_turn_index = game_get_player_on_turn_index(game);
+  Rack *player_rack =
+      player_get_rack(game_get_player(game, player_on_turn_index));
+
+  Rack racks[number_of_racks];
+  Equity target_equities[number_of_racks];
+  MoveList *batch_move_lists[number_of_racks];
+  for (int i = 0; i < number_of_racks; i++) {
+    set_random_rack(game, player_on_turn_index, NULL);
+    rack_copy(&racks[i], player_rack);
+    target_equities[i] = int_to_equity(10 + 2 * i);
+    batch_move_lists[i] = move_list_create(1000);
+  }
+  MoveList *single_move_list = move_list_create(1000);
+
+  const move_record_t record_types[] = {MOVE_RECORD_ALL, MOVE_RECORD_BEST,
+                                        MOVE_RECORD_BEST};
+  for (int mode = 0; mode < 3; mode++) {
+    const bool use_targets = mode == 2;
+    MoveGenArgs move_gen_args = {
+        .game = game,
+        .move_list = NULL,
+        .move_record_type = record_types[mode],
+        .move_sort_type = MOVE_SORT_EQUITY,
+        .override_kwg = NULL,
+        .eq_margin_movegen = 0,
+        .target_equity = EQUITY_MAX_VALUE,
+        .target_leave_size_for_exchange_cutoff = UNSET_LEAVE_SIZE,
+    };
+    generate_moves_for_racks(&move_gen_args, racks,
+                             use_targets ? target_equities : NULL,
+                             batch_move_lists, number_of_racks);
+    move_gen_args.move_list = single_move_list;
+    for (int i = 0; i < number_of_racks; i++) {
+      rack_copy(player_rack, &racks[i]);
+      move_gen_args.target_equity =
+          use_targets ? target_equities[i] : EQUITY_MAX_VALUE;
+      generate_moves(&move_gen_args);
+      assert(move_list_get_count(single_move_list) > 0);
+      assert_move_lists_are_equal(batch_move_lists[i], single_move_list);
+    }
+  }
+
+  for (int i = 0; i < number_of_racks; i++) {
+    move_list_destroy(batch_move_lists[i]);
+  }
+  move_list_destroy(single_move_list);
+  game_destroy(game);
+  config_destroy(config);
+}
+
+// Splitting the anchors of a position across threads generates the same
+// moves as generating them on one thread.
+void movegen_split_anchors_test(bool use_wmp) {
+  enum { number_of_racks = 8 };
+  char *config_string = get_formatted_string(
+      "set -lex CSW21 -s1 equity -s2 equity -r1 all -r2 all -numplays 1 "
+      "-wmp %s",
+      use_wmp ? "true" : "false");
+  Config *config = config_create_or_die(config_string);
+  free(config_string);
+  Game *game = config_game_create(config);
+  game_seed(game, 17);
+  load_cgp_or_die(game, NOAH_VS_MISHU_CGP);
+  const int player_on_turn_index = game_get_player_on_turn_index(game);
+
+  const int capacities[] = {1000, 20, 1};
+  const move_record_t record_types[] = {MOVE_RECORD_ALL, MOVE_RECORD_ALL,
+                                        MOVE_RECORD_BEST};
+  for (int mode = 0; mode < 3; mode++) {
+    MoveList *serial_move_list = move_list_create(capacities[mode]);
+    MoveList *split_move_list = move_list_create(capacities[mode]);
+    MoveGenArgs move_gen_args = {
+        .game = game,
+        .move_list = serial_move_list,
+        .move_record_type = record_types[mode],
+        .move_sort_type = MOVE_SORT_EQUITY,
+        .override_kwg = NULL,
+        .eq_margin_movegen = 0,
+        .target_equity = EQUITY_MAX_VALUE,
+        .target_leave_size_for_exchange_cutoff = UNSET_LEAVE_SIZE,
+    };
+    for (int i = 0; i < number_of_racks; i++) {
+      set_random_rack(game, player_on_turn_index, NULL);
+      move_gen_args.move_list = serial_move_list;
+      move_gen_args.num_threads = 1;
+      generate_moves(&move_gen_args);
+      move_list_sort_moves(serial_move_list);
+      for (int num_threads = 2; num_threads <= 5; num_threads += 3) {
+        move_gen_args.move_list = split_move_list;
+        move_gen_args.num_threads = num_threads;
+        generate_moves(&move_gen_args);
+        move_list_sort_moves(split_move_list);
+        assert(move_list_get_count(split_move_list) > 0);
+        assert_move_lists_are_equal(serial_move_list, split_move_list);
+      }
+    }
+    move_list_destroy(serial_move_list);
+    move_list_destroy(split_move_list);
+  }
+
+  game_destroy(game);
+  config_destroy(config);
+}
+
+static void assert_small_move_lists_are_equal(const MoveList *ml1,
+                                              const MoveList *ml2) {
+  assert(move_list_get_count(ml1) == move_list_get_count(ml2));
+  for (int i = 0; i < move_list_get_count(ml1); i++) {
+    const SmallMove *sm1 = ml1->small_moves[i];
+    const SmallMove *sm2 = ml2->small_moves[i];
+    assert(sm1->tiny_move == sm2->tiny_move);
+    assert(small_move_get_score(sm1) == small_move_get_score(sm2));
+    assert(small_move_get_play_length(sm1) == small_move_get_play_length(sm2));
+    assert(small_move_get_tiles_played(sm1) ==
+           small_move_get_tiles_played(sm2));
+  }
+}
+
+// Lanes served from a lane move cache must give exactly the moves a fresh
+// generation gives, both on an unchanged position and after plays change
+// some of the lanes.
+void movegen_lane_move_cache_test(void) {
+  Config *config =
+      config_create_or_die("set -lex NWL20 -s1 score -s2 score -wmp false");
+  Game *game = config_game_create(config);
+  const LetterDistribution *ld = game_get_ld(game);
+  MoveList *expected_move_list = move_list_create_small(100000);
+  MoveList *cached_move_list = move_list_create_small(100000);
+  LaneMoveCache *lane_move_cache = lane_move_cache_create(256);
+  MoveGenArgs move_gen_args = {
+      .game = game,
+      .move_record_type = MOVE_RECORD_ALL_SMALL,
+      .move_sort_type = MOVE_SORT_SCORE,
+      .override_kwg = NULL,
+      .eq_margin_movegen = 0,
+      .target_equity = EQUITY_MAX_VALUE,
+      .target_leave_size_for_exchange_cutoff = UNSET_LEAVE_SIZE,
+  };
+
+  load_cgp_or_die(game, VS_JEREMY);
+  rack_set_to_string(ld, player_get_rack(game_get_player(game, 0)), "DDESW??");
+  draw_to_full_rack(game, 1);
+
+  for (int turn = 0; turn < 3; turn++) {
+    move_gen_args.move_list = expected_move_list;
+    move_gen_args.lane_move_cache = NULL;
+    generate_moves(&move_gen_args);
+    move_gen_args.move_list = cached_move_list;
+    move_gen_args.lane_move_cache = lane_move_cache;
+    for (int repeat = 0; repeat < 2; repeat++) {
+      generate_moves(&move_gen_args);
+      assert_small_move_lists_are_equal(expected_move_list, cached_move_list);
+    }
+    int best_index = 0;
+    for (int i = 1; i < move_list_get_count(expected_move_list); i++) {
+      if (small_move_get_score(expected_move_list->small_moves[i]) >
+          small_move_get_score(expected_move_list->small_moves[best_index])) {
+        best_index = i;
+      }
+    }
+    small_move_to_move(expected_move_list->spare_move,
+                       expected_move_list->small_moves[best_index],
+                       game_get_board(game));
+    play_move(expected_move_list->spare_move, game, NULL);
+  }
+  assert(lane_move_cache_get_hits(lane_move_cache) > 0);
+  assert(lane_move_cache_get_misses(lane_move_cache) > 0);
+
+  lane_move_cache_destroy(lane_move_cache);
+  small_move_list_destroy(cached_move_list);
+  small_move_list_destroy(expected_move_list);
+  game_destroy(game);
+  config_destroy(config);
+}
+
 void test_move_gen(void) {
+  movegen_split_anchors_test(false);
+  movegen_split_anchors_test(true);
   test_move_gen_instance_fingerprint();
   leave_lookup_test();
   unfound_leave_lookup_test();
@@ -1691,4 +1892,7 @@ void test_move_gen(void) {
   wmp_blank_possibilities_bananas_4();
   wmp_blank_possibilities_bananas_5();
   large_alphabet_movegen_test();
+  movegen_for_racks_test(false);
+  movegen_for_racks_test(true);
+  movegen_lane_move_cache_test();
 }
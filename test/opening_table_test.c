@@ -0,0 +1,252 @@
+#include "opening_table_test.h"
+
+#include "../src/def/rack_defs.h"
+#include "../src/ent/bit_rack.h"
+#include "../src/ent/board.h"
+#include "../src/ent/data_filepaths.h"
+#include "../src/ent/game.h"
+#include "../src/ent/letter_distribution.h"
+#include "../src/ent/move.h"
+#include "../src/ent/opening_table.h"
+#include "../src/ent/player.h"
+#include "../src/ent/players_data.h"
+#include "../src/ent/rack.h"
+#include "../src/impl/config.h"
+#include "../src/impl/gameplay.h"
+#include "../src/impl/opening_table_maker.h"
+#include "../src/util/io_util.h"
+#include "test_util.h"
+#include <assert.h>
+#include <stdlib.h>
+
+static const char *opening_test_racks[] = {
+    "AEINRST", "??ABCDE", "QXZJKVW", "EEEEIII",
+    "UUUUVVW", "AAAAAAA", "CEILNOR",
+};
+
+enum {
+  NUMBER_OF_OPENING_TEST_RACKS =
+      sizeof(opening_test_racks) / sizeof(opening_test_racks[0]),
+  OPENING_TEST_NUMBER_OF_MOVES = 3,
+};
+
+static void assert_moves_equal(const Move *m1, const Move *m2) {
+  assert(compare_moves(m1, m2, true) == -1);
+}
+
+// Puts the given rack on turn on the empty board and gives the opponent a
+// full rack.
+static void set_opening_position(Game *game, const char *rack_string) {
+  const LetterDistribution *ld = game_get_ld(game);
+  game_reset(game);
+  Rack *rack = rack_create(ld_get_size(ld));
+  rack_set_to_string(ld, rack, rack_string);
+  assert(draw_rack_from_bag(game, 0, rack));
+  draw_to_full_rack(game, 1);
+  rack_destroy(rack);
+}
+
+static void assert_tables_equal(const OpeningTable *t1,
+                                const OpeningTable *t2) {
+  assert_strings_equal(opening_table_get_lexicon_name(t1),
+                       opening_table_get_lexicon_name(t2));
+  assert_strings_equal(opening_table_get_ld_name(t1),
+                       opening_table_get_ld_name(t2));
+  assert(opening_table_get_layout_fingerprint(t1) ==
+         opening_table_get_layout_fingerprint(t2));
+  assert(opening_table_get_bingo_bonus(t1) ==
+         opening_table_get_bingo_bonus(t2));
+  const int number_of_moves = opening_table_get_number_of_moves(t1);
+  assert(number_of_moves == opening_table_get_number_of_moves(t2));
+  const int number_of_entries = opening_table_get_number_of_entries(t1);
+  assert(number_of_entries == opening_table_get_number_of_entries(t2));
+  for (int entry_index = 0; entry_index < number_of_entries; entry_index++) {
+    const BitRack bit_rack = opening_table_get_bit_rack(t1, entry_index);
+    const int loaded_entry_index = opening_table_lookup(t2, &bit_rack);
+    assert(loaded_entry_index >= 0);
+    for (int move_index = 0; move_index < number_of_moves; move_index++) {
+      Move m1;
+      Move m2;
+      opening_table_get_move(t1, entry_index, move_index, &m1);
+      opening_table_get_move(t2, loaded_entry_index, move_index, &m2);
+      assert_moves_equal(&m1, &m2);
+    }
+  }
+}
+
+static void test_opening_table_maker(Game *game, OpeningTable *table) {
+  const LetterDistribution *ld = game_get_ld(game);
+  assert(opening_table_get_number_of_entries(table) ==
+         NUMBER_OF_OPENING_TEST_RACKS);
+  assert(opening_table_get_number_of_moves(table) ==
+         OPENING_TEST_NUMBER_OF_MOVES);
+  assert_strings_equal(opening_table_get_lexicon_name(table), "CSW21");
+  assert_strings_equal(opening_table_get_ld_name(table), "english");
+  assert(opening_table_get_bingo_bonus(table) == game_get_bingo_bonus(game));
+  assert(opening_table_get_layout_fingerprint(table) ==
+         board_get_layout_fingerprint(game_get_board(game)));
+
+  const BitRack missing_bit_rack = string_to_bit_rack(ld, "BCDFGHL");
+  assert(opening_table_lookup(table, &missing_bit_rack) == -1);
+
+  MoveList *move_list = move_list_create(1);
+  for (int i = 0; i < NUMBER_OF_OPENING_TEST_RACKS; i++) {
+    const BitRack bit_rack = string_to_bit_rack(ld, opening_test_racks[i]);
+    const int entry_index = opening_table_lookup(table, &bit_rack);
+    assert(entry_index >= 0);
+    // The first move is the best move and the others follow by equity.
+    set_opening_position(game, opening_test_racks[i]);
+    const Move *best_move = get_top_equity_move(game, move_list);
+    Move previous_move;
+    for (int move_index = 0; move_index < OPENING_TEST_NUMBER_OF_MOVES;
+         move_index++) {
+      Move move;
+      opening_table_get_move(table, entry_index, move_index, &move);
+      if (move_index == 0) {
+        assert_moves_equal(&move, best_move);
+      } else {
+        assert(move_get_equity(&move) <= move_get_equity(&previous_move));
+        assert(compare_moves(&move, best_move, true) != -1);
+      }
+      previous_move = move;
+    }
+  }
+  move_list_destroy(move_list);
+}
+
+static void test_opening_table_probe(Config *config, Game *game,
+                                     OpeningTable *table) {
+  Player *player = game_get_player(game, 0);
+  MoveList *move_list = move_list_create(1);
+  for (int i = 0; i < NUMBER_OF_OPENING_TEST_RACKS; i++) {
+    set_opening_position(game, opening_test_racks[i]);
+    player_set_opening_table(player, NULL);
+    Move generated_move;
+    move_copy(&generated_move, get_top_equity_move(game, move_list));
+    player_set_opening_table(player, table);
+    const Move *probed_move = get_top_equity_move(game, move_list);
+    assert_moves_equal(probed_move, &generated_move);
+  }
+
+  // Replace the best move of an entry with its second best move to tell
+  // probed moves apart from generated ones.
+  const LetterDistribution *ld = game_get_ld(game);
+  const BitRack bit_rack = string_to_bit_rack(ld, opening_test_racks[0]);
+  const int entry_index = opening_table_lookup(table, &bit_rack);
+  Move best_move;
+  Move second_move;
+  opening_table_get_move(table, entry_index, 0, &best_move);
+  opening_table_get_move(table, entry_index, 1, &second_move);
+  opening_table_set_move(table, entry_index, 0, &second_move);
+
+  set_opening_position(game, opening_test_racks[0]);
+  assert_moves_equal(get_top_equity_move(game, move_list), &second_move);
+
+  // The table is not used once a tile is on the board.
+  play_move(&best_move, game, NULL);
+  return_rack_to_bag(game, 0);
+  Rack *rack = rack_create(ld_get_size(ld));
+  rack_set_to_string(ld, rack, opening_test_racks[0]);
+  assert(draw_rack_from_bag(game, 0, rack));
+  rack_destroy(rack);
+  game_set_player_on_turn_index(game, 0);
+  assert(compare_moves(get_top_equity_move(game, move_list), &second_move,
+                       true) != -1);
+
+  // The table is not used for a different bingo bonus.
+  load_and_exec_config_or_die(config, "set -bb 40");
+  Game *bingo_bonus_game = config_game_create(config);
+  player_set_opening_table(game_get_player(bingo_bonus_game, 0), table);
+  set_opening_position(bingo_bonus_game, opening_test_racks[0]);
+  assert(compare_moves(get_top_equity_move(bingo_bonus_game, move_list),
+                       &second_move, true) != -1);
+  game_destroy(bingo_bonus_game);
+  load_and_exec_config_or_die(config, "set -bb 50");
+
+  opening_table_set_move(table, entry_index, 0, &best_move);
+  player_set_opening_table(player, NULL);
+  move_list_destroy(move_list);
+}
+
+static void test_opening_table_config(Config *config, OpeningTable *table) {
+  ErrorStack *error_stack = error_stack_create();
+  const char *data_paths = DEFAULT_TEST_DATA_PATH;
+  char *csw_filename = data_filepaths_get_writable_filename(
+      data_paths, "CSW21", DATA_FILEPATH_TYPE_OPENING_TABLE, error_stack);
+  char *nwl_filename = data_filepaths_get_writable_filename(
+      data_paths, "NWL20", DATA_FILEPATH_TYPE_OPENING_TABLE, error_stack);
+  assert(error_stack_is_empty(error_stack));
+
+  // Tables are found by the name of the leaves.
+  opening_table_write(table, data_paths, "CSW21", error_stack);
+  assert(error_stack_is_empty(error_stack));
+  OpeningTable *loaded_table =
+      opening_table_create(data_paths, "CSW21", error_stack);
+  assert(error_stack_is_empty(error_stack));
+  assert_tables_equal(table, loaded_table);
+  opening_table_destroy(loaded_table);
+
+  load_and_exec_config_or_die(config, "set -openings true");
+  const PlayersData *players_data = config_get_players_data(config);
+  for (int player_index = 0; player_index < 2; player_index++) {
+    const OpeningTable *player_table =
+        players_data_get_opening_table(players_data, player_index);
+    assert(player_table);
+    assert_tables_equal(table, player_table);
+  }
+  Game *game = config_game_create(config);
+  assert(player_get_opening_table(game_get_player(game, 0)) ==
+         players_data_get_opening_table(players_data, 0));
+  game_destroy(game);
+
+  load_and_exec_config_or_die(config, "set -openings false");
+  assert(!players_data_get_opening_table(players_data, 0));
+  assert(!players_data_get_opening_table(players_data, 1));
+
+  assert_config_exec_status(config, "createdata openings CSW21 0",
+                            ERROR_STATUS_CREATE_DATA_INVALID_NUMBER_OF_MOVES);
+  assert_config_exec_status(config, "createdata openings CSW21 256",
+                            ERROR_STATUS_CREATE_DATA_INVALID_NUMBER_OF_MOVES);
+
+  // A table built with a different lexicon is rejected.
+  opening_table_write(table, data_paths, "NWL20", error_stack);
+  assert(error_stack_is_empty(error_stack));
+  assert_config_exec_status(config, "set -lex NWL20 -openings true",
+                            ERROR_STATUS_OPENING_TABLE_INCOMPATIBLE_DATA);
+  load_and_exec_config_or_die(config, "set -lex CSW21 -openings false");
+
+  remove_or_die(csw_filename);
+  remove_or_die(nwl_filename);
+  free(csw_filename);
+  free(nwl_filename);
+  error_stack_destroy(error_stack);
+}
+
+void test_opening_table(void) {
+  Config *config = config_create_or_die("set -numplays 1");
+  assert_config_exec_status(config, "createdata openings CSW21",
+                            ERROR_STATUS_CREATE_DATA_MISSING_LEXICON);
+
+  load_and_exec_config_or_die(
+      config, "set -lex CSW21 -s1 equity -s2 equity -r1 best -r2 best");
+  Game *game = config_game_create(config);
+  const LetterDistribution *ld = game_get_ld(game);
+  BitRack bit_racks[NUMBER_OF_OPENING_TEST_RACKS];
+  for (int i = 0; i < NUMBER_OF_OPENING_TEST_RACKS; i++) {
+    bit_racks[i] = string_to_bit_rack(ld, opening_test_racks[i]);
+  }
+  ErrorStack *error_stack = error_stack_create();
+  OpeningTable *table = make_opening_table_for_racks(
+      game, bit_racks, NUMBER_OF_OPENING_TEST_RACKS,
+      OPENING_TEST_NUMBER_OF_MOVES, 2, error_stack);
+  assert(error_stack_is_empty(error_stack));
+
+  test_opening_table_maker(game, table);
+  test_opening_table_probe(config, game, table);
+  test_opening_table_config(config, table);
+
+  opening_table_destroy(table);
+  error_stack_destroy(error_stack);
+  game_destroy(game);
+  config_destroy(config);
+}
@@ -0,0 +1,6 @@
+#ifndef OPENING_TABLE_TEST_H
+#define OPENING_TABLE_TEST_H
+
+void test_opening_table(void);
+
+#endif
@@ -0,0 +1,54 @@
+#include "perf_counters_test.h"
+
+#include "../src/compat/cpthread.h"
+#include "../src/def/cpthread_defs.h"
+#include "../src/def/perf_counter_defs.h"
+#include "../src/ent/perf_counters.h"
+#include "../src/util/string_util.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+  PERF_TEST_NUM_THREADS = 4,
+  PERF_TEST_RECORDS_PER_THREAD = 1000,
+};
+
+static void *perf_counters_test_worker(void __attribute__((unused)) * arg) {
+  for (int i = 0; i < PERF_TEST_RECORDS_PER_THREAD; i++) {
+    perf_counter_record(PERF_COUNTER_MOVEGEN_ANCHORS, 3);
+  }
+  return NULL;
+}
+
+void test_perf_counters(void) {
+  perf_counters_reset();
+  cpthread_t threads[PERF_TEST_NUM_THREADS];
+  for (int i = 0; i < PERF_TEST_NUM_THREADS; i++) {
+    cpthread_create(&threads[i], perf_counters_test_worker, NULL);
+  }
+  for (int i = 0; i < PERF_TEST_NUM_THREADS; i++) {
+    cpthread_join(threads[i]);
+  }
+  char *stats = perf_counters_to_string();
+  if (!perf_counters_enabled()) {
+    assert(strstr(stats, "PERF_COUNTERS=1") != NULL);
+    free(stats);
+    return;
+  }
+  // Every thread records into its own slot; the dump merges them. Each
+  // value of 3 lands in the [2, 4) bucket, so every percentile is 3.
+  char *expected = get_formatted_string(
+      "movegen_anchors      value %12d %16d %12.1f %12d %12d %12d\n",
+      PERF_TEST_NUM_THREADS * PERF_TEST_RECORDS_PER_THREAD,
+      PERF_TEST_NUM_THREADS * PERF_TEST_RECORDS_PER_THREAD * 3, 3.0, 3, 3, 3);
+  assert(strstr(stats, expected) != NULL);
+  free(expected);
+  free(stats);
+
+  perf_counters_reset();
+  stats = perf_counters_to_string();
+  assert(strstr(stats, "movegen_anchors      value            0") != NULL);
+  free(stats);
+}
@@ -0,0 +1,6 @@
+#ifndef PERF_COUNTERS_TEST_H
+#define PERF_COUNTERS_TEST_H
+
+void test_perf_counters(void);
+
+#endif
@@ -81,6 +81,23 @@ static void assert_rits_equal(const RackInfoTable *a, const RackInfoTable *b) {
     }
     assert(ea->nonplaythrough_has_word_of_length_bitmask ==
            eb->nonplaythrough_has_word_of_length_bitmask);
+    for (int bl_idx = 0; bl_idx < RACK_INFO_TABLE_BEST_LEAVES_PER_ENTRY;
+         bl_idx++) {
+      assert(ea->best_leaves[bl_idx] == eb->best_leaves[bl_idx]);
+    }
+    for (int k = 0; k < RIT_MULTI_PT_TP7_NUM_WORD_LENGTHS; k++) {
+      assert(ea->multi_pt_tp7_bitvec[k] == eb->multi_pt_tp7_bitvec[k]);
+    }
+    for (int k = 0; k < RIT_MULTI_PT_TP6_NUM_WORD_LENGTHS; k++) {
+      assert(ea->multi_pt_tp6_bitvec[k] == eb->multi_pt_tp6_bitvec[k]);
+    }
+    assert(ea->num_bingo_words == eb->num_bingo_words);
+    assert(memcmp(ea->bingo_words, eb->bingo_words, sizeof(ea->bingo_words)) ==
+           0);
+    assert(ea->best_exchange_tiles_exchanged ==
+           eb->best_exchange_tiles_exchanged);
+    assert(memcmp(ea->best_exchange_strip, eb->best_exchange_strip,
+                  sizeof(ea->best_exchange_strip)) == 0);
     for (int byte_idx = 0; byte_idx < RACK_INFO_TABLE_BITRACK_BYTES;
          byte_idx++) {
       assert(ea->bit_rack_bytes[byte_idx] == eb->bit_rack_bytes[byte_idx]);
@@ -244,6 +261,38 @@ static void verify_unions_against_wmp(const RackInfoTable *rit, const WMP *wmp,
   }
 }
 
+// Refilling the leaves of a table built from one KLV with a different KLV
+// must give exactly the table a full build with the second KLV would.
+static void test_rack_info_table_refill_leaves(const KLV *klv, const WMP *wmp,
+                                               const LetterDistribution *ld,
+                                               uint8_t min_played) {
+  KLV *new_klv = klv_create_or_die(DEFAULT_TEST_DATA_PATH, "CSW21");
+  // Perturb every leave so the best leaves and best exchanges move around.
+  for (uint32_t leave_idx = 0; leave_idx < new_klv->number_of_leaves;
+       leave_idx++) {
+    const Equity value = klv_get_indexed_leave_value(new_klv, leave_idx);
+    klv_set_indexed_leave_value(
+        new_klv, leave_idx,
+        -value / 2 + (Equity)(leave_idx % 7) * int_to_equity(1));
+  }
+
+  RackInfoTable *expected =
+      make_rack_info_table(new_klv, wmp, ld, 1, min_played);
+  RackInfoTable *refilled = make_rack_info_table(klv, wmp, ld, 2, min_played);
+  rack_info_table_refill_leaves(refilled, new_klv, wmp, ld, 2);
+  assert_rits_equal(expected, refilled);
+
+  // Refilling back with the original KLV restores the original table.
+  RackInfoTable *original = make_rack_info_table(klv, wmp, ld, 1, min_played);
+  rack_info_table_refill_leaves(refilled, klv, wmp, ld, 1);
+  assert_rits_equal(original, refilled);
+
+  rack_info_table_destroy(original);
+  rack_info_table_destroy(refilled);
+  rack_info_table_destroy(expected);
+  klv_destroy(new_klv);
+}
+
 void test_rack_info_table(void) {
   // Use CSW21 with the english_ab distribution (50 A, 50 B, 0 blank).
   // This keeps the number of full racks small (8, for 0A+7B through 7A+0B)
@@ -342,6 +391,8 @@ void test_rack_info_table(void) {
   assert(rit_loaded != NULL);
   assert_rits_equal(rit, rit_loaded);
 
+  test_rack_info_table_refill_leaves(klv, wmp, ld, min_played);
+
   rack_info_table_destroy(rit_loaded);
   rack_info_table_destroy(rit);
   free(rit_filename);
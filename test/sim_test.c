@@ -8,6 +8,7 @@
 #include "../src/ent/bai_result.h"
 #include "../src/ent/equity.h"
 #include "../src/ent/game.h"
+#include "../src/ent/heat_map.h"
 #include "../src/ent/letter_distribution.h"
 #include "../src/ent/move.h"
 #include "../src/ent/rack.h"
@@ -348,6 +349,109 @@ void test_sim_round_robin_consistency(void) {
   config_destroy(config);
 }
 
+// The per ply stats and heat maps are collected by each thread without
+// locking and merged into the results, so they must not depend on the number
+// of threads, including when only some of the rollouts are sampled.
+void test_sim_ply_stats_consistency(void) {
+  Config *config = config_create_or_die(
+      "set -lex NWL20 -wmp true -s1 score -s2 score -r1 all -r2 all -numplays "
+      "3 -plies 2 -threads 1 -iter 300 -scond none -sr rr -useheatmap true "
+      "-plystatrate 3");
+  load_and_exec_config_or_die(config, "cgp " EMPTY_CGP);
+  load_and_exec_config_or_die(config, "rack AEIQRST");
+  load_and_exec_config_or_die(config, "gen");
+
+  const uint64_t seed = ctime_get_current_time();
+  SimResults *sim_results_single_threaded = config_get_sim_results(config);
+  SimResults *sim_results_multithreaded =
+      sim_results_create(convert_user_cutoff_to_cutoff(0.005));
+  const int thread_counts[] = {1, 4, 7};
+  for (int i = 0; i < 3; i++) {
+    char *set_threads_cmd = get_formatted_string("set -threads %d -seed %lu",
+                                                 thread_counts[i], seed);
+    load_and_exec_config_or_die(config, set_threads_cmd);
+    free(set_threads_cmd);
+    SimResults *sim_results =
+        i == 0 ? sim_results_single_threaded : sim_results_multithreaded;
+    assert(config_simulate_and_return_status(config, NULL, NULL,
+                                             sim_results) ==
+           ERROR_STATUS_SUCCESS);
+    if (i == 0) {
+      continue;
+    }
+    assert_sim_results_equal(sim_results_single_threaded, sim_results);
+    for (int play = 0; play < sim_results_get_number_of_plays(sim_results);
+         play++) {
+      SimmedPlay *sp1 =
+          sim_results_get_simmed_play(sim_results_single_threaded, play);
+      SimmedPlay *sp2 = sim_results_get_simmed_play(sim_results, play);
+      // Only about a third of the rollouts are sampled.
+      const uint64_t num_sampled =
+          stat_get_num_samples(simmed_play_get_score_stat(sp2, 0));
+      const uint64_t num_rollouts =
+          stat_get_num_samples(simmed_play_get_equity_stat(sp2));
+      assert(num_sampled > 0 && num_sampled < num_rollouts);
+      for (int ply = 0; ply < sim_results_get_num_plies(sim_results); ply++) {
+        for (int type = 0; type < NUM_HEAT_MAP_TYPES; type++) {
+          for (int row = 0; row < BOARD_DIM; row++) {
+            for (int col = 0; col < BOARD_DIM; col++) {
+              assert(heat_map_get_count(simmed_play_get_heat_map(sp1, ply),
+                                        row, col, (heat_map_t)type) ==
+                     heat_map_get_count(simmed_play_get_heat_map(sp2, ply),
+                                        row, col, (heat_map_t)type));
+            }
+          }
+        }
+      }
+    }
+  }
+
+  sim_results_destroy(sim_results_multithreaded);
+  config_destroy(config);
+}
+
+// Sharing rollout moves between plays only skips repeated move generation,
+// so the results must be the same as without sharing for every sampling rule.
+void test_sim_share_rollouts(void) {
+  Config *config = config_create_or_die(
+      "set -lex NWL20 -wmp true -s1 equity -s2 equity -r1 all -r2 all "
+      "-numplays 20 -plies 2 -iter 400 -scond none");
+  load_and_exec_config_or_die(config, "cgp " EMPTY_CGP);
+  load_and_exec_config_or_die(config, "rack QUUUUVV");
+  load_and_exec_config_or_die(config, "gen");
+
+  const uint64_t seed = ctime_get_current_time();
+  SimResults *sim_results_without_sharing = config_get_sim_results(config);
+  SimResults *sim_results_with_sharing =
+      sim_results_create(convert_user_cutoff_to_cutoff(0.005));
+  const char *sampling_rules[] = {"rr", "tt"};
+  const int thread_counts[] = {1, 1, 4};
+  for (int rule_index = 0; rule_index < 2; rule_index++) {
+    for (int i = 0; i < 3; i++) {
+      char *set_cmd = get_formatted_string(
+          "set -threads %d -seed %lu -sshare %s -sr %s", thread_counts[i],
+          seed, i == 0 ? "false" : "true", sampling_rules[rule_index]);
+      load_and_exec_config_or_die(config, set_cmd);
+      free(set_cmd);
+      SimResults *sim_results =
+          i == 0 ? sim_results_without_sharing : sim_results_with_sharing;
+      assert(config_simulate_and_return_status(config, NULL, NULL,
+                                               sim_results) ==
+             ERROR_STATUS_SUCCESS);
+      if (i == 0) {
+        assert(sim_results_get_shared_reply_count(sim_results) == 0);
+      } else {
+        // The exchanges share the replies to every sampled opponent rack.
+        assert(sim_results_get_shared_reply_count(sim_results) > 0);
+        assert_sim_results_equal(sim_results_without_sharing, sim_results);
+      }
+    }
+  }
+
+  sim_results_destroy(sim_results_with_sharing);
+  config_destroy(config);
+}
+
 void test_sim_top_two_consistency(void) {
   Config *config = config_create_or_die(
       "set -lex CSW21 -wmp true -numplays 15 -plies 5 -threads 10 "
@@ -1285,6 +1389,8 @@ void test_sim(void) {
   if (sim_perf_iters) {
     test_sim_perf(sim_perf_iters);
   } else {
+    test_sim_share_rollouts();
+    test_sim_ply_stats_consistency();
     test_similar_play_consistency(1);
     test_similar_play_consistency(10);
     test_sim_error_cases();
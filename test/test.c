@@ -8,6 +8,7 @@
 #include "bag_test.h"
 #include "bai_test.h"
 #include "bai_utility_test.h"
+#include "bench_suite_test.h"
 #include "benchmark_endgame_test.h"
 #include "benchmark_peg_test.h"
 #include "bit_rack_test.h"
@@ -20,6 +21,7 @@
 #include "command_test.h"
 #include "config_test.h"
 #include "convert_test.h"
+#include "core_lender_test.h"
 #include "create_data_test.h"
 #include "cross_set_test.h"
 #include "dawg_packed_test.h"
@@ -32,6 +34,7 @@
 #include "heat_map_test.h"
 #include "infer_cmp_test.h"
 #include "infer_test.h"
+#include "job_server_test.h"
 #include "klv_test.h"
 #include "kwg_alpha_test.h"
 #include "kwg_maker_test.h"
@@ -39,14 +42,17 @@
 #include "leaves_test.h"
 #include "letter_distribution_test.h"
 #include "load_gcg_test.h"
+#include "magpie_multi_test.h"
 #include "math_util_test.h"
 #include "move_gen_test.h"
 #include "move_test.h"
+#include "opening_table_test.h"
 #include "peg_oracle_test.h"
 #include "peg_pess_test.h"
 #include "peg_poll_test.h"
 #include "peg_pool_test.h"
 #include "peg_test.h"
+#include "perf_counters_test.h"
 #include "play_chooser_test.h"
 #include "players_data_test.h"
 #include "rack_info_table_test.h"
@@ -58,6 +64,7 @@
 #include "sim_test.h"
 #include "stats_test.h"
 #include "string_util_test.h"
+#include "thread_pool_test.h"
 #include "transposition_table_test.h"
 #include "validated_move_test.h"
 #include "win_pct_test.h"
@@ -87,6 +94,7 @@ static TestEntry test_table[] = {
     {"l", test_leaves},
     {"leavemap", test_leave_map},
     {"rit", test_rack_info_table},
+    {"ot", test_opening_table},
     {"kwg", test_kwg_alpha},
     {"bag", test_bag},
     {"rack", test_rack},
@@ -103,6 +111,7 @@ static TestEntry test_table[] = {
     {"eqadj", test_equity_adjustments},
     {"gameplay", test_gameplay},
     {"stats", test_stats},
+    {"perf", test_perf_counters},
     {"infer", test_infer},
     {"rv", test_random_variable},
     {"am", test_alias_method},
@@ -114,6 +123,7 @@ static TestEntry test_table[] = {
     {"command", test_command},
     {"cmdapi", test_cmd_api},
     {"gcg", test_gcg},
+    {"jobserver", test_job_server},
     {"analyze", test_analyze},
     {"autoplay", test_autoplay},
     {"words", test_words},
@@ -133,11 +143,13 @@ static TestEntry test_table[] = {
     {"endgame", test_endgame},
     {"endgameoutplay", test_endgame_outplay_zobrist_overflow},
     {"endgamefirstwin", test_endgame_first_win_sign},
+    {"corelender", test_core_lender},
     {"eldar_v", test_eldar_v_stick},
     {"zobrist", test_zobrist},
     {"tt", test_transposition_table},
     {"load", test_load_gcg},
     {"pegpool", test_peg_pool},
+    {"threadpool", test_thread_pool},
     {"peg", test_peg},
     {"pegpessdraw", test_peg_pessfull_draw_regression},
     {"pegtopkall", test_peg_pegtopk_all},
@@ -178,8 +190,11 @@ static TestEntry on_demand_test_table[] = {
     {"kwgmergebench", test_kwg_merge_build_bench},
     {"endgame_stream", test_endgame_progress_stream},
     {"kue", test_kue},
+    // Needs bin/magpie_multi from 'make magpie_multi'
+    {"multi", test_magpie_multi},
     {"monsterq", test_monster_q},
     {"simbench", test_sim_benchmark},
+    {"bench", test_bench_suite},
     {"ap_rit", test_autoplay_rit_correctness},
     // Pre-endgame (PEG) solver
     {"peg1pb", test_peg_1bag_pass_best},
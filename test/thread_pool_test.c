@@ -0,0 +1,130 @@
+#include "../src/compat/cpthread.h"
+#include "../src/def/cpthread_defs.h"
+#include "../src/impl/move_gen.h"
+#include "../src/impl/thread_pool.h"
+#include "../src/util/io_util.h"
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+enum { NUM_ROUTINES = 6, LARGE_STACK_BYTES = 16 * 1024 * 1024 };
+
+// Every routine waits until all of them have started, which only finishes if
+// the pool runs the started routines concurrently.
+typedef struct RendezvousArgs {
+  cpthread_mutex_t *mutex;
+  cpthread_cond_t *cond;
+  int *num_started;
+  int num_routines;
+  atomic_int *num_finished;
+} RendezvousArgs;
+
+static void *rendezvous_routine(void *uncasted_args) {
+  const RendezvousArgs *args = (const RendezvousArgs *)uncasted_args;
+  cpthread_mutex_lock(args->mutex);
+  (*args->num_started)++;
+  cpthread_cond_broadcast(args->cond);
+  while (*args->num_started < args->num_routines) {
+    cpthread_cond_wait(args->cond, args->mutex);
+  }
+  cpthread_mutex_unlock(args->mutex);
+  atomic_fetch_add(args->num_finished, 1);
+  return NULL;
+}
+
+static void run_rendezvous(int num_routines) {
+  cpthread_mutex_t mutex;
+  cpthread_mutex_init(&mutex);
+  cpthread_cond_t cond;
+  cpthread_cond_init(&cond);
+  int num_started = 0;
+  atomic_int num_finished;
+  atomic_init(&num_finished, 0);
+  const RendezvousArgs args = {
+      .mutex = &mutex,
+      .cond = &cond,
+      .num_started = &num_started,
+      .num_routines = num_routines,
+      .num_finished = &num_finished,
+  };
+  ThreadPoolThread **threads =
+      malloc_or_die(sizeof(ThreadPoolThread *) * num_routines);
+  for (int i = 0; i < num_routines; i++) {
+    threads[i] = thread_pool_start(rendezvous_routine, (void *)&args);
+  }
+  for (int i = 0; i < num_routines; i++) {
+    thread_pool_join(threads[i]);
+  }
+  assert(atomic_load(&num_finished) == num_routines);
+  free(threads);
+}
+
+// A routine that starts its own routines on the pool and joins them, as a
+// simulation inside an autoplay worker does.
+static void *nested_routine(void *uncasted_num_routines) {
+  run_rendezvous(*(int *)uncasted_num_routines);
+  return NULL;
+}
+
+static void *get_movegen_routine(void *uncasted_gen) {
+  *(MoveGen **)uncasted_gen = get_movegen();
+  return NULL;
+}
+
+// A parked thread returns its MoveGen slot, so the next thread to ask for a
+// MoveGen gets the same one.
+static void test_thread_pool_releases_movegen_slot(size_t stack_bytes) {
+  gen_destroy_cache();
+  MoveGen *pool_thread_gen = NULL;
+  thread_pool_join(thread_pool_start_with_stack(get_movegen_routine,
+                                                &pool_thread_gen, stack_bytes));
+  assert(pool_thread_gen);
+  assert(get_movegen() == pool_thread_gen);
+  gen_destroy_cache();
+}
+
+void test_thread_pool(void) {
+  thread_pool_destroy();
+  assert(thread_pool_get_num_threads() == 0);
+
+  run_rendezvous(NUM_ROUTINES);
+  assert(thread_pool_get_num_threads() == NUM_ROUTINES);
+
+  // Joined threads are parked and reused rather than recreated.
+  for (int i = 0; i < 10; i++) {
+    run_rendezvous(NUM_ROUTINES);
+  }
+  run_rendezvous(NUM_ROUTINES / 2);
+  assert(thread_pool_get_num_threads() == NUM_ROUTINES);
+
+  // Nested starts get threads of their own while the outer routines run.
+  int num_inner_routines = 2;
+  ThreadPoolThread *outer_threads[2];
+  for (int i = 0; i < 2; i++) {
+    outer_threads[i] = thread_pool_start(nested_routine, &num_inner_routines);
+  }
+  for (int i = 0; i < 2; i++) {
+    thread_pool_join(outer_threads[i]);
+  }
+  assert(thread_pool_get_num_threads() == NUM_ROUTINES);
+
+  thread_pool_set_cpu_affinity(true);
+  run_rendezvous(NUM_ROUTINES);
+  thread_pool_set_cpu_affinity(false);
+  run_rendezvous(NUM_ROUTINES);
+
+  test_thread_pool_releases_movegen_slot(0);
+  assert(thread_pool_get_num_threads() == NUM_ROUTINES);
+
+  // Parked threads have the default stack, so a routine that needs a larger
+  // one gets a new thread, which then also runs routines without such needs.
+  test_thread_pool_releases_movegen_slot(LARGE_STACK_BYTES);
+  assert(thread_pool_get_num_threads() == NUM_ROUTINES + 1);
+  test_thread_pool_releases_movegen_slot(LARGE_STACK_BYTES);
+  run_rendezvous(NUM_ROUTINES + 1);
+  assert(thread_pool_get_num_threads() == NUM_ROUTINES + 1);
+
+  thread_pool_destroy();
+  assert(thread_pool_get_num_threads() == 0);
+}
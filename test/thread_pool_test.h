@@ -0,0 +1,6 @@
+#ifndef THREAD_POOL_TEST_H
+#define THREAD_POOL_TEST_H
+
+void test_thread_pool(void);
+
+#endif
@@ -1,13 +1,42 @@
 #include "../src/ent/win_pct.h"
 #include "../src/impl/config.h"
+#include "../src/util/io_util.h"
 #include "test_util.h"
 #include <assert.h>
+#include <math.h>
 #include <stdint.h>
 
 void assert_win_pct_get(const float actual, const double expected) {
   assert(within_epsilon(actual, expected));
 }
 
+static void test_win_pct_logistic(const WinPct *win_pct) {
+  // The logistic flavor is fitted to the table of the same name.
+  ErrorStack *error_stack = error_stack_create();
+  WinPct *logistic_win_pct =
+      win_pct_create(DEFAULT_TEST_DATA_PATH, "winpct.logistic", error_stack);
+  assert(error_stack_is_empty(error_stack));
+  assert_strings_equal(win_pct_get_name(logistic_win_pct), "winpct.logistic");
+  for (unsigned int unseen = 1; unseen <= 93; unseen++) {
+    float previous = 0.0f;
+    for (int spread = -600; spread <= 600; spread++) {
+      const float value = win_pct_get(logistic_win_pct, spread, unseen);
+      assert(value >= previous);
+      previous = value;
+    }
+    // The model stays close to the sampled values near even spreads.
+    for (int spread = -100; spread <= 100; spread += 10) {
+      assert(fabs(win_pct_get(logistic_win_pct, spread, unseen) -
+                  win_pct_get(win_pct, spread, unseen)) < 0.05);
+    }
+  }
+  win_pct_destroy(logistic_win_pct);
+
+  win_pct_create(DEFAULT_TEST_DATA_PATH, "missing.logistic", error_stack);
+  assert(error_stack_top(error_stack) == ERROR_STATUS_FILEPATH_FILE_NOT_FOUND);
+  error_stack_destroy(error_stack);
+}
+
 void test_win_pct(void) {
   Config *config = config_create_or_die(
       "set -lex CSW21 -s1 score -s2 score -r1 all -r2 all -numplays 1 "
@@ -39,5 +68,7 @@ void test_win_pct(void) {
                      180395057 / (double)((uint64_t)2932802774 * 2));
   assert_win_pct_get(win_pct_get(win_pct, 250, 93),
                      5842108920 / (double)((uint64_t)2932802774 * 2));
+
+  test_win_pct_logistic(win_pct);
   config_destroy(config);
 }
@@ -18,6 +18,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 void test_make_wmp_from_kwg(void) {
   Config *config = config_create_or_die("set -lex CSW21");
@@ -256,8 +257,95 @@ void test_make_wmp_from_words(void) {
   config_destroy(config);
 }
 
+static void assert_wmp_tables_equal(uint32_t num_buckets1,
+                                    uint32_t num_entries1,
+                                    const uint32_t *bucket_starts1,
+                                    const WMPEntry *entries1,
+                                    uint32_t num_buckets2,
+                                    uint32_t num_entries2,
+                                    const uint32_t *bucket_starts2,
+                                    const WMPEntry *entries2) {
+  assert(num_buckets1 == num_buckets2);
+  assert(num_entries1 == num_entries2);
+  assert(memcmp(bucket_starts1, bucket_starts2,
+                (num_buckets1 + 1) * sizeof(uint32_t)) == 0);
+  assert(memcmp(entries1, entries2, num_entries1 * sizeof(WMPEntry)) == 0);
+}
+
+static void assert_wmps_equal(const WMP *wmp1, const WMP *wmp2) {
+  assert(wmp1->max_word_lookup_bytes == wmp2->max_word_lookup_bytes);
+  for (int len = 2; len <= BOARD_DIM; len++) {
+    const WMPForLength *wfl1 = &wmp1->wfls[len];
+    const WMPForLength *wfl2 = &wmp2->wfls[len];
+    assert_wmp_tables_equal(wfl1->num_word_buckets, wfl1->num_word_entries,
+                            wfl1->word_bucket_starts, wfl1->word_map_entries,
+                            wfl2->num_word_buckets, wfl2->num_word_entries,
+                            wfl2->word_bucket_starts, wfl2->word_map_entries);
+    assert(wfl1->num_uninlined_words == wfl2->num_uninlined_words);
+    assert(memcmp(wfl1->word_letters, wfl2->word_letters,
+                  (size_t)wfl1->num_uninlined_words * len) == 0);
+    assert_wmp_tables_equal(wfl1->num_blank_buckets, wfl1->num_blank_entries,
+                            wfl1->blank_bucket_starts, wfl1->blank_map_entries,
+                            wfl2->num_blank_buckets, wfl2->num_blank_entries,
+                            wfl2->blank_bucket_starts,
+                            wfl2->blank_map_entries);
+    assert_wmp_tables_equal(
+        wfl1->num_double_blank_buckets, wfl1->num_double_blank_entries,
+        wfl1->double_blank_bucket_starts, wfl1->double_blank_map_entries,
+        wfl2->num_double_blank_buckets, wfl2->num_double_blank_entries,
+        wfl2->double_blank_bucket_starts, wfl2->double_blank_map_entries);
+  }
+}
+
+void test_make_wmp_from_words_bounded(void) {
+  Config *config = config_create_or_die("set -lex CSW21");
+  const LetterDistribution *ld = config_get_ld(config);
+  Game *game = config_game_create(config);
+  const Player *player = game_get_player(game, 0);
+  const KWG *csw_kwg = player_get_kwg(player);
+  DictionaryWordList *words = dictionary_word_list_create();
+  kwg_write_words(csw_kwg, kwg_get_dawg_root_node_index(csw_kwg), words, NULL);
+
+  // Keep the 2-7 letter words so the unbounded build stays quick under the
+  // sanitizers while still producing thousands of blank pairs per length.
+  DictionaryWordList *short_words = dictionary_word_list_create();
+  for (int word_idx = 0; word_idx < dictionary_word_list_get_count(words);
+       word_idx++) {
+    const DictionaryWord *word = dictionary_word_list_get_word(words, word_idx);
+    const uint8_t length = dictionary_word_get_length(word);
+    if (length <= 7) {
+      dictionary_word_list_add_word(short_words, dictionary_word_get_word(word),
+                                    length);
+    }
+  }
+  dictionary_word_list_destroy(words);
+
+  WMP *unbounded_wmp = make_wmp_from_words(short_words, ld, 0);
+  // A one byte limit forces the smallest chunks and therefore many spilled
+  // runs for every length.
+  WMP *spilled_wmp = make_wmp_from_words_bounded(short_words, ld, 1, 1);
+  assert_wmps_equal(unbounded_wmp, spilled_wmp);
+  wmp_destroy(spilled_wmp);
+  // Splitting the limit between threads still leaves every length bounded.
+  WMP *threaded_spilled_wmp =
+      make_wmp_from_words_bounded(short_words, ld, 4, 1);
+  assert_wmps_equal(unbounded_wmp, threaded_spilled_wmp);
+  wmp_destroy(threaded_spilled_wmp);
+  // A single thread with a generous limit fits in one chunk and never spills.
+  WMP *single_chunk_wmp =
+      make_wmp_from_words_bounded(short_words, ld, 1, (size_t)1 << 30);
+  assert_wmps_equal(unbounded_wmp, single_chunk_wmp);
+  wmp_destroy(single_chunk_wmp);
+
+  wmp_destroy(unbounded_wmp);
+  dictionary_word_list_destroy(short_words);
+  game_destroy(game);
+  config_destroy(config);
+}
+
 void test_wmp_maker(void) {
   test_make_wmp_from_kwg();
   test_make_wmp_from_dawg_only_kwg();
   test_make_wmp_from_words();
+  test_make_wmp_from_words_bounded();
 }